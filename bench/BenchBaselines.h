@@ -0,0 +1,98 @@
+#pragma once
+#include "BenchRunner.h"
+
+// Committed baselines: median cost per call of each primitive. Re-record after an intended change of cost
+// (copy the median column of the BENCH lines of one run, including `reference_loop`); 0 = not recorded yet.
+
+// Firmware build on the ESP32-C3 at 160 MHz [cycles]; recorded with the `benchmark` environment.
+// Not recorded yet: no board has run the benchmark firmware so far, so the run on the target reports its
+// timings as NEW and fails on its counts and checks only. The cycle counter of the target is exact, so the
+// first recorded run can be committed as is, without the scaling by `reference_loop`.
+const BenchBaseline target_baselines[] = {
+    {"reference_loop", 0},
+    {"frequency_trigger_check", 0},
+    {"frequency_toggler2_check", 0},
+    {"ewma_update", 0},
+    {"statdisplay_check_redraw", 0},
+    {"onewire_scratchpad_decode", 0},
+    {"onewire_scratchpad_read", 0},
+    {"zone_tick_1", 0},
+    {"zone_tick_2", 0},
+    {"zone_tick_4", 0},
+    {"zone_tick_8", 0},
+    {"command_dispatch", 0},
+    {"command_roundtrip_pty", 0},
+    {"framemirror_check_unchanged", 0},
+    {"framemirror_delta_frame", 0},
+    {"flightrecorder_record", 0},
+    {"burstpattern_next", 0},
+    {"ledc_indicator_blink", 0},
+    {"oled_bus_bytes_full_screen", 0}, // host only: counted by the capture backend of the display stand-in
+    {"oled_bus_bytes_temp_change", 0},
+    {"oled_bus_transactions_temp_change", 0},
+    {"workflow_frame_bytes", 0},
+    {"workflow_resume", 0},
+    {"workflow_check_waiting", 0},
+    {"heater_accounting_transition", 0},
+    {"snapshot_bytes", 0},
+    {"snapshot_build", 0},
+    {"snapshot_decode", 0},
+    {"xbm_heating_bytes", 0},
+    {"xbm_splash_bytes", 0},
+    {"xbm_decode_splash_frame", 0},
+    {"xbm_blit_icon", 0},
+    {"series_bytes_per_sample_x100", 0},
+    {"series_encode", 0},
+    {"series_append", 0},
+    {"series_write_amplification_x100", 0},
+    {"streamstats_bytes", 0},
+    {"streamstats_add", 0},
+    {"streamstats_add_after_gap", 0},
+    {"p2quantile_add", 0},
+    {"thermal_period", 0}};
+
+// Host build against the stand-ins in `bench/host` [nanoseconds]; recorded with the `native_benchmark` environment.
+// Host timings depend on the machine and its load: these are the slowest medians of repeated runs on the
+// development machine, each scaled to the median of `reference_loop` over the runs. A run scales them by the
+// speed of its machine relative to the development machine, measured on the same reference loop.
+const BenchBaseline host_baselines[] = {
+    {"reference_loop", 190},
+    {"frequency_trigger_check", 52},
+    {"frequency_toggler2_check", 50},
+    {"ewma_update", 7},
+    {"statdisplay_check_redraw", 30},
+    {"onewire_scratchpad_decode", 256},
+    {"zone_tick_1", 11},
+    {"zone_tick_2", 16},
+    {"zone_tick_4", 27},
+    {"zone_tick_8", 44},
+    {"command_dispatch", 650},
+    {"command_roundtrip_pty", 0}, // not recorded: dominated by the kernel's tty layer, which varies between machines
+    {"framemirror_check_unchanged", 14},
+    {"framemirror_delta_frame", 1198},
+    {"flightrecorder_record", 64},
+    {"burstpattern_next", 3},
+    {"ledc_indicator_blink", 216},
+    {"oled_bus_bytes_full_screen", 435}, // exact counts [bytes, transactions], not timings
+    {"oled_bus_bytes_temp_change", 284},
+    {"oled_bus_transactions_temp_change", 24},
+    {"workflow_frame_bytes", 88}, // size of the coroutine frame [bytes], not a timing
+    {"workflow_resume", 112},
+    {"workflow_check_waiting", 60},
+    {"heater_accounting_transition", 52},
+    {"snapshot_bytes", 115}, // size of the snapshot [bytes], not a timing
+    {"snapshot_build", 168},
+    {"snapshot_decode", 43},
+    {"xbm_heating_bytes", 58}, // encoded sizes of the animations [bytes], not timings
+    {"xbm_splash_bytes", 284},
+    {"xbm_decode_splash_frame", 1287},
+    {"xbm_blit_icon", 827},
+    {"series_bytes_per_sample_x100", 210}, // encoded bytes per sample x100, not a timing
+    {"series_encode", 15},
+    {"series_append", 53},
+    {"series_write_amplification_x100", 104}, // flash consumed per byte of records x100, not a timing
+    {"streamstats_bytes", 4120},              // size of the statistics [bytes], not a timing
+    {"streamstats_add", 81},
+    {"streamstats_add_after_gap", 968},
+    {"p2quantile_add", 32},
+    {"thermal_period", 188}};
@@ -0,0 +1,1252 @@
+#include <Arduino.h>
+#include <OneWire.h>
+#include <U8g2lib.h>
+
+#include "AnimationAssets.h"
+#include "BenchBaselines.h"
+#include "BenchRunner.h"
+#include "BurstPattern.h"
+#include "CommandServer.h"
+#include "ControllerSnapshot.h"
+#include "Ewma.h"
+#include "FlightRecorder.h"
+#include "FrameMirror.h"
+#include "FrequentlyUtils.h"
+#include "HeaterAccounting.h"
+#include "HeaterSupervisor.h"
+#include "LedUtils.h"
+#include "OneWireSlots.h"
+#include "SeriesStore.h"
+#include "StreamStats.h"
+#include "ThermalPredictor.h"
+#include "StatDisplay.h"
+#include "Workflow.h"
+#include "XbmAnimation.h"
+#include "ZoneController.h"
+
+#ifdef KOLIBRIE_HOST
+#include "host/PtyStream.h"
+#include <hal/gpio_ll.h>
+#include <cstdio>  // For snprintf()
+#include <cstdlib> // For getenv()
+#include <unistd.h>
+#include <vector>
+#else
+#include "DallasTemperature.h"
+#endif
+
+/* ▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅ BENCHMARK CONFIGURATION ▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅ */
+// Microbenchmarks of the primitives the controller loop depends on. The same source builds the benchmark
+// firmware (environment `benchmark`) and the host build against stand-ins (environment `native_benchmark`,
+// KOLIBRIE_HOST defined). The primitives are configured as in the controller, and timed on their hot path,
+// i.e. the path taken on (almost) every pass of the loop.
+
+#define BENCH_LED_GPIO 8            // blue on-board LED (as in the controller)
+#define BENCH_SENSOR_GPIO 2         // DS18B20 OneWire bus (as in the controller)
+#define BENCH_NEVER_MS 3600000UL    // interval that does not elapse during the benchmark: times the hot path
+#define BENCH_SCRATCHPAD_BYTES 9    // DS18B20 scratchpad length
+#define BENCH_PING_BYTES 16         // payload of the ping command
+#define BENCH_PTY_ITERATIONS 20     // round trips through the pty per round (each takes a few system calls)
+#define BENCH_TX_BUFFER_BYTES 1024  // free space the streams report for writing (as the console of the controller)
+#define BENCH_SERIES_INTERVAL_S 10  // measurement interval of the synthetic temperature history
+#define BENCH_SERIES_SAMPLES 600    // samples of the codec round trip
+#define BENCH_LOAD_GPIO 10          // first load pin of the supervisor scenarios (one pin per load)
+#define BENCH_SUPERVISED_LOADS 4    // loads of the supervisor scenarios (one per injected per-load fault)
+#define BENCH_HEATER_MAX_C 45.0f    // maximum temperature of the supervised load (as in the controller)
+#define BENCH_HEATER_MAX_RISE 5.0f  // maximum rate of rise [°C/min] (as in the controller)
+#define BENCH_BUDGET_ZONES 5        // zones of the power budget check, all asking for heat
+#define BENCH_BUDGET_LOADS 2        // loads on at the same time in the power budget check
+#define BENCH_BUDGET_MINUTES 20     // simulated time of the power budget check
+#define BENCH_SUPERVISOR_STEP_MS 10 // simulated time per loop pass of the supervisor scenarios
+#define BENCH_CODEC_FRAME_BYTES 360 // frames of the codec round trip (the buffer of the 72x40 screen)
+#define BENCH_CODEC_FRAMES 200      // random frames of the codec round trip
+#define BENCH_BURST_CHANGES 20000   // random level changes of the burst fire check
+#define BENCH_TRACE_CASES 200       // randomized traces of the timing core against the reference
+#define BENCH_TRACE_STEPS 400       // calls per trace (checks, activations, expiries)
+#define BENCH_STATS_GAP_MS 82800000 // gap between values of the worst case of the rolling statistics (23 hours)
+#define BENCH_PLANT_TAU_S 600.0f    // simulated heated zone: time constant [seconds]
+#define BENCH_PLANT_GAIN_C 20.0f    // simulated heated zone: temperature rise at full duty [°C]
+#define BENCH_PLANT_AMBIENT_C 20.0f // simulated heated zone: ambient temperature [°C]
+#define BENCH_PLANT_DEAD_PERIODS 3  // simulated heated zone: dead time [periods of the thermal model]
+#define BENCH_PLANT_PERIODS 2880    // periods identified before the check (4 hours)
+
+#ifdef KOLIBRIE_HOST
+#define BENCH_PLATFORM "host"
+#define BENCH_BASELINES host_baselines
+#else
+#define BENCH_PLATFORM "esp32c3"
+#define BENCH_BASELINES target_baselines
+#endif
+
+BenchRunner bench(BENCH_PLATFORM, BENCH_BASELINES, sizeof(BENCH_BASELINES) / sizeof(BENCH_BASELINES[0]));
+volatile uint32_t benchSink = 0; // stores results, so the compiler cannot drop the timed calls
+
+U8G2_SSD1306_72X40_ER_F_SW_I2C u8g2(U8G2_R2, 6, 5, U8X8_PIN_NONE);
+
+// In-memory stream for the command server: reads the same request again after each `rewind()`, and
+// discards the response
+class BenchStream : public Stream {
+  public:
+  BenchStream(const uint8_t *input, size_t length) : input(input), length(length), position(0) {}
+
+  void rewind() { position = 0; }
+
+  int available() override { return static_cast<int>(length - position); }
+  int read() override { return (position < length) ? input[position++] : -1; }
+  int peek() override { return (position < length) ? input[position] : -1; }
+  int availableForWrite() override { return BENCH_TX_BUFFER_BYTES; }
+  size_t write(uint8_t /* c */) override { return 1; }
+  size_t write(const uint8_t * /* buffer */, size_t size) override { return size; }
+
+  private:
+  const uint8_t *const input;
+  const size_t length;
+  size_t position;
+};
+
+#ifdef KOLIBRIE_HOST
+// Reference for the timing traces: the triggers and togglers as implemented before `TimingCore`, except that
+// missed intervals are skipped one at a time (the former toggler spun forever after a missed on/off period).
+// A trigger is a toggler that does not toggle, with the interval as its off-duration.
+class ReferenceToggler {
+  public:
+  ReferenceToggler(int64_t lifetimeMs, int64_t onMs, int64_t offMs, bool toggles)
+      : lifetimeMs(lifetimeMs), onMs(onMs), offMs(offMs), toggles(toggles), activatedMs(0), nextMs(0), on(false), status(2) {}
+
+  bool check() {
+    if (status == 2) return false;
+    int64_t nowMs = esp_timer_get_time() / 1000LL;
+    if ((status == 1) || ((lifetimeMs >= 0) && (nowMs - activatedMs > lifetimeMs))) {
+      bool wasOn = on;
+      status = 2;
+      on = false;
+      return wasOn;
+    }
+    if (nowMs < nextMs) return false;
+    do {
+      if (toggles) on = !on;
+      nextMs += on ? onMs : offMs;
+    } while (nowMs >= nextMs);
+    return true;
+  }
+  void activate(long delayMs) {
+    if (lifetimeMs == 0) return;
+    activatedMs = esp_timer_get_time() / 1000LL + delayMs;
+    nextMs = activatedMs;
+    status = 0;
+  }
+  void expire() {
+    if (status != 2) status = 1;
+  }
+  bool isOn() { return on; }
+  bool isExpired() { return status != 0; }
+
+  private:
+  const int64_t lifetimeMs, onMs, offMs;
+  const bool toggles;
+  int64_t activatedMs, nextMs;
+  bool on;
+  uint8_t status; // 0: active, 1: should expire, 2: expired
+};
+#endif
+
+/* FUNCTION PROTOTYPES
+ * ╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴ */
+uint8_t runBenchmarks();
+void benchTimingPrimitives();
+#ifdef KOLIBRIE_HOST
+uint32_t timingTraceErrors(const char *check);
+template <typename Core>
+uint32_t timingTraceErrors(const char *check, Core &core, ReferenceToggler &reference, uint32_t &random, int64_t maxStepUs);
+#endif
+void benchDisplay();
+void benchScratchpad();
+void benchZoneTick();
+void benchZoneTick(const char *name, uint8_t zoneCount);
+void benchZoneBudget();
+void writeNoLoad(uint8_t loadPin, bool on);
+void benchCommands();
+void benchFrameMirror();
+void benchFlightRecorder();
+void benchBurstPattern();
+void benchDisplayBus();
+void benchWorkflows();
+void benchHeaterAccounting();
+void benchSnapshot();
+void benchAnimations();
+void benchSeries();
+void benchStreamStats();
+void benchThermalPredictor();
+void benchHeaterSupervisor();
+#ifdef KOLIBRIE_HOST
+uint32_t startSupervisedLoads(const char *check, HeaterSupervisor &supervisor);
+uint32_t superviseUntilOff(HeaterSupervisor &supervisor, uint8_t load, uint32_t limitMs, bool loopRuns, bool readingsArrive, float startC, float riseCPerS);
+uint8_t supervisedLoadsOn();
+#endif
+SeriesSample seriesTraceSample(uint32_t index, uint8_t channels);
+bool isSameSample(const SeriesSample &a, const SeriesSample &b, uint8_t channels);
+uint32_t seriesRoundTripErrors(const char *check, const SeriesSample *samples, size_t count, uint8_t channels, size_t &encodedBytes);
+uint32_t frameCodecRoundTripErrors(const char *check, const uint8_t *frame, const uint8_t *reference, size_t length);
+CommandStatus handleBenchPing(PayloadReader &request, PayloadWriter &response);
+size_t recordScratchpadWaveform(const uint8_t *scratchpad, OneWireSlots::Symbol *out);
+
+/* ▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅ ENTRY POINTS ▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅ */
+
+#ifdef KOLIBRIE_HOST
+// host build: the exit code fails the run on a regression
+int main() { return (runBenchmarks() == 0) ? 0 : 1; }
+#else
+void setup() {
+  Serial.begin(115200);
+  delay(1000);
+  u8g2.begin();
+  u8g2.setBusClock(400000);
+  runBenchmarks();
+}
+
+// the results are printed once; reset the board to repeat the run
+void loop() { delay(1000); }
+#endif
+
+/* ▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅ BENCHMARKS ▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅ */
+
+// Runs all benchmarks; returns the number of regressions against the baselines
+uint8_t runBenchmarks() {
+  bench.begin();
+  benchTimingPrimitives();
+  benchDisplay();
+  benchScratchpad();
+  benchZoneTick();
+  benchZoneBudget();
+  benchCommands();
+  benchFrameMirror();
+  benchFlightRecorder();
+  benchBurstPattern();
+  benchDisplayBus();
+  benchWorkflows();
+  benchHeaterAccounting();
+  benchSnapshot();
+  benchAnimations();
+  benchSeries();
+  benchStreamStats();
+  benchThermalPredictor();
+  benchHeaterSupervisor(); // last: skips simulated time
+  return bench.finish();
+}
+
+void benchTimingPrimitives() {
+  FrequencyTrigger trigger(FrequencyUtils::unbounded_lifetime, BENCH_NEVER_MS);
+  trigger.activate();
+  trigger.checkTrigger(); // fires once at activation
+  bench.run("frequency_trigger_check", [&] { benchSink = trigger.checkTrigger(); });
+
+  FrequencyToggler2 toggler(FrequencyUtils::unbounded_lifetime, BENCH_NEVER_MS, BENCH_NEVER_MS);
+  toggler.activate();
+  toggler.checkToggle(); // switches on at activation
+  bench.run("frequency_toggler2_check", [&] { benchSink = toggler.checkToggle(); });
+
+  LEDExpiringToggler ledToggler(BENCH_LED_GPIO, FrequencyUtils::unbounded_lifetime, BENCH_NEVER_MS, LedUtils::LOW_IS_ON);
+  ledToggler.activate();
+  ledToggler.checkToggleLED();
+  // changing the pattern: stops the timer, and writes the first step (the timer then steps the pattern)
+  bench.run("ledc_indicator_blink", [&] { ledToggler.indicator().blink(BENCH_NEVER_MS, BENCH_NEVER_MS); });
+  ledToggler.expire();
+
+  Ewma average(0.05f);
+  float sample = 0.0f;
+  bench.run("ewma_update", [&] {
+    sample += 0.25f;
+    benchSink = static_cast<uint32_t>(average.update(sample));
+  });
+
+#ifdef KOLIBRIE_HOST
+  bench.check("timing_trace_equivalence", timingTraceErrors("timing_trace_equivalence"));
+#else
+  bench.skip("timing_trace_equivalence"); // needs the stopped clock of the host
+#endif
+}
+
+#ifdef KOLIBRIE_HOST
+// Randomized traces of the triggers and togglers against `ReferenceToggler`, on a stopped clock that the trace
+// advances by random steps (up to three intervals, so intervals are missed) between random calls of `check()`,
+// `activate()` and `expire()`. Lifetimes are unbounded, zero or random. Returns the number of calls whose
+// result, state or expiry differ.
+uint32_t timingTraceErrors(const char *check) {
+  uint32_t random = 1;
+  auto next = [&](uint32_t range) {
+    random = random * 1103515245u + 12345u;
+    return static_cast<int64_t>((random >> 8) % range);
+  };
+  uint32_t errors = 0;
+  hostFreezeTime(true);
+  for (uint32_t i = 0; i < BENCH_TRACE_CASES; i++) {
+    int64_t onMs = 1 + next(50);
+    int64_t offMs = 1 + next(50);
+    int64_t lifetimeMs = (i % 4 == 0) ? -1 : (i % 4 == 1) ? 0 : next(2000);
+    int64_t maxStepUs = 3000 * (onMs + offMs);
+    switch (i % 3) {
+      case 0: {
+        FrequencyTrigger core(lifetimeMs, offMs);
+        ReferenceToggler reference(lifetimeMs, onMs, offMs, false);
+        errors += timingTraceErrors(check, core, reference, random, maxStepUs);
+        break;
+      }
+      case 1: {
+        FrequencyToggler core(lifetimeMs, offMs);
+        ReferenceToggler reference(lifetimeMs, offMs, offMs, true);
+        errors += timingTraceErrors(check, core, reference, random, maxStepUs);
+        break;
+      }
+      default: {
+        FrequencyToggler2 core(lifetimeMs, onMs, offMs);
+        ReferenceToggler reference(lifetimeMs, onMs, offMs, true);
+        errors += timingTraceErrors(check, core, reference, random, maxStepUs);
+        break;
+      }
+    }
+  }
+  hostFreezeTime(false);
+  return errors;
+}
+
+template <typename Core>
+uint32_t timingTraceErrors(const char *check, Core &core, ReferenceToggler &reference, uint32_t &random, int64_t maxStepUs) {
+  uint32_t errors = 0;
+  for (uint32_t step = 0; step < BENCH_TRACE_STEPS; step++) {
+    random = random * 1103515245u + 12345u;
+    uint32_t action = (random >> 8) % 100;
+    if (action < 5) {
+      long delayMs = static_cast<long>((random >> 16) % 20);
+      core.activate(delayMs);
+      reference.activate(delayMs);
+    } else if (action < 8) {
+      core.expire();
+      reference.expire();
+    } else {
+      hostAdvanceTime(static_cast<uint64_t>((random >> 4) % maxStepUs));
+      errors += bench.expect(check, core.check() == reference.check(), "check() result differs");
+    }
+    errors += bench.expect(check, core.isCurrentStateOn() == reference.isOn(), "on/off state differs");
+    errors += bench.expect(check, core.isExpired() == reference.isExpired(), "expiry differs");
+  }
+  return errors;
+}
+#endif
+
+// Redraw check of the status screen while nothing has changed (heating symbol inactive)
+void benchDisplay() {
+  static uint8_t iconFrame[20 * 3];
+  XbmAnimationPlayer heatingIcon(heatingAnimation, iconFrame, 150, true);
+  StatDisplay statDisplay(u8g2, heatingIcon);
+  statDisplay.setTemp(40.0f);
+  statDisplay.checkRedraw(); // initial full draw
+  bench.run("statdisplay_check_redraw", [&] { statDisplay.checkRedraw(); });
+}
+
+// Decoding of a scratchpad from the waveform sampled by the RMT receiver, including the CRC check; on the
+// target additionally the read of the scratchpad on the bit-banged bus (if a DS18B20 is attached). Checks
+// that the decoded bytes are those recorded, that a corrupted bit fails the CRC, and that the presence
+// pulse after a reset is decoded (and its absence detected).
+void benchScratchpad() {
+  static const uint8_t scratchpad[BENCH_SCRATCHPAD_BYTES] = {0x80, 0x02, 0x4B, 0x46, 0x3F, 0xFF, 0x00, 0x10, 0x00};
+  uint8_t recorded[BENCH_SCRATCHPAD_BYTES];
+  memcpy(recorded, scratchpad, sizeof(recorded));
+  recorded[8] = OneWire::crc8(recorded, 8);
+
+  static OneWireSlots::Symbol waveform[8 * BENCH_SCRATCHPAD_BYTES];
+  size_t symbols = recordScratchpadWaveform(recorded, waveform);
+  uint8_t decoded[BENCH_SCRATCHPAD_BYTES];
+  bench.run("onewire_scratchpad_decode", [&] {
+    bool valid = OneWireSlots::decodeBytes(waveform, symbols, decoded, sizeof(decoded)) && (OneWire::crc8(decoded, 8) == decoded[8]);
+    benchSink = valid;
+  });
+
+  const char *check = "onewire_decode_errors";
+  uint32_t decodeErrors = 0;
+  memset(decoded, 0, sizeof(decoded));
+  bool valid = OneWireSlots::decodeBytes(waveform, symbols, decoded, sizeof(decoded));
+  decodeErrors += bench.expect(check, valid && (memcmp(decoded, recorded, sizeof(recorded)) == 0), "decoded bytes differ from the recorded ones");
+  decodeErrors += bench.expect(check, !OneWireSlots::decodeBytes(waveform, symbols - 1, decoded, sizeof(decoded)), "missing slot accepted");
+  waveform[12].duration0 = (waveform[12].duration0 == OneWireSlots::read_low_us) ? 30 : OneWireSlots::read_low_us; // bit 4 of byte 1 flipped
+  valid = OneWireSlots::decodeBytes(waveform, symbols, decoded, sizeof(decoded)) && (OneWire::crc8(decoded, 8) == decoded[8]);
+  decodeErrors += bench.expect(check, !valid, "flipped bit passes the CRC");
+  recordScratchpadWaveform(recorded, waveform);
+
+  // reset pulse as sampled back: the presence pulse follows after 30 us, a glitch is too short, or the line stays released
+  const OneWireSlots::Symbol present[2] = {{OneWireSlots::reset_low_us, 0, 30, 1}, {120, 0, 330, 1}};
+  const OneWireSlots::Symbol glitch[2] = {{OneWireSlots::reset_low_us, 0, 30, 1}, {10, 0, 440, 1}};
+  const OneWireSlots::Symbol absent[1] = {{OneWireSlots::reset_low_us, 0, OneWireSlots::reset_release_us, 1}};
+  decodeErrors += bench.expect(check, OneWireSlots::decodePresence(present, 2), "presence pulse not decoded");
+  decodeErrors += bench.expect(check, !OneWireSlots::decodePresence(glitch, 2), "glitch taken for a presence pulse");
+  decodeErrors += bench.expect(check, !OneWireSlots::decodePresence(absent, 1), "absent presence pulse not detected");
+  bench.check(check, decodeErrors);
+
+#ifdef KOLIBRIE_HOST
+  bench.skip("onewire_scratchpad_read");
+#else
+  OneWire sensorBus(BENCH_SENSOR_GPIO);
+  DallasTemperature sensors(&sensorBus);
+  DeviceAddress address;
+  sensors.begin();
+  if (!sensors.getAddress(address, 0)) {
+    bench.skip("onewire_scratchpad_read");
+    return;
+  }
+  ScratchPad read;
+  bench.run("onewire_scratchpad_read", [&] { benchSink = sensors.readScratchPad(address, read); }, 1);
+#endif
+}
+
+// Waveform of read slots as sampled back from the bus: a 1 is a short low pulse (the host's), a 0 is held
+// low by the device. Returns the number of symbols written to `out` (8 per byte).
+size_t recordScratchpadWaveform(const uint8_t *scratchpad, OneWireSlots::Symbol *out) {
+  size_t count = 0;
+  for (uint8_t i = 0; i < BENCH_SCRATCHPAD_BYTES; i++) {
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      bool one = (scratchpad[i] >> bit) & 0x01;
+      OneWireSlots::Symbol &symbol = out[count++];
+      symbol.level0 = 0;
+      symbol.duration0 = one ? OneWireSlots::read_low_us : 30;
+      symbol.level1 = 1;
+      symbol.duration1 = one ? OneWireSlots::read_release_us : 40;
+    }
+  }
+  return count;
+}
+
+// Control tick of the zone controller with 1, 2, 4 and 8 zones: the cost per tick grows linearly with the zones
+void benchZoneTick() {
+  benchZoneTick("zone_tick_1", 1);
+  benchZoneTick("zone_tick_2", 2);
+  benchZoneTick("zone_tick_4", 4);
+  benchZoneTick("zone_tick_8", 8);
+}
+
+// Zones alternate below and above their setpoint, so the budget is contended; ticks advance simulated time
+void benchZoneTick(const char *name, uint8_t zoneCount) {
+  static const uint8_t address[ZoneUtils::address_bytes] = {0x28, 0, 0, 0, 0, 0, 0, 0};
+  ZoneController zones(2, &writeNoLoad);
+  for (uint8_t zone = 0; zone < zoneCount; zone++) {
+    zones.addZone(address, zone, 40.0f);
+    zones.addTemperature(zone, (zone & 1) ? 45.0f : 30.0f);
+  }
+  uint32_t nowMs = 0;
+  bench.run(name, [&] {
+    nowMs += ZoneUtils::tick_ms;
+    benchSink = zones.tick(nowMs);
+  });
+}
+
+// zone loads are not driven during the benchmark
+void writeNoLoad(uint8_t /* loadPin */, bool /* on */) {}
+
+// Shared power budget of the zone controller, in simulated time: more zones ask for heat than loads may be on.
+// Every tick, at most `maxActiveLoads` loads may be on, and loads may switch on only `stagger_ms` apart. While
+// zones wait, the longest-running load must yield its slot once per `rotation_window_ms`, so that every zone
+// is served in turn.
+void benchZoneBudget() {
+#ifdef KOLIBRIE_HOST
+  using namespace ZoneUtils;
+  static const uint8_t address[address_bytes] = {0x28, 0, 0, 0, 0, 0, 0, 0};
+  const char *check = "zone_budget_errors";
+  uint32_t errors = 0;
+  hostFreezeTime(true);
+  ZoneController zones(BENCH_BUDGET_LOADS, &writeNoLoad);
+  for (uint8_t zone = 0; zone < BENCH_BUDGET_ZONES; zone++) {
+    zones.addZone(address, BENCH_LOAD_GPIO + zone, 40.0f);
+    zones.setExternalDemand(zone, true);
+  }
+  zones.activate();
+
+  uint32_t onSinceMs[BENCH_BUDGET_ZONES] = {};
+  uint32_t lastSwitchOnMs = 0;
+  uint32_t rotationMs = static_cast<uint32_t>(esp_timer_get_time() / 1000LL); // latest yield, or latest tick without waiting zones
+  uint8_t served = 0;
+  bool switchedOnBefore = false;
+  for (uint32_t elapsedMs = 0; elapsedMs < BENCH_BUDGET_MINUTES * 60000UL; elapsedMs += tick_ms) {
+    uint32_t nowMs = static_cast<uint32_t>(esp_timer_get_time() / 1000LL);
+    for (uint8_t zone = 0; zone < BENCH_BUDGET_ZONES; zone++) zones.addTemperature(zone, 30.0f);
+    uint32_t longestMs = 0;
+    for (uint8_t zone = 0; zone < BENCH_BUDGET_ZONES; zone++) {
+      if (zones.isLoadOn(zone) && (nowMs - onSinceMs[zone] > longestMs)) longestMs = nowMs - onSinceMs[zone];
+    }
+
+    uint8_t switched = zones.tick(nowMs);
+    errors += bench.expect(check, zones.activeLoads() <= BENCH_BUDGET_LOADS, "more loads on than the budget");
+    for (uint8_t zone = 0; zone < BENCH_BUDGET_ZONES; zone++) {
+      if ((switched & (1 << zone)) == 0) continue;
+      if (zones.isLoadOn(zone)) {
+        errors += bench.expect(check, !switchedOnBefore || (nowMs - lastSwitchOnMs >= stagger_ms), "loads switch on closer than stagger_ms");
+        switchedOnBefore = true;
+        lastSwitchOnMs = nowMs;
+        onSinceMs[zone] = nowMs;
+        served |= 1 << zone;
+      } else {
+        // every zone asks for heat: a load that switches off yields its slot
+        errors += bench.expect(check, nowMs - onSinceMs[zone] == longestMs, "a load yields that does not run longest");
+        rotationMs = nowMs;
+      }
+    }
+    uint8_t waiting = 0;
+    for (uint8_t zone = 0; zone < BENCH_BUDGET_ZONES; zone++) {
+      if (zones.hasDemand(zone) && !zones.isLoadOn(zone)) waiting |= 1 << zone;
+    }
+    if (waiting == 0) rotationMs = nowMs;
+    errors += bench.expect(check, nowMs - rotationMs <= rotation_window_ms + tick_ms, "the longest-running load does not yield after rotation_window_ms");
+    hostAdvanceTime(tick_ms * 1000ULL);
+  }
+  errors += bench.expect(check, served == (1 << BENCH_BUDGET_ZONES) - 1, "a waiting zone is never served");
+  hostFreezeTime(false);
+  bench.check(check, errors);
+#else
+  bench.skip("zone_budget_errors"); // runs in simulated time
+#endif
+}
+
+// Command protocol: parsing, dispatch and response of a ping with a 16-byte payload, from an in-memory
+// stream; on the host additionally the round trip through a pseudo-terminal, i.e. the kernel's tty layer
+// in both directions, as seen by a client on the slave end
+void benchCommands() {
+  static constexpr CommandEntry table[] = {{CommandId::CommandPing, &handleBenchPing}};
+  uint8_t payload[BENCH_PING_BYTES];
+  for (uint8_t i = 0; i < sizeof(payload); i++) payload[i] = i;
+  uint8_t request[CommandUtils::max_frame_bytes];
+  size_t requestSize = encodeCommandFrame(CommandId::CommandPing, 1, payload, sizeof(payload), request);
+
+  BenchStream stream(request, requestSize);
+  CommandServer server(stream, table, 1);
+  bench.run("command_dispatch", [&] {
+    stream.rewind();
+    benchSink = server.checkInput();
+  });
+
+#ifdef KOLIBRIE_HOST
+  PtyStream pty;
+  int client = pty.begin() ? pty.openSlave() : -1;
+  if (client < 0) {
+    bench.skip("command_roundtrip_pty");
+    return;
+  }
+  CommandServer ptyServer(pty, table, 1);
+  CommandParser clientParser;
+  bench.run("command_roundtrip_pty", [&] {
+    if (write(client, request, requestSize) != static_cast<ssize_t>(requestSize)) return;
+    bool responded = false;
+    while (!responded) {
+      ptyServer.checkInput();
+      uint8_t received[CommandUtils::max_frame_bytes];
+      ssize_t count = read(client, received, sizeof(received));
+      for (ssize_t i = 0; i < count; i++) responded |= clientParser.feed(received[i], 0);
+    }
+    benchSink = clientParser.frame().length;
+  }, BENCH_PTY_ITERATIONS);
+  close(client);
+#else
+  bench.skip("command_roundtrip_pty");
+#endif
+}
+
+// echoes the request payload, as the controller's ping command
+CommandStatus handleBenchPing(PayloadReader &request, PayloadWriter &response) {
+  response.putBytes(request.remainingData(), request.remaining());
+  return CommandStatus::CommandOk;
+}
+
+// Screen mirroring: the check of an unchanged frame buffer (the cost on almost every pass of the loop), and
+// the encoding and sending of a delta frame with one changed byte; the stream discards the messages. The
+// frame codec, which the host viewer and xbmpack share, must reproduce random frames and the edge cases of
+// its control bytes (a check).
+void benchFrameMirror() {
+  BenchStream stream(nullptr, 0);
+  FrameMirror mirror(u8g2, stream);
+  mirror.activate(0);
+  mirror.checkFrame(); // key frame
+  bench.run("framemirror_check_unchanged", [&] { benchSink = mirror.checkFrame(); });
+
+  uint8_t *frame = u8g2.getBufferPtr();
+  size_t length = 8 * u8g2.getBufferTileWidth() * u8g2.getBufferTileHeight();
+  size_t position = 0;
+  bench.run("framemirror_delta_frame", [&] {
+    frame[position] ^= 0x5A;
+    position = (position + 37) % length;
+    benchSink = mirror.checkFrame();
+  });
+
+  const char *check = "framecodec_roundtrip_errors";
+  static uint8_t codecFrame[BENCH_CODEC_FRAME_BYTES];
+  static uint8_t codecReference[BENCH_CODEC_FRAME_BYTES];
+  uint32_t errors = 0;
+  uint32_t random = 1;
+  for (uint32_t i = 0; i < BENCH_CODEC_FRAMES; i++) {
+    // from noise (i % 8 == 0) to long runs of a few values, as on a screen
+    for (size_t j = 0; j < sizeof(codecFrame); j++) {
+      random = random * 1103515245u + 12345u;
+      codecReference[j] = static_cast<uint8_t>(random >> 24);
+      codecFrame[j] = ((random >> 8) % 8 < i % 8) ? ((j > 0) ? codecFrame[j - 1] : 0) : static_cast<uint8_t>(random >> 16) % 4;
+    }
+    errors += frameCodecRoundTripErrors(check, codecFrame, codecReference, sizeof(codecFrame));
+  }
+
+  // edge cases: a run of the longest length, and one longer; a literal of the longest length, and one longer;
+  // runs of two (too short for a run) at the boundaries of literals
+  size_t distinct = 0;
+  auto literal = [&](size_t start, size_t count) {
+    for (size_t j = start; j < start + count; j++) codecFrame[j] = static_cast<uint8_t>(distinct++ % 251); // no two equal in a row
+  };
+  memset(codecReference, 0, sizeof(codecReference));
+  memset(codecFrame, 0x55, FrameCodec::max_run);
+  errors += frameCodecRoundTripErrors(check, codecFrame, codecReference, FrameCodec::max_run);
+  memset(codecFrame, 0x55, FrameCodec::max_run + 1);
+  errors += frameCodecRoundTripErrors(check, codecFrame, codecReference, FrameCodec::max_run + 1);
+  literal(0, FrameCodec::max_literal);
+  errors += frameCodecRoundTripErrors(check, codecFrame, codecReference, FrameCodec::max_literal);
+  literal(0, FrameCodec::max_literal + 1);
+  errors += frameCodecRoundTripErrors(check, codecFrame, codecReference, FrameCodec::max_literal + 1);
+  for (size_t pairAt : {size_t(0), FrameCodec::max_literal - 2, FrameCodec::max_literal - 1, FrameCodec::max_literal}) {
+    literal(0, sizeof(codecFrame));
+    codecFrame[pairAt + 1] = codecFrame[pairAt];
+    errors += frameCodecRoundTripErrors(check, codecFrame, codecReference, sizeof(codecFrame));
+    errors += frameCodecRoundTripErrors(check, codecFrame, codecReference, pairAt + 2); // the pair ends the frame
+  }
+  bench.check(check, errors);
+}
+
+// Encodes `frame` as a key frame and as a delta to `reference`, and decodes both again; the key frame must
+// also fit a buffer of exactly its size, and not one byte less. Returns the failed assertions.
+uint32_t frameCodecRoundTripErrors(const char *check, const uint8_t *frame, const uint8_t *reference, size_t length) {
+  static uint8_t encoded[FrameCodec::maxEncodedSize(BENCH_CODEC_FRAME_BYTES)];
+  static uint8_t decoded[BENCH_CODEC_FRAME_BYTES];
+  uint32_t errors = 0;
+  size_t size = FrameCodec::encode(frame, length, encoded, sizeof(encoded));
+  bool valid = (size > 0) && FrameCodec::decode(encoded, size, nullptr, decoded, length);
+  errors += bench.expect(check, valid && (memcmp(decoded, frame, length) == 0), "key frame differs");
+  errors += bench.expect(check, FrameCodec::encode(frame, length, encoded, size) == size, "key frame does not fit its exact size");
+  errors += bench.expect(check, FrameCodec::encode(frame, length, encoded, size - 1) == 0, "key frame overruns the capacity");
+
+  size = FrameCodec::encodeDelta(frame, reference, length, encoded, sizeof(encoded));
+  valid = (size > 0) && FrameCodec::decode(encoded, size, reference, decoded, length);
+  errors += bench.expect(check, valid && (memcmp(decoded, frame, length) == 0), "delta frame differs");
+  return errors;
+}
+
+// Flight recorder: appending a temperature record, as on every sample (the log in RAM here, instead of RTC
+// memory; both are internal SRAM on the ESP32-C3)
+void benchFlightRecorder() {
+  static FlightLog log; // static: too large for the stack of the loop task
+  FlightRecorder recorder(log);
+  recorder.begin(0);
+  float tempC = 40.0f;
+  bench.run("flightrecorder_record", [&] {
+    recorder.recordTemperature(FlightEvent::FlightTemperature, 0, tempC);
+    tempC += 0.0625f;
+  });
+  benchSink = recorder.recordCount();
+}
+
+// Burst fire: deciding one mains cycle, as the timer ISR does 50 times per second. Also checks the claims of
+// `BurstPattern` for every level: the delivered energy stays within one cycle of the requested energy, and a
+// period switches as few times as an even spread can (at levels up to one half, every conducting cycle stands
+// alone, above, every blocking cycle); then, with the level changing every few cycles, that the remainder
+// carries over the changes.
+void benchBurstPattern() {
+  BurstPattern pattern;
+  pattern.setLevel(750);
+  bench.run("burstpattern_next", [&] { benchSink = pattern.next(); });
+
+  const char *check = "burst_pattern_errors";
+  const uint32_t period = BurstUtils::level_scale; // cycles after which every level repeats
+  uint32_t errors = 0;
+  for (uint16_t level = 0; level <= BurstUtils::level_scale; level++) {
+    BurstPattern levelPattern;
+    levelPattern.setLevel(level);
+    bool withinCycle = true;
+    for (uint32_t i = 0; i < 2 * period; i++) {
+      if (i == period) levelPattern.resetStats(); // the first period settles the state of the previous cycle
+      levelPattern.next();
+      int32_t error = levelPattern.energyErrorPerMille();
+      withinCycle = withinCycle && (error > -static_cast<int32_t>(BurstUtils::level_scale)) && (error < static_cast<int32_t>(BurstUtils::level_scale));
+    }
+    const uint32_t blocking = period - level;
+    errors += bench.expect(check, withinCycle, "energy deviates by a full cycle at a steady level");
+    errors += bench.expect(check, levelPattern.onCycleCount() == level, "conducting cycles per period differ from the level");
+    errors += bench.expect(check, levelPattern.switchingCount() == 2 * ((level < blocking) ? level : blocking), "more switchings per period than the fewest");
+  }
+
+  BurstPattern changingPattern;
+  uint32_t random = 1;
+  bool withinCycle = true;
+  for (uint32_t i = 0; i < BENCH_BURST_CHANGES; i++) {
+    random = random * 1103515245u + 12345u;
+    changingPattern.setLevel(static_cast<uint16_t>((random >> 8) % (BurstUtils::level_scale + 1)));
+    for (uint32_t cycles = 1 + (random >> 24) % 4; cycles > 0; cycles--) {
+      changingPattern.next();
+      int32_t error = changingPattern.energyErrorPerMille();
+      withinCycle = withinCycle && (error > -static_cast<int32_t>(BurstUtils::level_scale)) && (error < static_cast<int32_t>(BurstUtils::level_scale));
+    }
+  }
+  errors += bench.expect(check, withinCycle, "energy deviates by a full cycle over level changes");
+  bench.check(check, errors);
+}
+
+// Display bus cost: bytes and I2C transactions the status screen sends to the panel, for the first full
+// draw and for a change of the temperature. Counted by the capture backend of the host stand-in; with
+// BENCH_FRAME_DIR set in the environment, the captured screens are also written there as PBM images (e.g.
+// to compare against golden images). Also checks that the button cycles through all screens, and that the
+// screen is drawn entirely once an overlay (e.g. the marquee) releases it.
+void benchDisplayBus() {
+#ifdef KOLIBRIE_HOST
+  const char *frameDirectory = getenv("BENCH_FRAME_DIR");
+  char path[256];
+  static uint8_t iconFrame[20 * 3];
+  XbmAnimationPlayer heatingIcon(heatingAnimation, iconFrame, 150, true);
+  StatDisplay statDisplay(u8g2, heatingIcon);
+
+  u8g2.resetCapture();
+  statDisplay.setTemp(40.0f);
+  statDisplay.checkRedraw();
+  const uint32_t fullScreenBytes = u8g2.busBytes();
+  bench.count("oled_bus_bytes_full_screen", fullScreenBytes);
+  if (frameDirectory != nullptr) {
+    snprintf(path, sizeof(path), "%s/statdisplay-full.pbm", frameDirectory);
+    u8g2.writePbm(path);
+  }
+
+  u8g2.resetCapture();
+  statDisplay.setTemp(41.5f);
+  statDisplay.checkRedraw();
+  bench.count("oled_bus_bytes_temp_change", u8g2.busBytes());
+  bench.count("oled_bus_transactions_temp_change", u8g2.busTransactions());
+  if (frameDirectory != nullptr) {
+    snprintf(path, sizeof(path), "%s/statdisplay-temp-change.pbm", frameDirectory);
+    u8g2.writePbm(path);
+  }
+
+  const char *check = "statdisplay_screens";
+  uint32_t screenErrors = 0;
+  for (uint8_t i = 0; i < 4; i++) { // MinMax, Diagnostics, Energy, and back to Status
+    statDisplay.showNextScreen();
+    u8g2.resetCapture();
+    statDisplay.checkRedraw();
+    screenErrors += bench.expect(check, u8g2.busBytes() == fullScreenBytes, "next screen not drawn in full");
+  }
+  statDisplay.setOverlaid(true);
+  statDisplay.setTemp(42.0f);
+  u8g2.resetCapture();
+  statDisplay.checkRedraw();
+  screenErrors += bench.expect(check, u8g2.busBytes() == 0, "drawn over the overlay"); // the overlay owns the screen
+  statDisplay.setOverlaid(false);
+  u8g2.resetCapture();
+  statDisplay.checkRedraw();
+  screenErrors += bench.expect(check, u8g2.busBytes() == fullScreenBytes, "not redrawn in full after the overlay");
+  bench.check(check, screenErrors);
+#else
+  bench.skip("oled_bus_bytes_full_screen");
+  bench.skip("oled_bus_bytes_temp_change");
+  bench.skip("oled_bus_transactions_temp_change");
+  bench.skip("statdisplay_screens");
+#endif
+}
+
+// resumed on every pass; counts its passes
+Workflow benchPassingWorkflow(uint32_t *passes) {
+  for (;;) {
+    co_await nextPass();
+    (*passes)++;
+  }
+}
+
+// waits for a deadline that does not pass during the benchmark
+Workflow benchSleepingWorkflow() { co_await sleepFor(BENCH_NEVER_MS); }
+
+// Workflows: resuming a workflow that waits for the next pass (the cost of one step of a workflow), and the
+// check of a workflow that is still waiting for its deadline (the cost on every pass of the loop); the size
+// of the coroutine frame is reported as a count
+void benchWorkflows() {
+  uint32_t passes = 0;
+  WorkflowRunner passingRunner;
+  passingRunner.start(benchPassingWorkflow(&passes), "passing");
+  bench.count("workflow_frame_bytes", passingRunner.maxFrameBytes());
+  bench.run("workflow_resume", [&] { passingRunner.checkResume(); });
+  benchSink = passes;
+
+  WorkflowRunner sleepingRunner;
+  sleepingRunner.start(benchSleepingWorkflow(), "sleeping");
+  bench.run("workflow_check_waiting", [&] { sleepingRunner.checkResume(); });
+}
+
+// Heater accounting: recording one transition of the load, as the burst-fire ISR does up to 50 times per
+// second (the totals in RAM here, instead of RTC memory)
+void benchHeaterAccounting() {
+  HeaterTotals totals = {};
+  HeaterAccounting accounting(totals, 1000.0f);
+  accounting.begin();
+  bool on = false;
+  bench.run("heater_accounting_transition", [&] {
+    on = !on;
+    accounting.recordTransition(on);
+  });
+  benchSink = accounting.switchCount();
+}
+
+// Controller snapshot: rebuilding it in place for eight zones, as `updateSnapshot()` does at the end of every
+// loop pass, and decoding it as the host does; its size is reported as a count
+void benchSnapshot() {
+  static const uint8_t address[ZoneUtils::address_bytes] = {0x28, 0, 0, 0, 0, 0, 0, 0};
+  ZoneController zones(2, &writeNoLoad);
+  for (uint8_t zone = 0; zone < ZoneUtils::max_zones; zone++) {
+    zones.addZone(address, zone, 40.0f);
+    zones.addTemperature(zone, 38.0f + 0.25f * zone);
+  }
+  ControllerSnapshot snapshot = {};
+  uint32_t uptimeMs = 0;
+  bench.count("snapshot_bytes", sizeof(ControllerSnapshot));
+  bench.run("snapshot_build", [&] {
+    beginSnapshot(snapshot, uptimeMs++);
+    snapshotZones(snapshot, zones);
+    snapshot.flags = SnapshotUtils::flag_heating;
+    snapshot.heaterFaults = 0;
+    snapshot.heaterPowerFraction = 0.75f;
+    snapshot.heaterEnergyKWh = 1.5f;
+    snapshot.heaterSwitchCount = uptimeMs;
+    snapshot.heaterHourDuty = 0.5f;
+    snapshot.loopTimeP50Us = 100.0f;
+    snapshot.loopTimeP90Us = 200.0f;
+    snapshot.loopTimeP99Us = 400.0f;
+    snapshot.eventsDispatched = uptimeMs;
+    snapshot.eventsDropped = 0;
+    snapshot.commands = 0;
+    snapshot.rejectedFrames = 0;
+    snapshot.freeHeapBytes = 200000;
+    snapshot.minimumFreeHeapBytes = 190000;
+  });
+
+  ControllerSnapshot decoded;
+  bench.run("snapshot_decode", [&] {
+    decodeSnapshot(reinterpret_cast<const uint8_t *>(&snapshot), sizeof(snapshot), decoded);
+    benchSink = decoded.sequence;
+  });
+}
+
+// Animations: decoding one frame of the boot splash (full screen, delta to its predecessor) and copying the
+// heating symbol into the (rotated) screen buffer, as the loop does on every pass while heating; the encoded
+// sizes are reported as counts
+void benchAnimations() {
+  bench.count("xbm_heating_bytes", heatingAnimation.dataBytes);
+  bench.count("xbm_splash_bytes", splashAnimation.dataBytes);
+
+  static uint8_t splashFrame[72 * 5];
+  XbmFrameDecoder decoder(splashAnimation);
+  bench.run("xbm_decode_splash_frame", [&] {
+    if (decoder.isAtEnd()) {
+      memset(splashFrame, 0, sizeof(splashFrame));
+      decoder.rewind();
+    }
+    decoder.decode(splashFrame, sizeof(splashFrame));
+    benchSink = splashFrame[0];
+  });
+
+  static uint8_t iconFrame[20 * 3];
+  XbmAnimationPlayer heatingIcon(heatingAnimation, iconFrame, 150, true);
+  heatingIcon.activate();
+  heatingIcon.checkFrame(); // frame 0
+  bench.run("xbm_blit_icon", [&] { heatingIcon.blit(u8g2, 37, 15); });
+}
+
+// Temperature history: the codec round trip over a synthetic history and its corner cases (a check), the
+// encoded bytes per sample of the controller's single zone (x100, as a count), and the cost of encoding one
+// sample. On the host, also appending to the store on the stand-in flash until the ring wraps, and a power
+// loss that tears a page (a check): the recovered log must export every sample of the programmed pages, in
+// order. The target skips the store: it would overwrite the history on the board.
+void benchSeries() {
+  static SeriesSample samples[BENCH_SERIES_SAMPLES];
+  size_t encodedBytes = 0;
+  uint32_t errors = 0;
+  for (uint8_t channels = 1; channels <= SeriesCodec::max_channels; channels++) {
+    for (uint32_t i = 0; i < BENCH_SERIES_SAMPLES; i++) samples[i] = seriesTraceSample(i, channels);
+    errors += seriesRoundTripErrors("series_roundtrip_errors", samples, BENCH_SERIES_SAMPLES, channels, encodedBytes);
+  }
+
+  // corner cases: the clock wrapping around, missing readings, jumps across the whole range
+  static const int16_t extremes[] = {INT16_MIN, INT16_MAX, INT16_MIN, 0, -1, INT16_MAX, INT16_MAX - 1, INT16_MIN + 1};
+  for (uint32_t i = 0; i < BENCH_SERIES_SAMPLES; i++) {
+    SeriesSample &sample = samples[i];
+    sample = seriesTraceSample(i, SeriesCodec::max_channels);
+    sample.timeS = UINT32_MAX - 3000 + ((i % 5 == 0) ? 7 * i : 3 * i);
+    sample.heaterPercent = static_cast<uint8_t>(i * 37);
+    sample.loads = static_cast<uint8_t>(i * 11);
+    for (uint8_t channel = 0; channel < SeriesCodec::max_channels; channel++) sample.temperature[channel] = extremes[(i + channel) % 8];
+  }
+  errors += seriesRoundTripErrors("series_roundtrip_errors", samples, BENCH_SERIES_SAMPLES, SeriesCodec::max_channels, encodedBytes);
+  bench.check("series_roundtrip_errors", errors);
+
+  encodedBytes = 0;
+  for (uint32_t i = 0; i < BENCH_SERIES_SAMPLES; i++) samples[i] = seriesTraceSample(i, 1);
+  seriesRoundTripErrors("series_bytes_per_sample_x100", samples, BENCH_SERIES_SAMPLES, 1, encodedBytes);
+  bench.count("series_bytes_per_sample_x100", static_cast<uint32_t>(100 * encodedBytes / BENCH_SERIES_SAMPLES));
+
+  SeriesEncoder encoder(1);
+  uint8_t record[SeriesCodec::max_record_bytes];
+  uint32_t index = 0;
+  bench.run("series_encode", [&] {
+    if (index % 64 == 0) encoder.reset(); // about one page
+    benchSink = encoder.encode(samples[index++ % BENCH_SERIES_SAMPLES], record);
+  });
+
+#ifdef KOLIBRIE_HOST
+  const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, SeriesStoreUtils::partition_label);
+  esp_partition_erase_range(partition, 0, partition->size);
+  SeriesStore store(1, BENCH_NEVER_MS / 1000);
+  store.begin();
+  uint32_t appended = 0;
+  bench.run("series_append", [&] { store.append(seriesTraceSample(appended++, 1)); });
+  while ((store.sectorsErased() <= PartitionHostUtils::sector_count) || (store.nextSlot() % SeriesStoreUtils::pages_per_sector == 0)) {
+    store.append(seriesTraceSample(appended++, 1)); // a full turn of the ring, then stop within a sector
+  }
+  bench.count("series_write_amplification_x100", static_cast<uint32_t>(100.0f * store.writeAmplification() + 0.5f));
+
+  // power loss while programming the page in RAM: half of it reaches the flash
+  uint8_t page[SeriesCodec::page_bytes];
+  size_t pendingBytes = store.pendingPage(page);
+  SeriesDecoder pendingDecoder(1);
+  SeriesSample decoded;
+  uint32_t pendingSamples = 0;
+  for (size_t offset = SeriesCodec::header_bytes; offset < pendingBytes; pendingSamples++) {
+    offset += pendingDecoder.decode(page + offset, pendingBytes - offset, decoded);
+  }
+  esp_partition_write(partition, store.nextSlot() * SeriesCodec::page_bytes, page, pendingBytes / 2);
+  uint32_t lastIndex = appended - 1 - pendingSamples; // the newest sample in the log
+
+  const char *check = "series_recovery_errors";
+  uint32_t recoveryErrors = 0;
+  SeriesStore recovered(1, BENCH_NEVER_MS / 1000);
+  bool begun = recovered.begin();
+  recoveryErrors += bench.expect(check, begun && (recovered.pageCount() == store.pageCount() + 1), "pages lost on recovery");
+  recoveryErrors += bench.expect(check, recovered.clockS() > seriesTraceSample(lastIndex, 1).timeS, "log clock does not continue");
+
+  class CaptureStream : public Stream {
+    public:
+    std::vector<uint8_t> bytes;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    int availableForWrite() override { return BENCH_TX_BUFFER_BYTES; }
+    size_t write(uint8_t c) override {
+      bytes.push_back(c);
+      return 1;
+    }
+  } capture;
+  SeriesExport exporter(recovered, capture);
+  exporter.activate();
+  for (uint32_t call = 0; !exporter.isExpired() && (call < 2 * recovered.slotCount()); call++) exporter.checkExport();
+  recoveryErrors += bench.expect(check, exporter.isExpired(), "export does not finish");
+
+  // reassemble the pages; their samples must be a consecutive run of the history up to the torn page
+  CommandParser parser;
+  std::vector<uint8_t> data;
+  int64_t expectedIndex = -1;
+  for (uint8_t byte : capture.bytes) {
+    if (!parser.feed(byte, 0)) continue;
+    const CommandFrame &frame = parser.frame();
+    if ((frame.payload[0] == 0) && (frame.payload[1] > 0)) data.clear();
+    data.insert(data.end(), frame.payload + SeriesStoreUtils::chunk_header_bytes, frame.payload + frame.length);
+    if ((frame.payload[1] == 0) || (frame.payload[0] + 1 < frame.payload[1])) continue;
+    if (bench.expect(check, isValidSeriesPage(data.data(), data.size()), "exported page invalid") > 0) {
+      recoveryErrors++;
+      continue;
+    }
+    SeriesDecoder decoder(1);
+    for (size_t offset = SeriesCodec::header_bytes; offset < data.size();) {
+      size_t size = decoder.decode(data.data() + offset, data.size() - offset, decoded);
+      if (bench.expect(check, size > 0, "exported record undecodable") > 0) {
+        recoveryErrors++;
+        break;
+      }
+      offset += size;
+      if (expectedIndex < 0) expectedIndex = (decoded.timeS - seriesTraceSample(0, 1).timeS) / BENCH_SERIES_INTERVAL_S;
+      recoveryErrors += bench.expect(check, isSameSample(decoded, seriesTraceSample(static_cast<uint32_t>(expectedIndex), 1), 1), "exported sample out of order");
+      expectedIndex++;
+    }
+  }
+  recoveryErrors += bench.expect(check, expectedIndex == static_cast<int64_t>(lastIndex) + 1, "export ends before the newest sample");
+  bench.check(check, recoveryErrors);
+#else
+  bench.skip("series_append");
+  bench.skip("series_write_amplification_x100");
+  bench.skip("series_recovery_errors");
+#endif
+}
+
+// Synthetic history: a measurement every `BENCH_SERIES_INTERVAL_S` (one in seven a second late), zones
+// warming up and settling near their setpoints with noise in the last bit, the heater switching every five
+// minutes
+SeriesSample seriesTraceSample(uint32_t index, uint8_t channels) {
+  SeriesSample sample = {};
+  sample.timeS = 1000 + BENCH_SERIES_INTERVAL_S * index + ((index % 7 == 3) ? 1 : 0);
+  bool heating = (index / 30) % 2 == 0;
+  sample.heaterPercent = heating ? 75 : 0;
+  sample.loads = heating ? 0x01 : 0x00;
+  uint32_t noise = index * 2654435761u;
+  for (uint8_t channel = 0; channel < channels; channel++) {
+    int32_t warmUp = min(index, 320u) / 2;
+    int32_t ripple = static_cast<int32_t>((index + 7 * channel) % 60) - 30;
+    sample.temperature[channel] = static_cast<int16_t>(16 * (20 + channel) + warmUp + ripple / 6 + static_cast<int32_t>((noise >> (channel + 13)) % 3) - 1);
+  }
+  return sample;
+}
+
+bool isSameSample(const SeriesSample &a, const SeriesSample &b, uint8_t channels) {
+  if ((a.timeS != b.timeS) || (a.heaterPercent != b.heaterPercent) || (a.loads != b.loads)) return false;
+  return memcmp(a.temperature, b.temperature, channels * sizeof(a.temperature[0])) == 0;
+}
+
+// Encodes the samples into pages, as the store does, and decodes them again; returns the samples that differ
+uint32_t seriesRoundTripErrors(const char *check, const SeriesSample *samples, size_t count, uint8_t channels, size_t &encodedBytes) {
+  SeriesEncoder encoder(channels);
+  SeriesDecoder decoder(channels);
+  uint8_t payload[SeriesCodec::max_payload];
+  uint32_t errors = 0;
+  size_t first = 0;
+  while (first < count) {
+    size_t length = 0, next = first;
+    uint8_t record[SeriesCodec::max_record_bytes];
+    encoder.reset();
+    while (next < count) {
+      size_t size = encoder.encode(samples[next], record);
+      if (length + size > sizeof(payload)) break;
+      memcpy(&payload[length], record, size);
+      length += size;
+      next++;
+    }
+    encodedBytes += length;
+    decoder.reset();
+    size_t offset = 0;
+    for (size_t i = first; i < next; i++) {
+      SeriesSample decoded;
+      size_t size = decoder.decode(payload + offset, length - offset, decoded);
+      errors += bench.expect(check, (size > 0) && isSameSample(decoded, samples[i], channels), "decoded sample differs");
+      offset += (size == 0) ? length - offset : size;
+    }
+    errors += bench.expect(check, offset == length, "page not decoded to its end");
+    first = next;
+  }
+  return errors;
+}
+
+// Rolling statistics: their size (a count), the cost of adding a value once per second, as the controller
+// does, and after a gap of almost a day, which closes every bucket of every window; the windows after gaps of
+// all lengths (a check). The P² quantile estimator: the cost of an update, and on the host a stream longer
+// than 2^24 values whose distribution shifts halfway (a check): the median must follow the shift.
+void benchStreamStats() {
+  static StreamStats stats; // static: too large for the stack of the loop task
+  bench.count("streamstats_bytes", sizeof(StreamStats));
+  int64_t nowMs = 0;
+  bench.run("streamstats_add", [&] {
+    nowMs += StreamStatsUtils::second_bucket_ms;
+    stats.add(static_cast<float>(nowMs % 97), nowMs);
+  });
+  bench.run("streamstats_add_after_gap", [&] {
+    nowMs += BENCH_STATS_GAP_MS;
+    stats.add(static_cast<float>(nowMs % 97), nowMs);
+  });
+
+  // one value each: the gap decides which windows still hold the first one
+  struct GapCase {
+    int64_t gapMs;
+    uint32_t minuteCount, hourCount, dayCount;
+  };
+  static const GapCase gap_cases[] = {
+      {0, 2, 2, 2},          // same bucket
+      {1000, 2, 2, 2},       // next bucket
+      {59000, 2, 2, 2},      // last second of the minute window
+      {61000, 1, 2, 2},      // past the minute window
+      {3661000, 1, 1, 2},    // past the hour window
+      {86399000, 1, 1, 2},   // last second of the day window
+      {86400001, 1, 1, 1},   // silent for longer than a day: all windows restart
+      {172800000, 1, 1, 1}}; // two days
+  const char *check = "streamstats_gaps";
+  uint32_t errors = 0;
+  for (const GapCase &gap : gap_cases) {
+    stats.reset();
+    stats.add(1.0f, 5000000);
+    stats.add(3.0f, 5000000 + gap.gapMs);
+    StatSummary minute = stats.lastMinute(), hour = stats.lastHour(), day = stats.lastDay();
+    errors += bench.expect(check, minute.count == gap.minuteCount, "minute window count");
+    errors += bench.expect(check, hour.count == gap.hourCount, "hour window count");
+    errors += bench.expect(check, day.count == gap.dayCount, "day window count");
+    errors += bench.expect(check, (day.count != 2) || ((day.min == 1.0f) && (day.max == 3.0f) && (day.mean == 2.0f)), "day window summary");
+  }
+  bench.check(check, errors);
+
+  P2Quantile quantile(0.99f);
+  uint32_t value = 0;
+  bench.run("p2quantile_add", [&] {
+    value = (value * 1103515245u + 12345u);
+    quantile.add(static_cast<float>(value >> 22));
+  });
+  benchSink = static_cast<uint32_t>(quantile.value());
+
+#ifdef KOLIBRIE_HOST
+  P2Quantile median(0.5f);
+  constexpr uint32_t half = 1UL << 24;
+  for (uint32_t i = 0; i < 2 * half; i++) {
+    value = (value * 1103515245u + 12345u);
+    median.add(static_cast<float>(value >> 22) + ((i < half) ? 0.0f : 1024.0f)); // [0, 1024), then [1024, 2048)
+  }
+  const char *quantileCheck = "p2quantile_long_stream";
+  bench.check(quantileCheck, bench.expect(quantileCheck, fabsf(median.value() - 1024.0f) < 32.0f, "median does not follow the shift past 2^24 values"));
+#else
+  bench.skip("p2quantile_long_stream"); // minutes on the target
+#endif
+}
+
+// Thermal model: identification of a simulated first-order-plus-dead-time zone, heated in pseudo-random runs
+// of 1 to 5 minutes and read with the resolution of the DS18B20 (a check): the learned dead time, gain, time
+// constant and ambient temperature must match the simulated zone. Then the cost of closing a period (model
+// update and heating decision), as the controller does every `ThermalUtils::period_ms`.
+void benchThermalPredictor() {
+  const float a = expf(-(ThermalUtils::period_ms / 1000.0f) / BENCH_PLANT_TAU_S);
+  float tempC = BENCH_PLANT_AMBIENT_C;
+  float duties[BENCH_PLANT_DEAD_PERIODS + 1] = {}; // ring: heater duty of the latest periods
+  uint32_t k = 0;
+  uint32_t random = 1;
+  uint8_t periodsLeft = 0;
+  bool on = false;
+  ThermalPredictor predictor(BENCH_HEATER_MAX_C, 0.5f);
+  auto simulatePeriod = [&] {
+    if (periodsLeft == 0) {
+      random = random * 1103515245u + 12345u;
+      periodsLeft = 12 + (random >> 16) % 48;
+      on = !on;
+    }
+    periodsLeft--;
+    duties[k % (BENCH_PLANT_DEAD_PERIODS + 1)] = on ? 1.0f : 0.0f;
+    float delayedDuty = duties[(k + 1) % (BENCH_PLANT_DEAD_PERIODS + 1)];
+    tempC = a * tempC + (1.0f - a) * (BENCH_PLANT_GAIN_C * delayedDuty + BENCH_PLANT_AMBIENT_C);
+    predictor.addTemperature(roundf(tempC * 16.0f) / 16.0f); // 12-bit resolution: 1/16 °C
+    predictor.addPeriod(duties[k % (BENCH_PLANT_DEAD_PERIODS + 1)]);
+    k++;
+  };
+
+  predictor.addTemperature(tempC);
+  predictor.addPeriod(0.0f);
+  for (uint32_t i = 0; i < BENCH_PLANT_PERIODS; i++) simulatePeriod();
+  const char *check = "thermal_identification";
+  uint32_t errors = 0;
+  errors += bench.expect(check, predictor.isTrusted(), "model not trusted");
+  errors += bench.expect(check, predictor.deadTimeS() == BENCH_PLANT_DEAD_PERIODS * (ThermalUtils::period_ms / 1000.0f), "dead time");
+  errors += bench.expect(check, fabsf(predictor.gainC() / BENCH_PLANT_GAIN_C - 1.0f) <= 0.1f, "gain");
+  errors += bench.expect(check, fabsf(predictor.timeConstantS() / BENCH_PLANT_TAU_S - 1.0f) <= 0.1f, "time constant");
+  errors += bench.expect(check, fabsf(predictor.ambientC() - BENCH_PLANT_AMBIENT_C) <= 1.0f, "ambient temperature");
+  bench.check(check, errors);
+
+  bench.run("thermal_period", simulatePeriod);
+  benchSink = predictor.shouldHeat();
+}
+
+// Heater supervision with injected faults, in simulated time (the host stand-in skips time and fires the
+// supervision timer on the way). One supervisor runs a load per zone on a single timer. After the loads have
+// run normally for a while, missing readings, an over-temperature and an excessive rise of one load must each
+// switch its pin off within the worst-case latency stated in HeaterSupervisor.h, and latch its fault, while
+// the other loads stay on. An isolated failed read must leave the load on, while `max_implausible_readings`
+// in a row latch a fault; after clearing the faults, all loads switch on again. Finally, a loop stall must
+// switch all loads off in time.
+void benchHeaterSupervisor() {
+#ifdef KOLIBRIE_HOST
+  using namespace HeaterSafetyUtils;
+  static HeaterSupervisor supervisor(true, BENCH_HEATER_MAX_C, BENCH_HEATER_MAX_RISE);
+  const char *check = "heater_supervisor_faults";
+  uint32_t errors = 0;
+  for (uint8_t load = 0; load < BENCH_SUPERVISED_LOADS; load++) supervisor.addLoad(BENCH_LOAD_GPIO + load);
+  supervisor.begin();
+  supervisor.arm();
+  errors += startSupervisedLoads(check, supervisor);
+
+  // one load after the other; the loads faulted before stay off
+  const uint8_t starved = 0, overheated = 1, runaway = 2, disconnected = 3;
+  uint32_t offMs = superviseUntilOff(supervisor, starved, 30000, true, false, 30.0f, 0.0f);
+  errors += bench.expect(check, offMs <= max_sample_age_ms + tick_ms, "stale reading: load not off in time");
+  errors += bench.expect(check, supervisor.faults(starved) == HeaterFault::StaleReading, "stale reading: fault not latched");
+  errors += bench.expect(check, supervisedLoadsOn() == 0x0E, "stale reading: other loads switched");
+
+  offMs = superviseUntilOff(supervisor, overheated, 1000, true, true, BENCH_HEATER_MAX_C + 1.0f, 0.0f);
+  errors += bench.expect(check, offMs == 0, "over-temperature: load not off at once");
+  errors += bench.expect(check, supervisor.faults(overheated) == HeaterFault::OverTemperature, "over-temperature: fault not latched");
+  errors += bench.expect(check, supervisedLoadsOn() == 0x0C, "over-temperature: other loads switched");
+
+  // 12 °C/min from a steady temperature: the rate is averaged over windows of `rise_window_ms`, hence the
+  // rise may only be detected in the window after the onset
+  offMs = superviseUntilOff(supervisor, runaway, 120000, true, true, 30.0f, 0.2f);
+  errors += bench.expect(check, offMs <= 2 * rise_window_ms + 1000, "excessive rise: load not off in time");
+  errors += bench.expect(check, supervisor.faults(runaway) == HeaterFault::ExcessiveRise, "excessive rise: fault not latched");
+  errors += bench.expect(check, supervisedLoadsOn() == 0x08, "excessive rise: other loads switched");
+  supervisor.requestLoad(starved, true);
+  errors += bench.expect(check, supervisedLoadsOn() == 0x08, "faulted load switches on");
+  supervisor.requestLoad(disconnected, false);
+  supervisor.requestLoad(disconnected, true);
+  errors += bench.expect(check, supervisedLoadsOn() == 0x08, "faults of other loads block the switch-on");
+
+  supervisor.reportTemperature(disconnected, -127.0f); // DEVICE_DISCONNECTED_C, e.g. a CRC error
+  bool stayedOn = superviseUntilOff(supervisor, disconnected, 5000, true, true, 30.0f, 0.0f) == UINT32_MAX;
+  errors += bench.expect(check, stayedOn, "isolated implausible reading switched the load off");
+  for (uint8_t reading = 1; reading <= max_implausible_readings; reading++) {
+    supervisor.reportTemperature(disconnected, -127.0f);
+    errors += bench.expect(check, supervisor.isLoadOn(disconnected) == (reading < max_implausible_readings), "implausible readings in a row: load state");
+  }
+  errors += bench.expect(check, supervisor.faults(disconnected) == HeaterFault::ImplausibleReading, "implausible readings: fault not latched");
+  errors += bench.expect(check, supervisedLoadsOn() == 0, "implausible readings: load pin on");
+
+  supervisor.clearFaults(); // recovery, e.g. by the clear-faults command
+  errors += startSupervisedLoads(check, supervisor);
+
+  offMs = superviseUntilOff(supervisor, 0, 10000, false, true, 30.0f, 0.0f);
+  errors += bench.expect(check, offMs <= max_loop_stall_ms + tick_ms, "loop stall: load not off in time");
+  errors += bench.expect(check, supervisedLoadsOn() == 0, "loop stall: not all loads off");
+  for (uint8_t load = 0; load < BENCH_SUPERVISED_LOADS; load++) {
+    errors += bench.expect(check, supervisor.faults(load) == HeaterFault::LoopStalled, "loop stall: fault not latched for every load");
+  }
+  bench.check(check, errors);
+#else
+  bench.skip("heater_supervisor_faults"); // would switch the load pins, and take minutes
+#endif
+}
+
+#ifdef KOLIBRIE_HOST
+// Switches all loads of `supervisor` on, then runs them normally for a few seconds; returns the errors
+uint32_t startSupervisedLoads(const char *check, HeaterSupervisor &supervisor) {
+  const uint8_t allLoads = (1 << BENCH_SUPERVISED_LOADS) - 1;
+  for (uint8_t load = 0; load < BENCH_SUPERVISED_LOADS; load++) supervisor.requestLoad(load, true);
+  uint32_t errors = bench.expect(check, supervisedLoadsOn() == allLoads, "loads do not switch on");
+  errors += bench.expect(check, superviseUntilOff(supervisor, 0, 3000, true, true, 30.0f, 0.0f) == UINT32_MAX, "load off in normal operation");
+  errors += bench.expect(check, supervisedLoadsOn() == allLoads, "loads off in normal operation");
+  errors += bench.expect(check, supervisor.faults() == HeaterFault::NoFault, "fault in normal operation");
+  return errors;
+}
+
+// Simulated loop passes every `BENCH_SUPERVISOR_STEP_MS` for up to `limitMs`: the loop checks in, and a reading
+// of every load is reported every second, `startC` (rising by `riseCPerS`) of `load`, and 30 °C of the others;
+// both happen at least at the start. Returns the time from the start until the pin of `load` is off [ms], or
+// UINT32_MAX if it stayed on.
+uint32_t superviseUntilOff(HeaterSupervisor &supervisor, uint8_t load, uint32_t limitMs, bool loopRuns, bool readingsArrive, float startC, float riseCPerS) {
+  for (uint32_t elapsedMs = 0; elapsedMs <= limitMs; elapsedMs += BENCH_SUPERVISOR_STEP_MS) {
+    if (loopRuns || (elapsedMs == 0)) supervisor.checkIn();
+    if (elapsedMs % 1000 == 0) {
+      for (uint8_t other = 0; other < BENCH_SUPERVISED_LOADS; other++) {
+        if (other != load) supervisor.reportTemperature(other, 30.0f);
+      }
+      if (readingsArrive || (elapsedMs == 0)) supervisor.reportTemperature(load, startC + riseCPerS * (elapsedMs / 1000));
+    }
+    if (gpio_ll_get_level(&GPIO, BENCH_LOAD_GPIO + load) == 0) return elapsedMs;
+    hostAdvanceTime(BENCH_SUPERVISOR_STEP_MS * 1000ULL);
+  }
+  return UINT32_MAX;
+}
+
+// Mask of the supervised load pins that are on, as read back from the GPIO (one bit per load)
+uint8_t supervisedLoadsOn() {
+  uint8_t mask = 0;
+  for (uint8_t load = 0; load < BENCH_SUPERVISED_LOADS; load++) {
+    if (gpio_ll_get_level(&GPIO, BENCH_LOAD_GPIO + load) != 0) mask |= 1 << load;
+  }
+  return mask;
+}
+#endif
@@ -0,0 +1,164 @@
+#include "BenchRunner.h"
+#include <cstring> // For strcmp()
+
+namespace {
+  volatile uint32_t referenceSink = 1; // keeps the compiler from dropping the reference loop
+
+  // Fixed workload of integer and float arithmetic, as in the primitives; its cost relates the machines
+  void referenceLoop() {
+    uint32_t x = referenceSink | 1;
+    float f = 1.0f;
+    for (uint8_t i = 0; i < BenchUtils::reference_steps; i++) {
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      f = f * 0.5f + static_cast<float>(x & 0xFF);
+    }
+    referenceSink = x + static_cast<uint32_t>(f);
+  }
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                      CLASS BenchRunner                                         *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Times primitives with the cycle counter and compares the median against committed baselines, scaled by
+// the speed of the machine relative to the one the baselines were recorded on.
+
+// constructor:
+BenchRunner::BenchRunner(const char *platform, const BenchBaseline *baselines, size_t baselineCount)
+    : platform(platform),
+      baselines(baselines),
+      baselineCount(baselineCount),
+      failures(0),
+      failingCheck(nullptr),
+      failedAssertions(0),
+      referenceMedian(0) {
+}
+
+void BenchRunner::begin() {
+  failures = 0;
+  Serial.print(F("BENCH_BEGIN,"));
+  Serial.print(platform);
+  Serial.print(',');
+  Serial.print(BenchUtils::rounds);
+  Serial.print(',');
+  Serial.println(BenchUtils::iterations_per_round);
+  timeReference();
+}
+
+void BenchRunner::skip(const char *name) {
+  Serial.print(F("BENCH,"));
+  Serial.print(name);
+  Serial.println(F(",0,0,0,0,SKIP"));
+}
+
+uint8_t BenchRunner::finish() {
+  Serial.print(F("BENCH_END,"));
+  Serial.println(failures);
+  return failures;
+}
+
+void BenchRunner::timeReference() {
+  uint32_t samples[BenchUtils::rounds];
+  for (uint8_t round = 0; round < BenchUtils::rounds; round++) {
+    uint32_t startCycles = esp_cpu_get_cycle_count();
+    for (uint16_t i = 0; i < BenchUtils::iterations_per_round; i++) referenceLoop();
+    samples[round] = (esp_cpu_get_cycle_count() - startCycles) / BenchUtils::iterations_per_round;
+  }
+  sortSamples(samples);
+  referenceMedian = samples[BenchUtils::rounds / 2];
+  printLine(BenchUtils::reference_name, samples[0], referenceMedian, samples[BenchUtils::rounds - 1], baselineFor(BenchUtils::reference_name), F("REF"));
+}
+
+void BenchRunner::sortSamples(uint32_t *samples) {
+  // insertion sort: the rounds are few
+  for (uint8_t i = 1; i < BenchUtils::rounds; i++) {
+    uint32_t sample = samples[i];
+    uint8_t j = i;
+    while ((j > 0) && (samples[j - 1] > sample)) {
+      samples[j] = samples[j - 1];
+      j--;
+    }
+    samples[j] = sample;
+  }
+}
+
+// Baseline of a timed primitive on this machine: the committed baseline times the ratio of the reference
+// loop's median in this run to its committed baseline (unscaled without a reference baseline)
+uint32_t BenchRunner::scaledBaselineFor(const char *name) {
+  uint32_t baseline = baselineFor(name);
+  uint32_t referenceBaseline = baselineFor(BenchUtils::reference_name);
+  if ((baseline == 0) || (referenceBaseline == 0) || (referenceMedian == 0)) return baseline;
+  uint64_t scaled = (static_cast<uint64_t>(baseline) * referenceMedian + referenceBaseline / 2) / referenceBaseline;
+  return (scaled > 0) ? static_cast<uint32_t>(scaled) : 1;
+}
+
+void BenchRunner::report(const char *name, uint32_t *samples) {
+  sortSamples(samples);
+  uint32_t median = samples[BenchUtils::rounds / 2];
+  uint32_t baseline = scaledBaselineFor(name);
+
+  const __FlashStringHelper *status = F("NEW");
+  if (baseline > 0) {
+    // compared in 64 bits: baseline * (100 + margin) must not overflow
+    uint64_t limit = static_cast<uint64_t>(baseline) * (100ULL + BenchUtils::regression_margin_pct) + 100ULL * BenchUtils::regression_slack_cycles;
+    bool regressed = static_cast<uint64_t>(median) * 100ULL > limit;
+    status = regressed ? F("FAIL") : F("PASS");
+    if (regressed) failures++;
+  }
+
+  printLine(name, samples[0], median, samples[BenchUtils::rounds - 1], baseline, status);
+}
+
+void BenchRunner::count(const char *name, uint32_t value) {
+  uint32_t baseline = baselineFor(name);
+  const __FlashStringHelper *status = F("NEW");
+  if (baseline > 0) {
+    bool regressed = value > baseline;
+    status = regressed ? F("FAIL") : F("PASS");
+    if (regressed) failures++;
+  }
+  printLine(name, value, value, value, baseline, status);
+}
+
+void BenchRunner::check(const char *name, uint32_t errors) {
+  if (errors > 0) failures++;
+  printLine(name, errors, errors, errors, 0, (errors > 0) ? F("FAIL") : F("PASS"));
+}
+
+uint32_t BenchRunner::expect(const char *check, bool holds, const char *label) {
+  if (holds) return 0;
+  if ((failingCheck == nullptr) || (strcmp(failingCheck, check) != 0)) {
+    failingCheck = check;
+    failedAssertions = 0;
+  }
+  if (failedAssertions++ < BenchUtils::max_fail_lines) {
+    Serial.print(F("BENCH_FAIL,"));
+    Serial.print(check);
+    Serial.print(',');
+    Serial.println(label);
+  }
+  return 1;
+}
+
+void BenchRunner::printLine(const char *name, uint32_t min, uint32_t median, uint32_t max, uint32_t baseline, const __FlashStringHelper *status) {
+  Serial.print(F("BENCH,"));
+  Serial.print(name);
+  Serial.print(',');
+  Serial.print(min);
+  Serial.print(',');
+  Serial.print(median);
+  Serial.print(',');
+  Serial.print(max);
+  Serial.print(',');
+  Serial.print(baseline);
+  Serial.print(',');
+  Serial.println(status);
+}
+
+uint32_t BenchRunner::baselineFor(const char *name) {
+  for (size_t i = 0; i < baselineCount; i++) {
+    if (strcmp(baselines[i].name, name) == 0) return baselines[i].medianCycles;
+  }
+  return 0;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <Arduino.h>
+#include <esp_cpu.h> // For esp_cpu_get_cycle_count()
+
+namespace BenchUtils {
+  constexpr uint8_t rounds = 31;                  // rounds per primitive; min, median and max are taken over the rounds
+  constexpr uint16_t iterations_per_round = 200;  // calls per round; a round yields the average cost of one call
+  constexpr uint32_t regression_margin_pct = 20;  // a median above baseline * (100 + margin) / 100 + slack fails the run
+  constexpr uint32_t regression_slack_cycles = 4; // absorbs the resolution of the counter on primitives of a few cycles
+  constexpr uint8_t reference_steps = 64;         // steps of the reference loop (integer and float arithmetic)
+  constexpr uint8_t max_fail_lines = 8;           // failed assertions printed per check; further ones are only counted
+  constexpr const char *reference_name = "reference_loop";
+}
+
+// Committed reference cost of a primitive: median [cycles per call]. A baseline of 0 is not recorded yet;
+// the primitive is then reported, but cannot fail the run. The baseline of `reference_loop` scales the others.
+struct BenchBaseline {
+  const char *name;
+  uint32_t medianCycles;
+};
+
+class BenchRunner {
+
+  // CLASS BenchRunner
+  //
+  // Times primitives with the cycle counter and reports one line per primitive on the Serial console, in a
+  // machine-readable format (comma-separated, fixed field order):
+  //   BENCH_BEGIN,<platform>,<rounds>,<iterations per round>
+  //   BENCH,<name>,<min>,<median>,<max>,<baseline>,<status>   status: PASS | FAIL | NEW | SKIP | REF
+  //   BENCH_FAIL,<check>,<label>                               a failed assertion of a check
+  //   BENCH_END,<number of FAIL>
+  // A primitive is run for `rounds` rounds of `iterations` calls each; min, median and max are the average
+  // cycles per call of the fastest, the median and the slowest round. The median is compared against the
+  // committed baseline, so a single round disturbed by an interrupt does not fail the run.
+  // Exact quantities (e.g. bytes sent on a bus) are reported by `count()` in the same format, with min,
+  // median and max equal; any value above the baseline fails the run. Correctness checks are reported by
+  // `check()` as their number of errors, without a baseline: any error fails the run. The assertions of a
+  // check go through `expect()`, which prints the label of every failed one ahead of the check's line.
+  //
+  // The reported cycles include the loop around the primitive (a few cycles per call). On the host build,
+  // the stand-in cycle counter counts nanoseconds, which depend on the machine: `begin()` first times a fixed
+  // reference loop (status REF), and if it has a baseline, the baselines of the timed primitives are scaled by
+  // the ratio of its median to that baseline. The reported baseline is the scaled one, i.e. the cost expected
+  // on this machine.
+
+  public:
+  BenchRunner(const char *platform, const BenchBaseline *baselines, size_t baselineCount); // constructor
+
+  // Runs `body` (a callable without arguments) for all rounds, and reports the result
+  template <typename Body>
+  void run(const char *name, Body body, uint16_t iterations = BenchUtils::iterations_per_round);
+
+  void count(const char *name, uint32_t value);  // reports an exact quantity instead of a timing
+  void check(const char *name, uint32_t errors); // reports a correctness check
+  void skip(const char *name);                   // reports a primitive that cannot run in this build or setup
+  void begin();                                  // prints the start line
+  uint8_t finish();                              // prints the end line; returns the number of regressions
+
+  // Assertion of a check: prints the label if it does not hold; returns 1 if it failed, else 0 (to sum the errors)
+  uint32_t expect(const char *check, bool holds, const char *label);
+
+  private:
+  void timeReference();
+  void sortSamples(uint32_t *samples);
+  uint32_t scaledBaselineFor(const char *name);
+  void report(const char *name, uint32_t *samples);
+  void printLine(const char *name, uint32_t min, uint32_t median, uint32_t max, uint32_t baseline, const __FlashStringHelper *status);
+  uint32_t baselineFor(const char *name);
+
+  // behavioral parameters are lifetime-constants (provided at construction)
+  const char *const platform;
+  const BenchBaseline *const baselines;
+  const size_t baselineCount;
+
+  // dynamic state parameters
+  uint8_t failures;
+  const char *failingCheck;  // check of the latest failed assertion
+  uint32_t failedAssertions; // failed assertions of `failingCheck`
+  uint32_t referenceMedian;  // median of the reference loop in this run
+};
+
+template <typename Body>
+void BenchRunner::run(const char *name, Body body, uint16_t iterations /* = BenchUtils::iterations_per_round */) {
+  uint32_t samples[BenchUtils::rounds];
+  for (uint8_t round = 0; round < BenchUtils::rounds; round++) {
+    uint32_t startCycles = esp_cpu_get_cycle_count();
+    for (uint16_t i = 0; i < iterations; i++) body();
+    samples[round] = (esp_cpu_get_cycle_count() - startCycles) / iterations;
+  }
+  report(name, samples);
+}
@@ -0,0 +1,83 @@
+#pragma once
+// Host stand-in for the parts of the Arduino core used by the benchmarked sources (see HostStandIns.cpp)
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+using std::isfinite;
+using std::max;
+using std::min;
+
+#define PROGMEM
+#define IRAM_ATTR
+#define RTC_NOINIT_ATTR
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define DEC 10
+#define HEX 16
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+class Print {
+  public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  size_t write(const char *str);
+
+  size_t print(const __FlashStringHelper *str) { return write(reinterpret_cast<const char *>(str)); }
+  size_t print(const char *str) { return write(str); }
+  size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+  size_t print(unsigned char value, int base = DEC) { return print(static_cast<unsigned long>(value), base); }
+  size_t print(int value, int base = DEC) { return print(static_cast<long>(value), base); }
+  size_t print(unsigned int value, int base = DEC) { return print(static_cast<unsigned long>(value), base); }
+  size_t print(long value, int base = DEC);
+  size_t print(unsigned long value, int base = DEC);
+  size_t print(double value, int digits = 2);
+
+  size_t println() { return write('\n'); }
+  template <typename T>
+  size_t println(T value) { return print(value) + println(); }
+  template <typename T>
+  size_t println(T value, int format) { return print(value, format) + println(); }
+};
+
+class Stream : public Print {
+  public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  virtual int availableForWrite() { return 0; }
+};
+
+class HostSerial : public Stream {
+  public:
+  using Print::write;
+  void begin(unsigned long baud) {}
+  size_t write(uint8_t c) override;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+};
+extern HostSerial Serial;
+
+// hardware timers: the alarms fire only while `hostAdvanceTime()` skips time (see esp_timer.h)
+struct hw_timer_t;
+hw_timer_t *timerBegin(uint32_t frequency);
+void timerAttachInterruptArg(hw_timer_t *timer, void (*userFunc)(void *), void *arg);
+void timerAlarm(hw_timer_t *timer, uint64_t alarm_value, bool autoreload, uint64_t reload_count);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+void delay(uint32_t ms);
+
+bool ledcAttachChannel(uint8_t pin, uint32_t freq, uint8_t resolution, uint8_t channel);
+bool ledcWrite(uint8_t pin, uint32_t duty);
+bool ledcFade(uint8_t pin, uint32_t start_duty, uint32_t target_duty, int max_fade_time_ms);
+bool ledcOutputInvert(uint8_t pin, bool out_invert);
+bool ledcDetach(uint8_t pin);
@@ -0,0 +1,240 @@
+#include "Arduino.h"
+#include "OneWire.h"
+#include "Preferences.h"
+#include "driver/ledc.h"
+#include "esp_cpu.h"
+#include "esp_partition.h"
+#include "esp_system.h"
+#include "esp_task_wdt.h"
+#include "esp_timer.h"
+#include "soc/gpio_struct.h"
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+// Host stand-ins for the Arduino core, ESP-IDF and OneWire functions used by the benchmarked sources (U8g2: see U8g2Host.cpp)
+
+// hardware timer: alarm period and next due time [microseconds of `esp_timer_get_time()`]
+struct hw_timer_t {
+  uint32_t frequency;
+  void (*callback)(void *);
+  void *arg;
+  uint64_t periodUs;
+  int64_t dueUs; // < 0: no alarm
+};
+
+namespace {
+  constexpr uint8_t max_hw_timers = 8;
+
+  const std::chrono::steady_clock::time_point processStart = std::chrono::steady_clock::now();
+  int64_t skippedUs = 0;  // time skipped by `hostAdvanceTime()`, less the time the clock was stopped
+  int64_t frozenAtUs = -1; // real time at which `hostFreezeTime()` stopped the clock; < 0: running
+  hw_timer_t hwTimers[max_hw_timers];
+  uint8_t hwTimerCount = 0;
+
+  struct PreferencesEntry {
+    char key[PreferencesHostUtils::max_key_length + 1];
+    uint8_t value[PreferencesHostUtils::max_value_bytes];
+    size_t length; // 0: slot free
+  };
+  PreferencesEntry preferencesEntries[PreferencesHostUtils::max_entries];
+
+  uint8_t partitionFlash[PartitionHostUtils::sector_count * PartitionHostUtils::sector_bytes];
+  const esp_partition_t seriesPartition = {ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, 0x290000, sizeof(partitionFlash), PartitionHostUtils::sector_bytes, "series"};
+  bool partitionErased = false; // flash leaves the factory erased
+
+  bool isPartitionRange(const esp_partition_t *partition, size_t offset, size_t size) {
+    return (partition == &seriesPartition) && (offset <= sizeof(partitionFlash)) && (size <= sizeof(partitionFlash) - offset);
+  }
+
+  PreferencesEntry *findPreferencesEntry(const char *key) {
+    for (PreferencesEntry &entry : preferencesEntries) {
+      if ((entry.length > 0) && (strncmp(entry.key, key, sizeof(entry.key)) == 0)) return &entry;
+    }
+    return nullptr;
+  }
+}
+
+HostSerial Serial;
+gpio_dev_t GPIO;
+
+size_t Print::write(const char *str) {
+  size_t count = 0;
+  while (*str != '\0') count += write(static_cast<uint8_t>(*str++));
+  return count;
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t count = 0;
+  while (size--) count += write(*buffer++);
+  return count;
+}
+
+size_t Print::print(long value, int base /* = DEC */) {
+  char buffer[24];
+  snprintf(buffer, sizeof(buffer), (base == HEX) ? "%lX" : "%ld", value);
+  return write(buffer);
+}
+
+size_t Print::print(unsigned long value, int base /* = DEC */) {
+  char buffer[24];
+  snprintf(buffer, sizeof(buffer), (base == HEX) ? "%lX" : "%lu", value);
+  return write(buffer);
+}
+
+size_t Print::print(double value, int digits /* = 2 */) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+  return write(buffer);
+}
+
+size_t HostSerial::write(uint8_t c) { return (fputc(c, stdout) == EOF) ? 0 : 1; }
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+void digitalWrite(uint8_t pin, uint8_t value) {}
+void delay(uint32_t ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+bool ledcAttachChannel(uint8_t pin, uint32_t freq, uint8_t resolution, uint8_t channel) { return true; }
+bool ledcWrite(uint8_t pin, uint32_t duty) { return true; }
+bool ledcFade(uint8_t pin, uint32_t start_duty, uint32_t target_duty, int max_fade_time_ms) { return true; }
+bool ledcOutputInvert(uint8_t pin, bool out_invert) { return true; }
+bool ledcDetach(uint8_t pin) { return true; }
+esp_err_t ledc_fade_stop(ledc_mode_t mode, ledc_channel_t channel) { return ESP_OK; }
+
+namespace {
+  int64_t realTimeUs() { return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - processStart).count(); }
+}
+
+int64_t esp_timer_get_time() { return ((frozenAtUs >= 0) ? frozenAtUs : realTimeUs()) + skippedUs; }
+
+void hostFreezeTime(bool frozen) {
+  if (frozen && (frozenAtUs < 0)) {
+    frozenAtUs = realTimeUs();
+  } else if (!frozen && (frozenAtUs >= 0)) {
+    skippedUs -= realTimeUs() - frozenAtUs; // the clock resumes where it stopped
+    frozenAtUs = -1;
+  }
+}
+
+void hostAdvanceTime(uint64_t us) {
+  const int64_t endUs = esp_timer_get_time() + static_cast<int64_t>(us);
+  for (;;) {
+    hw_timer_t *next = nullptr;
+    for (uint8_t i = 0; i < hwTimerCount; i++) {
+      hw_timer_t &timer = hwTimers[i];
+      if ((timer.dueUs >= 0) && (timer.dueUs <= endUs) && (timer.callback != nullptr) && ((next == nullptr) || (timer.dueUs < next->dueUs))) next = &timer;
+    }
+    if (next == nullptr) break;
+    int64_t now = esp_timer_get_time();
+    if (next->dueUs > now) skippedUs += next->dueUs - now;
+    next->dueUs = (next->periodUs > 0) ? (next->dueUs + static_cast<int64_t>(next->periodUs)) : -1;
+    next->callback(next->arg);
+  }
+  int64_t now = esp_timer_get_time();
+  if (endUs > now) skippedUs += endUs - now;
+}
+
+hw_timer_t *timerBegin(uint32_t frequency) {
+  if ((hwTimerCount >= max_hw_timers) || (frequency == 0)) return nullptr;
+  hwTimers[hwTimerCount] = {frequency, nullptr, nullptr, 0, -1};
+  return &hwTimers[hwTimerCount++];
+}
+
+void timerAttachInterruptArg(hw_timer_t *timer, void (*userFunc)(void *), void *arg) {
+  if (timer == nullptr) return;
+  timer->callback = userFunc;
+  timer->arg = arg;
+}
+
+void timerAlarm(hw_timer_t *timer, uint64_t alarm_value, bool autoreload, uint64_t reload_count) {
+  if (timer == nullptr) return;
+  uint64_t alarmUs = alarm_value * 1000000ULL / timer->frequency;
+  timer->periodUs = autoreload ? alarmUs : 0;
+  timer->dueUs = esp_timer_get_time() + static_cast<int64_t>(alarmUs);
+}
+
+esp_reset_reason_t esp_reset_reason() { return ESP_RST_POWERON; }
+
+esp_err_t esp_task_wdt_init(const esp_task_wdt_config_t *config) { return ESP_OK; }
+esp_err_t esp_task_wdt_reconfigure(const esp_task_wdt_config_t *config) { return ESP_OK; }
+esp_err_t esp_task_wdt_add(void *task) { return ESP_OK; }
+esp_err_t esp_task_wdt_reset() { return ESP_OK; }
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *handle) {
+  static int timers = 0;
+  *handle = reinterpret_cast<esp_timer_handle_t>(&timers); // any non-null handle
+  timers++;
+  return ESP_OK;
+}
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs) { return ESP_OK; }
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) { return ESP_OK; }
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) { return ESP_OK; }
+
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count() {
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - processStart).count();
+  return static_cast<esp_cpu_cycle_count_t>(ns);
+}
+
+// Dallas/Maxim CRC-8 (polynomial x^8 + x^5 + x^4 + 1), bitwise as in the OneWire library
+uint8_t OneWire::crc8(const uint8_t *addr, uint8_t len) {
+  uint8_t crc = 0;
+  while (len--) {
+    uint8_t inbyte = *addr++;
+    for (uint8_t i = 8; i; i--) {
+      uint8_t mix = (crc ^ inbyte) & 0x01;
+      crc >>= 1;
+      if (mix) crc ^= 0x8C;
+      inbyte >>= 1;
+    }
+  }
+  return crc;
+}
+
+size_t Preferences::putBytes(const char *key, const void *value, size_t length) {
+  if ((length == 0) || (length > PreferencesHostUtils::max_value_bytes) || (strlen(key) > PreferencesHostUtils::max_key_length)) return 0;
+  PreferencesEntry *entry = findPreferencesEntry(key);
+  for (PreferencesEntry &free : preferencesEntries) {
+    if ((entry == nullptr) && (free.length == 0)) entry = &free;
+  }
+  if (entry == nullptr) return 0;
+  strncpy(entry->key, key, sizeof(entry->key));
+  memcpy(entry->value, value, length);
+  entry->length = length;
+  return length;
+}
+
+size_t Preferences::getBytes(const char *key, void *buffer, size_t maxLength) {
+  PreferencesEntry *entry = findPreferencesEntry(key);
+  if ((entry == nullptr) || (entry->length > maxLength)) return 0;
+  memcpy(buffer, entry->value, entry->length);
+  return entry->length;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char *label) {
+  if ((type != ESP_PARTITION_TYPE_DATA) || (label == nullptr) || (strcmp(label, seriesPartition.label) != 0)) return nullptr;
+  if (!partitionErased) {
+    memset(partitionFlash, 0xFF, sizeof(partitionFlash));
+    partitionErased = true;
+  }
+  return &seriesPartition;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t srcOffset, void *dst, size_t size) {
+  if (!isPartitionRange(partition, srcOffset, size)) return ESP_ERR_INVALID_ARG;
+  memcpy(dst, &partitionFlash[srcOffset], size);
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dstOffset, const void *src, size_t size) {
+  if (!isPartitionRange(partition, dstOffset, size)) return ESP_ERR_INVALID_ARG;
+  const uint8_t *bytes = static_cast<const uint8_t *>(src);
+  for (size_t i = 0; i < size; i++) partitionFlash[dstOffset + i] &= bytes[i];
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size) {
+  if (!isPartitionRange(partition, offset, size)) return ESP_ERR_INVALID_ARG;
+  if ((offset % PartitionHostUtils::sector_bytes != 0) || (size % PartitionHostUtils::sector_bytes != 0)) return ESP_ERR_INVALID_SIZE;
+  memset(&partitionFlash[offset], 0xFF, size);
+  return ESP_OK;
+}
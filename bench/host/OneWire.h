@@ -0,0 +1,8 @@
+#pragma once
+// Host stand-in: CRC of the OneWire library (no bus access)
+#include <cstdint>
+
+class OneWire {
+  public:
+  static uint8_t crc8(const uint8_t *addr, uint8_t len);
+};
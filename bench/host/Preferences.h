@@ -0,0 +1,20 @@
+#pragma once
+// Host stand-in for the NVS key-value store of the Arduino core: entries are kept in memory for the lifetime
+// of the process (in a few fixed slots, shared by all namespaces)
+#include <cstddef>
+#include <cstdint>
+
+namespace PreferencesHostUtils {
+  constexpr uint8_t max_entries = 4;
+  constexpr uint8_t max_key_length = 15; // as in NVS
+  constexpr uint8_t max_value_bytes = 64;
+}
+
+class Preferences {
+  public:
+  bool begin(const char *name, bool readOnly = false, const char *partitionLabel = nullptr) { return true; }
+  void end() {}
+
+  size_t putBytes(const char *key, const void *value, size_t length); // 0 if the value does not fit
+  size_t getBytes(const char *key, void *buffer, size_t maxLength);   // 0 if the key is not found
+};
@@ -0,0 +1,85 @@
+#include "PtyStream.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+  bool makeRaw(int fd) {
+    termios attributes;
+    if (tcgetattr(fd, &attributes) != 0) return false;
+    cfmakeraw(&attributes);
+    return tcsetattr(fd, TCSANOW, &attributes) == 0;
+  }
+}
+
+PtyStream::PtyStream() : masterFd(-1), path{}, readPosition(0), readEnd(0) {}
+
+PtyStream::~PtyStream() {
+  if (masterFd >= 0) close(masterFd);
+}
+
+bool PtyStream::begin() {
+  masterFd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (masterFd < 0) return false;
+  if ((grantpt(masterFd) != 0) || (unlockpt(masterFd) != 0)) return false;
+  const char *name = ptsname(masterFd);
+  if (name == nullptr) return false;
+  snprintf(path, sizeof(path), "%s", name);
+  return true;
+}
+
+const char *PtyStream::slavePath() { return path; }
+
+int PtyStream::openSlave() {
+  int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if ((fd >= 0) && !makeRaw(fd)) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+bool PtyStream::fill() {
+  if (readPosition < readEnd) return true;
+  ssize_t count = ::read(masterFd, readAhead, sizeof(readAhead));
+  if (count <= 0) return false;
+  readPosition = 0;
+  readEnd = static_cast<size_t>(count);
+  return true;
+}
+
+int PtyStream::available() {
+  if (readPosition < readEnd) return static_cast<int>(readEnd - readPosition);
+  int pending = 0;
+  if (ioctl(masterFd, FIONREAD, &pending) != 0) return 0;
+  return pending;
+}
+
+int PtyStream::read() { return fill() ? readAhead[readPosition++] : -1; }
+
+int PtyStream::peek() { return fill() ? readAhead[readPosition] : -1; }
+
+int PtyStream::availableForWrite() {
+  pollfd descriptor = {masterFd, POLLOUT, 0};
+  return ((poll(&descriptor, 1, 0) == 1) && (descriptor.revents & POLLOUT)) ? 4096 : 0;
+}
+
+size_t PtyStream::write(uint8_t c) { return write(&c, 1); }
+
+size_t PtyStream::write(const uint8_t *buffer, size_t size) {
+  size_t written = 0;
+  while (written < size) {
+    ssize_t count = ::write(masterFd, buffer + written, size - written);
+    if (count > 0) {
+      written += static_cast<size_t>(count);
+    } else if ((count < 0) && (errno != EAGAIN) && (errno != EINTR)) {
+      break;
+    }
+  }
+  return written;
+}
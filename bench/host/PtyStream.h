@@ -0,0 +1,30 @@
+#pragma once
+// Host stand-in for the serial console of the board: the master end of a pseudo-terminal (pty). A client
+// (e.g. the CLI in tools/cli) talks to the slave end as it would talk to the serial port of the board.
+#include "Arduino.h"
+
+class PtyStream : public Stream {
+  public:
+  PtyStream(); // constructor
+  ~PtyStream();
+
+  bool begin();            // creates the pty (raw, non-blocking); returns false on failure
+  const char *slavePath(); // path of the slave end, e.g. /dev/pts/3
+  int openSlave();         // opens the slave end (raw, non-blocking); returns the file descriptor, or -1
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  int availableForWrite() override;
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buffer, size_t size) override;
+
+  private:
+  bool fill(); // reads ahead from the pty; returns false if nothing is available
+
+  int masterFd;
+  char path[64];
+  uint8_t readAhead[256];
+  size_t readPosition;
+  size_t readEnd;
+};
@@ -0,0 +1,282 @@
+#include "U8g2lib.h"
+#include <cstdio>
+
+// Host stand-in for U8g2 (see U8g2lib.h): rendering into the frame buffer, and capture of the transfers
+
+namespace {
+  // 5x7 pixel glyphs of the printable ASCII characters (0x20..0x7E): 5 columns each, bit 0 is the top row
+  const uint8_t ascii_glyphs[][U8g2HostUtils::glyph_columns] = {
+      {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00}, {0x14, 0x7F, 0x14, 0x7F, 0x14},
+      {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62}, {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00},
+      {0x00, 0x1C, 0x22, 0x41, 0x00}, {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x14, 0x08, 0x3E, 0x08, 0x14}, {0x08, 0x08, 0x3E, 0x08, 0x08},
+      {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x60, 0x60, 0x00, 0x00}, {0x20, 0x10, 0x08, 0x04, 0x02},
+      {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00}, {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4B, 0x31},
+      {0x18, 0x14, 0x12, 0x7F, 0x10}, {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03},
+      {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x36, 0x36, 0x00, 0x00}, {0x00, 0x56, 0x36, 0x00, 0x00},
+      {0x08, 0x14, 0x22, 0x41, 0x00}, {0x14, 0x14, 0x14, 0x14, 0x14}, {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x51, 0x09, 0x06},
+      {0x32, 0x49, 0x79, 0x41, 0x3E}, {0x7E, 0x11, 0x11, 0x11, 0x7E}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22},
+      {0x7F, 0x41, 0x41, 0x22, 0x1C}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x09, 0x01}, {0x3E, 0x41, 0x49, 0x49, 0x7A},
+      {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00}, {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41},
+      {0x7F, 0x40, 0x40, 0x40, 0x40}, {0x7F, 0x02, 0x0C, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E},
+      {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46}, {0x46, 0x49, 0x49, 0x49, 0x31},
+      {0x01, 0x01, 0x7F, 0x01, 0x01}, {0x3F, 0x40, 0x40, 0x40, 0x3F}, {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x3F, 0x40, 0x38, 0x40, 0x3F},
+      {0x63, 0x14, 0x08, 0x14, 0x63}, {0x07, 0x08, 0x70, 0x08, 0x07}, {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x00},
+      {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x7F, 0x00}, {0x04, 0x02, 0x01, 0x02, 0x04}, {0x40, 0x40, 0x40, 0x40, 0x40},
+      {0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78}, {0x7F, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20},
+      {0x38, 0x44, 0x44, 0x48, 0x7F}, {0x38, 0x54, 0x54, 0x54, 0x18}, {0x08, 0x7E, 0x09, 0x01, 0x02}, {0x0C, 0x52, 0x52, 0x52, 0x3E},
+      {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, {0x20, 0x40, 0x44, 0x3D, 0x00}, {0x7F, 0x10, 0x28, 0x44, 0x00},
+      {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x18, 0x04, 0x78}, {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38},
+      {0x7C, 0x14, 0x14, 0x14, 0x08}, {0x08, 0x14, 0x14, 0x18, 0x7C}, {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20},
+      {0x04, 0x3F, 0x44, 0x40, 0x20}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, {0x1C, 0x20, 0x40, 0x20, 0x1C}, {0x3C, 0x40, 0x30, 0x40, 0x3C},
+      {0x44, 0x28, 0x10, 0x28, 0x44}, {0x0C, 0x50, 0x50, 0x50, 0x3C}, {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00},
+      {0x00, 0x00, 0x7F, 0x00, 0x00}, {0x00, 0x41, 0x36, 0x08, 0x00}, {0x08, 0x04, 0x08, 0x10, 0x08}};
+  const uint8_t degree_glyph[U8g2HostUtils::glyph_columns] = {0x00, 0x06, 0x09, 0x09, 0x06};  // U+00B0
+  const uint8_t missing_glyph[U8g2HostUtils::glyph_columns] = {0x7F, 0x41, 0x41, 0x41, 0x7F}; // any other code point
+
+  const uint8_t *glyphFor(uint32_t codePoint) {
+    if ((codePoint >= 0x20) && (codePoint <= 0x7E)) return ascii_glyphs[codePoint - 0x20];
+    if (codePoint == 0xB0) return degree_glyph;
+    return missing_glyph;
+  }
+
+  // Decodes the next code point of `str`, and advances `str` past it (invalid sequences: one byte each)
+  uint32_t nextCodePoint(const char *&str) {
+    uint8_t lead = static_cast<uint8_t>(*str++);
+    uint8_t continuations = (lead >= 0xF0) ? 3 : (lead >= 0xE0) ? 2 : (lead >= 0xC0) ? 1 : 0;
+    uint32_t codePoint = (continuations == 0) ? lead : (lead & (0x3F >> continuations));
+    while (continuations-- > 0) {
+      uint8_t next = static_cast<uint8_t>(*str);
+      if ((next & 0xC0) != 0x80) break;
+      codePoint = (codePoint << 6) | (next & 0x3F);
+      str++;
+    }
+    return codePoint;
+  }
+}
+
+const u8g2_cb_t u8g2_cb_r0 = {0};
+const u8g2_cb_t u8g2_cb_r2 = {2};
+
+const uint8_t u8g2_font_logisoso30_tf[] = {3};
+const uint8_t u8g2_font_logisoso26_tn[] = {3};
+const uint8_t u8g2_font_logisoso18_tf[] = {2};
+const uint8_t u8g2_font_5x8_tf[] = {1};
+const uint8_t u8g2_font_6x12_tf[] = {1};
+const uint8_t u8g2_font_9x15_tf[] = {2};
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                          CLASS U8G2                                            *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Coordinates are logical (as passed by the caller), clipped against the clip window, and then rotated
+// into the physical frame buffer, as u8g2 does. Draw color 2 is XOR.
+
+// constructor:
+U8G2::U8G2(const u8g2_cb_t *rotation)
+    : fontScale(1),
+      drawColor(1),
+      fontTransparent(false),
+      bitmapTransparent(false),
+      cursorX(0),
+      cursorY(0),
+      utf8CodePoint(0),
+      utf8Pending(0),
+      transfers(0),
+      lastBytes(0),
+      lastTransactions(0),
+      totalBytes(0),
+      totalTransactions(0) {
+  u8g2.cb = rotation;
+  setMaxClipWindow();
+}
+
+void U8G2::clearBuffer() { memset(buffer, 0, sizeof(buffer)); }
+
+void U8G2::sendBuffer() { transfer(0, 0, U8g2HostUtils::tile_width, U8g2HostUtils::tile_height); }
+
+void U8G2::updateDisplayArea(uint8_t tx, uint8_t ty, uint8_t tw, uint8_t th) {
+  // clipped to the buffer, as u8g2 does
+  if ((tx >= U8g2HostUtils::tile_width) || (ty >= U8g2HostUtils::tile_height)) return;
+  if (tx + tw > U8g2HostUtils::tile_width) tw = U8g2HostUtils::tile_width - tx;
+  if (ty + th > U8g2HostUtils::tile_height) th = U8g2HostUtils::tile_height - ty;
+  transfer(tx, ty, tw, th);
+}
+
+void U8G2::setFont(const uint8_t *font) { fontScale = ((font != nullptr) && (font[0] > 0)) ? font[0] : 1; }
+
+void U8G2::setClipWindow(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+  clipX0 = x0;
+  clipY0 = y0;
+  clipX1 = x1;
+  clipY1 = y1;
+}
+
+void U8G2::setMaxClipWindow() { setClipWindow(0, 0, getDisplayWidth(), getDisplayHeight()); }
+
+void U8G2::setCursor(int16_t x, int16_t y) {
+  cursorX = x;
+  cursorY = y;
+}
+
+void U8G2::drawPixel(int16_t x, int16_t y) { setPixel(x, y, drawColor); }
+
+void U8G2::drawBox(int16_t x, int16_t y, int16_t w, int16_t h) {
+  for (int16_t row = y; row < y + h; row++) {
+    for (int16_t column = x; column < x + w; column++) setPixel(column, row, drawColor);
+  }
+}
+
+void U8G2::drawFrame(int16_t x, int16_t y, int16_t w, int16_t h) {
+  // as u8g2: full top and bottom lines, the sides in between, so no pixel is drawn twice (matters for XOR)
+  if ((w <= 0) || (h <= 0)) return;
+  drawBox(x, y, w, 1);
+  if (h >= 2) drawBox(x, y + h - 1, w, 1);
+  if (h >= 3) {
+    drawBox(x, y + 1, 1, h - 2);
+    if (w >= 2) drawBox(x + w - 1, y + 1, 1, h - 2);
+  }
+}
+
+void U8G2::drawXBMP(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t *bitmap) {
+  const int16_t bytesPerRow = (w + 7) / 8;
+  const uint8_t background = (drawColor == 0) ? 1 : 0;
+  for (int16_t row = 0; row < h; row++) {
+    for (int16_t column = 0; column < w; column++) {
+      bool set = (bitmap[row * bytesPerRow + column / 8] >> (column & 7)) & 1;
+      if (set) {
+        setPixel(x + column, y + row, drawColor);
+      } else if (!bitmapTransparent) {
+        setPixel(x + column, y + row, background);
+      }
+    }
+  }
+}
+
+int16_t U8G2::drawStr(int16_t x, int16_t y, const char *str) {
+  int16_t startX = x;
+  for (; *str != '\0'; str++) {
+    drawGlyph(x, y, static_cast<uint8_t>(*str));
+    x += U8g2HostUtils::glyph_advance * fontScale;
+  }
+  return x - startX;
+}
+
+int16_t U8G2::drawUTF8(int16_t x, int16_t y, const char *str) {
+  int16_t startX = x;
+  while (*str != '\0') {
+    drawGlyph(x, y, nextCodePoint(str));
+    x += U8g2HostUtils::glyph_advance * fontScale;
+  }
+  return x - startX;
+}
+
+int16_t U8G2::getStrWidth(const char *str) { return static_cast<int16_t>(U8g2HostUtils::glyph_advance * fontScale * strlen(str)); }
+
+int16_t U8G2::getUTF8Width(const char *str) {
+  int16_t glyphs = 0;
+  while (*str != '\0') {
+    nextCodePoint(str);
+    glyphs++;
+  }
+  return static_cast<int16_t>(U8g2HostUtils::glyph_advance * fontScale * glyphs);
+}
+
+size_t U8G2::write(uint8_t c) {
+  if ((c & 0xC0) == 0x80) { // continuation byte
+    if (utf8Pending == 0) return 1;
+    utf8CodePoint = (utf8CodePoint << 6) | (c & 0x3F);
+    if (--utf8Pending > 0) return 1;
+  } else {
+    utf8Pending = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : (c >= 0xC0) ? 1 : 0;
+    utf8CodePoint = (utf8Pending == 0) ? c : (c & (0x3F >> utf8Pending));
+    if (utf8Pending > 0) return 1;
+  }
+  drawGlyph(cursorX, cursorY, utf8CodePoint);
+  cursorX += U8g2HostUtils::glyph_advance * fontScale;
+  return 1;
+}
+
+void U8G2::resetCapture() {
+  transfers = 0;
+  lastBytes = 0;
+  lastTransactions = 0;
+  totalBytes = 0;
+  totalTransactions = 0;
+}
+
+bool U8G2::writePbm(const char *path) {
+  FILE *file = fopen(path, "w");
+  if (file == nullptr) return false;
+  const int16_t width = getDisplayWidth();
+  const int16_t height = getDisplayHeight();
+  const bool rotated180 = (u8g2.cb == U8G2_R2);
+  fprintf(file, "P1\n%d %d\n", width, height);
+  for (int16_t y = 0; y < height; y++) {
+    for (int16_t x = 0; x < width; x++) {
+      int16_t px = rotated180 ? width - 1 - x : x;
+      int16_t py = rotated180 ? height - 1 - y : y;
+      bool on = (panelMemory[(py / 8) * width + px] >> (py & 7)) & 1;
+      fputc(on ? '1' : '0', file);
+    }
+    fputc('\n', file);
+  }
+  return fclose(file) == 0;
+}
+
+void U8G2::transfer(uint8_t tx, uint8_t ty, uint8_t tw, uint8_t th) {
+  const uint16_t width = getDisplayWidth();
+  uint32_t bytes = 0;
+  uint32_t transactions = 0;
+  for (uint8_t row = ty; row < ty + th; row++) {
+    size_t offset = row * width + tx * 8;
+    uint16_t length = tw * 8;
+    memcpy(panelMemory + offset, buffer + offset, length);
+
+    bytes += U8g2HostUtils::bus_commands_per_row * U8g2HostUtils::bus_command_bytes;
+    transactions += U8g2HostUtils::bus_commands_per_row;
+    uint16_t chunks = (length + U8g2HostUtils::bus_data_chunk - 1) / U8g2HostUtils::bus_data_chunk;
+    bytes += length + chunks * U8g2HostUtils::bus_data_overhead;
+    transactions += chunks;
+  }
+  transfers++;
+  lastBytes = bytes;
+  lastTransactions = transactions;
+  totalBytes += bytes;
+  totalTransactions += transactions;
+}
+
+void U8G2::drawGlyph(int16_t x, int16_t y, uint32_t codePoint) {
+  // the glyph stands on the baseline `y`; in solid font mode, its cell (ascent to descent) is filled first
+  const uint8_t *glyph = glyphFor(codePoint);
+  const int16_t top = y - getAscent();
+  if (!fontTransparent) {
+    uint8_t background = (drawColor == 0) ? 1 : 0;
+    int16_t cellHeight = getAscent() - getDescent();
+    for (int16_t row = 0; row < cellHeight; row++) {
+      for (int16_t column = 0; column < U8g2HostUtils::glyph_advance * fontScale; column++) setPixel(x + column, top + row, background);
+    }
+  }
+  for (uint8_t column = 0; column < U8g2HostUtils::glyph_columns; column++) {
+    for (uint8_t row = 0; row < U8g2HostUtils::glyph_rows; row++) {
+      if (((glyph[column] >> row) & 1) == 0) continue;
+      for (uint8_t dy = 0; dy < fontScale; dy++) {
+        for (uint8_t dx = 0; dx < fontScale; dx++) setPixel(x + column * fontScale + dx, top + row * fontScale + dy, drawColor);
+      }
+    }
+  }
+}
+
+void U8G2::setPixel(int16_t x, int16_t y, uint8_t color) {
+  if ((x < clipX0) || (x >= clipX1) || (y < clipY0) || (y >= clipY1)) return;
+  const int16_t width = getDisplayWidth();
+  const int16_t height = getDisplayHeight();
+  if ((x < 0) || (x >= width) || (y < 0) || (y >= height)) return;
+  if (u8g2.cb == U8G2_R2) {
+    x = width - 1 - x;
+    y = height - 1 - y;
+  }
+  uint8_t &column = buffer[(y / 8) * width + x];
+  uint8_t mask = static_cast<uint8_t>(1 << (y & 7));
+  if (color == 0) column &= ~mask;
+  else if (color == 1) column |= mask;
+  else column ^= mask;
+}
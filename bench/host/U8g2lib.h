@@ -0,0 +1,127 @@
+#pragma once
+// Host stand-in for the U8g2 display class, with a capture backend (see U8g2Host.cpp). Drawing renders into
+// the frame buffer of the 72x40 panel, in the layout of u8g2 (tile rows of 8-pixel columns, rotation applied
+// when drawing), so rendering can be compared against golden images. Glyphs come from a fixed 5x7 pixel
+// font, scaled by a factor per font: the images check the layout, not the typeface.
+//
+// Every `sendBuffer()` and `updateDisplayArea()` is captured: the transferred tiles are copied into the
+// panel memory, and the bytes and I2C transactions that the SSD1306 software-I2C path of u8g2 sends for
+// them are counted (`begin()` and the initialization sequence are not counted).
+#include <Arduino.h>
+
+#define U8X8_PIN_NONE 255
+
+namespace U8g2HostUtils {
+  constexpr uint8_t tile_width = 9;          // 72 pixels
+  constexpr uint8_t tile_height = 5;         // 40 pixels
+  constexpr uint8_t glyph_columns = 5;       // pixels of the host font, before scaling
+  constexpr uint8_t glyph_rows = 7;
+  constexpr uint8_t glyph_advance = 6;       // glyph and one column of spacing
+  // SSD1306 on u8x8_cad_ssd13xx_fast_i2c: a tile row is addressed by three commands, each in a transaction
+  // of its own (I2C address, control byte 0x00, command); the data follows in transactions of up to 24
+  // bytes (I2C address, control byte 0x40, data)
+  constexpr uint8_t bus_commands_per_row = 3;
+  constexpr uint8_t bus_command_bytes = 3;
+  constexpr uint8_t bus_data_chunk = 24;
+  constexpr uint8_t bus_data_overhead = 2;
+}
+
+typedef struct u8g2_cb_struct {
+  uint8_t rotation;
+} u8g2_cb_t;
+extern const u8g2_cb_t u8g2_cb_r0;
+extern const u8g2_cb_t u8g2_cb_r2;
+#define U8G2_R0 (&u8g2_cb_r0)
+#define U8G2_R2 (&u8g2_cb_r2)
+
+typedef struct u8g2_struct {
+  const u8g2_cb_t *cb;
+} u8g2_t;
+
+// Host fonts: the only byte is the scale of the 5x7 pixel glyphs
+extern const uint8_t u8g2_font_logisoso30_tf[];
+extern const uint8_t u8g2_font_logisoso26_tn[];
+extern const uint8_t u8g2_font_logisoso18_tf[];
+extern const uint8_t u8g2_font_5x8_tf[];
+extern const uint8_t u8g2_font_6x12_tf[];
+extern const uint8_t u8g2_font_9x15_tf[];
+
+class U8G2 : public Print {
+  public:
+  U8G2(const u8g2_cb_t *rotation); // constructor
+
+  void begin() {}
+  void setBusClock(uint32_t clockSpeed) {}
+  void setContrast(uint8_t value) {}
+  void enableUTF8Print() {}
+  void clearBuffer();
+  void sendBuffer();
+  void updateDisplayArea(uint8_t tx, uint8_t ty, uint8_t tw, uint8_t th);
+
+  void setFont(const uint8_t *font);
+  void setFontMode(uint8_t isTransparent) { fontTransparent = (isTransparent != 0); }
+  void setBitmapMode(uint8_t isTransparent) { bitmapTransparent = (isTransparent != 0); }
+  void setDrawColor(uint8_t color) { drawColor = color; }
+  void setClipWindow(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+  void setMaxClipWindow();
+  void setCursor(int16_t x, int16_t y);
+
+  void drawPixel(int16_t x, int16_t y);
+  void drawBox(int16_t x, int16_t y, int16_t w, int16_t h);
+  void drawFrame(int16_t x, int16_t y, int16_t w, int16_t h);
+  void drawXBMP(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t *bitmap);
+  int16_t drawStr(int16_t x, int16_t y, const char *str);  // one glyph per byte
+  int16_t drawUTF8(int16_t x, int16_t y, const char *str); // one glyph per code point
+
+  int16_t getStrWidth(const char *str);
+  int16_t getUTF8Width(const char *str);
+  int8_t getAscent() { return static_cast<int8_t>(U8g2HostUtils::glyph_rows * fontScale); }
+  int8_t getDescent() { return static_cast<int8_t>(-fontScale); }
+  int16_t getDisplayWidth() { return 8 * U8g2HostUtils::tile_width; }
+  int16_t getDisplayHeight() { return 8 * U8g2HostUtils::tile_height; }
+  u8g2_t *getU8g2() { return &u8g2; }
+  uint8_t *getBufferPtr() { return buffer; }
+  uint8_t getBufferTileWidth() { return U8g2HostUtils::tile_width; }
+  uint8_t getBufferTileHeight() { return U8g2HostUtils::tile_height; }
+
+  size_t write(uint8_t c) override; // prints at the cursor (UTF-8)
+
+  // Capture
+  const uint8_t *panel() { return panelMemory; } // panel contents after the latest transfer (frame buffer layout)
+  uint32_t transferCount() { return transfers; }  // captured transfers
+  uint32_t lastBusBytes() { return lastBytes; }   // bytes of the latest transfer on the bus (incl. addresses)
+  uint32_t lastBusTransactions() { return lastTransactions; }
+  uint32_t busBytes() { return totalBytes; } // since construction or `resetCapture()`
+  uint32_t busTransactions() { return totalTransactions; }
+  void resetCapture(); // clears the counts (not the panel)
+  bool writePbm(const char *path); // writes the panel as a plain PBM image, as seen on the screen (rotation undone)
+
+  private:
+  void transfer(uint8_t tx, uint8_t ty, uint8_t tw, uint8_t th);
+  void drawGlyph(int16_t x, int16_t y, uint32_t codePoint);
+  void setPixel(int16_t x, int16_t y, uint8_t color);
+
+  u8g2_t u8g2;
+  uint8_t buffer[U8g2HostUtils::tile_width * U8g2HostUtils::tile_height * 8] = {};
+  uint8_t panelMemory[U8g2HostUtils::tile_width * U8g2HostUtils::tile_height * 8] = {};
+
+  // drawing state
+  uint8_t fontScale;
+  uint8_t drawColor;
+  bool fontTransparent;
+  bool bitmapTransparent;
+  int16_t clipX0, clipY0, clipX1, clipY1; // clip window (x1, y1 exclusive)
+  int16_t cursorX, cursorY;
+  uint32_t utf8CodePoint; // code point being decoded by `write()`
+  uint8_t utf8Pending;    // continuation bytes still expected by `write()`
+
+  // capture
+  uint32_t transfers;
+  uint32_t lastBytes, lastTransactions;
+  uint32_t totalBytes, totalTransactions;
+};
+
+class U8G2_SSD1306_72X40_ER_F_SW_I2C : public U8G2 {
+  public:
+  U8G2_SSD1306_72X40_ER_F_SW_I2C(const u8g2_cb_t *rotation, uint8_t clock, uint8_t data, uint8_t reset) : U8G2(rotation) {}
+};
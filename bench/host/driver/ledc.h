@@ -0,0 +1,8 @@
+#pragma once
+// Host stand-in for the LEDC driver functions used besides the Arduino core's `ledc...()` (see Arduino.h)
+#include "../esp_timer.h" // For esp_err_t
+
+typedef enum { LEDC_LOW_SPEED_MODE = 0 } ledc_mode_t;
+typedef enum { LEDC_CHANNEL_0 = 0 } ledc_channel_t;
+
+esp_err_t ledc_fade_stop(ledc_mode_t mode, ledc_channel_t channel);
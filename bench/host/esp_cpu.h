@@ -0,0 +1,6 @@
+#pragma once
+// Host stand-in: the host has no portable cycle counter, hence the "cycles" are nanoseconds (wrapping)
+#include <cstdint>
+
+typedef uint32_t esp_cpu_cycle_count_t;
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count();
@@ -0,0 +1,32 @@
+#pragma once
+// Host stand-in for the partition API of ESP-IDF: one data partition, "series", of `sector_count` sectors in
+// memory, for the lifetime of the process. Behaves as NOR flash: an erase sets a sector to 0xFF, a write can
+// only clear bits (it is ANDed into the contents).
+#include "esp_timer.h" // For esp_err_t
+#include <cstddef>
+#include <cstdint>
+
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_SIZE 0x104
+
+namespace PartitionHostUtils {
+  constexpr size_t sector_bytes = 4096;
+  constexpr size_t sector_count = 16;
+}
+
+typedef enum { ESP_PARTITION_TYPE_APP = 0x00, ESP_PARTITION_TYPE_DATA = 0x01 } esp_partition_type_t;
+typedef enum { ESP_PARTITION_SUBTYPE_ANY = 0xff } esp_partition_subtype_t;
+
+typedef struct {
+  esp_partition_type_t type;
+  esp_partition_subtype_t subtype;
+  uint32_t address;
+  uint32_t size;
+  uint32_t erase_size;
+  char label[17];
+} esp_partition_t;
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char *label);
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t srcOffset, void *dst, size_t size);
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dstOffset, const void *src, size_t size);
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size); // sector-aligned
@@ -0,0 +1,15 @@
+#pragma once
+// Host stand-in: the task watchdog is configured, but never resets the process
+#include "esp_timer.h" // For esp_err_t
+#include <cstdint>
+
+typedef struct {
+  uint32_t timeout_ms;
+  uint32_t idle_core_mask;
+  bool trigger_panic;
+} esp_task_wdt_config_t;
+
+esp_err_t esp_task_wdt_init(const esp_task_wdt_config_t *config);
+esp_err_t esp_task_wdt_reconfigure(const esp_task_wdt_config_t *config);
+esp_err_t esp_task_wdt_add(void *task);
+esp_err_t esp_task_wdt_reset();
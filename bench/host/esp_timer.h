@@ -0,0 +1,32 @@
+#pragma once
+// Host stand-in: time since start of the process [microseconds], plus the time skipped by `hostAdvanceTime()`,
+// less the time stopped by `hostFreezeTime()`; timers are created, but never fire
+#include <cstdint>
+
+typedef int esp_err_t;
+#define ESP_OK 0
+
+typedef struct esp_timer *esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void *arg);
+typedef enum { ESP_TIMER_TASK, ESP_TIMER_ISR } esp_timer_dispatch_t;
+typedef struct {
+  esp_timer_cb_t callback;
+  void *arg;
+  esp_timer_dispatch_t dispatch_method;
+  const char *name;
+  bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+int64_t esp_timer_get_time();
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *handle);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+
+// Host only: skips `us` of time at once; the alarms of hardware timers (see `timerAlarm()` in Arduino.h) that
+// fall due meanwhile fire on the way, at their due time. Intended for simulations of long time spans.
+void hostAdvanceTime(uint64_t us);
+
+// Host only: stops (true) or restarts (false) the clock; while stopped, only `hostAdvanceTime()` moves it.
+// Intended for traces that compare implementations at the same instant.
+void hostFreezeTime(bool frozen);
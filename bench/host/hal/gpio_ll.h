@@ -0,0 +1,10 @@
+#pragma once
+// Host stand-in: the level of a pin is the level last written to it (see soc/gpio_struct.h)
+#include "../soc/gpio_struct.h"
+#include <cstdint>
+
+static inline void gpio_ll_set_level(gpio_dev_t *hw, uint32_t gpio_num, uint32_t level) {
+  hw->out = (level != 0) ? (hw->out | (1UL << gpio_num)) : (hw->out & ~(1UL << gpio_num));
+}
+
+static inline int gpio_ll_get_level(gpio_dev_t *hw, uint32_t gpio_num) { return (hw->out >> gpio_num) & 1UL; }
@@ -0,0 +1,8 @@
+#pragma once
+// Host stand-in for the GPIO register block: only the output levels of GPIO 0..31
+#include <cstdint>
+
+typedef struct {
+  uint32_t out;
+} gpio_dev_t;
+extern gpio_dev_t GPIO;
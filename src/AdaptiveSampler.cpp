@@ -0,0 +1,129 @@
+#include "AdaptiveSampler.h"
+#include <cstdint>     // For int64_t
+#include <esp_timer.h> // For esp_timer_get_time()
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                    CLASS AdaptiveSampler                                       *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Selects sampling interval and resolution of the temperature sensor. It is intended to run on the
+// controller loop, consuming minimal resources.
+
+// constructor:
+AdaptiveSampler::AdaptiveSampler(float setpointC)
+    : setpointC(setpointC),
+      level(SamplerUtils::level_count - 1), // start slow; the first samples speed up if needed
+      activatedAtMilli(0),
+      lastSampleStartMilli(0),
+      nextSampleAtOrAfterMilli(0),
+      expired(true), // start as expired/disabled
+      hasPrevious(false),
+      previousC(0.0f),
+      previousAtMilli(0),
+      rate(0.2f),
+      busTimeUs(0),
+      fixedHeldC(0.0f),
+      nextFixedSampleAtMilli(0),
+      adaptiveError(0.05f),
+      fixedRateError(0.05f) {
+}
+
+bool AdaptiveSampler::checkSample() {
+  if (expired) return false;
+  int64_t currentMillis = esp_timer_get_time() / 1000LL; // convert microseconds returned by `esp_timer_get_time()` to milliseconds
+  if (currentMillis < nextSampleAtOrAfterMilli) return false;
+
+  // the interval counts from the start of a sample; a late sample does not cause a burst of samples
+  lastSampleStartMilli = currentMillis;
+  nextSampleAtOrAfterMilli = currentMillis + static_cast<int64_t>(intervalMs());
+  return true;
+}
+
+void AdaptiveSampler::addSample(float tempC) {
+  int64_t currentMillis = esp_timer_get_time() / 1000LL;
+
+  // estimation errors: difference to the value each scheme obtained last
+  if (!hasPrevious) {
+    fixedHeldC = tempC;
+    nextFixedSampleAtMilli = currentMillis + SamplerUtils::fixed_rate_interval_ms;
+  } else {
+    adaptiveError.update(fabsf(tempC - previousC));
+    if (currentMillis >= nextFixedSampleAtMilli) {
+      // the fixed-rate sampling would read now, at its resolution
+      fixedHeldC = roundf(tempC / SamplerUtils::fixed_rate_step_c) * SamplerUtils::fixed_rate_step_c;
+      while (currentMillis >= nextFixedSampleAtMilli) nextFixedSampleAtMilli += SamplerUtils::fixed_rate_interval_ms;
+    }
+    fixedRateError.update(fabsf(tempC - fixedHeldC));
+
+    int64_t elapsedMs = currentMillis - previousAtMilli;
+    if (elapsedMs > 0) rate.update((tempC - previousC) * 1000.0f / static_cast<float>(elapsedMs));
+  }
+  hasPrevious = true;
+  previousC = tempC;
+  previousAtMilli = currentMillis;
+
+  // allowed change between two samples, shrinking towards the setpoint
+  float allowedC = SamplerUtils::change_per_distance * fabsf(tempC - setpointC);
+  allowedC = min(max(allowedC, SamplerUtils::min_change_per_sample_c), SamplerUtils::max_change_per_sample_c);
+
+  // slowest level that keeps the expected change within the allowance
+  float ratePerMs = fabsf(rate.value()) / 1000.0f;
+  uint8_t target = 0;
+  for (uint8_t i = SamplerUtils::level_count; i-- > 0;) {
+    if (ratePerMs * static_cast<float>(SamplerUtils::levels[i].intervalMs) <= allowedC) {
+      target = i;
+      break;
+    }
+  }
+  level = (target > level) ? level + 1 : target;
+
+  // a faster level takes effect for the next sample already
+  int64_t nextAtFasterLevel = lastSampleStartMilli + static_cast<int64_t>(intervalMs());
+  if (nextAtFasterLevel < nextSampleAtOrAfterMilli) nextSampleAtOrAfterMilli = nextAtFasterLevel;
+}
+
+void AdaptiveSampler::addBusTime(uint32_t busTimeUs) { this->busTimeUs += busTimeUs; }
+
+void AdaptiveSampler::setSetpoint(float setpointC) { this->setpointC = setpointC; }
+
+uint8_t AdaptiveSampler::resolution() { return SamplerUtils::levels[level].resolution; }
+
+unsigned long AdaptiveSampler::intervalMs() { return SamplerUtils::levels[level].intervalMs; }
+
+void AdaptiveSampler::activate(long delayMs /* = 0 */) {
+  activatedAtMilli = esp_timer_get_time() / 1000LL;
+  nextSampleAtOrAfterMilli = activatedAtMilli + static_cast<int64_t>(delayMs);
+  busTimeUs = 0;
+  expired = false;
+}
+
+void AdaptiveSampler::expire() { expired = true; }
+
+bool AdaptiveSampler::isExpired() { return expired; }
+
+float AdaptiveSampler::rateCPerSecond() { return rate.value(); }
+
+float AdaptiveSampler::busDutyCycle() {
+  int64_t elapsedMs = esp_timer_get_time() / 1000LL - activatedAtMilli;
+  if (elapsedMs <= 0) return 0.0f;
+  return static_cast<float>(busTimeUs) / (1000.0f * static_cast<float>(elapsedMs));
+}
+
+float AdaptiveSampler::adaptiveErrorC() { return adaptiveError.value(); }
+
+float AdaptiveSampler::fixedRateErrorC() { return fixedRateError.value(); }
+
+void AdaptiveSampler::printStats() {
+  Serial.print(F("Sampling: "));
+  Serial.print(resolution(), DEC);
+  Serial.print(F(" bits every "));
+  Serial.print(intervalMs());
+  Serial.print(F(" ms, rate "));
+  Serial.print(rate.value(), 4);
+  Serial.print(F(" C/s, bus duty cycle "));
+  Serial.print(100.0f * busDutyCycle(), 3);
+  Serial.print(F("%, estimation error avg "));
+  Serial.print(adaptiveError.value(), 3);
+  Serial.print(F(" C (fixed-rate "));
+  Serial.print(fixedRateError.value(), 3);
+  Serial.println(F(" C)"));
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include "Ewma.h"
+#include <Arduino.h>
+
+namespace SamplerUtils {
+  // Sampling levels, from fast (coarse) to slow (fine). The interval of a level must exceed the DS18B20
+  // conversion time at its resolution (94, 188, 375, 750 ms).
+  struct Level {
+    uint8_t resolution;       // DS18B20 resolution [bits]
+    unsigned long intervalMs; // sampling interval [milliseconds]
+  };
+  constexpr Level levels[] = {
+      {9, 100},
+      {10, 250},
+      {11, 1000},
+      {12, 5000}};
+  constexpr uint8_t level_count = sizeof(levels) / sizeof(levels[0]);
+
+  // The expected change between two samples may be this fraction of the distance to the setpoint,
+  // within the bounds below [°C]
+  constexpr float change_per_distance = 0.25f;
+  constexpr float min_change_per_sample_c = 0.0625f;
+  constexpr float max_change_per_sample_c = 0.5f;
+
+  // Reference for the estimation error: the fixed-rate sampling used before
+  constexpr unsigned long fixed_rate_interval_ms = 5000;
+  constexpr float fixed_rate_step_c = 0.25f; // 10-bit resolution
+}
+
+class AdaptiveSampler {
+
+  // CLASS AdaptiveSampler
+  //
+  // Picks the sampling interval and the resolution of the temperature sensor from the recent rate of change
+  // and the distance to the setpoint: fast and coarse (9 bits every 100 ms) while the temperature changes
+  // quickly or is close to the setpoint, slow and fine (12 bits every 5 s) while it is stable.
+  //
+  // The sampler selects the slowest level at which the expected change between two samples (rate of change
+  // times interval) stays within an allowance, which shrinks with the distance to the setpoint. It switches
+  // to a faster level immediately, but to a slower one only a single level at a time.
+  //
+  // The rate of change is the exponentially weighted average of the signed rate between consecutive samples,
+  // so the quantization steps of a coarse resolution average out while the temperature is stable.
+  //
+  // Statistics: the bus duty cycle (time the bus was busy, as reported with `addBusTime()`), and the error of
+  // the estimate against the actual reading, both for the adaptive sampling and for the fixed-rate sampling
+  // it replaces. The error of a sampling scheme at the time of a reading is the difference between the reading
+  // and the value that scheme last obtained (i.e. the value it would currently be acting on).
+
+  public:
+  AdaptiveSampler(float setpointC); // constructor
+
+  bool checkSample(); // Loop function: returns true _once_ when the next sample is due
+
+  void addSample(float tempC);         // reports a valid reading; selects the level for the next sample
+  void addBusTime(uint32_t busTimeUs); // reports the bus time of a transaction [microseconds]
+  void setSetpoint(float setpointC);
+
+  uint8_t resolution();       // resolution for the next sample [bits]
+  unsigned long intervalMs(); // current sampling interval [milliseconds]
+
+  // Lifecycle functions
+  void activate(long delayMs = 0); // activates sampling (after optional delay [milliseconds])
+  void expire();                   // disables sampling
+  bool isExpired();                // returns true if sampling is expired/disabled
+
+  // Statistics
+  float rateCPerSecond();  // estimated rate of change [°C/s]
+  float busDutyCycle();    // fraction of time the bus was busy since activation
+  float adaptiveErrorC();  // average estimation error of the adaptive sampling [°C]
+  float fixedRateErrorC(); // average estimation error of the fixed-rate sampling [°C]
+  void printStats();       // prints the statistics to the Serial console
+
+  private:
+  // dynamic state parameters
+  float setpointC;
+  uint8_t level;
+  int64_t activatedAtMilli;
+  int64_t lastSampleStartMilli;
+  int64_t nextSampleAtOrAfterMilli;
+  bool expired;
+
+  bool hasPrevious;
+  float previousC;
+  int64_t previousAtMilli;
+  Ewma rate;
+
+  // statistics
+  uint64_t busTimeUs;
+  float fixedHeldC;
+  int64_t nextFixedSampleAtMilli;
+  Ewma adaptiveError;
+  Ewma fixedRateError;
+};
@@ -0,0 +1,33 @@
+// Generated by tools/xbmpack from the XBM frames in docs/animations; do not edit.
+#pragma once
+#include "XbmAnimation.h"
+
+// 4 frames of 20x20 pixels: 240 bytes as XBM, 58 bytes encoded
+inline const uint8_t heatingAnimation_data[] PROGMEM = {
+    0x97, 0x00, 0x83, 0x80, 0x8B, 0x00, 0x04, 0x01, 0x0F, 0x07, 0x03, 0x01, 0x86, 0x00, 0x96, 0x00,
+    0x03, 0x20, 0x70, 0x60, 0x70, 0x80, 0x7C, 0x01, 0x60, 0x30, 0x97, 0x00, 0x82, 0x00, 0x03, 0x40,
+    0xE0, 0x60, 0x60, 0x82, 0xE0, 0x00, 0x20, 0x8B, 0x00, 0x00, 0x02, 0x80, 0x03, 0x98, 0x00, 0x83,
+    0x00, 0x05, 0x10, 0x18, 0x1E, 0x1F, 0x0F, 0x03, 0xAD, 0x00};
+inline const XbmAnimation heatingAnimation = {20, 20, 4, 0, heatingAnimation_data, 58, 240};
+
+// 8 frames of 72x40 pixels, rotated by 180°: 2880 bytes as XBM, 284 bytes encoded
+inline const uint8_t splashAnimation_data[] PROGMEM = {
+    0xFF, 0x00, 0xA8, 0x00, 0x00, 0xFF, 0x89, 0x81, 0x00, 0xFF, 0xFF, 0x00, 0xA8, 0x00, 0xDB, 0x00,
+    0x00, 0xF0, 0x98, 0x10, 0x00, 0xF0, 0xA8, 0x00, 0x00, 0xFF, 0x83, 0x00, 0x00, 0xFF, 0x89, 0x81,
+    0x00, 0xFF, 0x84, 0x00, 0x00, 0xFF, 0xA8, 0x00, 0x00, 0x0F, 0x98, 0x08, 0x00, 0x0F, 0xDA, 0x00,
+    0xD4, 0x00, 0x00, 0xFF, 0x83, 0x01, 0x00, 0xF1, 0x98, 0x11, 0x00, 0xF1, 0x83, 0x01, 0x00, 0xFF,
+    0x9A, 0x00, 0x00, 0xFF, 0x83, 0x00, 0x00, 0xFF, 0x98, 0x00, 0x00, 0xFF, 0x83, 0x00, 0x00, 0xFF,
+    0x9A, 0x00, 0x00, 0xFF, 0x83, 0x80, 0x00, 0x8F, 0x98, 0x88, 0x00, 0x8F, 0x83, 0x80, 0x00, 0xFF,
+    0xD3, 0x00, 0x84, 0x00, 0x00, 0xF0, 0xB5, 0x10, 0x00, 0xF0, 0x8B, 0x00, 0x00, 0xFF, 0x84, 0x00,
+    0x00, 0xFF, 0xA6, 0x01, 0x00, 0xFF, 0x83, 0x00, 0x00, 0xFF, 0x8B, 0x00, 0x00, 0xFF, 0x84, 0x00,
+    0x00, 0xFF, 0xA6, 0x00, 0x00, 0xFF, 0x83, 0x00, 0x00, 0xFF, 0x8B, 0x00, 0x00, 0xFF, 0x84, 0x00,
+    0x00, 0xFF, 0xA6, 0x80, 0x00, 0xFF, 0x83, 0x00, 0x00, 0xFF, 0x8B, 0x00, 0x00, 0x0F, 0xB5, 0x08,
+    0x00, 0x0F, 0x84, 0x00, 0x00, 0xFF, 0x83, 0x01, 0x00, 0xF1, 0xB5, 0x11, 0x00, 0xF1, 0x83, 0x01,
+    0x01, 0xFF, 0xFF, 0x83, 0x00, 0x00, 0xFF, 0xB5, 0x00, 0x00, 0xFF, 0x83, 0x00, 0x01, 0xFF, 0xFF,
+    0x83, 0x00, 0x00, 0xFF, 0xB5, 0x00, 0x00, 0xFF, 0x83, 0x00, 0x01, 0xFF, 0xFF, 0x83, 0x00, 0x00,
+    0xFF, 0xB5, 0x00, 0x00, 0xFF, 0x83, 0x00, 0x01, 0xFF, 0xFF, 0x83, 0x80, 0x00, 0x8F, 0xB5, 0x88,
+    0x00, 0x8F, 0x83, 0x80, 0x00, 0xFF, 0xE6, 0x00, 0x06, 0x80, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC, 0xE0,
+    0xBD, 0x00, 0x86, 0x01, 0xFF, 0x00, 0xAA, 0x00, 0xFF, 0x00, 0xAB, 0x00, 0x07, 0x42, 0x70, 0x7E,
+    0x7E, 0x5E, 0x02, 0x00, 0x42, 0xFF, 0x00, 0xAB, 0x00, 0xFF, 0x00, 0xAB, 0x00, 0x86, 0x80, 0xBB,
+    0x00, 0x80, 0x01, 0x05, 0x31, 0x3D, 0x3F, 0x1F, 0x07, 0x03, 0xE5, 0x00};
+inline const XbmAnimation splashAnimation = {72, 40, 8, XbmAnimationUtils::flag_rotated_180, splashAnimation_data, 284, 2880};
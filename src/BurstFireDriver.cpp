@@ -0,0 +1,127 @@
+#include "BurstFireDriver.h"
+#include <esp_timer.h> // For esp_timer_get_time()
+
+namespace {
+  inline uint32_t IRAM_ATTR nowUs() { return static_cast<uint32_t>(esp_timer_get_time()); }
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                    CLASS BurstFireDriver                                       *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// The pattern is stepped from two interrupt handlers (timer and zero-cross GPIO) and read by the loop;
+// the spinlock keeps its counters consistent. The load is written outside of the lock.
+
+// constructor:
+BurstFireDriver::BurstFireDriver(BurstWriter writer, uint8_t mainsHz)
+    : writer(writer),
+      mainsHz(mainsHz),
+      cycleUs(1000000UL / mainsHz),
+      mux(portMUX_INITIALIZER_UNLOCKED),
+      lastZeroCrossUs(0),
+      zeroCrossEdges(0),
+      edgesPerCycle(0),
+      missedZeroCrossings(0) {
+}
+
+void BurstFireDriver::begin() {
+  // hardware timer with 1 MHz resolution, periodic alarm once per mains cycle
+  hw_timer_t *timer = timerBegin(1000000);
+  timerAttachInterruptArg(timer, &BurstFireDriver::onTimerISR, this);
+  timerAlarm(timer, cycleUs, true, 0);
+}
+
+void BurstFireDriver::attachZeroCross(uint8_t pin, uint8_t edgesPerCycle) {
+  this->edgesPerCycle = (edgesPerCycle > 0) ? edgesPerCycle : 1;
+  lastZeroCrossUs = nowUs();
+  pinMode(pin, INPUT);
+  attachInterruptArg(digitalPinToInterrupt(pin), &BurstFireDriver::onZeroCrossISR, this, RISING);
+}
+
+void BurstFireDriver::setFraction(float fraction) {
+  float perMille = fraction * BurstUtils::level_scale;
+  uint16_t level = (perMille <= 0.0f) ? 0 : (perMille >= BurstUtils::level_scale) ? BurstUtils::level_scale : static_cast<uint16_t>(lroundf(perMille));
+  portENTER_CRITICAL(&mux);
+  pattern.setLevel(level);
+  portEXIT_CRITICAL(&mux);
+}
+
+float BurstFireDriver::fraction() { return static_cast<float>(pattern.level()) / BurstUtils::level_scale; }
+
+void IRAM_ATTR BurstFireDriver::onTimerISR(void *arg) {
+  BurstFireDriver *driver = static_cast<BurstFireDriver *>(arg);
+  if (driver->edgesPerCycle > 0) {
+    if (nowUs() - driver->lastZeroCrossUs < driver->cycleUs * BurstFireUtils::zero_cross_timeout_pct / 100) return; // phase-locked
+    driver->missedZeroCrossings = driver->missedZeroCrossings + 1;
+  }
+  driver->step();
+}
+
+void IRAM_ATTR BurstFireDriver::onZeroCrossISR(void *arg) {
+  BurstFireDriver *driver = static_cast<BurstFireDriver *>(arg);
+  driver->lastZeroCrossUs = nowUs();
+  uint8_t edges = driver->zeroCrossEdges + 1;
+  if (edges < driver->edgesPerCycle) {
+    driver->zeroCrossEdges = edges;
+    return;
+  }
+  driver->zeroCrossEdges = 0;
+  driver->step();
+}
+
+void IRAM_ATTR BurstFireDriver::step() {
+  portENTER_CRITICAL_ISR(&mux);
+  bool on = pattern.next();
+  portEXIT_CRITICAL_ISR(&mux);
+  writer(on);
+}
+
+uint32_t BurstFireDriver::cycleCount() {
+  portENTER_CRITICAL(&mux);
+  uint32_t cycles = pattern.cycleCount();
+  portEXIT_CRITICAL(&mux);
+  return cycles;
+}
+
+float BurstFireDriver::switchingEventsPerMinute() {
+  portENTER_CRITICAL(&mux);
+  uint32_t cycles = pattern.cycleCount();
+  uint32_t switchings = pattern.switchingCount();
+  portEXIT_CRITICAL(&mux);
+  return (cycles > 0) ? 60.0f * mainsHz * static_cast<float>(switchings) / static_cast<float>(cycles) : 0.0f;
+}
+
+float BurstFireDriver::powerError() {
+  portENTER_CRITICAL(&mux);
+  int32_t errorPerMille = pattern.energyErrorPerMille();
+  uint32_t onCycles = pattern.onCycleCount();
+  portEXIT_CRITICAL(&mux);
+  float requested = static_cast<float>(onCycles) * BurstUtils::level_scale - static_cast<float>(errorPerMille);
+  return (requested > 0.0f) ? static_cast<float>(errorPerMille) / requested : 0.0f;
+}
+
+uint32_t BurstFireDriver::missedZeroCrossCount() { return missedZeroCrossings; }
+
+void BurstFireDriver::resetStats() {
+  portENTER_CRITICAL(&mux);
+  pattern.resetStats();
+  missedZeroCrossings = 0;
+  portEXIT_CRITICAL(&mux);
+}
+
+void BurstFireDriver::printStats() {
+  Serial.print(F("Burst fire: fraction "));
+  Serial.print(fraction(), 3);
+  Serial.print(F(", "));
+  Serial.print(cycleCount());
+  Serial.print(F(" cycles, "));
+  Serial.print(switchingEventsPerMinute(), 1);
+  Serial.print(F(" switching events/min, power error "));
+  Serial.print(100.0f * powerError(), 3);
+  Serial.print(F("%"));
+  if (edgesPerCycle > 0) {
+    Serial.print(F(", "));
+    Serial.print(missedZeroCrossings);
+    Serial.print(F(" missed zero crossings"));
+  }
+  Serial.println();
+}
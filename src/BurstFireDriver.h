@@ -0,0 +1,69 @@
+#pragma once
+#include "BurstPattern.h"
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h> // For portMUX_TYPE
+
+namespace BurstFireUtils {
+  constexpr uint32_t zero_cross_timeout_pct = 150; // without a zero crossing for 1.5 cycles, the timer takes over
+}
+
+// Switches the load for one mains cycle; called from an interrupt handler, hence must reside in IRAM
+typedef void (*BurstWriter)(bool on);
+
+class BurstFireDriver {
+
+  // CLASS BurstFireDriver
+  //
+  // Actuator of a power fraction on a zero-crossing solid-state relay (e.g. the OMRON G3MB-202P): once per
+  // mains cycle, an interrupt handler steps a `BurstPattern` and writes the load through a `BurstWriter`.
+  // The loop only sets the fraction; the timing does not depend on the loop.
+  //
+  // Whole cycles (rather than half-cycles) are switched, so every burst conducts as many positive as
+  // negative half-waves and draws no DC from the mains. The relay itself turns on at the next zero crossing
+  // and off at the next zero current, hence the cycles are whole even if the write is not aligned with
+  // the mains. Free-running, the cycles are timed by a hardware timer at the nominal mains frequency, which
+  // drifts against the mains: about once every few minutes, a decision then straddles a zero crossing and
+  // the burst is one half-cycle off. With a zero-cross detector attached (`attachZeroCross()`), the pattern
+  // is phase-locked to the mains instead, and the timer only takes over while zero crossings are missing.
+  //
+  // Statistics count since `begin()` or the latest `resetStats()`.
+
+  public:
+  BurstFireDriver(BurstWriter writer, uint8_t mainsHz); // constructor
+
+  void begin(); // starts the hardware timer (the fraction is 0 until set)
+  // Phase-locks to a zero-cross detector on `pin`, which signals `edgesPerCycle` rising edges per mains
+  // cycle (2 for a detector that pulses at every zero crossing, 1 for one that marks a half-wave)
+  void attachZeroCross(uint8_t pin, uint8_t edgesPerCycle);
+
+  void setFraction(float fraction); // share of full power, 0..1 (in steps of 1/1000)
+  float fraction();
+
+  // Statistics
+  uint32_t cycleCount();
+  float switchingEventsPerMinute(); // transitions of the load, per minute of mains cycles
+  float powerError();               // delivered minus requested energy, as a share of the energy requested
+  uint32_t missedZeroCrossCount();  // cycles timed by the timer while a zero-cross detector is attached
+  void resetStats();
+  void printStats(); // prints the statistics to the Serial console
+
+  private:
+  static void onTimerISR(void *arg);
+  static void onZeroCrossISR(void *arg);
+  void step(); // called from the ISRs
+
+  // behavioral parameters are lifetime-constants (provided at construction)
+  const BurstWriter writer;
+  const uint8_t mainsHz;
+  const uint32_t cycleUs;
+
+  // dynamic state parameters; shared with the ISRs
+  BurstPattern pattern;
+  portMUX_TYPE mux;
+  volatile uint32_t lastZeroCrossUs;
+  volatile uint8_t zeroCrossEdges; // edges since the latest step
+  uint8_t edgesPerCycle;           // 0: no zero-cross detector attached
+
+  // statistics
+  volatile uint32_t missedZeroCrossings;
+};
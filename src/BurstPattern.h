@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+
+// Burst-fire pattern of whole mains cycles for a zero-crossing solid-state relay: a power level is
+// produced by conducting a share of the cycles, and blocking the others.
+//
+// This header does not depend on the Arduino framework, so patterns can be generated and checked on the
+// host. It is header-only: `next()` is inlined into the interrupt handler that steps it.
+namespace BurstUtils {
+  constexpr uint16_t level_scale = 1000; // power levels are in 1/1000 of full power
+}
+
+class BurstPattern {
+
+  // CLASS BurstPattern
+  //
+  // Distributes the conducting cycles of a power level with a first-order error diffusion (Bresenham's line
+  // algorithm): every cycle adds the level to an accumulator, and a cycle conducts whenever the accumulator
+  // reaches full scale. The conducting cycles are spread as evenly as possible, which gives the lowest
+  // flicker. The switching events per cycle are the fewest an even spread can have: at levels up to one
+  // half, every conducting cycle stands alone, above one half, every blocking cycle. The delivered energy
+  // never deviates from the requested energy by a full cycle; the remainder carries over a change of the
+  // level, so a level that changes every few cycles is still delivered on average.
+  //
+  // Statistics count since the construction or the latest `resetStats()`.
+
+  public:
+  BurstPattern() : levelPerMille(0), accumulator(0), on(false), cycles(0), onCycles(0), switchings(0), requested(0) {}
+
+  void setLevel(uint16_t perMille) { levelPerMille = (perMille > BurstUtils::level_scale) ? BurstUtils::level_scale : perMille; }
+  uint16_t level() const { return levelPerMille; }
+
+  // Decides the next cycle; returns true if it conducts
+  bool next() {
+    accumulator += levelPerMille;
+    bool conducts = (accumulator >= BurstUtils::level_scale);
+    if (conducts) accumulator -= BurstUtils::level_scale;
+    if (conducts != on) switchings++;
+    on = conducts;
+    cycles++;
+    if (conducts) onCycles++;
+    requested += levelPerMille;
+    return conducts;
+  }
+
+  // Statistics
+  uint32_t cycleCount() const { return cycles; }
+  uint32_t onCycleCount() const { return onCycles; }
+  uint32_t switchingCount() const { return switchings; } // transitions between conducting and blocking cycles
+  // delivered minus requested energy, in 1/1000 of a cycle at full power (within ±1000)
+  int32_t energyErrorPerMille() const { return static_cast<int32_t>(static_cast<int64_t>(onCycles) * BurstUtils::level_scale - static_cast<int64_t>(requested)); }
+  void resetStats() {
+    cycles = 0;
+    onCycles = 0;
+    switchings = 0;
+    requested = 0;
+  }
+
+  private:
+  // dynamic state parameters
+  uint16_t levelPerMille;
+  uint16_t accumulator; // below `level_scale` between two cycles
+  bool on;
+
+  // statistics
+  uint32_t cycles;
+  uint32_t onCycles;
+  uint32_t switchings;
+  uint64_t requested; // sum of the levels of all cycles [1/1000 cycle]
+};
@@ -0,0 +1,212 @@
+#include "CommandProtocol.h"
+#include <cstring> // For memcpy()
+
+namespace {
+  // CRC-16/CCITT-FALSE (polynomial 0x1021) of one nibble: two lookups per byte instead of eight shifts, with a
+  // table of 32 bytes instead of 512 for a whole byte
+  const uint16_t crcNibbleTable[16] = {
+      0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+      0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF};
+}
+
+uint16_t commandCrc16(const uint8_t *data, size_t length, uint16_t crc /* = 0xFFFF */) {
+  while (length--) {
+    uint8_t byte = *data++;
+    crc = static_cast<uint16_t>((crc << 4) ^ crcNibbleTable[(crc >> 12) ^ (byte >> 4)]);
+    crc = static_cast<uint16_t>((crc << 4) ^ crcNibbleTable[(crc >> 12) ^ (byte & 0x0F)]);
+  }
+  return crc;
+}
+
+size_t encodeCommandFrame(uint8_t command, uint8_t sequence, const uint8_t *payload, uint8_t length, uint8_t *out) {
+  if (length > CommandUtils::max_payload) return 0;
+  out[0] = CommandUtils::sync_0;
+  out[1] = CommandUtils::sync_1;
+  out[2] = length;
+  out[3] = command;
+  out[4] = sequence;
+  if (length > 0) memcpy(&out[CommandUtils::header_bytes], payload, length);
+  size_t size = CommandUtils::header_bytes + length;
+  uint16_t crc = commandCrc16(&out[2], size - 2);
+  out[size++] = static_cast<uint8_t>(crc & 0xFF);
+  out[size++] = static_cast<uint8_t>(crc >> 8);
+  return size;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                     CLASS CommandParser                                        *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// One state per field of the frame; the CRC is updated byte by byte, so a complete frame is checked
+// without a second pass over it.
+
+// constructor:
+CommandParser::CommandParser()
+    : state(StateSync0),
+      received(0),
+      crc(0xFFFF),
+      frameCrc(0),
+      lastByteMs(0),
+      current{},
+      frames(0),
+      crcErrors(0),
+      dropped(0) {
+}
+
+bool CommandParser::feed(uint8_t byte, uint32_t nowMs) {
+  if ((state != StateSync0) && (nowMs - lastByteMs > CommandUtils::byte_timeout_ms)) {
+    dropped++;
+    state = StateSync0;
+  }
+  lastByteMs = nowMs;
+
+  switch (state) {
+    case StateSync0:
+      if (byte == CommandUtils::sync_0) state = StateSync1;
+      return false;
+    case StateSync1:
+      if (byte == CommandUtils::sync_1) {
+        state = StateLength;
+      } else if (byte != CommandUtils::sync_0) { // a repeated first sync byte may still start a frame
+        state = StateSync0;
+      }
+      return false;
+    case StateLength:
+      if (byte > CommandUtils::max_payload) {
+        dropped++;
+        state = StateSync0;
+        return false;
+      }
+      current.length = byte;
+      received = 0;
+      crc = commandCrc16(&byte, 1);
+      state = StateCommand;
+      return false;
+    case StateCommand:
+      current.command = byte;
+      crc = commandCrc16(&byte, 1, crc);
+      state = StateSequence;
+      return false;
+    case StateSequence:
+      current.sequence = byte;
+      crc = commandCrc16(&byte, 1, crc);
+      state = (current.length > 0) ? StatePayload : StateCrc0;
+      return false;
+    case StatePayload:
+      current.payload[received++] = byte;
+      crc = commandCrc16(&byte, 1, crc);
+      if (received == current.length) state = StateCrc0;
+      return false;
+    case StateCrc0:
+      frameCrc = byte;
+      state = StateCrc1;
+      return false;
+    case StateCrc1:
+      frameCrc |= static_cast<uint16_t>(byte) << 8;
+      state = StateSync0;
+      if (frameCrc != crc) {
+        crcErrors++;
+        return false;
+      }
+      frames++;
+      return true;
+    default:
+      state = StateSync0;
+      return false;
+  }
+}
+
+const CommandFrame &CommandParser::frame() { return current; }
+
+void CommandParser::reset() { state = StateSync0; }
+
+uint32_t CommandParser::frameCount() { return frames; }
+
+uint32_t CommandParser::crcErrorCount() { return crcErrors; }
+
+uint32_t CommandParser::droppedCount() { return dropped; }
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                     CLASS PayloadWriter                                        *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+// constructor:
+PayloadWriter::PayloadWriter(uint8_t *buffer, uint8_t capacity)
+    : buffer(buffer),
+      capacity(capacity),
+      written(0),
+      overflow(false) {
+}
+
+void PayloadWriter::putU8(uint8_t value) { putBytes(&value, 1); }
+
+void PayloadWriter::putU16(uint16_t value) {
+  uint8_t bytes[2] = {static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8)};
+  putBytes(bytes, sizeof(bytes));
+}
+
+void PayloadWriter::putU32(uint32_t value) {
+  uint8_t bytes[4] = {static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 24)};
+  putBytes(bytes, sizeof(bytes));
+}
+
+void PayloadWriter::putFloat(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  putU32(bits);
+}
+
+void PayloadWriter::putBytes(const uint8_t *data, uint8_t length) {
+  if (length > capacity - written) {
+    overflow = true;
+    return;
+  }
+  memcpy(&buffer[written], data, length);
+  written += length;
+}
+
+uint8_t PayloadWriter::length() { return written; }
+
+bool PayloadWriter::overflowed() { return overflow; }
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                     CLASS PayloadReader                                        *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+// constructor:
+PayloadReader::PayloadReader(const uint8_t *data, uint8_t length)
+    : data(data),
+      length(length),
+      position(0) {
+}
+
+bool PayloadReader::getU8(uint8_t &value) {
+  if (remaining() < 1) return false;
+  value = data[position++];
+  return true;
+}
+
+bool PayloadReader::getU16(uint16_t &value) {
+  if (remaining() < 2) return false;
+  value = static_cast<uint16_t>(data[position] | (data[position + 1] << 8));
+  position += 2;
+  return true;
+}
+
+bool PayloadReader::getU32(uint32_t &value) {
+  if (remaining() < 4) return false;
+  value = static_cast<uint32_t>(data[position]) | (static_cast<uint32_t>(data[position + 1]) << 8) |
+          (static_cast<uint32_t>(data[position + 2]) << 16) | (static_cast<uint32_t>(data[position + 3]) << 24);
+  position += 4;
+  return true;
+}
+
+bool PayloadReader::getFloat(float &value) {
+  uint32_t bits;
+  if (!getU32(bits)) return false;
+  memcpy(&value, &bits, sizeof(value));
+  return true;
+}
+
+const uint8_t *PayloadReader::remainingData() { return &data[position]; }
+
+uint8_t PayloadReader::remaining() { return length - position; }
@@ -0,0 +1,148 @@
+#pragma once
+#include <Arduino.h>
+
+// Framed binary command protocol on the serial console. A frame is
+//
+//   0xA5 0x5A | length | command | sequence | payload[length] | CRC-16 (low byte first)
+//
+// with the CRC-16/CCITT-FALSE over length, command, sequence and payload. A response carries the command
+// of the request with `response_flag` set and the same sequence number; its first payload byte is the
+// `CommandStatus`. Messages the controller sends on its own also carry `response_flag`, but no status.
+// Multi-byte values are little-endian, floats are IEEE 754 single precision.
+//
+// Frames share the console with the text output of the controller: a reader skips everything outside
+// of a frame, and the CRC rejects text that happens to contain the sync bytes.
+namespace CommandUtils {
+  constexpr uint8_t sync_0 = 0xA5;
+  constexpr uint8_t sync_1 = 0x5A;
+  constexpr uint8_t header_bytes = 5;                                        // sync 0, sync 1, length, command, sequence
+  constexpr uint8_t crc_bytes = 2;                                           // CRC-16 after the payload
+  constexpr uint8_t max_payload = 120;                                       // payload bytes per frame
+  constexpr uint8_t max_frame_bytes = header_bytes + max_payload + crc_bytes; // frame with the longest payload
+  constexpr uint8_t response_flag = 0x80;                                    // set in the command of a response
+  constexpr uint32_t byte_timeout_ms = 100;                                  // a frame stalling longer between two bytes is dropped
+}
+
+// Commands of the controller; payloads of request -> response (the response payload follows the status)
+enum CommandId : uint8_t {
+  CommandPing = 0x01,          // any bytes -> the same bytes
+  CommandGetState = 0x02,      // - -> u8 zones, u32 heater faults, per zone: f32 temperature, f32 setpoint, u8 flags (bit 0: load on, bit 1: demand), u8 faults
+  CommandSetSetpoint = 0x03,   // u8 zone, f32 setpoint [°C] -> -
+  CommandGetMetrics = 0x04,    // - -> u32 uptime [ms], u32 free heap, u32 minimum free heap, f32 loop time p50, p90, p99 [us], u32 events dispatched, u32 events dropped, u32 commands, u32 rejected frames
+  CommandRescanSensors = 0x05, // - -> - (the bus is scanned once the current measurement is complete; results on the console)
+  CommandMirrorDisplay = 0x06, // u8 enable, u16 minimum interval between frames [ms] -> - (see `FrameMirror`)
+  CommandGetSnapshot = 0x07,   // - -> the `ControllerSnapshot` as is (see src/ControllerSnapshot.h)
+  CommandExportSeries = 0x08,  // - -> u32 pages to follow as `MessageSeriesPage` (Busy while an export runs; see `SeriesExport`)
+  CommandClearFaults = 0x09,   // - -> u32 heater faults that were latched (now cleared; the load stays off until requested again)
+
+  // messages sent by the controller on its own (with `response_flag`)
+  MessageDisplayFrame = 0x40, // sequence: frame number; u8 encoding, u8 chunk, u8 chunks, u8 tile width, u8 tile height, u8 flags, encoded data
+  MessageSeriesPage = 0x41,   // sequence: low byte of the page sequence; u8 chunk, u8 chunks (0: end of the export), page data (see src/SeriesCodec.h)
+};
+
+enum CommandStatus : uint8_t {
+  CommandOk = 0,
+  CommandUnknown = 1,    // no handler for the command
+  CommandBadPayload = 2, // request payload too short, or a value out of range
+  CommandBusy = 3,       // the command cannot be executed now; retry later
+};
+
+struct CommandFrame {
+  uint8_t command;
+  uint8_t sequence;
+  uint8_t length;
+  uint8_t payload[CommandUtils::max_payload];
+};
+
+uint16_t commandCrc16(const uint8_t *data, size_t length, uint16_t crc = 0xFFFF);
+
+// Writes a frame to `out` (at least `header_bytes + length + crc_bytes` bytes). Returns the size of the
+// frame, or 0 if the payload is too long. `payload` may be null for an empty payload.
+size_t encodeCommandFrame(uint8_t command, uint8_t sequence, const uint8_t *payload, uint8_t length, uint8_t *out);
+
+class CommandParser {
+
+  // CLASS CommandParser
+  //
+  // Incremental parser of frames: `feed()` takes one byte at a time, so a frame may arrive in any number of
+  // chunks, and never blocks. Bytes outside of a frame are skipped. A frame with a wrong CRC or a payload
+  // longer than `max_payload` is dropped, and the parser resynchronizes on the next sync bytes; so is a
+  // frame that stalls for more than `byte_timeout_ms` between two bytes.
+
+  public:
+  CommandParser(); // constructor
+
+  bool feed(uint8_t byte, uint32_t nowMs); // returns true once a frame is complete; it is valid until the next `feed()`
+  const CommandFrame &frame();             // latest complete frame
+  void reset();                            // drops a partially received frame
+
+  // Statistics
+  uint32_t frameCount();    // complete frames
+  uint32_t crcErrorCount(); // frames dropped for a wrong CRC
+  uint32_t droppedCount();  // frames dropped for an oversized payload or a timeout
+
+  private:
+  enum _state : uint8_t {
+    StateSync0 = 0,
+    StateSync1 = 1,
+    StateLength = 2,
+    StateCommand = 3,
+    StateSequence = 4,
+    StatePayload = 5,
+    StateCrc0 = 6,
+    StateCrc1 = 7
+  };
+
+  // dynamic state parameters
+  _state state;
+  uint8_t received; // payload bytes received
+  uint16_t crc;     // running CRC of the frame
+  uint16_t frameCrc;
+  uint32_t lastByteMs;
+  CommandFrame current;
+
+  // statistics
+  uint32_t frames;
+  uint32_t crcErrors;
+  uint32_t dropped;
+};
+
+// Appends little-endian values to a payload; writes beyond the capacity are dropped and flagged
+class PayloadWriter {
+  public:
+  PayloadWriter(uint8_t *buffer, uint8_t capacity); // constructor
+
+  void putU8(uint8_t value);
+  void putU16(uint16_t value);
+  void putU32(uint32_t value);
+  void putFloat(float value);
+  void putBytes(const uint8_t *data, uint8_t length);
+
+  uint8_t length();
+  bool overflowed(); // true if a value did not fit
+
+  private:
+  uint8_t *const buffer;
+  const uint8_t capacity;
+  uint8_t written;
+  bool overflow;
+};
+
+// Reads little-endian values from a payload; reads beyond the end fail (and leave the value untouched)
+class PayloadReader {
+  public:
+  PayloadReader(const uint8_t *data, uint8_t length); // constructor
+
+  bool getU8(uint8_t &value);
+  bool getU16(uint16_t &value);
+  bool getU32(uint32_t &value);
+  bool getFloat(float &value);
+
+  const uint8_t *remainingData();
+  uint8_t remaining();
+
+  private:
+  const uint8_t *const data;
+  const uint8_t length;
+  uint8_t position;
+};
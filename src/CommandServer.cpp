@@ -0,0 +1,83 @@
+#include "CommandServer.h"
+#include <esp_timer.h> // For esp_timer_get_time()
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                     CLASS CommandServer                                        *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Command dispatch on the controller loop. The table is searched linearly: it holds a handful of commands.
+
+// constructor:
+CommandServer::CommandServer(Stream &stream, const CommandEntry *table, uint8_t tableSize)
+    : stream(stream),
+      table(table),
+      tableSize(tableSize),
+      commands(0),
+      droppedResponses(0),
+      maxDispatch(0) {
+}
+
+uint8_t CommandServer::checkInput() {
+  uint8_t dispatched = 0;
+  int available = stream.available();
+  if (available <= 0) return 0;
+  if (available > CommandServerUtils::max_bytes_per_check) available = CommandServerUtils::max_bytes_per_check;
+
+  uint32_t nowMs = static_cast<uint32_t>(esp_timer_get_time() / 1000LL);
+  while (available-- > 0) {
+    int byte = stream.read();
+    if (byte < 0) break;
+    if (parser.feed(static_cast<uint8_t>(byte), nowMs)) {
+      dispatch(parser.frame());
+      dispatched++;
+    }
+  }
+  return dispatched;
+}
+
+void CommandServer::dispatch(const CommandFrame &request) {
+  int64_t startUs = esp_timer_get_time();
+  if (request.command & CommandUtils::response_flag) return; // a response (e.g. echoed by a terminal): not for us
+  commands++;
+
+  // the first payload byte of the response is the status; the handler writes the rest
+  PayloadReader reader(request.payload, request.length);
+  PayloadWriter writer(&responsePayload[1], CommandUtils::max_payload - 1);
+  CommandStatus status = CommandStatus::CommandUnknown;
+  for (uint8_t i = 0; i < tableSize; i++) {
+    if (table[i].command != request.command) continue;
+    status = table[i].handler(reader, writer);
+    break;
+  }
+  responsePayload[0] = status;
+  uint8_t length = (status == CommandStatus::CommandOk) ? 1 + writer.length() : 1;
+
+  size_t size = encodeCommandFrame(request.command | CommandUtils::response_flag, request.sequence, responsePayload, length, responseFrame);
+  if (stream.availableForWrite() < static_cast<int>(size)) {
+    droppedResponses++;
+    return;
+  }
+  stream.write(responseFrame, size);
+
+  uint32_t dispatchUs = static_cast<uint32_t>(esp_timer_get_time() - startUs);
+  if (dispatchUs > maxDispatch) maxDispatch = dispatchUs;
+}
+
+uint32_t CommandServer::commandCount() { return commands; }
+
+uint32_t CommandServer::rejectedFrameCount() { return parser.crcErrorCount() + parser.droppedCount(); }
+
+uint32_t CommandServer::droppedResponseCount() { return droppedResponses; }
+
+uint32_t CommandServer::maxDispatchUs() { return maxDispatch; }
+
+void CommandServer::printStats() {
+  Serial.print(F("Commands: "));
+  Serial.print(commands);
+  Serial.print(F(" dispatched, "));
+  Serial.print(rejectedFrameCount());
+  Serial.print(F(" frames rejected, "));
+  Serial.print(droppedResponses);
+  Serial.print(F(" responses dropped, max dispatch "));
+  Serial.print(maxDispatch);
+  Serial.println(F(" us"));
+}
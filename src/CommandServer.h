@@ -0,0 +1,59 @@
+#pragma once
+#include "CommandProtocol.h"
+#include <Arduino.h>
+
+namespace CommandServerUtils {
+  constexpr uint8_t max_bytes_per_check = 64; // bytes read from the stream per loop pass (bounds the time per pass)
+}
+
+// Handler of a command: reads the request payload, writes the response payload; returns the status
+typedef CommandStatus (*CommandHandler)(PayloadReader &request, PayloadWriter &response);
+
+struct CommandEntry {
+  uint8_t command; // `CommandId`
+  CommandHandler handler;
+};
+
+class CommandServer {
+
+  // CLASS CommandServer
+  //
+  // Serves the command protocol (see `CommandProtocol.h`) on a stream, typically `Serial`. The loop function
+  // `checkInput()` reads whatever bytes are available (at most `max_bytes_per_check`), feeds them to the
+  // parser, and dispatches a complete frame through the command table to its handler. The response is
+  // written only if it fits into the stream's transmit buffer, so a host that does not read never blocks
+  // the loop; such a response is dropped and counted.
+  //
+  // The command table is typically a `constexpr` array of `CommandEntry`, hence resides in flash. Requests
+  // and responses are parsed and built in fixed buffers of this class: there is no heap allocation.
+
+  public:
+  CommandServer(Stream &stream, const CommandEntry *table, uint8_t tableSize); // constructor
+
+  uint8_t checkInput(); // Loop function: reads available input; returns the number of commands dispatched
+
+  // Statistics
+  uint32_t commandCount();         // commands dispatched
+  uint32_t rejectedFrameCount();   // frames dropped by the parser (wrong CRC, oversized, timed out)
+  uint32_t droppedResponseCount(); // responses that did not fit into the transmit buffer
+  uint32_t maxDispatchUs();        // longest time from a complete frame to the response written [microseconds]
+  void printStats();               // prints the statistics to the Serial console
+
+  private:
+  void dispatch(const CommandFrame &request);
+
+  // behavioral parameters are lifetime-constants (provided at construction)
+  Stream &stream;
+  const CommandEntry *const table;
+  const uint8_t tableSize;
+
+  // dynamic state parameters
+  CommandParser parser;
+  uint8_t responsePayload[CommandUtils::max_payload];
+  uint8_t responseFrame[CommandUtils::max_frame_bytes];
+
+  // statistics
+  uint32_t commands;
+  uint32_t droppedResponses;
+  uint32_t maxDispatch;
+};
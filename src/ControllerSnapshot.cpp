@@ -0,0 +1,79 @@
+#include "ControllerSnapshot.h"
+#include <cstring> // For memcpy(), memset()
+
+#define SNAPSHOT_FIELD(name, type, count, since) {#name, static_cast<uint8_t>(offsetof(ControllerSnapshot, name)), type, count, since}
+
+const SnapshotField snapshotSchema[] = {
+    SNAPSHOT_FIELD(uptimeMs, SnapshotU32, 1, 1),
+    SNAPSHOT_FIELD(zoneCount, SnapshotU8, 1, 1),
+    SNAPSHOT_FIELD(flags, SnapshotU8, 1, 1),
+    SNAPSHOT_FIELD(wifiDisconnectReason, SnapshotU8, 1, 1),
+    SNAPSHOT_FIELD(heaterFaults, SnapshotU32, 1, 1),
+    SNAPSHOT_FIELD(temperature, SnapshotTemperature, SnapshotUtils::max_zones, 1),
+    SNAPSHOT_FIELD(setpoint, SnapshotTemperature, SnapshotUtils::max_zones, 1),
+    SNAPSHOT_FIELD(zoneFlags, SnapshotU8, SnapshotUtils::max_zones, 1),
+    SNAPSHOT_FIELD(zoneFaults, SnapshotU8, SnapshotUtils::max_zones, 1),
+    SNAPSHOT_FIELD(heaterPowerFraction, SnapshotF32, 1, 1),
+    SNAPSHOT_FIELD(heaterEnergyKWh, SnapshotF32, 1, 1),
+    SNAPSHOT_FIELD(heaterSwitchCount, SnapshotU32, 1, 1),
+    SNAPSHOT_FIELD(heaterHourDuty, SnapshotF32, 1, 1),
+    SNAPSHOT_FIELD(loopTimeP50Us, SnapshotF32, 1, 1),
+    SNAPSHOT_FIELD(loopTimeP90Us, SnapshotF32, 1, 1),
+    SNAPSHOT_FIELD(loopTimeP99Us, SnapshotF32, 1, 1),
+    SNAPSHOT_FIELD(eventsDispatched, SnapshotU32, 1, 1),
+    SNAPSHOT_FIELD(eventsDropped, SnapshotU32, 1, 1),
+    SNAPSHOT_FIELD(commands, SnapshotU32, 1, 1),
+    SNAPSHOT_FIELD(rejectedFrames, SnapshotU32, 1, 1),
+    SNAPSHOT_FIELD(freeHeapBytes, SnapshotU32, 1, 1),
+    SNAPSHOT_FIELD(minimumFreeHeapBytes, SnapshotU32, 1, 1)};
+
+const uint8_t snapshotFieldCount = sizeof(snapshotSchema) / sizeof(snapshotSchema[0]);
+
+void beginSnapshot(ControllerSnapshot &snapshot, uint32_t uptimeMs) {
+  snapshot.version = SnapshotUtils::schema_version;
+  snapshot.size = sizeof(ControllerSnapshot);
+  snapshot.sequence++;
+  snapshot.uptimeMs = uptimeMs;
+}
+
+// A snapshot of an older version is shorter: its fields are a prefix of the current record. A newer one is
+// longer: the fields beyond the current record are skipped.
+bool decodeSnapshot(const uint8_t *data, size_t length, ControllerSnapshot &snapshot) {
+  if (length < SnapshotUtils::header_bytes) return false;
+  uint8_t version = data[0], size = data[1];
+  if ((version == 0) || (size < SnapshotUtils::header_bytes) || (size > length)) return false;
+  size_t copied = min(static_cast<size_t>(size), sizeof(ControllerSnapshot));
+  memset(&snapshot, 0, sizeof(ControllerSnapshot));
+  memcpy(&snapshot, data, copied);
+  return true;
+}
+
+bool isFieldPresent(const ControllerSnapshot &snapshot, const SnapshotField &field) { return field.since <= snapshot.version; }
+
+double snapshotFieldValue(const ControllerSnapshot &snapshot, const SnapshotField &field, uint8_t index) {
+  const uint8_t *element = reinterpret_cast<const uint8_t *>(&snapshot) + field.offset;
+  switch (field.type) {
+    case SnapshotType::SnapshotU8: return element[index];
+    case SnapshotType::SnapshotU16: {
+      uint16_t value;
+      memcpy(&value, element + 2 * index, sizeof(value));
+      return value;
+    }
+    case SnapshotType::SnapshotU32: {
+      uint32_t value;
+      memcpy(&value, element + 4 * index, sizeof(value));
+      return value;
+    }
+    case SnapshotType::SnapshotF32: {
+      float value;
+      memcpy(&value, element + 4 * index, sizeof(value));
+      return value;
+    }
+    case SnapshotType::SnapshotTemperature: {
+      int16_t value;
+      memcpy(&value, element + 2 * index, sizeof(value));
+      return snapshotCelsius(value);
+    }
+  }
+  return NAN;
+}
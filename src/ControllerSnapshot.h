@@ -0,0 +1,116 @@
+#pragma once
+#include "CommandProtocol.h" // For CommandUtils::max_payload
+#include <Arduino.h>
+#include <cstddef> // For offsetof()
+
+namespace SnapshotUtils {
+  constexpr uint8_t schema_version = 1;          // incremented whenever fields are appended
+  constexpr uint8_t max_zones = 8;               // as `ZoneUtils::max_zones`
+  constexpr uint8_t header_bytes = 8;            // version, size, sequence, uptime: present in every version
+  constexpr int16_t temperature_scale = 16;      // temperatures in 1/16 °C (the DS18B20 resolution)
+  constexpr int16_t no_temperature = INT16_MIN;  // zone without a valid reading
+
+  // flags
+  constexpr uint8_t flag_heating = 0x01;         // the burst fire modulates the heater
+  constexpr uint8_t flag_load_on = 0x02;         // EXT_LOAD_SWITCH is on (at the moment of the snapshot)
+  constexpr uint8_t flag_wifi_connected = 0x04;
+  // zone flags
+  constexpr uint8_t zone_load_on = 0x01;
+  constexpr uint8_t zone_demand = 0x02;
+}
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "the snapshot is little-endian and copied as is");
+
+// State of the controller in one packed, little-endian record, built in place once per loop pass. Consumers
+// (commands, console, tools) share it and copy it as is; the host decodes it with `decodeSnapshot()`.
+//
+// Schema evolution: fields are only ever appended, never removed, reordered or resized, and every append
+// increments `schema_version`. A decoder takes the fields a snapshot holds (as told by `size`) and zeroes the
+// others; fields newer than the version of a snapshot are not present (see `SnapshotField::since`).
+struct __attribute__((packed)) ControllerSnapshot {
+  // header
+  uint8_t version;   // `schema_version` of the sender
+  uint8_t size;      // bytes of the snapshot, header included
+  uint16_t sequence; // snapshots built since boot (wrapping)
+  uint32_t uptimeMs;
+
+  // version 1
+  uint8_t zoneCount;
+  uint8_t flags;                // `flag_...`
+  uint8_t wifiDisconnectReason; // reason of the latest disconnect (wifi_err_reason_t); 0 while connected
+  uint32_t heaterFaults;        // latched `HeaterFault` flags
+  int16_t temperature[SnapshotUtils::max_zones]; // [1/16 °C]; `no_temperature` without a valid reading
+  int16_t setpoint[SnapshotUtils::max_zones];    // [1/16 °C]
+  uint8_t zoneFlags[SnapshotUtils::max_zones];   // `zone_...`
+  uint8_t zoneFaults[SnapshotUtils::max_zones];  // `ZoneFault` flags
+  float heaterPowerFraction;    // share of the mains cycles the SSR conducts
+  float heaterEnergyKWh;        // cumulative, across resets
+  uint32_t heaterSwitchCount;   // cumulative switch-ons of the SSR
+  float heaterHourDuty;         // duty cycle of the running hour [0..1]
+  float loopTimeP50Us;
+  float loopTimeP90Us;
+  float loopTimeP99Us;
+  uint32_t eventsDispatched;
+  uint32_t eventsDropped;
+  uint32_t commands;
+  uint32_t rejectedFrames;
+  uint32_t freeHeapBytes;
+  uint32_t minimumFreeHeapBytes;
+};
+
+// a snapshot is sent as the payload of one response, after the status byte
+static_assert(sizeof(ControllerSnapshot) <= CommandUtils::max_payload - 1, "the snapshot must fit into one frame");
+
+enum SnapshotType : uint8_t {
+  SnapshotU8 = 0,
+  SnapshotU16 = 1,
+  SnapshotU32 = 2,
+  SnapshotF32 = 3,
+  SnapshotTemperature = 4 // int16 in 1/16 °C, `no_temperature`: none
+};
+
+// Schema: one entry per field, in the order of the record
+struct SnapshotField {
+  const char *name;
+  uint8_t offset;
+  SnapshotType type;
+  uint8_t count; // elements (per zone: `max_zones`, of which `zoneCount` are valid)
+  uint8_t since; // schema version that appended the field
+};
+
+extern const SnapshotField snapshotSchema[];
+extern const uint8_t snapshotFieldCount;
+
+inline int16_t snapshotTemperature(float tempC) {
+  if (!isfinite(tempC)) return SnapshotUtils::no_temperature;
+  float scaled = tempC * SnapshotUtils::temperature_scale;
+  return (scaled >= INT16_MAX) ? INT16_MAX : (scaled <= INT16_MIN + 1) ? INT16_MIN + 1 : static_cast<int16_t>(lroundf(scaled));
+}
+
+// Starts a new snapshot in place: header of `schema_version`, next sequence number
+void beginSnapshot(ControllerSnapshot &snapshot, uint32_t uptimeMs);
+
+// Fills the zone fields from a `ZoneController` (a template, so the host decoder does not depend on it)
+template <typename Zones>
+void snapshotZones(ControllerSnapshot &snapshot, Zones &zones) {
+  uint8_t count = min(zones.zoneCount(), SnapshotUtils::max_zones);
+  snapshot.zoneCount = count;
+  for (uint8_t zone = 0; zone < SnapshotUtils::max_zones; zone++) {
+    bool valid = zone < count;
+    snapshot.temperature[zone] = valid ? snapshotTemperature(zones.temperatureC(zone)) : SnapshotUtils::no_temperature;
+    snapshot.setpoint[zone] = valid ? snapshotTemperature(zones.setpointC(zone)) : SnapshotUtils::no_temperature;
+    snapshot.zoneFlags[zone] = valid ? ((zones.isLoadOn(zone) ? SnapshotUtils::zone_load_on : 0) | (zones.hasDemand(zone) ? SnapshotUtils::zone_demand : 0)) : 0;
+    snapshot.zoneFaults[zone] = valid ? zones.faults(zone) : 0;
+  }
+}
+
+inline float snapshotCelsius(int16_t temperature) {
+  return (temperature == SnapshotUtils::no_temperature) ? NAN : static_cast<float>(temperature) / SnapshotUtils::temperature_scale;
+}
+
+// Decodes a received snapshot of any version into `snapshot`: the fields present are copied, the others
+// zeroed. Returns false if the data is shorter than the header or inconsistent with it.
+bool decodeSnapshot(const uint8_t *data, size_t length, ControllerSnapshot &snapshot);
+
+bool isFieldPresent(const ControllerSnapshot &snapshot, const SnapshotField &field); // the snapshot's version has the field
+double snapshotFieldValue(const ControllerSnapshot &snapshot, const SnapshotField &field, uint8_t index); // element as a number (temperatures in °C)
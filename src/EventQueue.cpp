@@ -0,0 +1,123 @@
+#include "EventQueue.h"
+#include <esp_timer.h> // For esp_timer_get_time()
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                       CLASS EventQueue                                         *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Bounded multi-producer / single-consumer ring buffer.
+//
+// Positions are free-running 32-bit counters; the cell of position `pos` is `cells[pos % capacity]`.
+// The sequence number of a cell encodes its state relative to a position:
+//   * sequence == pos:     the cell is free for the producer that claims position `pos`
+//   * sequence == pos + 1: the event at position `pos` has been published and may be consumed
+// After consuming, the consumer sets the sequence to `pos + capacity`, i.e. frees the cell for the
+// producer one lap ahead. A producer claims a position by advancing `enqueuePosition` with a
+// compare-and-swap, writes the event, and then publishes it by storing the sequence number. If an ISR
+// preempts a producer between claiming and publishing, the consumer simply stops at the unpublished
+// cell and picks up both events on its next pass.
+
+// constructor:
+EventQueue::EventQueue()
+    : enqueuePosition(0),
+      dequeuePosition(0),
+      handlers{},
+      overflows(0),
+      highWater(0),
+      dispatched(0),
+      maxLatency(0),
+      latency(0.05f) {
+  for (uint32_t i = 0; i < EventUtils::queue_capacity; i++) {
+    cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+bool IRAM_ATTR EventQueue::post(EventType type, uint8_t param /* = 0 */, int32_t value /* = 0 */) {
+  uint32_t pos = enqueuePosition.load(std::memory_order_relaxed);
+  Cell *cell;
+  while (true) {
+    cell = &cells[pos & (EventUtils::queue_capacity - 1)];
+    uint32_t sequence = cell->sequence.load(std::memory_order_acquire);
+    int32_t diff = static_cast<int32_t>(sequence - pos);
+    if (diff == 0) {
+      // cell is free: try to claim the position (on failure, `pos` is updated to the current value)
+      if (enqueuePosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (diff < 0) {
+      // cell still holds the event from one lap ago: queue is full
+      overflows.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      // another producer claimed this position in the meantime
+      pos = enqueuePosition.load(std::memory_order_relaxed);
+    }
+  }
+
+  cell->event.type = type;
+  cell->event.param = param;
+  cell->event.value = value;
+  cell->event.postedAtUs = static_cast<uint32_t>(esp_timer_get_time());
+  cell->sequence.store(pos + 1, std::memory_order_release); // publish
+
+  // high-water mark is a statistic only, hence races between producers are acceptable
+  uint32_t depth = pos + 1 - dequeuePosition.load(std::memory_order_relaxed);
+  if (depth > highWater.load(std::memory_order_relaxed)) highWater.store(depth, std::memory_order_relaxed);
+  return true;
+}
+
+void EventQueue::subscribe(EventType type, EventHandler handler) {
+  if (type >= EventType::Count) return;
+  handlers[static_cast<uint8_t>(type)] = handler;
+}
+
+uint8_t EventQueue::dispatch(uint8_t maxEvents /* = EventUtils::queue_capacity */) {
+  uint8_t count = 0;
+  while (count < maxEvents) {
+    uint32_t pos = dequeuePosition.load(std::memory_order_relaxed);
+    Cell &cell = cells[pos & (EventUtils::queue_capacity - 1)];
+    if (cell.sequence.load(std::memory_order_acquire) != pos + 1) break; // nothing (more) published
+
+    Event event = cell.event;
+    cell.sequence.store(pos + EventUtils::queue_capacity, std::memory_order_release); // free the cell
+    dequeuePosition.store(pos + 1, std::memory_order_relaxed);
+
+    uint32_t latencyUs = static_cast<uint32_t>(esp_timer_get_time()) - event.postedAtUs;
+    if (latencyUs > maxLatency) maxLatency = latencyUs;
+    latency.update(static_cast<float>(latencyUs));
+    dispatched++;
+    count++;
+
+    if (event.type >= EventType::Count) continue;
+    EventHandler handler = handlers[static_cast<uint8_t>(event.type)];
+    if (handler != nullptr) handler(event);
+  }
+  return count;
+}
+
+uint32_t EventQueue::depth() {
+  return enqueuePosition.load(std::memory_order_relaxed) - dequeuePosition.load(std::memory_order_relaxed);
+}
+
+uint32_t EventQueue::highWaterMark() { return highWater.load(std::memory_order_relaxed); }
+
+uint32_t EventQueue::overflowCount() { return overflows.load(std::memory_order_relaxed); }
+
+uint32_t EventQueue::dispatchedCount() { return dispatched; }
+
+uint32_t EventQueue::maxLatencyUs() { return maxLatency; }
+
+float EventQueue::averageLatencyUs() { return latency.value(); }
+
+void EventQueue::printStats() {
+  Serial.print(F("Events: dispatched "));
+  Serial.print(dispatched);
+  Serial.print(F(", depth "));
+  Serial.print(depth());
+  Serial.print(F(" (max "));
+  Serial.print(highWaterMark());
+  Serial.print(F("), overflows "));
+  Serial.print(overflowCount());
+  Serial.print(F(", latency avg "));
+  Serial.print(latency.value());
+  Serial.print(F(" us, max "));
+  Serial.print(maxLatency);
+  Serial.println(F(" us"));
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "Ewma.h"
+#include <Arduino.h>
+#include <atomic>
+
+namespace EventUtils {
+  constexpr uint32_t queue_capacity = 32; // number of events; must be a power of two
+  static_assert((queue_capacity & (queue_capacity - 1)) == 0, "queue_capacity must be a power of two");
+}
+
+// Types of events posted by ISRs and system callbacks. `Count` must remain the last entry.
+enum class EventType : uint8_t {
+  ButtonEdge = 0,                // GPIO edge on a push button (not debounced); `param` holds the GPIO, `value` the pin level read by the ISR
+  TemperatureConversionDone = 1, // DS18B20 conversion time has elapsed; the scratchpad can be read
+  WifiConnected = 2,             // station got an IP address
+  WifiDisconnected = 3,          // station lost the connection; `value` holds the reason code
+  Count
+};
+
+// Small fixed-size event. Events are copied into and out of the queue, i.e. they must not reference memory
+// owned by the poster.
+struct Event {
+  EventType type;
+  uint8_t param;
+  int32_t value;
+  uint32_t postedAtUs; // lower 32 bits of `esp_timer_get_time()` when posted (set by the queue)
+};
+
+typedef void (*EventHandler)(const Event &event);
+
+class EventQueue {
+
+  // CLASS EventQueue
+  //
+  // Allocation-free event bus: ISRs and system callbacks post events into a lock-free ring buffer (multiple
+  // producers); the controller `loop` (the single consumer) dispatches them to the handler subscribed for
+  // the event's type. This replaces spin-polling of hardware state: the loop learns about a change on its
+  // next pass, without having to query the hardware.
+  //
+  // The ring follows the bounded queue design by D. Vyukov: every cell carries a sequence number, which tells
+  // producers whether the cell is free and the consumer whether it has been published. Producers never block;
+  // if the ring is full, the event is dropped and counted as overflow. On the single-core ESP32-C3 (without
+  // the RISC-V atomic extension), the atomic operations are short interrupt-masked sequences, so `post()` is
+  // safe to call from ISRs and from other tasks.
+  //
+  // The queue records its depth, high-water mark, overflows and the latency between posting and dispatching,
+  // so event latency can be compared against the period of the polling loop.
+
+  public:
+  EventQueue(); // constructor
+
+  // Posts an event (safe to call from ISRs). Returns false if the queue is full and the event was dropped.
+  bool post(EventType type, uint8_t param = 0, int32_t value = 0);
+
+  // Subscribes `handler` to all events of the given type (replacing a previous handler).
+  // Events without handler are dispatched and discarded.
+  void subscribe(EventType type, EventHandler handler);
+
+  // Loop function: dispatches at most `maxEvents` pending events; returns the number dispatched.
+  uint8_t dispatch(uint8_t maxEvents = EventUtils::queue_capacity);
+
+  // Statistics
+  uint32_t depth();           // number of events currently pending
+  uint32_t highWaterMark();   // maximum depth observed by producers
+  uint32_t overflowCount();   // number of events dropped because the queue was full
+  uint32_t dispatchedCount(); // number of events dispatched
+  uint32_t maxLatencyUs();    // maximum latency between posting and dispatching [microseconds]
+  float averageLatencyUs();   // exponentially weighted average latency [microseconds]
+  void printStats();          // prints the statistics to the Serial console
+
+  private:
+  struct Cell {
+    std::atomic<uint32_t> sequence;
+    Event event;
+  };
+
+  Cell cells[EventUtils::queue_capacity];
+  std::atomic<uint32_t> enqueuePosition;
+  std::atomic<uint32_t> dequeuePosition;
+  EventHandler handlers[static_cast<uint8_t>(EventType::Count)];
+
+  // statistics
+  std::atomic<uint32_t> overflows;
+  std::atomic<uint32_t> highWater;
+  uint32_t dispatched;
+  uint32_t maxLatency;
+  Ewma latency;
+};
@@ -0,0 +1,144 @@
+#include "FlightRecorder.h"
+#include <atomic>      // For std::atomic_signal_fence()
+#include <cstring>     // For memset()
+#include <esp_timer.h> // For esp_timer_get_time()
+
+namespace {
+  constexpr uint32_t record_index_mask = FlightRecorderUtils::record_capacity - 1;
+  static_assert((FlightRecorderUtils::record_capacity & record_index_mask) == 0, "record_capacity must be a power of two");
+
+  // Names of the reset reasons, in the order of `esp_reset_reason_t` (ESP-IDF 5)
+  const char *const reset_reason_names[] = {"unknown", "power-on", "external pin", "software", "panic", "interrupt watchdog",
+                                            "task watchdog", "other watchdog", "deep sleep", "brownout", "SDIO", "USB",
+                                            "JTAG", "eFuse", "power glitch", "CPU lock-up"};
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                     CLASS FlightRecorder                                       *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// The log is valid if it carries the magic number; after power loss, the RTC memory holds arbitrary data,
+// and the log is initialized. Records are written before the head is advanced, so the head never points
+// past a partially written record.
+
+// constructor:
+FlightRecorder::FlightRecorder(FlightLog &log)
+    : log(log),
+      previousRecords(0) {
+}
+
+void FlightRecorder::begin(uint8_t resetReason) {
+  if (log.magic != FlightRecorderUtils::log_magic) {
+    memset(&log, 0, sizeof(FlightLog));
+    log.magic = FlightRecorderUtils::log_magic;
+  }
+  log.sessions++;
+  record(FlightEvent::FlightBoot, static_cast<uint8_t>(log.sessions), resetReason);
+  previousRecords = recordCount() - 1; // all but the boot record
+}
+
+void FlightRecorder::record(FlightEvent event, uint8_t param, int16_t value) {
+  FlightRecord &slot = log.records[log.head & record_index_mask];
+  slot.timeMs = static_cast<uint32_t>(esp_timer_get_time() / 1000LL);
+  slot.event = event;
+  slot.param = param;
+  slot.value = value;
+  std::atomic_signal_fence(std::memory_order_release); // the compiler must not advance the head before the record is stored
+  log.head++;
+}
+
+void FlightRecorder::recordTemperature(FlightEvent event, uint8_t zone, float tempC) {
+  float scaled = tempC * FlightRecorderUtils::temperature_scale;
+  int16_t value = (scaled >= INT16_MAX) ? INT16_MAX : (scaled <= INT16_MIN) ? INT16_MIN : static_cast<int16_t>(lroundf(scaled));
+  record(event, zone, value);
+}
+
+uint16_t FlightRecorder::recordCount() {
+  return (log.head < FlightRecorderUtils::record_capacity) ? static_cast<uint16_t>(log.head) : FlightRecorderUtils::record_capacity;
+}
+
+uint16_t FlightRecorder::previousCount() { return previousRecords; }
+
+void FlightRecorder::printLog() {
+  uint16_t count = recordCount();
+  Serial.print(F("Flight recorder: "));
+  Serial.print(count);
+  Serial.print(F(" records, "));
+  Serial.print(previousRecords);
+  Serial.println(F(" of previous sessions"));
+
+  for (uint32_t i = log.head - count; i != log.head; i++) {
+    const FlightRecord &entry = log.records[i & record_index_mask];
+    FlightEvent event = static_cast<FlightEvent>(entry.event);
+    Serial.print(F("  "));
+    Serial.print(entry.timeMs);
+    Serial.print(F(" ms "));
+    Serial.print(eventName(event));
+    switch (event) {
+      case FlightEvent::FlightBoot:
+        Serial.print(F(" of session "));
+        Serial.print(entry.param);
+        Serial.print(F(", reset reason: "));
+        Serial.print((entry.value >= 0) && (static_cast<size_t>(entry.value) < sizeof(reset_reason_names) / sizeof(reset_reason_names[0]))
+                         ? reset_reason_names[entry.value]
+                         : "?");
+        break;
+      case FlightEvent::FlightTemperature:
+      case FlightEvent::FlightSetpoint:
+        Serial.print(F(" zone "));
+        Serial.print(entry.param + 1);
+        Serial.print(F(": "));
+        Serial.print(static_cast<float>(entry.value) / FlightRecorderUtils::temperature_scale);
+        Serial.print(F(" °C"));
+        break;
+      case FlightEvent::FlightSensorError:
+        Serial.print(F(" zone "));
+        Serial.print(entry.param + 1);
+        break;
+      case FlightEvent::FlightLoad:
+        Serial.print(F(" GPIO "));
+        Serial.print(entry.param);
+        Serial.print(entry.value ? F(" on") : F(" off"));
+        break;
+      case FlightEvent::FlightLoopOverrun:
+        Serial.print(F(": "));
+        Serial.print(entry.value);
+        Serial.print(F(" ms"));
+        break;
+      case FlightEvent::FlightHeaterFault:
+        Serial.print(F(": 0x"));
+        Serial.print(static_cast<uint16_t>(entry.value), HEX);
+        break;
+      case FlightEvent::FlightWifi:
+        if (entry.param) {
+          Serial.print(F(" connected"));
+        } else {
+          Serial.print(F(" disconnected, reason "));
+          Serial.print(entry.value);
+        }
+        break;
+      case FlightEvent::FlightSensorRescan:
+        Serial.print(F(": "));
+        Serial.print(entry.value);
+        Serial.print(F(" devices"));
+        break;
+      default:
+        break;
+    }
+    Serial.println();
+  }
+}
+
+const char *FlightRecorder::eventName(FlightEvent event) {
+  switch (event) {
+    case FlightEvent::FlightBoot: return "boot";
+    case FlightEvent::FlightTemperature: return "temperature";
+    case FlightEvent::FlightSensorError: return "sensor error";
+    case FlightEvent::FlightLoad: return "load";
+    case FlightEvent::FlightLoopOverrun: return "loop overrun";
+    case FlightEvent::FlightHeaterFault: return "heater fault";
+    case FlightEvent::FlightSetpoint: return "setpoint";
+    case FlightEvent::FlightWifi: return "wifi";
+    case FlightEvent::FlightSensorRescan: return "sensor rescan";
+    default: return "invalid";
+  }
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <Arduino.h>
+
+namespace FlightRecorderUtils {
+  constexpr uint16_t record_capacity = 256;     // records kept; a power of two, so the index wraps with a mask
+  constexpr uint32_t log_magic = 0x4B4F4C46;    // "KOLF": the log in RTC memory is initialized
+  constexpr int16_t temperature_scale = 16;     // temperatures are recorded in 1/16 °C (the DS18B20 resolution)
+}
+
+// Recorded events; the meaning of `param` and `value` of a record depends on the event
+enum FlightEvent : uint8_t {
+  FlightNone = 0,        // empty record (never written)
+  FlightBoot = 1,        // start of a session; param: session number (modulo 256); value: reset reason (esp_reset_reason_t)
+  FlightTemperature = 2, // param: zone; value: temperature [1/16 °C]
+  FlightSensorError = 3, // param: zone; no valid reading
+  FlightLoad = 4,        // param: GPIO of the load; value: 1 = on, 0 = off
+  FlightLoopOverrun = 5, // value: duration of the loop pass [ms]
+  FlightHeaterFault = 6, // value: latched heater faults (lower 16 bits of the HeaterFault flags)
+  FlightSetpoint = 7,    // param: zone; value: setpoint [1/16 °C]
+  FlightWifi = 8,        // param: 1 = connected, 0 = disconnected; value: disconnect reason
+  FlightSensorRescan = 9 // value: devices found
+};
+
+// One record: two 32-bit words
+struct FlightRecord {
+  uint32_t timeMs; // since the boot of the session
+  uint8_t event;   // `FlightEvent`
+  uint8_t param;
+  int16_t value;
+};
+
+// Storage of the recorder; placed in RTC memory (`RTC_NOINIT_ATTR`), it survives software, panic and
+// watchdog resets (not power loss)
+struct FlightLog {
+  uint32_t magic;
+  uint32_t head; // records written since the log was initialized; the next record goes to `head % record_capacity`
+  uint32_t sessions; // sessions started since the log was initialized
+  FlightRecord records[FlightRecorderUtils::record_capacity];
+};
+
+class FlightRecorder {
+
+  // CLASS FlightRecorder
+  //
+  // Crash-surviving flight recorder: a circular log of the latest `record_capacity` significant events in
+  // RTC memory, which is not initialized at boot. After a reset, `begin()` takes over the log of the previous
+  // sessions, `printLog()` dumps it, and `record()` appends to it: each session starts with a `FlightBoot`
+  // record holding the reset reason, so the dump shows what happened up to each reset.
+  //
+  // `record()` is a bounded, constant-time append: a timestamp, the stores of one 8-byte record and an
+  // increment of the head, without locking. The recorder has a single writer, the controller loop (interrupt handlers must not record). A
+  // reset between the stores and the increment loses only the record being written.
+
+  public:
+  FlightRecorder(FlightLog &log); // constructor
+
+  void begin(uint8_t resetReason); // takes over the log of previous sessions (or initializes it) and starts a session
+  void record(FlightEvent event, uint8_t param, int16_t value);
+  void recordTemperature(FlightEvent event, uint8_t zone, float tempC); // records `tempC` in 1/16 °C (saturated)
+
+  uint16_t recordCount();      // records in the log
+  uint16_t previousCount();    // records of previous sessions, as taken over by `begin()`
+  void printLog();             // prints the log to the Serial console, oldest record first
+  static const char *eventName(FlightEvent event);
+
+  private:
+  // behavioral parameters are lifetime-constants (provided at construction)
+  FlightLog &log;
+
+  // dynamic state parameters
+  uint16_t previousRecords;
+};
@@ -0,0 +1,79 @@
+#include "FrameCodec.h"
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                      NAMESPACE FrameCodec                                      *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Single pass over the frame: a run is emitted as soon as it ends; literal bytes are collected until a run
+// of `min_run` bytes starts. The source is a template parameter, so the delta is XORed on the fly instead
+// of in a temporary copy of the frame.
+
+namespace {
+  struct PlainSource {
+    const uint8_t *frame;
+    uint8_t operator[](size_t i) const { return frame[i]; }
+  };
+
+  struct DeltaSource {
+    const uint8_t *frame;
+    const uint8_t *reference;
+    uint8_t operator[](size_t i) const { return frame[i] ^ reference[i]; }
+  };
+
+  template <typename Source>
+  size_t packRuns(const Source &source, size_t length, uint8_t *out, size_t capacity) {
+    size_t size = 0;
+    size_t i = 0;
+    while (i < length) {
+      // run starting at i
+      uint8_t value = source[i];
+      size_t run = 1;
+      while ((i + run < length) && (run < FrameCodec::max_run) && (source[i + run] == value)) run++;
+      if (run >= FrameCodec::min_run) {
+        if (size + 2 > capacity) return 0;
+        out[size++] = static_cast<uint8_t>(0x80 | (run - FrameCodec::min_run));
+        out[size++] = value;
+        i += run;
+        continue;
+      }
+
+      // literal from i up to the start of the next run
+      size_t end = i + run;
+      while ((end < length) && (end - i < FrameCodec::max_literal)) {
+        if ((end + 2 < length) && (source[end] == source[end + 1]) && (source[end] == source[end + 2])) break;
+        end++;
+      }
+      if (size + 1 + (end - i) > capacity) return 0;
+      out[size++] = static_cast<uint8_t>(end - i - 1);
+      for (size_t j = i; j < end; j++) out[size++] = source[j];
+      i = end;
+    }
+    return size;
+  }
+}
+
+size_t FrameCodec::encode(const uint8_t *frame, size_t length, uint8_t *out, size_t capacity) {
+  return packRuns(PlainSource{frame}, length, out, capacity);
+}
+
+size_t FrameCodec::encodeDelta(const uint8_t *frame, const uint8_t *reference, size_t length, uint8_t *out, size_t capacity) {
+  return packRuns(DeltaSource{frame, reference}, length, out, capacity);
+}
+
+bool FrameCodec::decode(const uint8_t *encoded, size_t size, const uint8_t *reference, uint8_t *out, size_t length) {
+  size_t position = 0;
+  size_t decoded = 0;
+  while (position < size) {
+    uint8_t control = encoded[position++];
+    if (control & 0x80) {
+      size_t run = (control & 0x7F) + min_run;
+      if ((position >= size) || (decoded + run > length)) return false;
+      uint8_t value = encoded[position++];
+      for (size_t j = 0; j < run; j++, decoded++) out[decoded] = (reference != nullptr) ? (reference[decoded] ^ value) : value;
+    } else {
+      size_t literal = control + 1;
+      if ((position + literal > size) || (decoded + literal > length)) return false;
+      for (size_t j = 0; j < literal; j++, decoded++) out[decoded] = (reference != nullptr) ? (reference[decoded] ^ encoded[position++]) : encoded[position++];
+    }
+  }
+  return decoded == length;
+}
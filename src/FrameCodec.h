@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Run-length encoding of display frames (u8g2 frame buffers), for mirroring the screen to a host. A frame
+// is encoded either as is (key frame), or as the XOR with the previous frame (delta frame): on a mostly
+// static screen, the delta is almost all zeros and compresses to a few bytes.
+//
+// The run-length code is byte-oriented: a control byte `c < 0x80` is followed by `c + 1` literal bytes; a
+// control byte `c >= 0x80` is followed by one byte, which repeats `(c & 0x7F) + min_run` times.
+//
+// This header and its implementation do not depend on the Arduino framework, so the host viewer decodes
+// with the same code.
+namespace FrameCodec {
+  constexpr size_t min_run = 3;       // shorter runs are part of a literal
+  constexpr size_t max_run = 127 + 3; // longest run of one control byte
+  constexpr size_t max_literal = 128; // longest literal of one control byte
+
+  // Worst-case size of an encoded frame of `length` bytes (all literals)
+  constexpr size_t maxEncodedSize(size_t length) { return length + (length + max_literal - 1) / max_literal; }
+
+  // Encodes `length` bytes; returns the encoded size, or 0 if it exceeds `capacity`
+  size_t encode(const uint8_t *frame, size_t length, uint8_t *out, size_t capacity);
+
+  // Encodes the XOR of `frame` with `reference` (both `length` bytes); returns the encoded size, or 0 if it
+  // exceeds `capacity`
+  size_t encodeDelta(const uint8_t *frame, const uint8_t *reference, size_t length, uint8_t *out, size_t capacity);
+
+  // Decodes into `out` (exactly `length` bytes); with a `reference`, the decoded bytes are XORed onto it
+  // (delta frame). Returns false if the encoding is malformed or does not decode to `length` bytes.
+  bool decode(const uint8_t *encoded, size_t size, const uint8_t *reference, uint8_t *out, size_t length);
+}
@@ -0,0 +1,114 @@
+#include "FrameMirror.h"
+#include <esp_cpu.h>   // For esp_cpu_get_cycle_count()
+#include <esp_timer.h> // For esp_timer_get_time()
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                      CLASS FrameMirror                                         *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Screen mirroring. The frame buffer is compared and encoded in place, without a copy: the copy kept in
+// `sent` is updated only after the frame has been written.
+
+// constructor:
+FrameMirror::FrameMirror(U8G2 &display, Stream &stream)
+    : display(display),
+      stream(stream),
+      active(false),
+      minIntervalMs(0),
+      lastSentMs(0),
+      frameNumber(0),
+      keyFrameDue(true),
+      sent{},
+      frames(0),
+      skipped(0),
+      rawBytes(0),
+      encodedBytes(0),
+      lastCycles(0),
+      maxCycles(0) {
+}
+
+bool FrameMirror::checkFrame() {
+  if (!active) return false;
+  const uint8_t *frame = display.getBufferPtr();
+  size_t length = 8 * display.getBufferTileWidth() * display.getBufferTileHeight();
+  if ((frame == nullptr) || (length > FrameMirrorUtils::max_buffer_bytes)) return false;
+  if (!keyFrameDue && (memcmp(frame, sent, length) == 0)) return false; // unchanged
+  uint32_t nowMs = static_cast<uint32_t>(esp_timer_get_time() / 1000LL);
+  if ((frames > 0) && (nowMs - lastSentMs < minIntervalMs)) return false;
+
+  FrameEncoding encoding = (keyFrameDue || (frameNumber % FrameMirrorUtils::key_frame_interval == 0)) ? FrameEncoding::FrameKey : FrameEncoding::FrameDelta;
+  uint32_t startCycles = esp_cpu_get_cycle_count();
+  size_t encodedSize = (encoding == FrameEncoding::FrameKey) ? FrameCodec::encode(frame, length, encoded, sizeof(encoded))
+                                                             : FrameCodec::encodeDelta(frame, sent, length, encoded, sizeof(encoded));
+  lastCycles = esp_cpu_get_cycle_count() - startCycles;
+  if (lastCycles > maxCycles) maxCycles = lastCycles;
+
+  lastSentMs = nowMs;
+  if (!send(encoding, encodedSize)) {
+    skipped++;
+    keyFrameDue = true; // the viewer lacks the reference of the next delta
+    return false;
+  }
+  memcpy(sent, frame, length);
+  keyFrameDue = false;
+  frameNumber++;
+  frames++;
+  rawBytes += length;
+  encodedBytes += encodedSize;
+  return true;
+}
+
+bool FrameMirror::send(FrameEncoding encoding, size_t encodedSize) {
+  uint8_t chunkCount = static_cast<uint8_t>((encodedSize + FrameMirrorUtils::chunk_data_bytes - 1) / FrameMirrorUtils::chunk_data_bytes);
+  size_t messageBytes = encodedSize + chunkCount * (CommandUtils::header_bytes + FrameMirrorUtils::chunk_header_bytes + CommandUtils::crc_bytes);
+  if ((encodedSize == 0) || (stream.availableForWrite() < static_cast<int>(messageBytes))) return false;
+
+  uint8_t header[FrameMirrorUtils::chunk_header_bytes] = {
+      encoding, 0, chunkCount, display.getBufferTileWidth(), display.getBufferTileHeight(),
+      static_cast<uint8_t>((display.getU8g2()->cb == U8G2_R2) ? FrameMirrorUtils::flag_rotated_180 : 0)};
+  uint8_t payload[CommandUtils::max_payload];
+  memcpy(payload, header, sizeof(header));
+  for (uint8_t chunk = 0; chunk < chunkCount; chunk++) {
+    size_t offset = chunk * FrameMirrorUtils::chunk_data_bytes;
+    size_t chunkBytes = min(encodedSize - offset, static_cast<size_t>(FrameMirrorUtils::chunk_data_bytes));
+    payload[1] = chunk;
+    memcpy(&payload[FrameMirrorUtils::chunk_header_bytes], &encoded[offset], chunkBytes);
+    size_t size = encodeCommandFrame(CommandId::MessageDisplayFrame | CommandUtils::response_flag, frameNumber, payload,
+                                     static_cast<uint8_t>(FrameMirrorUtils::chunk_header_bytes + chunkBytes), message);
+    stream.write(message, size);
+  }
+  return true;
+}
+
+void FrameMirror::activate(uint32_t minIntervalMs) {
+  this->minIntervalMs = minIntervalMs;
+  keyFrameDue = true;
+  active = true;
+}
+
+void FrameMirror::expire() { active = false; }
+
+bool FrameMirror::isExpired() { return !active; }
+
+uint32_t FrameMirror::framesSent() { return frames; }
+
+uint32_t FrameMirror::framesSkipped() { return skipped; }
+
+float FrameMirror::compressionRatio() { return (encodedBytes > 0) ? static_cast<float>(rawBytes) / static_cast<float>(encodedBytes) : 0.0f; }
+
+uint32_t FrameMirror::lastEncodeCycles() { return lastCycles; }
+
+uint32_t FrameMirror::maxEncodeCycles() { return maxCycles; }
+
+void FrameMirror::printStats() {
+  Serial.print(F("Frame mirror: "));
+  Serial.print(frames);
+  Serial.print(F(" frames sent, "));
+  Serial.print(skipped);
+  Serial.print(F(" skipped, compression "));
+  Serial.print(compressionRatio(), 1);
+  Serial.print(F(":1, encode "));
+  Serial.print(lastCycles);
+  Serial.print(F(" cycles (max "));
+  Serial.print(maxCycles);
+  Serial.println(F(")"));
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "CommandProtocol.h"
+#include "FrameCodec.h"
+#include <Arduino.h>
+#include <U8g2lib.h>
+
+namespace FrameMirrorUtils {
+  constexpr size_t max_buffer_bytes = 9 * 5 * 8; // u8g2 full frame buffer of the 72x40 panel: 9 x 5 tiles of 8 bytes
+  constexpr uint8_t key_frame_interval = 16;     // every 16th frame is a key frame, so a viewer that missed one resynchronizes
+  constexpr uint8_t chunk_header_bytes = 6;      // encoding, chunk index, chunk count, tile width, tile height, flags
+  constexpr uint8_t chunk_data_bytes = CommandUtils::max_payload - chunk_header_bytes;
+  constexpr uint8_t flag_rotated_180 = 0x01; // the frame buffer is upside down relative to the screen (U8G2_R2)
+}
+
+enum FrameEncoding : uint8_t {
+  FrameKey = 0,  // run-length encoded frame buffer
+  FrameDelta = 1 // run-length encoded XOR with the previous frame
+};
+
+class FrameMirror {
+
+  // CLASS FrameMirror
+  //
+  // Mirrors the screen to a host: whenever the u8g2 frame buffer differs from the frame sent last, it is
+  // sent as a `MessageDisplayFrame` of the command protocol (see `CommandProtocol.h`), run-length encoded as
+  // a key frame or as a delta to the previous frame (see `FrameCodec.h`). An encoded frame longer than one
+  // message is split into chunks, which all carry the frame number as sequence number.
+  //
+  // The loop function `checkFrame()` compares the frame buffer with a copy of the frame sent last, which
+  // costs a `memcmp()` of the frame buffer while the screen is unchanged; it can be called after every
+  // redraw. Frames are sent at most once per `minIntervalMs`: changes within the interval are sent with
+  // the first check after it (intermediate frames are skipped). A frame is only written if the stream can
+  // take all its chunks without blocking; otherwise it is skipped, and the next frame is a key frame.
+  //
+  // The constructor instantiates a _disabled_ mirror, which can be enabled by calling `activate()`.
+
+  public:
+  FrameMirror(U8G2 &display, Stream &stream); // constructor
+
+  bool checkFrame(); // Loop function: sends the frame buffer if it changed; returns true if a frame was sent
+
+  // Lifecycle functions
+  void activate(uint32_t minIntervalMs); // starts mirroring (the first frame is a key frame)
+  void expire();                         // stops mirroring
+  bool isExpired();
+
+  // Statistics
+  uint32_t framesSent();
+  uint32_t framesSkipped();    // frames the stream could not take
+  float compressionRatio();    // frame buffer bytes per encoded byte, over all frames sent
+  uint32_t lastEncodeCycles(); // CPU cycles of the latest encoding
+  uint32_t maxEncodeCycles();
+  void printStats(); // prints the statistics to the Serial console
+
+  private:
+  bool send(FrameEncoding encoding, size_t encodedSize); // sends `encoded` in chunks; false if it does not fit the stream
+
+  // behavioral parameters are lifetime-constants (provided at construction)
+  U8G2 &display;
+  Stream &stream;
+
+  // dynamic state parameters
+  bool active;
+  uint32_t minIntervalMs;
+  uint32_t lastSentMs;
+  uint8_t frameNumber;
+  bool keyFrameDue;
+  uint8_t sent[FrameMirrorUtils::max_buffer_bytes]; // frame sent last
+  uint8_t encoded[FrameCodec::maxEncodedSize(FrameMirrorUtils::max_buffer_bytes)];
+  uint8_t message[CommandUtils::max_frame_bytes];
+
+  // statistics
+  uint32_t frames;
+  uint32_t skipped;
+  uint64_t rawBytes;
+  uint64_t encodedBytes;
+  uint32_t lastCycles;
+  uint32_t maxCycles;
+};
@@ -1,11 +1,12 @@
 #pragma once
+#include "TimingCore.h"
 #include <Arduino.h>
 
 namespace FrequencyUtils {
   constexpr int64_t unbounded_lifetime = -1LL;
 }
 
-class FrequencyTrigger {
+class FrequencyTrigger : public TimingCore<Timing::Trigger> {
 
   // CLASS FrequencyTrigger
   //
@@ -21,41 +22,26 @@ class FrequencyTrigger {
   // true - until `activate()` is called again.
   // Negative lifetime means that the trigger remains active indefinitely until `expire()` is called.
   //
-  // This implementation is intended to run on the controller loop, consuming minimal
-  // resources. Results should be largely deterministic across different controllers as
-  // we don't rely on CPU frequency.
+  // Lifecycle functions `activate()`, `expire()` and `isExpired()` are provided by `TimingCore`.
 
   public:
-  FrequencyTrigger(int64_t lifetimeMs, unsigned long triggerIntervalMs); // constructor
+  FrequencyTrigger(int64_t lifetimeMs, unsigned long triggerIntervalMs) // constructor
+      : TimingCore(Timing::BoundedLifetime(lifetimeMs), Timing::Trigger(triggerIntervalMs)) {
+  }
 
-  bool checkTrigger(); // Loop function
-
-  // Lifecycle functions
-  void activate(long delayMs = 0); // activates the trigger (after optional delay [milliseconds])
-  void expire();                   // disables the trigger
-  bool isExpired();                // returns true if the trigger is expired/disabled
-
-  private:
-  // behavioral parameters are lifetime-constants (provided at construction)
-  const int64_t lifetimeMs;
-  const int64_t triggerIntervalMs;
-
-  // dynamic state parameters
-  int64_t lastActivationObservedMilli;
-  int64_t nextTriggerAtOrAfterMilli;
-  bool expired;
+  bool checkTrigger() { return check(); } // Loop function
 };
 
-class FrequencyToggler2 {
+class FrequencyToggler2 : public TimingCore<Timing::AsymmetricToggle> {
 
-  // CLASS FrequencyToggler
+  // CLASS FrequencyToggler2
   //
-  // This class provides an on/off toggling that changes between the on- and off-state _once_ in
-  // specified time intervals.
+  // This class provides an on/off toggling that stays in the on-state for `toggleDurationOnMs` and in the
+  // off-state for `toggleDurationOffMs` milliseconds.
   //
   // The constructor instantiates a _disabled_ toggler, which can be enabled by calling `activate()`.
-  // Once activated, the `checkToggle` function will return true on the first call within every time interval
-  // of `toggleIntervalMs` milliseconds. If an inteval is missed (e.g., because the controller loop
+  // Once activated, the `checkToggle` function will return true on the first call after each switch time,
+  // starting with a switch to the on-state. If an inteval is missed (e.g., because the controller loop
   // is busy), the interval is skipped and the toggler will return true on the next interval as it would
   // otherwise.
   // The lifetime is measured from the point of latest activation. After the specified `lifetimeMs`
@@ -65,94 +51,37 @@ class FrequencyToggler2 {
   //   * If the state is OFF, when the lifetime expires or `expire()` is called, no state change occurs, i.e
   //     `checkToggle()` returns false.
   // All subsequent `checkToggle()` calls then return false, until `activate()` is called again.
-  // toggler deactivates and no longer returns
-  // true - until `activate()` is called again.
-  // Negative lifetime means that the trigger remains active indefinitely until `expire()` is called.
+  // Negative lifetime means that the toggler remains active indefinitely until `expire()` is called.
   //
-  // This implementation is intended to run on the controller loop, consuming minimal
-  // resources. Results should be largely deterministic across different controllers as
-  // we don't rely on CPU frequency.
+  // Lifecycle functions `activate()`, `expire()`, `isExpired()` and `isActive()` are provided by `TimingCore`.
 
   public:
-  FrequencyToggler2(int64_t lifetimeMs, unsigned long toggleDurationOnMs, unsigned long toggleDurationOffMs); // constructor
+  FrequencyToggler2(int64_t lifetimeMs, unsigned long toggleDurationOnMs, unsigned long toggleDurationOffMs) // constructor
+      : TimingCore(Timing::BoundedLifetime(lifetimeMs), Timing::AsymmetricToggle(toggleDurationOnMs, toggleDurationOffMs)) {
+  }
 
   // checkToggle is intended to be called with high frequency, e.g. by the controller `loop`. It returns true _once_
   // the time for the next switch on <-> off has been reached or surpassed.
   // To find out whether the current state is on or off, the user must call `isCurrentStateOn()`.
-  bool checkToggle();
-
-  // Returns true if the current state is "on", false if "off".
-  bool isCurrentStateOn();
-
-  // Lifecycle functions
-  void activate(long delayMs = 0); // activates the trigger (after optional delay [milliseconds])
-  void expire();                   // disables the trigger
-  bool isExpired();                // returns true if the trigger is expired/disabled (inverse of `isActive()`)
-  bool isActive();                 // returns true if the trigger is active (irrespective whether the toggler's state is on or off)
-
-  private:
-  // Internally, the `checkToggle()` represents three states:
-  //  * Active: the toggler is active and in the ON state
-  //  * ShouldExpire: the toggler was active, and `expire()` was called - the next call to `checkToggle()` will switch it OFF,
-  //  * Expired: the toggler is expired/disabled
-  enum _status {
-    Active = 0,
-    ShouldExpire = 1,
-    Expired = 2
-  };
-
-  // behavioral parameters are lifetime-constants (provided at construction)
-  const int64_t lifetimeMs;
-  const int64_t toggleDurationOnMs;
-  const int64_t toggleDurationOffMs;
-
-  // dynamic state parameters
-  int64_t lastActivationObservedMilli;
-  int64_t nextTriggerAtOrAfterMilli;
-  bool stateIsOn;
-  _status status;
-
-  void advanceState(int64_t currentMillis);
+  bool checkToggle() { return check(); }
 };
 
-class FrequencyToggler {
+class FrequencyToggler : public TimingCore<Timing::Toggle> {
 
   // CLASS FrequencyToggler
   //
   // This class provides an on/off toggling that changes between the on- and off-state _once_ in
-  // specified time intervals.
+  // specified time intervals; otherwise, it behaves like `FrequencyToggler2` with equal on- and off-durations.
   //
-  // The constructor instantiates a _disabled_ toggler, which can be enabled by calling `activate()`.
-  // Once activated, the `checkToggle` function will return true on the first call within every time interval
-  // of `toggleIntervalMs` milliseconds. If an inteval is missed (e.g., because the controller loop
-  // is busy), the interval is skipped and the toggler will return true on the next interval as it would
-  // otherwise.
-  // The lifetime is measured from the point of latest activation. After the specified `lifetimeMs`
-  // [milliseconds] has elapsed, or `expire()` is called, the toggler deactivates and no longer returns
-  // true - until `activate()` is called again.
-  // Negative lifetime means that the trigger remains active indefinitely until `expire()` is called.
-  //
-  // This implementation is intended to run on the controller loop, consuming minimal
-  // resources. Results should be largely deterministic across different controllers as
-  // we don't rely on CPU frequency.
+  // Lifecycle functions `activate()`, `expire()`, `isExpired()` and `isActive()` are provided by `TimingCore`.
 
   public:
-  FrequencyToggler(int64_t lifetimeMs, unsigned long toggleIntervalMs); // constructor
+  FrequencyToggler(int64_t lifetimeMs, unsigned long toggleIntervalMs) // constructor
+      : TimingCore(Timing::BoundedLifetime(lifetimeMs), Timing::Toggle(toggleIntervalMs)) {
+  }
 
   // checkToggle is intended to be called with high frequency, e.g. by the controller `loop`. It returns true _once_
   // the time for the next switch on <-> off has been reached or surpassed.
   // To find out whether the current state is on or off, the user must call `isCurrentStateOn()`.
-  bool checkToggle();
-
-  // Returns true if the current state is "on", false if "off".
-  bool isCurrentStateOn();
-
-  // Lifecycle functions
-  void activate(long delayMs = 0); // activates the trigger (after optional delay [milliseconds])
-  void expire();                   // disables the trigger
-  bool isExpired();                // returns true if the trigger is expired/disabled (inverse of `isActive()`)
-  bool isActive();                 // returns true if the trigger is active (irrespective whether the toggler's state is on or off)
-
-  private:
-  FrequencyToggler2 frequencyToggler2;
+  bool checkToggle() { return check(); }
 };
@@ -0,0 +1,96 @@
+#include "HeapMonitor.h"
+#include <esp_heap_caps.h> // For heap_caps_get_info()
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                      CLASS HeapMonitor                                         *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Telemetry of the internal heap. All figures are taken from a single `heap_caps_get_info()` call, which
+// walks the heap's block list, hence sampling is kept to once every `check_interval_ms`.
+
+// constructor:
+HeapMonitor::HeapMonitor()
+    : checkTrigger(FrequencyUtils::unbounded_lifetime, HeapUtils::check_interval_ms),
+      baselineBlocks(0),
+      reportedMaxBlocks(0),
+      freeNow(0),
+      largestBlock(0),
+      minimumFree(0),
+      allocatedBlocks(0),
+      detected(HeapRegression::NoRegression) {
+}
+
+bool HeapMonitor::checkHeap() {
+  if (!checkTrigger.checkTrigger()) return false;
+  sample();
+
+  uint8_t found = HeapRegression::NoRegression;
+  if (allocatedBlocks > reportedMaxBlocks) {
+    // report every new maximum, so a slow leak shows up repeatedly
+    reportedMaxBlocks = allocatedBlocks;
+    found |= HeapRegression::AllocationsAfterBoot;
+  }
+  if (minimumFree < HeapUtils::min_free_bytes) found |= HeapRegression::LowMemory;
+  if (fragmentationPct() > HeapUtils::max_fragmentation_pct) found |= HeapRegression::Fragmentation;
+
+  // low memory and fragmentation are reported once; new allocations on every new maximum
+  uint8_t isNew = found & ~(detected & ~HeapRegression::AllocationsAfterBoot);
+  detected |= found;
+  if (isNew == HeapRegression::NoRegression) return false;
+
+  Serial.print(F("HEAP WARNING:"));
+  if (isNew & HeapRegression::AllocationsAfterBoot) Serial.print(F(" allocations after boot;"));
+  if (isNew & HeapRegression::LowMemory) Serial.print(F(" low memory;"));
+  if (isNew & HeapRegression::Fragmentation) Serial.print(F(" fragmentation;"));
+  Serial.println();
+  printStats();
+  return true;
+}
+
+void HeapMonitor::activate(long delayMs /* = 0 */) {
+  sample();
+  baselineBlocks = allocatedBlocks;
+  reportedMaxBlocks = allocatedBlocks;
+  detected = HeapRegression::NoRegression;
+  checkTrigger.activate(delayMs);
+}
+
+void HeapMonitor::expire() { checkTrigger.expire(); }
+
+bool HeapMonitor::isExpired() { return checkTrigger.isExpired(); }
+
+uint32_t HeapMonitor::freeBytes() { return freeNow; }
+
+uint32_t HeapMonitor::largestFreeBlock() { return largestBlock; }
+
+uint32_t HeapMonitor::minimumFreeBytes() { return minimumFree; }
+
+int32_t HeapMonitor::allocationsAfterBoot() { return static_cast<int32_t>(allocatedBlocks - baselineBlocks); }
+
+uint8_t HeapMonitor::fragmentationPct() {
+  if (freeNow == 0) return 0;
+  return static_cast<uint8_t>(100 - (100ULL * largestBlock) / freeNow);
+}
+
+uint8_t HeapMonitor::regressions() { return detected; }
+
+void HeapMonitor::printStats() {
+  Serial.print(F("Heap: free "));
+  Serial.print(freeNow);
+  Serial.print(F(" B, largest block "));
+  Serial.print(largestBlock);
+  Serial.print(F(" B (fragmentation "));
+  Serial.print(fragmentationPct());
+  Serial.print(F("%), min free "));
+  Serial.print(minimumFree);
+  Serial.print(F(" B, allocations after boot "));
+  Serial.println(allocationsAfterBoot());
+}
+
+void HeapMonitor::sample() {
+  multi_heap_info_t info;
+  heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+  freeNow = info.total_free_bytes;
+  largestBlock = info.largest_free_block;
+  minimumFree = info.minimum_free_bytes;
+  allocatedBlocks = info.allocated_blocks;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "FrequentlyUtils.h"
+#include <Arduino.h>
+
+namespace HeapUtils {
+  constexpr uint32_t min_free_bytes = 32768;         // warn if the free heap ever drops below
+  constexpr uint8_t max_fragmentation_pct = 50;      // warn if the largest free block is less than half of the free heap
+  constexpr unsigned long check_interval_ms = 10000; // period of the heap checks
+}
+
+// Heap regressions (bit flags), reported once when first detected
+enum HeapRegression : uint8_t {
+  NoRegression = 0,
+  AllocationsAfterBoot = 1 << 0, // more heap blocks allocated than at the end of `setup()`
+  LowMemory = 1 << 1,            // minimum-ever free heap below `min_free_bytes`
+  Fragmentation = 1 << 2         // largest free block small relative to the free heap
+};
+
+class HeapMonitor {
+
+  // CLASS HeapMonitor
+  //
+  // Telemetry of the internal heap (8-bit capable memory), to verify that the controller does not use the
+  // heap after `setup()`. Objects allocated during setup stay allocated for the lifetime of the controller and
+  // cannot fragment the heap; allocations in the loop, in contrast, add up over months of runtime.
+  //
+  // `activate()` records a baseline of the allocated blocks, hence must be called at the end of `setup()`.
+  // The loop function `checkHeap()` samples the heap every `check_interval_ms` and compares it against the
+  // baseline. A net increase of allocated blocks since the baseline (i.e. an allocation that is not freed
+  // again by the time of the next sample) is flagged, as is a low minimum-ever free heap or a fragmented heap.
+  // Note: the framework (e.g. the Wifi stack) allocates on its own; such allocations are reported as well.
+
+  public:
+  HeapMonitor(); // constructor
+
+  bool checkHeap(); // Loop function: returns true if a new regression was detected (and printed)
+
+  // Lifecycle functions
+  void activate(long delayMs = 0); // records the baseline and activates the periodic checks
+  void expire();                   // disables the periodic checks
+  bool isExpired();                // returns true if the periodic checks are expired/disabled
+
+  // Statistics (as of the latest sample)
+  uint32_t freeBytes();           // currently free heap [bytes]
+  uint32_t largestFreeBlock();    // largest contiguous free block [bytes]
+  uint32_t minimumFreeBytes();    // minimum free heap since boot [bytes]
+  int32_t allocationsAfterBoot(); // net number of blocks allocated since the baseline
+  uint8_t fragmentationPct();     // 100 - largest free block as percentage of the free heap
+  uint8_t regressions();          // all regressions detected so far (HeapRegression flags)
+  void printStats();              // prints the statistics to the Serial console
+
+  private:
+  void sample();
+
+  FrequencyTrigger checkTrigger;
+
+  // dynamic state parameters
+  uint32_t baselineBlocks;
+  uint32_t reportedMaxBlocks;
+  uint32_t freeNow;
+  uint32_t largestBlock;
+  uint32_t minimumFree;
+  uint32_t allocatedBlocks;
+  uint8_t detected;
+};
@@ -0,0 +1,165 @@
+#include "HeaterAccounting.h"
+#include <Preferences.h> // For persisting the totals in NVS
+#include <esp_timer.h>   // For esp_timer_get_time()
+#include <freertos/FreeRTOS.h>
+
+namespace {
+  Preferences totalsStore;
+  constexpr const char *store_namespace = "heater";
+  constexpr const char *store_key = "totals";
+
+  // guards the totals and the open interval against the burst-fire ISR
+  portMUX_TYPE accountingMux = portMUX_INITIALIZER_UNLOCKED;
+
+  inline uint32_t IRAM_ATTR checkWord(const HeaterTotals &totals) {
+    return ~(totals.magic ^ totals.switchCount ^ static_cast<uint32_t>(totals.onTimeUs) ^ static_cast<uint32_t>(totals.onTimeUs >> 32));
+  }
+
+  inline bool isValid(const HeaterTotals &totals) {
+    return (totals.magic == HeaterAccountingUtils::totals_magic) && (totals.check == checkWord(totals));
+  }
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                    CLASS HeaterAccounting                                      *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// The totals only grow, so of two valid copies (RTC memory and NVS) the one with the larger on-time is the
+// more recent. A reset between the update of the counters and of the check word invalidates the RTC copy;
+// the totals then continue from NVS. NVS itself replaces an entry only once the new one is written.
+
+// constructor:
+HeaterAccounting::HeaterAccounting(HeaterTotals &totals, float loadW)
+    : totals(totals),
+      loadW(loadW),
+      on(false),
+      onSinceUs(0),
+      hourStartUs(0),
+      hourStartOnUs(0),
+      hourStartSwitches(0),
+      dayStartUs(0),
+      dayStartOnUs(0),
+      lastPersistUs(0),
+      persistedOnUs(0),
+      lastHourDuty(NAN),
+      lastDayDuty(NAN),
+      lastHourSwitches(0),
+      persists(0) {
+}
+
+void HeaterAccounting::begin() {
+  HeaterTotals stored = {};
+  totalsStore.begin(store_namespace, false);
+  bool storedValid = (totalsStore.getBytes(store_key, &stored, sizeof(stored)) == sizeof(stored)) && isValid(stored);
+  if (!isValid(totals) || (storedValid && (stored.onTimeUs > totals.onTimeUs))) {
+    totals = storedValid ? stored : HeaterTotals{HeaterAccountingUtils::totals_magic, 0, 0, 0};
+    totals.check = checkWord(totals);
+  }
+  persistedOnUs = storedValid ? stored.onTimeUs : 0;
+
+  int64_t nowUs = esp_timer_get_time();
+  hourStartUs = nowUs;
+  dayStartUs = nowUs;
+  hourStartOnUs = totals.onTimeUs;
+  dayStartOnUs = totals.onTimeUs;
+  hourStartSwitches = totals.switchCount;
+  lastPersistUs = nowUs;
+}
+
+// Callable from the loop and from an ISR (through `HeaterSupervisor::requestLoad()`)
+void IRAM_ATTR HeaterAccounting::recordTransition(bool on) {
+  int64_t nowUs = esp_timer_get_time();
+  portENTER_CRITICAL_SAFE(&accountingMux);
+  if (on && !this->on) {
+    onSinceUs = nowUs;
+    totals.switchCount++;
+  } else if (!on && this->on) {
+    totals.onTimeUs += static_cast<uint64_t>(nowUs - onSinceUs);
+  }
+  totals.check = checkWord(totals);
+  this->on = on;
+  portEXIT_CRITICAL_SAFE(&accountingMux);
+}
+
+void HeaterAccounting::checkRollover() {
+  int64_t nowUs = esp_timer_get_time();
+  if (nowUs - hourStartUs >= HeaterAccountingUtils::hour_us) {
+    uint32_t switches;
+    uint64_t onUs = onTimeAt(nowUs, &switches);
+    lastHourDuty = static_cast<float>(onUs - hourStartOnUs) / static_cast<float>(nowUs - hourStartUs);
+    lastHourSwitches = switches - hourStartSwitches;
+    hourStartUs = nowUs;
+    hourStartOnUs = onUs;
+    hourStartSwitches = switches;
+
+    if (nowUs - dayStartUs >= HeaterAccountingUtils::day_us) {
+      lastDayDuty = static_cast<float>(onUs - dayStartOnUs) / static_cast<float>(nowUs - dayStartUs);
+      dayStartUs = nowUs;
+      dayStartOnUs = onUs;
+    }
+  }
+
+  if (nowUs - lastPersistUs >= static_cast<int64_t>(HeaterAccountingUtils::persist_every_ms) * 1000LL) {
+    lastPersistUs = nowUs;
+    persist();
+  }
+}
+
+uint32_t HeaterAccounting::switchCount() { return totals.switchCount; }
+
+float HeaterAccounting::onTimeHours() { return static_cast<float>(onTimeAt(esp_timer_get_time(), nullptr)) / static_cast<float>(HeaterAccountingUtils::hour_us); }
+
+float HeaterAccounting::energyKWh() { return onTimeHours() * loadW / 1000.0f; }
+
+float HeaterAccounting::hourDuty() { return lastHourDuty; }
+
+float HeaterAccounting::dayDuty() { return lastDayDuty; }
+
+float HeaterAccounting::currentHourDuty() {
+  int64_t nowUs = esp_timer_get_time();
+  if (nowUs <= hourStartUs) return 0.0f;
+  return static_cast<float>(onTimeAt(nowUs, nullptr) - hourStartOnUs) / static_cast<float>(nowUs - hourStartUs);
+}
+
+uint32_t HeaterAccounting::hourSwitches() { return lastHourSwitches; }
+
+uint32_t HeaterAccounting::persistCount() { return persists; }
+
+void HeaterAccounting::printStats() {
+  Serial.print(F("Heater energy: "));
+  Serial.print(energyKWh(), 3);
+  Serial.print(F(" kWh, on "));
+  Serial.print(onTimeHours(), 2);
+  Serial.print(F(" h, "));
+  Serial.print(totals.switchCount);
+  Serial.print(F(" switch-ons; duty "));
+  Serial.print(100.0f * currentHourDuty(), 1);
+  Serial.print(F("% this hour, "));
+  Serial.print(100.0f * lastHourDuty, 1);
+  Serial.print(F("% last hour ("));
+  Serial.print(lastHourSwitches);
+  Serial.print(F(" switch-ons), "));
+  Serial.print(100.0f * lastDayDuty, 1);
+  Serial.print(F("% last day; "));
+  Serial.print(persists);
+  Serial.println(F(" flash writes"));
+}
+
+uint64_t HeaterAccounting::onTimeAt(int64_t nowUs, uint32_t *switches) {
+  portENTER_CRITICAL(&accountingMux);
+  uint64_t onUs = totals.onTimeUs;
+  if (on) onUs += static_cast<uint64_t>(nowUs - onSinceUs);
+  if (switches != nullptr) *switches = totals.switchCount;
+  portEXIT_CRITICAL(&accountingMux);
+  return onUs;
+}
+
+// Writes the totals of the closed intervals to NVS, unless they are unchanged since the latest write
+void HeaterAccounting::persist() {
+  portENTER_CRITICAL(&accountingMux);
+  HeaterTotals snapshot = totals;
+  portEXIT_CRITICAL(&accountingMux);
+  if (snapshot.onTimeUs == persistedOnUs) return;
+  totalsStore.putBytes(store_key, &snapshot, sizeof(snapshot));
+  persistedOnUs = snapshot.onTimeUs;
+  persists++;
+}
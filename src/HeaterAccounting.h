@@ -0,0 +1,78 @@
+#pragma once
+#include <Arduino.h>
+
+namespace HeaterAccountingUtils {
+  constexpr uint32_t totals_magic = 0x4B4F4C41;          // "KOLA": the totals are initialized
+  constexpr int64_t hour_us = 3600LL * 1000000LL;
+  constexpr int64_t day_us = 24LL * hour_us;
+  constexpr uint32_t persist_every_ms = 3600000;         // totals are written to flash at most once per hour
+}
+
+// Cumulative counters of the load, across sessions. A copy lives in RTC memory (`RTC_NOINIT_ATTR`), where it
+// is updated at every transition and survives software, panic and watchdog resets; the check word tells a
+// valid copy from uninitialized memory or an update cut short by a reset. The same record is persisted in NVS.
+struct HeaterTotals {
+  uint32_t magic;
+  uint32_t switchCount; // off -> on transitions of the load (switching cycles of the SSR)
+  uint64_t onTimeUs;    // on-time of the closed on-intervals [microseconds]
+  uint32_t check;       // `magic ^ switchCount ^ onTimeUs (both halves)`, inverted
+};
+
+class HeaterAccounting {
+
+  // CLASS HeaterAccounting
+  //
+  // Duty-cycle and energy accounting of the heater, from the transitions of EXT_LOAD_SWITCH as reported by
+  // the `HeaterSupervisor` (the only writer of the load). `recordTransition()` timestamps a transition and
+  // adds a closed on-interval to the totals: constant time, no per-tick work, callable from an ISR. The
+  // energy is estimated from the on-time and the rated power of the load.
+  //
+  // The loop function `checkRollover()` closes the hourly and daily windows (from the difference of the
+  // on-time at both ends, including an interval still open), and writes the totals to NVS once per
+  // `persist_every_ms`, if they have changed. After a reset, `begin()` continues from the RTC copy if it is
+  // valid, else from NVS: a reset loses nothing, a power loss at most the time since the last write.
+
+  public:
+  HeaterAccounting(HeaterTotals &totals, float loadW); // constructor; `loadW`: rated power of the load [W]
+
+  void begin(); // takes over the totals of previous sessions (RTC memory, else NVS); call before the load is switched
+  void recordTransition(bool on); // the load was switched on (or off); ISR-safe
+
+  void checkRollover(); // Loop function
+
+  // Metrics
+  uint32_t switchCount();   // switch-ons since the totals were initialized
+  float onTimeHours();      // cumulative on-time [hours]
+  float energyKWh();        // estimated cumulative energy [kWh]
+  float hourDuty();         // duty cycle of the latest completed hour [0..1]; NAN before
+  float dayDuty();          // duty cycle of the latest completed day [0..1]; NAN before
+  float currentHourDuty();  // duty cycle of the running hour so far [0..1]
+  uint32_t hourSwitches();  // switch-ons in the latest completed hour
+  uint32_t persistCount();  // writes to NVS since boot
+  void printStats();        // prints the metrics to the Serial console
+
+  private:
+  uint64_t onTimeAt(int64_t nowUs, uint32_t *switches); // on-time up to `nowUs`, including an open interval
+  void persist();
+
+  // behavioral parameters are lifetime-constants (provided at construction)
+  HeaterTotals &totals;
+  const float loadW;
+
+  // dynamic state parameters; `on` and `onSinceUs` are written by the burst-fire ISR
+  volatile bool on;
+  int64_t onSinceUs;   // start of the open on-interval
+  int64_t hourStartUs; // start of the running hour window
+  uint64_t hourStartOnUs;
+  uint32_t hourStartSwitches;
+  int64_t dayStartUs;
+  uint64_t dayStartOnUs;
+  int64_t lastPersistUs;
+  uint64_t persistedOnUs; // on-time of the latest write to NVS
+
+  // metrics
+  float lastHourDuty;
+  float lastDayDuty;
+  uint32_t lastHourSwitches;
+  uint32_t persists;
+};
@@ -0,0 +1,265 @@
+#include "HeaterSupervisor.h"
+#include <esp_system.h>   // For esp_reset_reason()
+#include <esp_task_wdt.h> // For the task watchdog
+#include <esp_timer.h>    // For esp_timer_get_time()
+#include <freertos/FreeRTOS.h>
+#include <hal/gpio_ll.h>     // For gpio_ll_set_level(): ISR-safe GPIO write
+#include <soc/gpio_struct.h> // For GPIO (register block)
+
+namespace {
+  constexpr uint32_t persisted_magic = 0x4B4F4C48; // "KOLH"
+
+  // Latched faults of the running session. Placed in RTC memory that is not initialized at boot, so the
+  // record of the previous session can be read after a software or watchdog reset.
+  struct PersistedFaults {
+    uint32_t magic;
+    uint32_t faults;
+  };
+  RTC_NOINIT_ATTR PersistedFaults persistedFaults;
+
+  // guards the fault state and the load GPIO against concurrent access from the loop and the timer ISR
+  portMUX_TYPE faultMux = portMUX_INITIALIZER_UNLOCKED;
+
+  inline uint32_t IRAM_ATTR nowUs() { return static_cast<uint32_t>(esp_timer_get_time()); }
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                    CLASS HeaterSupervisor                                      *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Independent safety supervisor for the external loads (heaters).
+//
+// Timestamps shared with the ISR are the lower 32 bits of `esp_timer_get_time()`. Differences are
+// computed with unsigned arithmetic, hence correct across the wrap-around (every ~71 minutes), as
+// long as the compared timestamps are less than ~71 minutes apart. This holds, because the timer ISR
+// latches a fault long before.
+
+// constructor:
+HeaterSupervisor::HeaterSupervisor(bool highIsOn, float maxTempC, float maxRiseCPerMin)
+    : highIsOn(highIsOn),
+      maxTempC(maxTempC),
+      maxRiseCPerMin(maxRiseCPerMin),
+      count(0),
+      loadMask(0),
+      riseReferenceMask(0),
+      lastCheckInUs(0),
+      reactionUs(0),
+      armed(false),
+      recoveredFaults(HeaterFault::NoFault) {
+}
+
+uint8_t HeaterSupervisor::addLoad(uint8_t loadPin) {
+  if (count >= HeaterSafetyUtils::max_loads) return HeaterSafetyUtils::max_loads;
+  uint8_t load = count;
+  this->loadPin[load] = loadPin;
+  accounting[load] = nullptr;
+  lastValidSampleUs[load] = nowUs();
+  latchedFaults[load] = HeaterFault::NoFault;
+  riseReferenceUs[load] = 0;
+  riseReferenceTempC[load] = 0.0f;
+  implausibleReadings[load] = 0;
+  pinMode(loadPin, OUTPUT);
+  forceLoadOff(load);
+  count = load + 1; // last: from here on, the timer ISR supervises the load
+  return load;
+}
+
+uint8_t HeaterSupervisor::loadCount() { return count; }
+
+uint8_t HeaterSupervisor::loadIndex(uint8_t loadPin) {
+  for (uint8_t load = 0; load < count; load++) {
+    if (this->loadPin[load] == loadPin) return load;
+  }
+  return HeaterSafetyUtils::max_loads;
+}
+
+void HeaterSupervisor::begin() {
+  // recover the faults of the previous session
+  if (persistedFaults.magic != persisted_magic) {
+    persistedFaults.magic = persisted_magic;
+    persistedFaults.faults = HeaterFault::NoFault;
+  }
+  recoveredFaults = persistedFaults.faults;
+  esp_reset_reason_t reason = esp_reset_reason();
+  if ((reason == ESP_RST_TASK_WDT) || (reason == ESP_RST_INT_WDT) || (reason == ESP_RST_WDT)) {
+    recoveredFaults |= HeaterFault::WatchdogReset;
+  }
+  persistedFaults.faults = HeaterFault::NoFault;
+}
+
+void HeaterSupervisor::setAccounting(uint8_t load, HeaterAccounting *accounting) {
+  if (load < count) this->accounting[load] = accounting;
+}
+
+void HeaterSupervisor::arm() {
+  uint32_t now = nowUs();
+  lastCheckInUs = now;
+  for (uint8_t load = 0; load < count; load++) lastValidSampleUs[load] = now; // grace period for the first reading
+  armed = true;
+
+  // Task watchdog for the calling task (the Arduino loop task); the watchdog is usually already
+  // initialized by the framework, hence we try to reconfigure it first.
+  esp_task_wdt_config_t watchdogConfig = {};
+  watchdogConfig.timeout_ms = HeaterSafetyUtils::watchdog_timeout_ms;
+  watchdogConfig.idle_core_mask = 0;
+  watchdogConfig.trigger_panic = true;
+  if (esp_task_wdt_reconfigure(&watchdogConfig) != ESP_OK) {
+    esp_task_wdt_init(&watchdogConfig);
+  }
+  esp_task_wdt_add(NULL);
+
+  // hardware timer with 1 MHz resolution, periodic alarm every `tick_ms`
+  hw_timer_t *timer = timerBegin(1000000);
+  timerAttachInterruptArg(timer, &HeaterSupervisor::onTimerISR, this);
+  timerAlarm(timer, HeaterSafetyUtils::tick_ms * 1000ULL, true, 0);
+}
+
+void HeaterSupervisor::checkIn() {
+  lastCheckInUs = nowUs();
+  if (armed) esp_task_wdt_reset();
+}
+
+void HeaterSupervisor::reportTemperature(uint8_t load, float tempC) {
+  if (load >= count) return;
+  uint32_t now = nowUs();
+
+  // DEVICE_DISCONNECTED_C (-127) is outside of the plausible range; an isolated one is a missing reading
+  if (!isfinite(tempC) || (tempC < HeaterSafetyUtils::min_plausible_temp_c) || (tempC > HeaterSafetyUtils::max_plausible_temp_c)) {
+    if (implausibleReadings[load] < HeaterSafetyUtils::max_implausible_readings) implausibleReadings[load]++;
+    if (implausibleReadings[load] >= HeaterSafetyUtils::max_implausible_readings) latchFault(load, HeaterFault::ImplausibleReading, lastValidSampleUs[load]);
+    return;
+  }
+  implausibleReadings[load] = 0;
+  lastValidSampleUs[load] = now;
+
+  if (tempC > maxTempC) {
+    latchFault(load, HeaterFault::OverTemperature, now);
+  }
+
+  // Rate of rise: a single step of the sensor resolution between two readings would exaggerate the
+  // rate, hence it is evaluated against a reference reading at least `rise_window_ms` old.
+  uint8_t bit = 1 << load;
+  if ((riseReferenceMask & bit) == 0) {
+    riseReferenceUs[load] = now;
+    riseReferenceTempC[load] = tempC;
+    riseReferenceMask |= bit;
+    return;
+  }
+  uint32_t elapsedUs = now - riseReferenceUs[load];
+  if (elapsedUs < HeaterSafetyUtils::rise_window_ms * 1000UL) return;
+  float riseCPerMin = (tempC - riseReferenceTempC[load]) * 60.0e6f / static_cast<float>(elapsedUs);
+  if (riseCPerMin > maxRiseCPerMin) {
+    latchFault(load, HeaterFault::ExcessiveRise, now);
+  }
+  riseReferenceUs[load] = now;
+  riseReferenceTempC[load] = tempC;
+}
+
+// Callable from the loop and from an ISR (e.g. the burst-fire timer)
+void IRAM_ATTR HeaterSupervisor::requestLoad(uint8_t load, bool on) {
+  if (load >= count) return;
+  portENTER_CRITICAL_SAFE(&faultMux);
+  if (latchedFaults[load] != HeaterFault::NoFault) on = false;
+  writeLoad(load, on);
+  portEXIT_CRITICAL_SAFE(&faultMux);
+}
+
+bool HeaterSupervisor::isLoadOn(uint8_t load) { return (loadMask & (1 << load)) != 0; }
+
+uint32_t HeaterSupervisor::faults() {
+  uint32_t combined = HeaterFault::NoFault;
+  for (uint8_t load = 0; load < count; load++) combined |= latchedFaults[load];
+  return combined;
+}
+
+uint32_t HeaterSupervisor::faults(uint8_t load) { return (load < count) ? latchedFaults[load] : HeaterFault::NoFault; }
+
+uint32_t HeaterSupervisor::previousFaults() { return recoveredFaults; }
+
+uint32_t HeaterSupervisor::lastReactionMs() { return reactionUs / 1000UL; }
+
+void HeaterSupervisor::clearFaults() {
+  portENTER_CRITICAL(&faultMux);
+  persistedFaults.faults = HeaterFault::NoFault;
+  uint32_t now = nowUs();
+  lastCheckInUs = now;
+  for (uint8_t load = 0; load < count; load++) {
+    latchedFaults[load] = HeaterFault::NoFault;
+    lastValidSampleUs[load] = now;
+    implausibleReadings[load] = 0;
+  }
+  portEXIT_CRITICAL(&faultMux);
+  riseReferenceMask = 0;
+}
+
+void HeaterSupervisor::printFaults(uint32_t faults) {
+  if (faults == HeaterFault::NoFault) {
+    Serial.print(F("none"));
+    return;
+  }
+  static const struct {
+    uint32_t fault;
+    const char *name;
+  } faultNames[] = {
+      {HeaterFault::ImplausibleReading, "implausible reading"},
+      {HeaterFault::StaleReading, "stale reading"},
+      {HeaterFault::OverTemperature, "over-temperature"},
+      {HeaterFault::ExcessiveRise, "excessive rise"},
+      {HeaterFault::LoopStalled, "loop stalled"},
+      {HeaterFault::WatchdogReset, "watchdog reset"}};
+
+  bool first = true;
+  for (const auto &entry : faultNames) {
+    if ((faults & entry.fault) == 0) continue;
+    if (!first) Serial.print(F(", "));
+    Serial.print(entry.name);
+    first = false;
+  }
+}
+
+void IRAM_ATTR HeaterSupervisor::onTimerISR(void *arg) { static_cast<HeaterSupervisor *>(arg)->checkTimeouts(); }
+
+// Walks the loads: the cost of a tick is linear in the number of loads
+void IRAM_ATTR HeaterSupervisor::checkTimeouts() {
+  if (!armed) return;
+  uint32_t now = nowUs();
+  uint8_t loads = count;
+
+  uint32_t lastCheckIn = lastCheckInUs;
+  bool loopStalled = (now - lastCheckIn > HeaterSafetyUtils::max_loop_stall_ms * 1000UL);
+  for (uint8_t load = 0; load < loads; load++) {
+    if (loopStalled) latchFault(load, HeaterFault::LoopStalled, lastCheckIn);
+    uint32_t lastSample = lastValidSampleUs[load];
+    if (now - lastSample > HeaterSafetyUtils::max_sample_age_ms * 1000UL) {
+      latchFault(load, HeaterFault::StaleReading, lastSample);
+    }
+
+    // re-assert: the load stays off for as long as a fault is latched
+    if (latchedFaults[load] != HeaterFault::NoFault) {
+      portENTER_CRITICAL_ISR(&faultMux);
+      forceLoadOff(load);
+      portEXIT_CRITICAL_ISR(&faultMux);
+    }
+  }
+}
+
+// Latches the fault of the load and forces it off. Callable from the loop and from the timer ISR.
+// `lastHealthyUs` is the last time the supervised condition was fine, to record the reaction time.
+void IRAM_ATTR HeaterSupervisor::latchFault(uint8_t load, uint32_t fault, uint32_t lastHealthyUs) {
+  portENTER_CRITICAL_SAFE(&faultMux);
+  bool isNew = (latchedFaults[load] & fault) == 0;
+  latchedFaults[load] = latchedFaults[load] | fault;
+  persistedFaults.faults |= fault;
+  forceLoadOff(load);
+  if (isNew) reactionUs = nowUs() - lastHealthyUs;
+  portEXIT_CRITICAL_SAFE(&faultMux);
+}
+
+void IRAM_ATTR HeaterSupervisor::forceLoadOff(uint8_t load) { writeLoad(load, false); }
+
+void IRAM_ATTR HeaterSupervisor::writeLoad(uint8_t load, bool on) {
+  uint8_t bit = 1 << load;
+  bool wasOn = (loadMask & bit) != 0;
+  gpio_ll_set_level(&GPIO, loadPin[load], (on == highIsOn) ? 1 : 0);
+  if ((accounting[load] != nullptr) && (on != wasOn)) accounting[load]->recordTransition(on);
+  loadMask = on ? (loadMask | bit) : (loadMask & ~bit);
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include "HeaterAccounting.h"
+#include <Arduino.h>
+
+namespace HeaterSafetyUtils {
+  // Plausible range of DS18B20 readings (specified measurement range of the sensor) [°C]
+  constexpr float min_plausible_temp_c = -55.0f;
+  constexpr float max_plausible_temp_c = 125.0f;
+
+  constexpr uint32_t tick_ms = 100;               // period of the supervision timer interrupt
+  constexpr uint32_t max_loop_stall_ms = 2000;    // the loop must check in at least this often
+  constexpr uint32_t max_sample_age_ms = 15000;   // a valid temperature reading must arrive at least this often
+  constexpr uint32_t rise_window_ms = 30000;      // rate of rise is evaluated over (at least) this time window
+  constexpr uint32_t watchdog_timeout_ms = 5000;  // task watchdog: resets the controller if the loop stalls
+  constexpr uint8_t max_implausible_readings = 3; // consecutive implausible readings latch a fault; fewer count as missing
+  constexpr uint8_t max_loads = 8;                // loads per supervisor (one per heating zone); masks of all loads fit into one byte
+}
+
+// Fault codes (bit flags), per load. Faults are latched until `clearFaults()` is called and persisted across resets.
+enum HeaterFault : uint32_t {
+  NoFault = 0,
+  ImplausibleReading = 1 << 0, // `max_implausible_readings` in a row disconnected (DEVICE_DISCONNECTED_C) or out of sensor range
+  StaleReading = 1 << 1,       // no valid reading for more than `max_sample_age_ms`
+  OverTemperature = 1 << 2,    // reading above the configured maximum temperature
+  ExcessiveRise = 1 << 3,      // temperature rising faster than the configured maximum rate
+  LoopStalled = 1 << 4,        // controller loop did not check in for more than `max_loop_stall_ms`
+  WatchdogReset = 1 << 5       // previous session ended with a watchdog reset
+};
+
+class HeaterSupervisor {
+
+  // CLASS HeaterSupervisor
+  //
+  // Independent safety supervisor for the external loads (heaters), up to `max_loads` of them, e.g. one per
+  // heating zone. Every load has its own pin, temperature reading and latched faults; all writes to a load's
+  // GPIO go through `requestLoad()`, which only switches the load on if no fault is latched for it.
+  //
+  // The supervision does not rely on the controller loop: one hardware timer interrupt checks every `tick_ms`
+  // that the loop is still checking in and that temperature readings are still arriving for every load, and
+  // forces a load off (by writing the GPIO register directly) as soon as a fault is latched for it. A stalled
+  // loop latches `LoopStalled` for all loads. Checks on the temperature value itself (plausibility,
+  // over-temperature, rate of rise) are evaluated when a reading of the load is reported.
+  // A single failed read (e.g. a CRC error on the bus) is not a fault: it counts as a missing reading, which
+  // the sample age covers; only `max_implausible_readings` in a row latch `ImplausibleReading`.
+  // As a backstop, the loop task is registered with the hardware task watchdog, which resets the controller
+  // if the loop stalls for `watchdog_timeout_ms`; `addLoad()` drives a load off as soon as it is added.
+  //
+  // Worst-case latency from fault to load off:
+  //   * loop stalled:              max_loop_stall_ms + tick_ms  (2.1 s)
+  //   * no valid readings:         max_sample_age_ms + tick_ms  (15.1 s)
+  //   * over-temperature:          immediately when the reading is reported
+  //   * excessive rise:            2 x rise_window_ms           (60 s after the onset; the rate is averaged over windows)
+  //   * implausible readings:      when the last of `max_implausible_readings` in a row is reported (or as no valid readings)
+  //   * interrupts dead as well:   watchdog_timeout_ms          (5 s; reset, load pins off in `addLoad()`)
+  // Note: during the reset itself the GPIO floats; the gate of the MOSFET must be pulled down in hardware.
+  //
+  // Latched faults are persisted in RTC memory, which survives software and watchdog resets (not power loss);
+  // the record of the previous session is combined over the loads. They are cleared only on request
+  // (`clearFaults()`, e.g. by the clear-faults command).
+  // Every transition of a load, including a forced switch-off, is reported to its `HeaterAccounting`, if set.
+
+  public:
+  HeaterSupervisor(bool highIsOn, float maxTempC, float maxRiseCPerMin); // constructor
+
+  // Adds a load and drives it off; returns its index, or `max_loads` if all loads are taken. Call first in
+  // `setup()`, once per load.
+  uint8_t addLoad(uint8_t loadPin);
+  uint8_t loadCount();
+  uint8_t loadIndex(uint8_t loadPin); // index of the load on `loadPin`, or `max_loads` if it is not supervised
+
+  void begin();                                                   // recovers faults of the previous session; call after adding the loads
+  void setAccounting(uint8_t load, HeaterAccounting *accounting); // reports every transition of the load to `accounting`; nullptr: none
+  void arm();                                                     // starts supervision by timer interrupt and task watchdog; call at the end of `setup()`
+
+  void checkIn();                                    // Loop function: signals progress of the loop (and feeds the watchdog)
+  void reportTemperature(uint8_t load, float tempC); // reports a temperature reading of the load (including DEVICE_DISCONNECTED_C)
+  void requestLoad(uint8_t load, bool on);           // switches the load, unless a fault is latched for it (then forced off); ISR-safe
+
+  bool isLoadOn(uint8_t load);
+  uint32_t faults();                        // currently latched faults, combined over all loads
+  uint32_t faults(uint8_t load);            // currently latched faults of the load
+  uint32_t previousFaults();                // faults latched in the previous session (before the last reset)
+  uint32_t lastReactionMs();                // time between last sign of health and forcing a load off [milliseconds], of the latest fault
+  void clearFaults();                       // clears the latched faults of all loads (they remain off until requested again)
+  static void printFaults(uint32_t faults); // prints the names of the faults to the Serial console
+
+  private:
+  static void onTimerISR(void *arg);
+  void checkTimeouts(); // called from the timer ISR
+  void latchFault(uint8_t load, uint32_t fault, uint32_t lastHealthyUs);
+  void forceLoadOff(uint8_t load);
+  void writeLoad(uint8_t load, bool on); // writes the GPIO, and reports a transition to the accounting
+
+  // behavioral parameters are lifetime-constants (provided at construction)
+  const bool highIsOn;
+  const float maxTempC;
+  const float maxRiseCPerMin;
+
+  // loads, structure-of-arrays; the arrays the timer ISR walks first. Shared with the ISR, hence 32-bit
+  // timestamps [microseconds, wrapping]
+  volatile uint8_t count;
+  volatile uint32_t lastValidSampleUs[HeaterSafetyUtils::max_loads];
+  volatile uint32_t latchedFaults[HeaterSafetyUtils::max_loads];
+  uint8_t loadPin[HeaterSafetyUtils::max_loads];
+  HeaterAccounting *accounting[HeaterSafetyUtils::max_loads];
+  uint32_t riseReferenceUs[HeaterSafetyUtils::max_loads];
+  float riseReferenceTempC[HeaterSafetyUtils::max_loads];
+  uint8_t implausibleReadings[HeaterSafetyUtils::max_loads]; // consecutive implausible readings
+
+  // per-load flags, one bit per load
+  volatile uint8_t loadMask; // load is on
+  uint8_t riseReferenceMask; // load has a reference reading for the rate of rise
+
+  // dynamic state parameters, shared by the loads
+  volatile uint32_t lastCheckInUs;
+  volatile uint32_t reactionUs;
+  volatile bool armed;
+  uint32_t recoveredFaults;
+};
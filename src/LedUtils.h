@@ -1,5 +1,5 @@
 #pragma once
-#include "FrequentlyUtils.h"
+#include "LedcIndicator.h"
 #include <Arduino.h>
 
 namespace LedUtils {
@@ -9,39 +9,49 @@ namespace LedUtils {
 
 class LEDExpiringToggler {
 
+  // CLASS LEDExpiringToggler
+  //
   // This class toggles a GPIO Pin (uint8_t for ESP32 - style GPIOx) on and off
-  // throughout a specified interval. Each time toggleLED() is called, the internal
-  // time reference `lastTriggerObservedMilli` is set to the current time milliseconds.
-  // Throughout the interval `intervalMs` thereafter, the LED is allowed to be toggled
+  // throughout a specified interval. Each time `activate()` is called, the internal
+  // time reference is set to the current time milliseconds.
+  // Throughout the interval `lifetimeMs` thereafter, the LED is toggled
   // between on and off and when exceeding the interval, the LED is turned off.
   // To produce human-visible blinking, a `toggleIntervalMs` specifies the number of
   // milliseconds after which the output is alternated between on <-> off.
   //
-  // This implementation is intended to run on the controller loop, consuming minimal
-  // resources. Results should be largely deterministic across different controllers as
-  // we don't rely on CPU frequency.
+  // The constructor instantiates a _disabled_ toggler, which must be enabled by calling
+  // `activate()` for blinking to start. Once activated, the LED starts the blinking
+  // cycle in the ON state (after the optional delay).
+  // Negative lifetime means that the toggling remains active indefinitely until `expire()`
+  // is called.
+  //
+  // The blinking is generated by a `LedcIndicator` (LEDC peripheral and timer), not by the
+  // loop: `checkToggleLED()` is empty, and the timing holds while the loop is blocked. Other
+  // patterns (breathing, blink codes) are played on `indicator()`; `activate()` returns to blinking.
 
   public:
-  LEDExpiringToggler(uint8_t pin, int64_t lifetimeMs, unsigned long toggleIntervalMs, bool highIsOn); // constructor
+  LEDExpiringToggler(uint8_t pin, int64_t lifetimeMs, unsigned long toggleIntervalMs, bool highIsOn) // constructor
+      : output(pin, highIsOn),
+        lifetimeMs(lifetimeMs),
+        toggleIntervalMs(toggleIntervalMs) {
+  }
 
-  void checkToggleLED(); // Loop function
+  void checkToggleLED() {} // Loop function: nothing left to do, kept for the callers
 
   // Lifecycle functions
-  void activate(long delayMs = 0); // activates the LED toggling (after optional delay [milliseconds])
-  void expire();                   // disables the LED toggling
-  bool isExpired();                // returns true if LED toggling is expired/disabled
+  void activate(long delayMs = 0) { // starts blinking (after optional delay [milliseconds])
+    if (lifetimeMs == 0LL) return;  // zero lifetime: cannot be activated
+    output.blink(toggleIntervalMs, toggleIntervalMs, lifetimeMs, (delayMs > 0) ? static_cast<uint32_t>(delayMs) : 0);
+  }
+  void expire() { output.stop(); } // disables the LED toggling, LED off immediately
+  bool isExpired() { return output.isExpired(); }
+  bool isActive() { return !output.isExpired(); }
 
-  static const bool HIGH_IS_ON; // Indicates that GPIO state HIGH means LED is on
-  static const bool LOW_IS_ON;  // Indicates that GPIO state LOW means LED is on (modus operandi for build-in LEDs in Arduino Nano EPS32)
+  LedcIndicator &indicator() { return output; }
 
   private:
-  void setLedOn();
-  void setLedOff();
-
   // behavioral parameters are lifetime-constants (provided at construction)
-  const uint8_t pin;
-  const bool highIsOn;
-
-  // dynamic state parameters
-  FrequencyToggler toggler;
-};
\ No newline at end of file
+  LedcIndicator output;
+  const int64_t lifetimeMs;
+  const unsigned long toggleIntervalMs;
+};
@@ -0,0 +1,160 @@
+#include "LedcIndicator.h"
+#include <driver/ledc.h> // For ledc_fade_stop()
+#include <esp_cpu.h>     // For esp_cpu_get_cycle_count()
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                     CLASS LedcIndicator                                        *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// A hardware fade is stopped before the duty is written again: the LEDC driver would otherwise block the
+// write until the fade has completed. The output is inverted in the peripheral for an LED that is on at
+// LOW, so brightness 0 is always off.
+
+// constructor:
+LedcIndicator::LedcIndicator(uint8_t pin, bool highIsOn)
+    : pin(pin),
+      timer(nullptr),
+      stepTotal(0),
+      nextStep(0),
+      brightness(0),
+      fading(false),
+      expired(true),
+      nextStepUs(0),
+      endUs(-1),
+      steppedCount(0),
+      averageStepCycles(LedcUtils::step_cycles_alpha) {
+  ledcAttachChannel(pin, LedcUtils::pwm_frequency_hz, LedcUtils::pwm_resolution_bits, LedcUtils::channel);
+  ledcOutputInvert(pin, !highIsOn);
+  write(0);
+
+  esp_timer_create_args_t timerArgs = {};
+  timerArgs.callback = &LedcIndicator::onTimer;
+  timerArgs.arg = this;
+  timerArgs.dispatch_method = ESP_TIMER_TASK;
+  timerArgs.name = "indicator";
+  esp_timer_create(&timerArgs, &timer);
+}
+
+LedcIndicator::~LedcIndicator() {
+  halt();
+  write(0);
+  esp_timer_delete(timer);
+  ledcDetach(pin);
+}
+
+void LedcIndicator::blink(uint32_t onMs, uint32_t offMs, int64_t lifetimeMs /* = -1 */, uint32_t delayMs /* = 0 */) {
+  const IndicatorStep pattern[] = {{onMs, LedcUtils::full_brightness, false}, {offMs, 0, false}};
+  play(pattern, 2, lifetimeMs, delayMs);
+}
+
+void LedcIndicator::breathe(uint32_t periodMs, int64_t lifetimeMs /* = -1 */, uint32_t delayMs /* = 0 */) {
+  const IndicatorStep pattern[] = {{periodMs / 2, LedcUtils::full_brightness, true}, {periodMs - periodMs / 2, 0, true}};
+  play(pattern, 2, lifetimeMs, delayMs);
+}
+
+void LedcIndicator::blinkCode(uint8_t flashes, uint32_t flashMs, uint32_t pauseMs, int64_t lifetimeMs /* = -1 */, uint32_t delayMs /* = 0 */) {
+  if (flashes == 0) flashes = 1;
+  if (flashes > LedcUtils::max_code_flashes) flashes = LedcUtils::max_code_flashes;
+  IndicatorStep pattern[LedcUtils::max_steps];
+  for (uint8_t flash = 0; flash < flashes; flash++) {
+    pattern[2 * flash] = {flashMs, LedcUtils::full_brightness, false};
+    pattern[2 * flash + 1] = {flashMs, 0, false};
+  }
+  pattern[2 * flashes - 1].durationMs = pauseMs; // the pause replaces the gap after the last flash
+  play(pattern, 2 * flashes, lifetimeMs, delayMs);
+}
+
+void LedcIndicator::play(const IndicatorStep *steps, uint8_t count, int64_t lifetimeMs /* = -1 */, uint32_t delayMs /* = 0 */) {
+  halt();
+  if (count > LedcUtils::max_steps) count = LedcUtils::max_steps;
+  for (uint8_t i = 0; i < count; i++) {
+    this->steps[i] = steps[i];
+    if (this->steps[i].durationMs == 0) this->steps[i].durationMs = 1; // a pattern must advance in time
+  }
+  stepTotal = count;
+  nextStep = 0;
+  if (count == 0) {
+    stop();
+    return;
+  }
+  expired = false;
+  nextStepUs = esp_timer_get_time() + static_cast<int64_t>(delayMs) * 1000LL;
+  endUs = (lifetimeMs >= 0) ? nextStepUs + lifetimeMs * 1000LL : -1;
+  if (delayMs == 0) {
+    step(); // first step right away; the timer is stopped, so the loop steps in its place
+  } else {
+    esp_timer_start_once(timer, static_cast<uint64_t>(delayMs) * 1000ULL);
+  }
+}
+
+void LedcIndicator::stop() {
+  halt();
+  write(0);
+  brightness = 0;
+  expired = true;
+}
+
+bool LedcIndicator::isExpired() { return expired; }
+
+uint32_t LedcIndicator::stepCount() { return steppedCount; }
+
+float LedcIndicator::stepCycles() { return averageStepCycles.value(); }
+
+void LedcIndicator::printStats() {
+  Serial.print(F("Status LED: "));
+  Serial.print(steppedCount);
+  Serial.print(F(" pattern steps, "));
+  Serial.print(averageStepCycles.value(), 0);
+  Serial.println(F(" CPU cycles per step"));
+}
+
+void LedcIndicator::onTimer(void *arg) { static_cast<LedcIndicator *>(arg)->step(); }
+
+void LedcIndicator::step() {
+  esp_cpu_cycle_count_t startCycles = esp_cpu_get_cycle_count();
+  int64_t nowUs = esp_timer_get_time();
+  if (fading) {
+    ledc_fade_stop(LEDC_LOW_SPEED_MODE, static_cast<ledc_channel_t>(LedcUtils::channel));
+    fading = false;
+  }
+
+  if ((endUs >= 0) && (nowUs >= endUs)) {
+    write(0);
+    brightness = 0;
+    expired = true;
+  } else {
+    // steps missed entirely are skipped (not written)
+    while (nextStepUs + static_cast<int64_t>(steps[nextStep].durationMs) * 1000LL <= nowUs) {
+      nextStepUs += static_cast<int64_t>(steps[nextStep].durationMs) * 1000LL;
+      brightness = steps[nextStep].brightness;
+      nextStep = (nextStep + 1 < stepTotal) ? nextStep + 1 : 0;
+    }
+
+    const IndicatorStep &current = steps[nextStep];
+    nextStepUs += static_cast<int64_t>(current.durationMs) * 1000LL;
+    int remainingMs = static_cast<int>((nextStepUs - nowUs) / 1000LL);
+    if (current.fade && (remainingMs > 0) && (current.brightness != brightness)) {
+      fading = ledcFade(pin, brightness, current.brightness, remainingMs);
+    }
+    if (!fading) write(current.brightness);
+    brightness = current.brightness;
+    nextStep = (nextStep + 1 < stepTotal) ? nextStep + 1 : 0;
+
+    int64_t wakeUs = ((endUs >= 0) && (endUs < nextStepUs)) ? endUs : nextStepUs;
+    esp_timer_start_once(timer, static_cast<uint64_t>(wakeUs - nowUs));
+  }
+
+  float cycles = static_cast<float>(esp_cpu_get_cycle_count() - startCycles);
+  if (steppedCount == 0) averageStepCycles.reset(cycles);
+  else averageStepCycles.update(cycles);
+  steppedCount = steppedCount + 1;
+}
+
+void LedcIndicator::halt() {
+  esp_timer_stop(timer); // fails harmlessly if the timer is not running
+  if (fading) {
+    ledc_fade_stop(LEDC_LOW_SPEED_MODE, static_cast<ledc_channel_t>(LedcUtils::channel));
+    fading = false;
+  }
+}
+
+void LedcIndicator::write(uint8_t brightness) { ledcWrite(pin, brightness); }
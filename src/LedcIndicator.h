@@ -0,0 +1,84 @@
+#pragma once
+#include "Ewma.h"
+#include <Arduino.h>
+#include <esp_timer.h> // For esp_timer_handle_t
+
+namespace LedcUtils {
+  constexpr uint8_t channel = 0;               // LEDC channel of the indicator (the controller drives no other PWM output)
+  constexpr uint32_t pwm_frequency_hz = 5000;  // well above visible flicker
+  constexpr uint8_t pwm_resolution_bits = 8;   // brightness levels 0..255
+  constexpr uint8_t full_brightness = 255;     // brightness of an LED that is on
+  constexpr uint8_t max_steps = 16;            // steps of a pattern
+  constexpr uint8_t max_code_flashes = max_steps / 2;
+  constexpr float step_cycles_alpha = 0.05f;   // smoothing of the CPU cycles per step
+}
+
+// One step of an indicator pattern: the LED jumps to `brightness` at the start of the step, or with `fade`,
+// ramps there in hardware over the duration of the step
+struct IndicatorStep {
+  uint32_t durationMs;
+  uint8_t brightness;
+  bool fade;
+};
+
+class LedcIndicator {
+
+  // CLASS LedcIndicator
+  //
+  // Status LED on a channel of the LEDC PWM peripheral, with its patterns timed by an `esp_timer`. The
+  // peripheral holds the brightness (and ramps it, with hardware fades), and the timer callback only steps
+  // the pattern: a few register writes at every step, in the high-priority timer task. Hence the patterns
+  // run without the controller loop, and keep their timing while the loop is blocked (e.g. in `delay()`).
+  //
+  // Steps are scheduled on absolute times, so the latency of the timer callback does not accumulate; if
+  // steps were missed entirely, the pattern skips ahead to the step due now. With a lifetime, the LED is
+  // switched off once it has elapsed, and the indicator expires.
+  //
+  // Patterns are changed by the loop while the timer is stopped; this relies on the single core of the
+  // ESP32-C3 (the callback runs to completion before the loop resumes). As the constructor attaches the
+  // LEDC channel, an indicator must be constructed at run time (e.g. with a `StaticInstance` in `setup()`).
+
+  public:
+  LedcIndicator(uint8_t pin, bool highIsOn); // constructor: LED off, expired
+  ~LedcIndicator();
+
+  // Patterns; each replaces the current pattern, and starts after `delayMs` [milliseconds]. A negative
+  // lifetime runs the pattern until `stop()` is called.
+  void blink(uint32_t onMs, uint32_t offMs, int64_t lifetimeMs = -1, uint32_t delayMs = 0); // starts ON
+  void breathe(uint32_t periodMs, int64_t lifetimeMs = -1, uint32_t delayMs = 0);           // fades in and out
+  // Blink code: `flashes` (up to `max_code_flashes`) flashes of `flashMs`, then a pause of `pauseMs`
+  void blinkCode(uint8_t flashes, uint32_t flashMs, uint32_t pauseMs, int64_t lifetimeMs = -1, uint32_t delayMs = 0);
+  void play(const IndicatorStep *steps, uint8_t count, int64_t lifetimeMs = -1, uint32_t delayMs = 0);
+
+  void stop();      // LED off immediately, the indicator expires
+  bool isExpired(); // true once stopped, or after the lifetime
+
+  // Statistics
+  uint32_t stepCount();   // timer callbacks since construction
+  float stepCycles();     // average CPU cycles of a timer callback
+  void printStats();      // prints the statistics to the Serial console
+
+  private:
+  static void onTimer(void *arg);
+  void step(); // called from the timer task
+  void halt(); // stops the timer and a fade in progress
+  void write(uint8_t brightness);
+
+  // behavioral parameters are lifetime-constants (provided at construction)
+  const uint8_t pin;
+
+  // dynamic state parameters; written by the timer task while the timer runs
+  esp_timer_handle_t timer;
+  IndicatorStep steps[LedcUtils::max_steps];
+  uint8_t stepTotal;
+  uint8_t nextStep;
+  uint8_t brightness; // latest brightness written (or target of the fade in progress)
+  bool fading;
+  volatile bool expired;
+  int64_t nextStepUs; // start of the next step
+  int64_t endUs;      // end of the lifetime; negative: none
+
+  // statistics
+  volatile uint32_t steppedCount;
+  Ewma averageStepCycles;
+};
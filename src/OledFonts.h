@@ -0,0 +1,38 @@
+#pragma once
+#include <Arduino.h>
+#include <U8g2lib.h>
+
+namespace OledFonts {
+
+  // Metrics of the fonts used for plain text on the 72x40 OLED screen. For two lines of text, the baseline
+  // of the first line is at `yOffset + fontHeight` and the baseline of the second at `yOffset + 2*fontHeight + yPad`.
+  struct Metrics {
+    uint8_t maxTextHeight; // largest requested text height served by this font
+    const uint8_t *font;
+    uint8_t fontHeight; // vertical pitch of the glyphs [pixels]
+    uint8_t yOffset;    // distance from the top of the screen to the first line [pixels]
+    uint8_t yPad;       // additional spacing between first and second line [pixels]
+  };
+
+  // Fonts ordered by increasing text height. Text heights above the last entry's `maxTextHeight`
+  // are served by the last entry.
+  constexpr Metrics text_fonts[] = {
+      {10, u8g2_font_5x8_tf, 10, 6, 6},
+      {12, u8g2_font_6x12_tf, 10, 5, 5},
+      {13, u8g2_font_6x13_tf, 10, 4, 6},
+      {14, u8g2_font_7x13_tf, 11, 3, 7},
+      {15, u8g2_font_8x13_tf, 12, 2, 4},
+      {16, u8g2_font_9x15_tf, 13, 1, 2},
+      {18, u8g2_font_9x18_tf, 14, 0, 2},
+      {20, u8g2_font_10x20_tf, 15, 0, 2},
+  };
+  constexpr size_t text_fonts_count = sizeof(text_fonts) / sizeof(text_fonts[0]);
+
+  // Returns the metrics of the smallest font that serves the requested text height.
+  constexpr const Metrics &forTextHeight(uint8_t textHeight) {
+    for (size_t i = 0; i < text_fonts_count - 1; i++) {
+      if (textHeight <= text_fonts[i].maxTextHeight) return text_fonts[i];
+    }
+    return text_fonts[text_fonts_count - 1];
+  }
+}
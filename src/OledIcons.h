@@ -0,0 +1,23 @@
+#pragma once
+#include <Arduino.h>
+
+// XBM icons of the OLED screen, shared by the screens (compiled into flash once). Animated icons are packed by
+// tools/xbmpack instead (see AnimationAssets.h).
+
+// Char 'flash-8x.png' from the Open Iconic font https://github.com/iconic/open-iconic, down-scaled to 20x20 pixels
+constexpr int epd_bitmap_flash_width = 20;
+constexpr int epd_bitmap_flash_height = 20;
+inline const unsigned char epd_bitmap_flash[] PROGMEM = {
+    0x00, 0x0E, 0x00, 0x00, 0x0F, 0x00, 0x00, 0x07, 0x00, 0x80, 0x07, 0x00,
+    0xC0, 0x03, 0x00, 0xC0, 0x7F, 0x00, 0xE0, 0x3F, 0x00, 0x40, 0x3E, 0x00,
+    0x00, 0x1C, 0x00, 0x00, 0x1E, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00,
+    0x40, 0x2F, 0x00, 0xE0, 0x3F, 0x00, 0xC0, 0x1F, 0x00, 0xC0, 0x0F, 0x00,
+    0xC0, 0x07, 0x00, 0x80, 0x03, 0x00, 0x80, 0x01, 0x00, 0x80, 0x00, 0x00};
+
+// Wifi symbol, shown while the wifi internet connection is active
+// Char `rss-8x.png' from the Open Iconic font https://github.com/iconic/open-iconic, down-scaled to 12x12 pixels
+constexpr int epd_bitmap_wifi_width = 12;
+constexpr int epd_bitmap_wifi_height = 12;
+inline const unsigned char epd_bitmap_wifi[] PROGMEM = {
+    0x80, 0x07, 0xE0, 0x03, 0x30, 0x00, 0x18, 0x07, 0xCC, 0x03, 0x66, 0x00,
+    0x32, 0x06, 0x93, 0x03, 0x9B, 0x00, 0xDB, 0x0E, 0x49, 0x0E, 0x00, 0x0E};
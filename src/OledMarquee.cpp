@@ -0,0 +1,156 @@
+#include "OledMarquee.h"
+#include <cstring> // For memcpy, memset
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                      CLASS OledMarquee                                         *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Non-blocking horizontal scrolling of a single line of text on the on-board OLED screen.
+//
+// The u8g2 frame buffer of the SSD1306 is organized in pages of 8 pixel rows: the byte at index
+// `page * bufferWidth + x` holds the 8 pixels of column x within that page. The off-screen strip
+// uses the same layout (with `stripWidth` instead of `bufferWidth`), so that rendering a frame of
+// the scrolling text is a plain byte copy of a window of the strip - no font decoding per frame.
+//
+// With rotation U8G2_R2 (as used on the Abrobot board), u8g2 maps the logical pixel (x, y) to the
+// physical pixel (W-1-x, H-1-y) in the frame buffer. For pages of 8 rows (display height 40 is a
+// multiple of 8), this means that logical pages and columns are reversed, while the bit order
+// within each byte is consistently reversed in both the strip and the frame buffer. The strip is
+// always stored in logical column order; the reversal is applied when copying.
+
+// The scrolling line repeats with `period`: columns [0, screen width) of a pass are blank, the text
+// follows. Column c of the line is kept at index c % stripWidth of the strip; the strip holds the columns
+// [renderedEnd - stripWidth, renderedEnd), and a chunk of one screen width is rendered once the window
+// would pass `renderedEnd` - so a strip of two screen widths always holds the whole window.
+
+// constructor:
+OledMarquee::OledMarquee(U8G2 &display, unsigned long stepIntervalMs, int16_t passes)
+    : display(display),
+      passes(passes),
+      stepTrigger(FrequencyUtils::unbounded_lifetime, stepIntervalMs),
+      stripWidth(0),
+      bandPages(1),
+      firstPage(0),
+      rotated180(false),
+      text(nullptr),
+      font(nullptr),
+      textWidth(0),
+      period(1),
+      offset(0),
+      renderedEnd(0),
+      passesCompleted(0) {
+}
+
+void OledMarquee::render(const char *text, const uint8_t *font, uint8_t firstPage /* = 1 */) {
+  const uint16_t bufferWidth = display.getBufferTileWidth() * 8;
+  const uint8_t bufferPages = display.getBufferTileHeight();
+  rotated180 = (display.getU8g2()->cb == U8G2_R2);
+  this->text = text;
+  this->font = font;
+
+  display.setFont(font);
+  int ascent = display.getAscent();
+  int descent = display.getDescent(); // negative for fonts with descenders
+
+  // band of whole 8-pixel pages that holds the text (at least one page, clipped at the bottom of the screen,
+  // and at the pages a strip of two screen widths can hold)
+  this->firstPage = (firstPage < bufferPages) ? firstPage : bufferPages - 1;
+  bandPages = static_cast<uint8_t>((ascent - descent + 7) / 8);
+  if (bandPages == 0) bandPages = 1;
+  if (bandPages > bufferPages - this->firstPage) bandPages = bufferPages - this->firstPage;
+  uint8_t maxPages = MarqueeUtils::strip_capacity_bytes / (2 * bufferWidth);
+  if (bandPages > maxPages) bandPages = maxPages;
+
+  stripWidth = MarqueeUtils::strip_capacity_bytes / bandPages;
+  textWidth = display.getUTF8Width(text);
+  period = static_cast<uint32_t>(bufferWidth) + textWidth;
+  offset = 0;
+  renderedEnd = 0;
+}
+
+void OledMarquee::checkScroll() {
+  if (!stepTrigger.checkTrigger()) return; // also false if expired
+
+  const uint16_t bufferWidth = display.getBufferTileWidth() * 8;
+  while (offset + bufferWidth > renderedEnd) renderChunk();
+  blitWindow();
+
+  // advance by one pixel; after a pass, the text has left the screen at the left edge
+  offset++;
+  if (offset % period != 0) return;
+  passesCompleted++;
+  if ((passes >= 0) && (passesCompleted >= passes)) {
+    stepTrigger.expire();
+  }
+}
+
+void OledMarquee::activate(long delayMs /* = 0 */) {
+  if ((passes == 0) || (text == nullptr)) return; // nothing to scroll
+  offset = 0;
+  renderedEnd = 0;
+  passesCompleted = 0;
+
+  // start from a blank screen; afterwards, only the text band is transferred to the display
+  display.clearBuffer();
+  display.sendBuffer();
+  stepTrigger.activate(delayMs);
+}
+
+void OledMarquee::expire() { stepTrigger.expire(); }
+
+bool OledMarquee::isExpired() { return stepTrigger.isExpired(); }
+
+// The chunk is drawn into the top pages of the frame buffer, with the text shifted to its position in the
+// chunk (u8g2 clips the glyphs outside of the buffer), and the band pages are then copied into the strip
+void OledMarquee::renderChunk() {
+  const uint16_t bufferWidth = display.getBufferTileWidth() * 8;
+  uint8_t *buffer = display.getBufferPtr();
+  uint32_t chunkStart = renderedEnd;
+  uint32_t passStart = chunkStart - chunkStart % period;
+
+  display.clearBuffer();
+  if (textWidth > 0) {
+    display.setFont(font);
+    display.setFontMode(1); // transparent mode, which is faster
+    display.drawUTF8(static_cast<int>(passStart + bufferWidth) - static_cast<int>(chunkStart), display.getAscent(), text);
+  }
+  for (uint8_t p = 0; p < bandPages; p++) {
+    const uint8_t *src = buffer + physicalPage(p) * bufferWidth;
+    uint8_t *dst = strip + p * stripWidth;
+    for (uint16_t i = 0; i < bufferWidth; i++) dst[(chunkStart + i) % stripWidth] = rotated180 ? src[bufferWidth - 1 - i] : src[i];
+  }
+  renderedEnd += bufferWidth;
+}
+
+void OledMarquee::blitWindow() {
+  const uint16_t bufferWidth = display.getBufferTileWidth() * 8;
+  uint8_t *buffer = display.getBufferPtr();
+
+  for (uint8_t p = 0; p < bandPages; p++) {
+    uint8_t *dst = buffer + physicalPage(firstPage + p) * bufferWidth;
+    const uint8_t *src = strip + p * stripWidth;
+    uint16_t col = offset % stripWidth;
+
+    if (!rotated180) {
+      // at most two contiguous copies: the window may wrap around the end of the strip
+      for (uint16_t x = 0; x < bufferWidth; col = 0) {
+        uint16_t n = stripWidth - col;
+        if (n > bufferWidth - x) n = bufferWidth - x;
+        memcpy(dst + x, src + col, n);
+        x += n;
+      }
+    } else {
+      for (uint16_t x = 0; x < bufferWidth; x++) {
+        dst[bufferWidth - 1 - x] = src[col];
+        if (++col == stripWidth) col = 0;
+      }
+    }
+  }
+
+  // transfer only the tile rows of the text band (tile coordinates are physical, i.e. not rotated)
+  uint8_t topPhysicalPage = rotated180 ? physicalPage(firstPage + bandPages - 1) : firstPage;
+  display.updateDisplayArea(0, topPhysicalPage, display.getBufferTileWidth(), bandPages);
+}
+
+uint8_t OledMarquee::physicalPage(uint8_t logicalPage) {
+  return rotated180 ? display.getBufferTileHeight() - 1 - logicalPage : logicalPage;
+}
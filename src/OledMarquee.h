@@ -0,0 +1,74 @@
+#pragma once
+#include "FrequentlyUtils.h"
+#include <Arduino.h>
+#include <U8g2lib.h>
+
+namespace MarqueeUtils {
+  constexpr uint16_t strip_capacity_bytes = 1024; // off-screen strip: (ring width in pixels) x (number of 8-pixel pages)
+  constexpr int16_t unbounded_passes = -1;
+}
+
+class OledMarquee {
+
+  // CLASS OledMarquee
+  //
+  // Non-blocking horizontal scrolling of a single line of text on the on-board OLED screen.
+  //
+  // The text is rendered into an off-screen 1-bit-per-pixel strip, which uses the same memory layout as the
+  // u8g2 frame buffer: one byte holds a vertical column of 8 pixels (one "page"). Hence, scrolling by one pixel
+  // is just copying a shifted window of the strip into the text band of the frame buffer, and only the tile
+  // rows of that band are transferred to the display. The strip is a ring of at least two screen widths:
+  // the text is rendered one screen width ahead of the window as it scrolls, so texts of any width scroll
+  // through completely. The text enters at the right edge of the screen and leaves at the left edge.
+  //
+  // The constructor instantiates a _disabled_ marquee, which can be enabled by calling `activate()`. Once activated,
+  // `checkScroll()` advances the text by one pixel on the first call within every `stepIntervalMs` time interval.
+  // After the text has scrolled through `passes` times, or `expire()` is called, the marquee deactivates - until
+  // `activate()` is called again. Negative `passes` means that the marquee scrolls until `expire()` is called.
+  //
+  // This implementation is intended to run on the controller loop, consuming minimal
+  // resources. Results should be largely deterministic across different controllers as
+  // we don't rely on CPU frequency.
+
+  public:
+  OledMarquee(U8G2 &display, unsigned long stepIntervalMs, int16_t passes); // constructor
+
+  // Sets `text` (which must stay valid while the marquee runs, e.g. a literal) with the given u8g2 font. The
+  // text band starts at 8-pixel page `firstPage` (i.e. pixel row 8*firstPage) of the screen.
+  // Note: rendering uses the u8g2 frame buffer as scratch space, i.e. the buffer content outside the text
+  // band is lost while the marquee runs.
+  void render(const char *text, const uint8_t *font, uint8_t firstPage = 1);
+
+  void checkScroll(); // Loop function
+
+  // Lifecycle functions
+  void activate(long delayMs = 0); // clears the screen and activates scrolling (after optional delay [milliseconds])
+  void expire();                   // disables scrolling
+  bool isExpired();                // returns true if scrolling is expired/disabled
+
+  private:
+  void renderChunk();            // renders the next screen width of the scrolling line into the strip
+  void blitWindow();             // copies the strip window starting at `offset` into the text band of the frame buffer
+  uint8_t physicalPage(uint8_t); // maps a logical page of the screen to the page index in the frame buffer
+
+  U8G2 &display;
+  const int16_t passes;
+  FrequencyTrigger stepTrigger;
+
+  // off-screen strip, page-major: byte `strip[p * stripWidth + (c % stripWidth)]` holds column c of the
+  // scrolling line in band page p
+  uint8_t strip[MarqueeUtils::strip_capacity_bytes];
+  uint16_t stripWidth;
+  uint8_t bandPages;
+  uint8_t firstPage;
+  bool rotated180; // u8g2 draws with U8G2_R2, i.e. logical columns and pages are reversed in the frame buffer
+  const char *text;
+  const uint8_t *font;
+  uint16_t textWidth;
+  uint32_t period; // columns of one pass of the scrolling line: a blank screen width, then the text
+
+  // dynamic state parameters
+  uint32_t offset;      // column of the scrolling line at the left edge of the screen
+  uint32_t renderedEnd; // columns of the scrolling line rendered into the strip so far
+  int16_t passesCompleted;
+};
@@ -0,0 +1,234 @@
+#include "OledWidgets.h"
+#include <cstring> // For strcmp
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                        STRUCT OledBox                                          *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+bool OledBox::intersects(const OledBox &other) const {
+  if (isEmpty() || other.isEmpty()) return false;
+  return (x < other.x + other.w) && (other.x < x + w) && (y < other.y + other.h) && (other.y < y + h);
+}
+
+void OledBox::unite(const OledBox &other) {
+  if (other.isEmpty()) return;
+  if (isEmpty()) {
+    *this = other;
+    return;
+  }
+  int16_t x1 = max(x + w, other.x + other.w);
+  int16_t y1 = max(y + h, other.y + other.h);
+  x = min(x, other.x);
+  y = min(y, other.y);
+  w = x1 - x;
+  h = y1 - y;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                       CLASS OledWidget                                         *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+// constructor:
+OledWidget::OledWidget(int16_t x, int16_t y) : x(x), y(y), box{x, y, 0, 0}, dirty(true) {}
+
+/* ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ TextWidget ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ */
+
+// constructor:
+TextWidget::TextWidget(int16_t x, int16_t y, const uint8_t *font, const char *text, int16_t width /* = 0 */)
+    : OledWidget(x, y), font(font), text(text), width(width) {}
+
+void TextWidget::setText(const char *text) {
+  if ((text == this->text) || (strcmp(text, this->text) == 0)) return; // no change
+  this->text = text;
+  dirty = true;
+}
+
+void TextWidget::layout(U8G2 &display) {
+  display.setFont(font);
+  int16_t textWidth = display.getUTF8Width(text);
+  box = {x, static_cast<int16_t>(y - display.getAscent()), max(textWidth, width), static_cast<int16_t>(display.getAscent() - display.getDescent())};
+}
+
+void TextWidget::draw(U8G2 &display) {
+  display.setFont(font);
+  display.drawUTF8(x, y, text);
+}
+
+/* ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ NumberWidget ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ */
+
+// constructor:
+NumberWidget::NumberWidget(int16_t x, int16_t y, const uint8_t *font, const char *widestValue, const uint8_t *negativeFont /* = nullptr */)
+    : OledWidget(x, y),
+      font(font),
+      negativeFont(negativeFont != nullptr ? negativeFont : font),
+      widestValue(widestValue),
+      value(0),
+      valid(true) {}
+
+void NumberWidget::setValue(int value) {
+  if (valid && (value == this->value)) return; // no change
+  this->value = value;
+  valid = true;
+  dirty = true;
+}
+
+void NumberWidget::setInvalid() {
+  if (!valid) return; // no change
+  valid = false;
+  dirty = true;
+}
+
+void NumberWidget::layout(U8G2 &display) {
+  // the box must cover the widest value in either font
+  display.setFont(font);
+  int16_t width = display.getStrWidth(widestValue);
+  int16_t ascent = display.getAscent();
+  int16_t descent = display.getDescent();
+  display.setFont(negativeFont);
+  width = max(width, static_cast<int16_t>(display.getStrWidth(widestValue)));
+  ascent = max(ascent, static_cast<int16_t>(display.getAscent()));
+  descent = min(descent, static_cast<int16_t>(display.getDescent()));
+  box = {x, static_cast<int16_t>(y - ascent), width, static_cast<int16_t>(ascent - descent)};
+}
+
+void NumberWidget::draw(U8G2 &display) {
+  if (!valid) {
+    display.setFont(font);
+    display.drawUTF8(x, y, "--");
+    return;
+  }
+  display.setFont(value >= 0 ? font : negativeFont);
+  display.setCursor(x, y);
+  display.print(value);
+}
+
+/* ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ BitmapWidget ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ */
+
+// constructor:
+BitmapWidget::BitmapWidget(int16_t x, int16_t y, uint8_t width, uint8_t height, const unsigned char *bitmap)
+    : OledWidget(x, y), width(width), height(height), bitmap(bitmap), visible(true) {}
+
+void BitmapWidget::setVisible(bool visible) {
+  if (visible == this->visible) return; // no change
+  this->visible = visible;
+  dirty = true;
+}
+
+void BitmapWidget::layout(U8G2 & /* display */) { box = {x, y, width, height}; }
+
+void BitmapWidget::draw(U8G2 &display) {
+  if (visible) display.drawXBMP(x, y, width, height, bitmap);
+}
+
+/* ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ AnimationWidget ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ */
+
+// constructor:
+AnimationWidget::AnimationWidget(int16_t x, int16_t y, XbmAnimationPlayer &player)
+    : OledWidget(x, y), player(player), active(false) {}
+
+void AnimationWidget::setActive(bool active) {
+  if (active == this->active) return; // no change
+  this->active = active;
+  dirty = true;
+}
+
+bool AnimationWidget::isActive() { return active; }
+
+void AnimationWidget::layout(U8G2 & /* display */) { box = {x, y, player.xbm().width, player.xbm().height}; }
+
+void AnimationWidget::draw(U8G2 &display) {
+  if (active) player.blit(display, x, y);
+}
+
+void AnimationWidget::poll() {
+  // the player keeps decoding while the icon is hidden, so it shows a current frame once activated
+  if (player.checkFrame() && active) dirty = true;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                       CLASS OledScreen                                         *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Partial redraws rely on the page layout of the u8g2 frame buffer: the display is updated in tiles
+// of 8x8 pixels, and `updateDisplayArea()` takes tile coordinates in the physical orientation of the
+// panel. With rotation U8G2_R2, the logical box (x, y, w, h) covers the physical pixels starting at
+// (W-x-w, H-y-h).
+
+// constructor:
+OledScreen::OledScreen(U8G2 &display, bool drawBorder)
+    : display(display),
+      drawBorder(drawBorder),
+      widgets{},
+      widgetCount(0),
+      laidOut(false) {}
+
+void OledScreen::add(OledWidget &widget) {
+  if (widgetCount >= OledWidgetUtils::max_widgets_per_screen) return;
+  widgets[widgetCount++] = &widget;
+  laidOut = false;
+}
+
+void OledScreen::show() {
+  if (!laidOut) {
+    for (uint8_t i = 0; i < widgetCount; i++) widgets[i]->layout(display);
+    laidOut = true;
+  }
+  redraw({0, 0, static_cast<int16_t>(display.getDisplayWidth()), static_cast<int16_t>(display.getDisplayHeight())});
+}
+
+void OledScreen::checkRedraw() {
+  if (!laidOut) return; // never shown
+
+  OledBox dirtyArea = {0, 0, 0, 0};
+  for (uint8_t i = 0; i < widgetCount; i++) {
+    widgets[i]->poll();
+    if (widgets[i]->isDirty()) dirtyArea.unite(widgets[i]->bounds());
+  }
+  if (dirtyArea.isEmpty()) return;
+  redraw(dirtyArea);
+}
+
+void OledScreen::redraw(const OledBox &area) {
+  display.setClipWindow(area.x, area.y, area.x + area.w, area.y + area.h);
+  display.setDrawColor(0);
+  display.drawBox(area.x, area.y, area.w, area.h);
+  display.setDrawColor(1);
+  display.setFontMode(1);
+  display.setBitmapMode(1);
+
+  if (drawBorder) display.drawFrame(0, 0, display.getDisplayWidth(), display.getDisplayHeight());
+  // overlapping widgets are redrawn as well (clipped to the area), in the order they were added
+  for (uint8_t i = 0; i < widgetCount; i++) {
+    if (!widgets[i]->bounds().intersects(area)) continue;
+    widgets[i]->draw(display);
+    widgets[i]->clearDirty();
+  }
+
+  display.setMaxClipWindow();
+  sendTiles(area);
+}
+
+void OledScreen::sendTiles(const OledBox &area) {
+  const int16_t width = display.getDisplayWidth();
+  const int16_t height = display.getDisplayHeight();
+
+  // clip to the screen
+  int16_t x0 = max(area.x, static_cast<int16_t>(0));
+  int16_t y0 = max(area.y, static_cast<int16_t>(0));
+  int16_t x1 = min(static_cast<int16_t>(area.x + area.w), width);
+  int16_t y1 = min(static_cast<int16_t>(area.y + area.h), height);
+  if ((x0 >= x1) || (y0 >= y1)) return;
+
+  // map to physical orientation of the panel
+  if (display.getU8g2()->cb == U8G2_R2) {
+    int16_t px0 = width - x1;
+    int16_t py0 = height - y1;
+    x1 = width - x0;
+    y1 = height - y0;
+    x0 = px0;
+    y0 = py0;
+  }
+
+  uint8_t tx = x0 / 8;
+  uint8_t ty = y0 / 8;
+  display.updateDisplayArea(tx, ty, (x1 + 7) / 8 - tx, (y1 + 7) / 8 - ty);
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include "XbmAnimation.h"
+#include <Arduino.h>
+#include <U8g2lib.h>
+
+namespace OledWidgetUtils {
+  constexpr uint8_t max_widgets_per_screen = 8;
+}
+
+// Axis-aligned rectangle in logical screen coordinates [pixels]. Empty if width or height is zero.
+struct OledBox {
+  int16_t x;
+  int16_t y;
+  int16_t w;
+  int16_t h;
+
+  bool isEmpty() const { return (w <= 0) || (h <= 0); }
+  bool intersects(const OledBox &other) const;
+  void unite(const OledBox &other); // grows this box to the bounding box of both boxes
+};
+
+class OledWidget {
+
+  // CLASS OledWidget
+  //
+  // Base class of the retained-mode widgets on the on-board OLED screen. A widget is anchored at a fixed
+  // position; its bounding box is computed _once_ by `layout()`. Whenever the value bound to the widget
+  // changes, the widget marks itself dirty, so that the owning `OledScreen` only re-renders the area of
+  // the dirty widgets.
+
+  public:
+  OledWidget(int16_t x, int16_t y); // constructor
+
+  virtual void layout(U8G2 &display) = 0; // computes the bounding box (once, e.g. for the widest value)
+  virtual void draw(U8G2 &display) = 0;   // draws the widget (the screen has cleared and clipped its area)
+  virtual void poll() {}                  // Loop function: time-driven widgets mark themselves dirty here
+
+  bool isDirty() { return dirty; }
+  void markDirty() { dirty = true; }
+  void clearDirty() { dirty = false; }
+  const OledBox &bounds() { return box; }
+
+  protected:
+  const int16_t x;
+  const int16_t y;
+  OledBox box;
+  bool dirty;
+};
+
+class TextWidget : public OledWidget {
+
+  // Static or occasionally changing text with baseline at (x, y). The text is _not_ copied, i.e. the
+  // pointer must remain valid (e.g. string literals). The box is as wide as the initial text, unless a
+  // larger `width` is specified.
+
+  public:
+  TextWidget(int16_t x, int16_t y, const uint8_t *font, const char *text, int16_t width = 0); // constructor
+
+  void setText(const char *text);
+
+  void layout(U8G2 &display) override;
+  void draw(U8G2 &display) override;
+
+  private:
+  const uint8_t *font;
+  const char *text;
+  const int16_t width;
+};
+
+class NumberWidget : public OledWidget {
+
+  // Integer value with baseline at (x, y). The box is sized for `widestValue` (e.g. "-99"). Optionally,
+  // negative values are drawn with a different font (e.g. a narrower, numbers-only font).
+
+  public:
+  NumberWidget(int16_t x, int16_t y, const uint8_t *font, const char *widestValue, const uint8_t *negativeFont = nullptr); // constructor
+
+  void setValue(int value);
+  void setInvalid(); // shows "--" until the next `setValue()`, e.g. while a sensor fails
+
+  void layout(U8G2 &display) override;
+  void draw(U8G2 &display) override;
+
+  private:
+  const uint8_t *font;
+  const uint8_t *negativeFont;
+  const char *widestValue;
+  int value;
+  bool valid;
+};
+
+class BitmapWidget : public OledWidget {
+
+  // XBM bitmap (in PROGMEM) with top-left corner at (x, y), which can be shown or hidden.
+
+  public:
+  BitmapWidget(int16_t x, int16_t y, uint8_t width, uint8_t height, const unsigned char *bitmap); // constructor
+
+  void setVisible(bool visible);
+
+  void layout(U8G2 &display) override;
+  void draw(U8G2 &display) override;
+
+  private:
+  const uint8_t width;
+  const uint8_t height;
+  const unsigned char *bitmap;
+  bool visible;
+};
+
+class AnimationWidget : public OledWidget {
+
+  // Animated icon with top-left corner at (x, y), shown while active. The frames are decoded by `player`
+  // (owned and activated by the caller), which is driven by `poll()`: the widget only marks itself dirty
+  // when the next frame is complete.
+
+  public:
+  AnimationWidget(int16_t x, int16_t y, XbmAnimationPlayer &player); // constructor
+
+  void setActive(bool active);
+  bool isActive();
+
+  void layout(U8G2 &display) override;
+  void draw(U8G2 &display) override;
+  void poll() override;
+
+  private:
+  XbmAnimationPlayer &player;
+  bool active;
+};
+
+class OledScreen {
+
+  // CLASS OledScreen
+  //
+  // A fixed set of widgets (at most `max_widgets_per_screen`, drawn in the order they were added) that
+  // together make up one page of the on-board OLED screen. The layout of all widgets is computed once,
+  // when the screen is shown for the first time.
+  //
+  // `checkRedraw()` only re-renders the bounding box of the dirty widgets: the box is cleared, all widgets
+  // intersecting it are redrawn (clipped to the box), and only the tiles covering the box are transferred
+  // to the display. Showing a screen (`show()`) redraws it entirely.
+
+  public:
+  OledScreen(U8G2 &display, bool drawBorder); // constructor
+
+  void add(OledWidget &widget); // adds a widget; ignored if the screen is full
+
+  void show();        // lays out the widgets (once) and redraws the whole screen
+  void checkRedraw(); // Loop function: re-renders only the dirty widgets
+
+  private:
+  void redraw(const OledBox &area);    // clears `area`, draws all widgets intersecting it, and sends its tiles
+  void sendTiles(const OledBox &area); // transfers the display tiles covering `area`
+
+  U8G2 &display;
+  const bool drawBorder;
+  OledWidget *widgets[OledWidgetUtils::max_widgets_per_screen];
+  uint8_t widgetCount;
+  bool laidOut;
+};
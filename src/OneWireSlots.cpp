@@ -0,0 +1,65 @@
+#include "OneWireSlots.h"
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                     NAMESPACE OneWireSlots                                     *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Encoding of OneWire slots into pulse symbols, and decoding of the sampled bus waveform.
+//
+// The bus is open-drain: the host pulls the line low (level 0) or releases it (level 1), and the
+// sampled waveform shows the host's and the devices' pulses combined. In a read slot, the host's short
+// low pulse is stretched by the device to send a 0; in a reset, the device answers with a separate
+// presence pulse after the host released the line.
+
+namespace {
+  OneWireSlots::Symbol makeSymbol(uint16_t lowUs, uint16_t releaseUs) {
+    OneWireSlots::Symbol symbol;
+    symbol.level0 = 0;
+    symbol.duration0 = lowUs;
+    symbol.level1 = 1;
+    symbol.duration1 = releaseUs;
+    return symbol;
+  }
+}
+
+OneWireSlots::Symbol OneWireSlots::resetSymbol() { return makeSymbol(reset_low_us, reset_release_us); }
+
+size_t OneWireSlots::encodeBytes(const uint8_t *data, size_t length, Symbol *out) {
+  size_t count = 0;
+  for (size_t i = 0; i < length; i++) {
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      out[count++] = ((data[i] >> bit) & 0x01) ? makeSymbol(write1_low_us, write1_release_us)
+                                               : makeSymbol(write0_low_us, write0_release_us);
+    }
+  }
+  return count;
+}
+
+size_t OneWireSlots::encodeReadSlots(size_t length, Symbol *out) {
+  for (size_t i = 0; i < 8 * length; i++) {
+    out[i] = makeSymbol(read_low_us, read_release_us);
+  }
+  return 8 * length;
+}
+
+bool OneWireSlots::decodePresence(const Symbol *received, size_t count) {
+  // expected: [reset pulse | short release] [presence pulse | release ...]
+  if (count < 2) return false;
+  if ((received[0].level0 != 0) || (received[0].duration0 < min_reset_low_us)) return false;
+  if ((received[0].duration1 == 0) || (received[0].duration1 > max_presence_wait_us)) return false;
+  return (received[1].level0 == 0) && (received[1].duration0 >= min_presence_low_us) &&
+         (received[1].duration0 <= max_presence_low_us);
+}
+
+bool OneWireSlots::decodeBytes(const Symbol *received, size_t count, uint8_t *out, size_t length) {
+  if (count < 8 * length) return false;
+  for (size_t i = 0; i < length; i++) {
+    uint8_t value = 0;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      const Symbol &slot = received[8 * i + bit];
+      if (slot.level0 != 0) return false;
+      if (slot.duration0 < read_sample_us) value |= (1 << bit);
+    }
+    out[i] = value;
+  }
+  return true;
+}
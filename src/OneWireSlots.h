@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// OneWire time slots encoded as pulse symbols, as used by the RMT peripheral: a symbol is a pair of
+// (level, duration) half-periods. Durations are in ticks of 1 microsecond.
+//
+// This header and its implementation do not depend on the Arduino framework or on the RMT driver, so the
+// encoding and decoding can be compiled and checked on the host, e.g. against recorded waveforms.
+namespace OneWireSlots {
+
+  // Same layout as `rmt_symbol_word_t` of the ESP-IDF RMT driver
+  struct Symbol {
+    uint32_t duration0 : 15;
+    uint32_t level0 : 1;
+    uint32_t duration1 : 15;
+    uint32_t level1 : 1;
+  };
+  static_assert(sizeof(Symbol) == 4, "Symbol must match the size of rmt_symbol_word_t");
+
+  constexpr uint32_t tick_hz = 1000000; // symbol durations are in microseconds
+
+  // Timing of the slots driven by the host [microseconds]
+  constexpr uint16_t reset_low_us = 480;     // reset pulse
+  constexpr uint16_t reset_release_us = 480; // presence window and recovery after the reset pulse
+  constexpr uint16_t write1_low_us = 6;      // write-1 slot: short low pulse ...
+  constexpr uint16_t write1_release_us = 64; // ... then released for the rest of the slot
+  constexpr uint16_t write0_low_us = 60;     // write-0 slot: low for (almost) the entire slot ...
+  constexpr uint16_t write0_release_us = 10; // ... then recovery
+  constexpr uint16_t read_low_us = 3;        // read slot: host starts the slot with a short low pulse ...
+  constexpr uint16_t read_release_us = 67;   // ... then releases, the device holds the line low to send a 0
+
+  // Thresholds to decode the waveform sampled back from the bus [microseconds]
+  constexpr uint16_t read_sample_us = 15;       // read slot: low for less than this is a 1, otherwise a 0
+  constexpr uint16_t min_reset_low_us = 400;    // the first low pulse of a reset must be the host's reset pulse
+  constexpr uint16_t max_presence_wait_us = 70; // device starts the presence pulse within 15..60 us
+  constexpr uint16_t min_presence_low_us = 50;  // presence pulse lasts 60..240 us
+  constexpr uint16_t max_presence_low_us = 300;
+  constexpr uint32_t max_signal_ns = 600000; // line not changing for longer ends a reception (> reset pulse)
+  constexpr uint32_t min_signal_ns = 1000;   // glitch filter
+
+  Symbol resetSymbol(); // reset pulse, followed by the presence window
+
+  // Encodes `length` bytes (LSB first) into write slots; returns the number of symbols written to `out`,
+  // which must hold 8 symbols per byte.
+  size_t encodeBytes(const uint8_t *data, size_t length, Symbol *out);
+
+  // Encodes read slots for `length` bytes; returns the number of symbols written to `out`, which must hold
+  // 8 symbols per byte.
+  size_t encodeReadSlots(size_t length, Symbol *out);
+
+  // Returns true if the waveform sampled during a reset shows a presence pulse of a device.
+  bool decodePresence(const Symbol *received, size_t count);
+
+  // Decodes the waveform sampled during read slots into `length` bytes (LSB first). Returns false if the
+  // waveform does not consist of (at least) 8 low pulses per byte.
+  bool decodeBytes(const Symbol *received, size_t count, uint8_t *out, size_t length);
+}
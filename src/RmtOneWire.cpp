@@ -0,0 +1,231 @@
+#include "RmtOneWire.h"
+#include <cstring>     // For memcpy()
+#include <esp_timer.h> // For esp_timer_get_time()
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                      CLASS RmtOneWire                                          *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// OneWire bus master on the RMT peripheral.
+//
+// The TX channel drives the GPIO in open-drain mode and loops its output back into the GPIO matrix, so
+// the RX channel on the same GPIO samples the combined waveform of host and devices. The RX channel is
+// only armed for the phases that need decoding (reset and read); a reception ends once the line has not
+// changed for `max_signal_ns`, which is longer than any pulse of a slot.
+//
+// Phases of a transaction:
+//   reset:  arm RX, transmit the reset symbol; when received: decode the presence pulse
+//   write:  transmit the write slots of all bytes (the driver refills the RMT memory as needed)
+//   read:   arm RX, transmit the read slots; when received: decode the bytes
+
+// constructor:
+RmtOneWire::RmtOneWire(uint8_t pin)
+    : pin(pin),
+      txChannel(nullptr),
+      rxChannel(nullptr),
+      copyEncoder(nullptr),
+      writeLength(0),
+      readLength(0),
+      phase(PhaseIdle),
+      result(OneWireStatus::Idle),
+      startedAtUs(0),
+      phaseStartedAtUs(0),
+      cpuUs(0),
+      transmitDone(false),
+      receiveDone(false),
+      receivedCount(0),
+      lastCpuUs(0),
+      lastBusUs(0),
+      cpuTime(0.1f) {
+}
+
+bool RmtOneWire::begin() {
+  // the RX channel must exist before the TX channel loops its output back onto the GPIO
+  rmt_rx_channel_config_t rxConfig = {};
+  rxConfig.gpio_num = static_cast<gpio_num_t>(pin);
+  rxConfig.clk_src = RMT_CLK_SRC_DEFAULT;
+  rxConfig.resolution_hz = OneWireSlots::tick_hz;
+  rxConfig.mem_block_symbols = RmtOneWireUtils::rx_mem_block_symbols;
+  if (rmt_new_rx_channel(&rxConfig, &rxChannel) != ESP_OK) return false;
+
+  rmt_tx_channel_config_t txConfig = {};
+  txConfig.gpio_num = static_cast<gpio_num_t>(pin);
+  txConfig.clk_src = RMT_CLK_SRC_DEFAULT;
+  txConfig.resolution_hz = OneWireSlots::tick_hz;
+  txConfig.mem_block_symbols = 48;
+  txConfig.trans_queue_depth = 2;
+  txConfig.flags.io_loop_back = 1; // RX samples what TX drives, plus the devices' pulses
+  txConfig.flags.io_od_mode = 1;   // open-drain: the line is pulled up when released
+  if (rmt_new_tx_channel(&txConfig, &txChannel) != ESP_OK) return false;
+
+  rmt_copy_encoder_config_t encoderConfig = {};
+  if (rmt_new_copy_encoder(&encoderConfig, &copyEncoder) != ESP_OK) return false;
+
+  rmt_rx_event_callbacks_t rxCallbacks = {};
+  rxCallbacks.on_recv_done = &RmtOneWire::onReceiveDone;
+  rmt_rx_register_event_callbacks(rxChannel, &rxCallbacks, this);
+  rmt_tx_event_callbacks_t txCallbacks = {};
+  txCallbacks.on_trans_done = &RmtOneWire::onTransmitDone;
+  rmt_tx_register_event_callbacks(txChannel, &txCallbacks, this);
+
+  return (rmt_enable(rxChannel) == ESP_OK) && (rmt_enable(txChannel) == ESP_OK);
+}
+
+void RmtOneWire::end() {
+  // deleting a channel releases its GPIO (output disabled, routed back to the plain GPIO output)
+  if (rxChannel != nullptr) {
+    rmt_disable(rxChannel);
+    rmt_del_channel(rxChannel);
+    rxChannel = nullptr;
+  }
+  if (txChannel != nullptr) {
+    rmt_disable(txChannel);
+    rmt_del_channel(txChannel);
+    txChannel = nullptr;
+  }
+  if (copyEncoder != nullptr) {
+    rmt_del_encoder(copyEncoder);
+    copyEncoder = nullptr;
+  }
+  if (phase != PhaseIdle) finish(OneWireStatus::Failed);
+}
+
+bool RmtOneWire::startTransaction(const uint8_t *writeData, uint8_t writeLength, uint8_t readLength) {
+  if ((phase != PhaseIdle) || (txChannel == nullptr)) return false;
+  if ((writeLength > RmtOneWireUtils::max_write_bytes) || (readLength > RmtOneWireUtils::max_read_bytes)) return false;
+
+  int64_t entryUs = esp_timer_get_time();
+  memcpy(writeBuffer, writeData, writeLength);
+  this->writeLength = writeLength;
+  this->readLength = readLength;
+  result = OneWireStatus::Busy;
+  startedAtUs = entryUs;
+  cpuUs = 0;
+  startReset();
+  cpuUs += static_cast<uint32_t>(esp_timer_get_time() - entryUs);
+  return true;
+}
+
+OneWireStatus RmtOneWire::checkTransaction() {
+  if (phase == PhaseIdle) return result;
+  int64_t entryUs = esp_timer_get_time();
+
+  switch (phase) {
+    case PhaseReset:
+      if (!(receiveDone && transmitDone)) break;
+      if (!OneWireSlots::decodePresence(rxSymbols, receivedCount)) {
+        finish(OneWireStatus::NoPresence);
+        break;
+      }
+      startPhaseAfter(PhaseReset);
+      break;
+    case PhaseWrite:
+      if (!transmitDone) break;
+      startPhaseAfter(PhaseWrite);
+      break;
+    case PhaseRead:
+      if (!(receiveDone && transmitDone)) break;
+      finish(OneWireSlots::decodeBytes(rxSymbols, receivedCount, readBuffer, readLength) ? OneWireStatus::Done : OneWireStatus::Failed);
+      break;
+    default:
+      break;
+  }
+  // a phase started by this call is not yet due; a completed one has advanced above
+  if ((phase != PhaseIdle) && (entryUs - phaseStartedAtUs > RmtOneWireUtils::phase_timeout_ms * 1000LL)) {
+    // abort a pending reception, so the channel can be armed again by the next transaction
+    rmt_disable(rxChannel);
+    rmt_enable(rxChannel);
+    finish(OneWireStatus::Failed);
+  }
+
+  // the time of this call is accounted to the transaction, even if it completed in this call
+  uint32_t spentUs = static_cast<uint32_t>(esp_timer_get_time() - entryUs);
+  if (phase == PhaseIdle) {
+    lastCpuUs += spentUs;
+    cpuTime.update(static_cast<float>(lastCpuUs));
+  } else {
+    cpuUs += spentUs;
+  }
+  return result;
+}
+
+OneWireStatus RmtOneWire::status() { return result; }
+
+const uint8_t *RmtOneWire::readData() { return readBuffer; }
+
+uint32_t RmtOneWire::lastCpuTimeUs() { return lastCpuUs; }
+
+uint32_t RmtOneWire::lastBusTimeUs() { return lastBusUs; }
+
+float RmtOneWire::averageCpuTimeUs() { return cpuTime.value(); }
+
+void RmtOneWire::startReset() {
+  phase = PhaseReset;
+  phaseStartedAtUs = esp_timer_get_time();
+  receiveDone = false;
+  transmitDone = false;
+  rmt_receive_config_t receiveConfig = {};
+  receiveConfig.signal_range_min_ns = OneWireSlots::min_signal_ns;
+  receiveConfig.signal_range_max_ns = OneWireSlots::max_signal_ns;
+  rmt_receive(rxChannel, rxSymbols, sizeof(rxSymbols), &receiveConfig);
+
+  txSymbols[0] = OneWireSlots::resetSymbol();
+  rmt_transmit_config_t transmitConfig = {};
+  transmitConfig.flags.eot_level = 1; // release the line
+  rmt_transmit(txChannel, copyEncoder, txSymbols, sizeof(OneWireSlots::Symbol), &transmitConfig);
+}
+
+void RmtOneWire::startWrite() {
+  phase = PhaseWrite;
+  phaseStartedAtUs = esp_timer_get_time();
+  transmitDone = false;
+  size_t count = OneWireSlots::encodeBytes(writeBuffer, writeLength, txSymbols);
+  rmt_transmit_config_t transmitConfig = {};
+  transmitConfig.flags.eot_level = 1;
+  rmt_transmit(txChannel, copyEncoder, txSymbols, count * sizeof(OneWireSlots::Symbol), &transmitConfig);
+}
+
+void RmtOneWire::startRead() {
+  phase = PhaseRead;
+  phaseStartedAtUs = esp_timer_get_time();
+  receiveDone = false;
+  transmitDone = false;
+  rmt_receive_config_t receiveConfig = {};
+  receiveConfig.signal_range_min_ns = OneWireSlots::min_signal_ns;
+  receiveConfig.signal_range_max_ns = OneWireSlots::max_signal_ns;
+  rmt_receive(rxChannel, rxSymbols, sizeof(rxSymbols), &receiveConfig);
+
+  size_t count = OneWireSlots::encodeReadSlots(readLength, txSymbols);
+  rmt_transmit_config_t transmitConfig = {};
+  transmitConfig.flags.eot_level = 1;
+  rmt_transmit(txChannel, copyEncoder, txSymbols, count * sizeof(OneWireSlots::Symbol), &transmitConfig);
+}
+
+// starts the phase following `completed`, skipping empty phases
+void RmtOneWire::startPhaseAfter(_phase completed) {
+  if ((completed == PhaseReset) && (writeLength > 0)) {
+    startWrite();
+  } else if ((completed != PhaseRead) && (readLength > 0)) {
+    startRead();
+  } else {
+    finish(OneWireStatus::Done);
+  }
+}
+
+void RmtOneWire::finish(OneWireStatus status) {
+  phase = PhaseIdle;
+  result = status;
+  lastBusUs = static_cast<uint32_t>(esp_timer_get_time() - startedAtUs);
+  lastCpuUs = cpuUs;
+}
+
+bool IRAM_ATTR RmtOneWire::onTransmitDone(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t *event, void *arg) {
+  static_cast<RmtOneWire *>(arg)->transmitDone = true;
+  return false; // no task woken
+}
+
+bool IRAM_ATTR RmtOneWire::onReceiveDone(rmt_channel_handle_t channel, const rmt_rx_done_event_data_t *event, void *arg) {
+  RmtOneWire *bus = static_cast<RmtOneWire *>(arg);
+  bus->receivedCount = event->num_symbols;
+  bus->receiveDone = true;
+  return false; // no task woken
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include "Ewma.h"
+#include "OneWireSlots.h"
+#include <Arduino.h>
+#include <driver/rmt_rx.h>
+#include <driver/rmt_tx.h>
+
+namespace RmtOneWireUtils {
+  constexpr uint8_t max_write_bytes = 13;     // MATCH ROM + 8-byte address + function command + up to 3 arguments
+  constexpr uint8_t max_read_bytes = 9;       // DS18B20 scratchpad
+  constexpr size_t rx_mem_block_symbols = 96; // two RMT memory blocks of the ESP32-C3; fits `max_read_bytes` read slots
+  constexpr uint32_t phase_timeout_ms = 20;   // a phase the hardware has not completed by then fails (the longest, 13 write bytes, takes ~7 ms)
+  static_assert(8 * max_read_bytes <= rx_mem_block_symbols, "read slots must fit into the RX memory");
+}
+
+// Status of the current (or latest) transaction
+enum class OneWireStatus : uint8_t {
+  Idle = 0,       // no transaction started yet
+  Busy = 1,       // transaction in progress
+  Done = 2,       // transaction completed; read data is available
+  NoPresence = 3, // no device answered the reset
+  Failed = 4      // waveform could not be decoded, or a phase timed out
+};
+
+class RmtOneWire {
+
+  // CLASS RmtOneWire
+  //
+  // OneWire bus master driven by the RMT peripheral instead of bit-banging. The OneWire library toggles the
+  // GPIO with busy-waits of up to 480 us, and masks interrupts during each time slot; a scratchpad read thus
+  // blocks the CPU for ~6 ms. Here, the time slots are encoded as RMT symbols (see `OneWireSlots`), which
+  // the TX channel drives onto the open-drain line; an RX channel on the same GPIO samples the line back,
+  // and the samples are decoded into the presence pulse and the bits read.
+  //
+  // A transaction is: reset, write `writeLength` bytes, then read `readLength` bytes. It is asynchronous:
+  // `startTransaction()` starts the reset, and the loop function `checkTransaction()` starts the next phase
+  // when the hardware has completed the previous one. The CPU is thus only involved at phase boundaries.
+  // The phases are chained by the loop rather than by the RMT callbacks, since `rmt_transmit()` may block and
+  // must not be called from an ISR. Hence each phase has its own timeout, which only expires if the hardware
+  // has not completed the phase: a slow loop pass delays the transaction, but does not fail it.
+  //
+  // `DallasTemperature` is bound to the `OneWire` class, hence it keeps using the bit-banged bus for device
+  // discovery and configuration during `setup()`. `begin()` then hands the GPIO over to the RMT peripheral;
+  // `end()` hands it back, e.g. to search the bus again.
+  //
+  // The CPU time spent per transaction is recorded, to compare against the bit-banged path.
+
+  public:
+  RmtOneWire(uint8_t pin); // constructor
+
+  bool begin(); // takes over the GPIO with RMT channels; returns false if the channels could not be set up
+  void end();   // releases the RMT channels and the GPIO (e.g. for a device search on the bit-banged bus); aborts a transaction
+
+  // Starts a transaction. Returns false if a transaction is still in progress or the lengths exceed the limits.
+  bool startTransaction(const uint8_t *writeData, uint8_t writeLength, uint8_t readLength);
+
+  OneWireStatus checkTransaction(); // Loop function: advances the transaction; returns its status
+  OneWireStatus status();           // status of the current (or latest) transaction
+  const uint8_t *readData();        // data read by the latest completed transaction
+
+  // Statistics
+  uint32_t lastCpuTimeUs(); // CPU time spent in the latest transaction [microseconds]
+  uint32_t lastBusTimeUs(); // duration of the latest transaction, until the loop saw it complete [microseconds]
+  float averageCpuTimeUs(); // exponentially weighted average CPU time per transaction [microseconds]
+
+  private:
+  enum _phase {
+    PhaseIdle = 0,
+    PhaseReset = 1,
+    PhaseWrite = 2,
+    PhaseRead = 3
+  };
+
+  void startReset();
+  void startWrite();
+  void startRead();
+  void startPhaseAfter(_phase completed);
+  void finish(OneWireStatus result);
+
+  static bool onTransmitDone(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t *event, void *arg);
+  static bool onReceiveDone(rmt_channel_handle_t channel, const rmt_rx_done_event_data_t *event, void *arg);
+
+  // behavioral parameters are lifetime-constants (provided at construction)
+  const uint8_t pin;
+
+  // RMT resources
+  rmt_channel_handle_t txChannel;
+  rmt_channel_handle_t rxChannel;
+  rmt_encoder_handle_t copyEncoder;
+  OneWireSlots::Symbol txSymbols[8 * RmtOneWireUtils::max_write_bytes];
+  OneWireSlots::Symbol rxSymbols[RmtOneWireUtils::rx_mem_block_symbols];
+
+  // dynamic state parameters
+  uint8_t writeBuffer[RmtOneWireUtils::max_write_bytes];
+  uint8_t readBuffer[RmtOneWireUtils::max_read_bytes];
+  uint8_t writeLength;
+  uint8_t readLength;
+  _phase phase;
+  OneWireStatus result;
+  int64_t startedAtUs;
+  int64_t phaseStartedAtUs;
+  uint32_t cpuUs;
+
+  // set by the RMT callbacks (ISR)
+  volatile bool transmitDone;
+  volatile bool receiveDone;
+  volatile size_t receivedCount;
+
+  // statistics
+  uint32_t lastCpuUs;
+  uint32_t lastBusUs;
+  Ewma cpuTime;
+};
@@ -0,0 +1,147 @@
+#include "SeriesCodec.h"
+#include "CommandProtocol.h" // For commandCrc16()
+#include <cstddef>           // For offsetof()
+#include <cstring>           // For memcpy(), memset()
+
+size_t putVarint(uint64_t value, uint8_t *out) {
+  size_t size = 0;
+  while (value >= 0x80) {
+    out[size++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  out[size++] = static_cast<uint8_t>(value);
+  return size;
+}
+
+size_t getVarint(const uint8_t *data, size_t length, uint64_t &value) {
+  uint64_t result = 0;
+  for (size_t i = 0; (i < length) && (i < SeriesCodec::max_varint_bytes); i++) {
+    result |= static_cast<uint64_t>(data[i] & 0x7F) << (7 * i);
+    if ((data[i] & 0x80) == 0) {
+      value = result;
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                     CLASS SeriesEncoder                                        *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// The time differences are taken modulo 2^32 (as unsigned numbers, reinterpreted as signed), so they cannot
+// overflow; the decoder undoes them the same way. The temperatures are 16 bits: their differences of
+// differences fit into 18 bits.
+
+// constructor:
+SeriesEncoder::SeriesEncoder(uint8_t channels)
+    : channels(min(channels, SeriesCodec::max_channels)) {
+  reset();
+}
+
+void SeriesEncoder::reset() {
+  records = 0;
+  memset(&previous, 0, sizeof(previous));
+  previousTimeDelta = 0;
+  memset(previousDelta, 0, sizeof(previousDelta));
+}
+
+size_t SeriesEncoder::encode(const SeriesSample &sample, uint8_t *out) {
+  bool statusChanged = (records == 0) || (sample.heaterPercent != previous.heaterPercent) || (sample.loads != previous.loads);
+  int32_t timeDelta = static_cast<int32_t>(sample.timeS - previous.timeS);
+  int32_t timeCode = (records < 2) ? timeDelta : static_cast<int32_t>(static_cast<uint32_t>(timeDelta) - static_cast<uint32_t>(previousTimeDelta));
+  size_t size = putVarint((static_cast<uint64_t>(zigZag(timeCode)) << 1) | (statusChanged ? 1 : 0), out);
+  if (statusChanged) {
+    size += putVarint(sample.heaterPercent, out + size);
+    size += putVarint(sample.loads, out + size);
+  }
+  for (uint8_t channel = 0; channel < channels; channel++) {
+    int32_t delta = static_cast<int32_t>(sample.temperature[channel]) - previous.temperature[channel];
+    int32_t code = (records < 2) ? delta : delta - previousDelta[channel];
+    size += putVarint(zigZag(code), out + size);
+    previousDelta[channel] = (records == 0) ? 0 : delta;
+  }
+  previousTimeDelta = (records == 0) ? 0 : timeDelta;
+  previous = sample;
+  if (records < 2) records++;
+  return size;
+}
+
+uint8_t SeriesEncoder::channelCount() { return channels; }
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                     CLASS SeriesDecoder                                        *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+// constructor:
+SeriesDecoder::SeriesDecoder(uint8_t channels)
+    : channels(min(channels, SeriesCodec::max_channels)) {
+  reset();
+}
+
+void SeriesDecoder::reset() {
+  records = 0;
+  memset(&previous, 0, sizeof(previous));
+  previousTimeDelta = 0;
+  memset(previousDelta, 0, sizeof(previousDelta));
+}
+
+size_t SeriesDecoder::decode(const uint8_t *data, size_t length, SeriesSample &sample) {
+  uint64_t value;
+  size_t size = getVarint(data, length, value);
+  if ((size == 0) || ((value >> 1) > UINT32_MAX)) return 0;
+  bool statusChanged = value & 1;
+  int32_t timeCode = unZigZag(static_cast<uint32_t>(value >> 1));
+  int32_t timeDelta = (records < 2) ? timeCode : static_cast<int32_t>(static_cast<uint32_t>(timeCode) + static_cast<uint32_t>(previousTimeDelta));
+
+  SeriesSample decoded = previous;
+  decoded.timeS = previous.timeS + static_cast<uint32_t>(timeDelta);
+  if (statusChanged) {
+    size_t read = getVarint(data + size, length - size, value);
+    if ((read == 0) || (value > UINT8_MAX)) return 0;
+    decoded.heaterPercent = static_cast<uint8_t>(value);
+    size += read;
+    read = getVarint(data + size, length - size, value);
+    if ((read == 0) || (value > UINT8_MAX)) return 0;
+    decoded.loads = static_cast<uint8_t>(value);
+    size += read;
+  } else if (records == 0) {
+    return 0; // the first record of a page carries the status
+  }
+  int32_t deltas[SeriesCodec::max_channels];
+  for (uint8_t channel = 0; channel < channels; channel++) {
+    size_t read = getVarint(data + size, length - size, value);
+    if ((read == 0) || (value > UINT32_MAX)) return 0;
+    size += read;
+    int32_t code = unZigZag(static_cast<uint32_t>(value));
+    deltas[channel] = (records < 2) ? code : code + previousDelta[channel];
+    int32_t temperature = previous.temperature[channel] + deltas[channel];
+    if ((temperature < INT16_MIN) || (temperature > INT16_MAX)) return 0;
+    decoded.temperature[channel] = static_cast<int16_t>(temperature);
+  }
+
+  for (uint8_t channel = 0; channel < channels; channel++) previousDelta[channel] = (records == 0) ? 0 : deltas[channel];
+  previousTimeDelta = (records == 0) ? 0 : timeDelta;
+  previous = decoded;
+  if (records < 2) records++;
+  sample = decoded;
+  return size;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                          PAGES                                                 *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+uint16_t seriesPageCrc(const uint8_t *page) {
+  SeriesPageHeader header;
+  memcpy(&header, page, sizeof(header));
+  return commandCrc16(page + offsetof(SeriesPageHeader, payloadBytes), 2 + header.payloadBytes);
+}
+
+bool isValidSeriesPage(const uint8_t *page, size_t length) {
+  if (length < SeriesCodec::header_bytes) return false;
+  SeriesPageHeader header;
+  memcpy(&header, page, sizeof(header));
+  if ((header.sequence == UINT32_MAX) || (header.payloadBytes > SeriesCodec::max_payload) || (header.channels > SeriesCodec::max_channels)) return false;
+  if (SeriesCodec::header_bytes + header.payloadBytes > length) return false;
+  return header.crc == seriesPageCrc(page);
+}
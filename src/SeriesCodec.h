@@ -0,0 +1,100 @@
+#pragma once
+#include <Arduino.h>
+
+// Compact code of the temperature and heater history (see `SeriesStore`), shared with the host CLI, which
+// decodes the exported pages.
+//
+// The history is a sequence of pages of `page_bytes` (the program page of the flash). A page holds an
+// 8-byte header (`SeriesPageHeader`) and the records of consecutive samples; it is decoded on its own: the
+// first record of a page holds the values of its sample, the second the differences to the first, every
+// further record the differences of the differences (delta of delta). A record is
+//
+//   varint (zig-zag(time) << 1 | status changed) | [varint heater percent, varint loads] | channels x varint zig-zag(temperature)
+//
+// with varints of 7 bits per byte, least significant group first. A sample taken at the regular interval
+// with unchanged status and steady temperatures encodes to one byte per value; the status is stored as is,
+// and only when it changes.
+namespace SeriesCodec {
+  constexpr size_t page_bytes = 256; // program page of the flash
+  constexpr size_t header_bytes = 8; // `SeriesPageHeader`
+  constexpr size_t max_payload = page_bytes - header_bytes;
+  constexpr uint8_t max_channels = 8;                               // temperatures per sample (one per zone)
+  constexpr size_t max_varint_bytes = 5;                            // 35 bits
+  constexpr size_t max_record_bytes = 5 + 2 + 2 + max_channels * 3; // worst case: varints of 33, 8, 8 and 18 bits
+}
+
+// A sample of the history
+struct SeriesSample {
+  uint32_t timeS;                                 // log clock [s]
+  uint8_t heaterPercent;                          // share of full power of the heater (burst fire)
+  uint8_t loads;                                  // bit z: the load of zone z is on
+  int16_t temperature[SeriesCodec::max_channels]; // [1/16 °C] as read from the DS18B20; INT16_MIN: no valid reading
+};
+
+struct __attribute__((packed)) SeriesPageHeader {
+  uint32_t sequence;    // pages written since the log was created; erased flash (0xFFFFFFFF) marks a free page
+  uint16_t crc;         // CRC-16/CCITT-FALSE over `payloadBytes`, `channels` and the payload
+  uint8_t payloadBytes; // bytes of the records
+  uint8_t channels;     // temperatures per record
+};
+static_assert(sizeof(SeriesPageHeader) == SeriesCodec::header_bytes, "the header is stored as is");
+
+// Zig-zag code: small magnitudes of either sign to small unsigned numbers (0, -1, 1, -2 ... to 0, 1, 2, 3 ...)
+inline uint32_t zigZag(int32_t value) { return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31); }
+inline int32_t unZigZag(uint32_t value) { return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1); }
+
+size_t putVarint(uint64_t value, uint8_t *out);                        // returns the bytes written; values up to 35 bits
+size_t getVarint(const uint8_t *data, size_t length, uint64_t &value); // returns the bytes read; 0 if truncated or too long
+
+class SeriesEncoder {
+
+  // CLASS SeriesEncoder
+  //
+  // Encodes the records of one page; `reset()` starts the next page. The state is the previous sample and
+  // the previous differences.
+
+  public:
+  SeriesEncoder(uint8_t channels); // constructor
+
+  void reset();
+  size_t encode(const SeriesSample &sample, uint8_t *out); // returns the bytes of the record (at most `max_record_bytes`)
+  uint8_t channelCount();
+
+  private:
+  // behavioral parameters are lifetime-constants (provided at construction)
+  const uint8_t channels;
+
+  // dynamic state parameters
+  uint8_t records; // in the current page
+  SeriesSample previous;
+  int32_t previousTimeDelta;
+  int32_t previousDelta[SeriesCodec::max_channels];
+};
+
+class SeriesDecoder {
+
+  // CLASS SeriesDecoder
+  //
+  // Decodes the records of one page, in the order they were encoded.
+
+  public:
+  SeriesDecoder(uint8_t channels); // constructor
+
+  void reset();
+  size_t decode(const uint8_t *data, size_t length, SeriesSample &sample); // returns the bytes of the record; 0 if malformed
+
+  private:
+  // behavioral parameters are lifetime-constants (provided at construction)
+  const uint8_t channels;
+
+  // dynamic state parameters
+  uint8_t records;
+  SeriesSample previous;
+  int32_t previousTimeDelta;
+  int32_t previousDelta[SeriesCodec::max_channels];
+};
+
+// Checks the header of a page read from flash or received from the export: a written page with a matching
+// CRC and a consistent size. A free page (erased flash) and a page torn by a power loss are not valid.
+bool isValidSeriesPage(const uint8_t *page, size_t length);
+uint16_t seriesPageCrc(const uint8_t *page); // CRC of a page with a complete header
@@ -0,0 +1,366 @@
+#include "SeriesStore.h"
+#include <cstddef>     // For offsetof()
+#include <esp_timer.h> // For esp_timer_get_time()
+
+namespace {
+  inline uint32_t uptimeS() { return static_cast<uint32_t>(esp_timer_get_time() / 1000000LL); }
+
+  inline uint32_t pageSequence(const uint8_t *page) {
+    SeriesPageHeader header;
+    memcpy(&header, page, sizeof(header));
+    return header.sequence;
+  }
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                      CLASS SeriesStore                                         *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// The first page of a sector is programmed right after the sector is erased, so a sector whose first page
+// is valid belongs to the log; the sequence numbers of the first pages order the sectors. Within the newest
+// sector, the pages are programmed in order: the first erased page is the next one. A sector torn by a power
+// loss during its erase has no valid first page: it is not part of the log, and is erased again before use.
+//
+// Erasing a sector blocks for some tens of milliseconds, once per `pages_per_sector` pages; programming a
+// page takes about a millisecond.
+
+// constructor:
+SeriesStore::SeriesStore(uint8_t channels, uint32_t flushIntervalS)
+    : channels(min(channels, SeriesCodec::max_channels)),
+      flushIntervalS(flushIntervalS),
+      partition(nullptr),
+      sectorCount(0),
+      tailSector(0),
+      headSector(0),
+      nextPage(0),
+      empty(true),
+      nextSequence(0),
+      clockOffsetS(0),
+      encoder(channels),
+      payloadBytes(0),
+      pageStartS(0),
+      samples(0),
+      recordBytes(0),
+      writtenBytes(0),
+      pages(0),
+      erases(0),
+      recoveredPages(0),
+      tornPages(0) {
+}
+
+bool SeriesStore::begin() {
+  partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, SeriesStoreUtils::partition_label);
+  if (partition == nullptr) return false;
+  uint32_t sectors = partition->size / SeriesStoreUtils::sector_bytes;
+  sectorCount = static_cast<uint16_t>((sectors > UINT16_MAX) ? UINT16_MAX : sectors);
+  if (sectorCount < 2) { // erasing the oldest sector would erase the newest
+    partition = nullptr;
+    return false;
+  }
+
+  // oldest and newest sector, by the sequence numbers of their first pages
+  uint32_t oldest = 0, newest = 0;
+  empty = true;
+  for (uint16_t sector = 0; sector < sectorCount; sector++) {
+    esp_partition_read(partition, pageOffset(sector, 0), page, sizeof(page));
+    if (!isValidSeriesPage(page, sizeof(page))) continue;
+    uint32_t sequence = pageSequence(page);
+    if (empty || (sequence < oldest)) {
+      oldest = sequence;
+      tailSector = sector;
+    }
+    if (empty || (sequence > newest)) {
+      newest = sequence;
+      headSector = sector;
+    }
+    empty = false;
+  }
+
+  uint32_t lastTimeS = 0;
+  if (empty) {
+    tailSector = headSector = 0;
+    nextPage = 0;
+    nextSequence = 0;
+  } else {
+    nextPage = SeriesStoreUtils::pages_per_sector;
+    nextSequence = newest + 1;
+    for (uint8_t p = 0; p < SeriesStoreUtils::pages_per_sector; p++) {
+      esp_partition_read(partition, pageOffset(headSector, p), page, sizeof(page));
+      if (isPageErased(page)) {
+        nextPage = p;
+        break;
+      }
+      if (!isValidSeriesPage(page, sizeof(page))) {
+        tornPages++; // programmed, but not completely: skipped (flash is not programmed twice)
+        continue;
+      }
+      recoveredPages++;
+      nextSequence = max(nextSequence, pageSequence(page) + 1);
+      lastTimeS = lastSampleTime(page);
+    }
+  }
+  clockOffsetS = empty ? 0 : lastTimeS + 1 - uptimeS();
+
+  memset(page, 0xFF, sizeof(page));
+  payloadBytes = 0;
+  encoder.reset();
+  return true;
+}
+
+void SeriesStore::append(const SeriesSample &sample) {
+  samples++;
+  if (partition == nullptr) return;
+  uint8_t record[SeriesCodec::max_record_bytes];
+  if (payloadBytes == 0) pageStartS = sample.timeS;
+  size_t size = encoder.encode(sample, record);
+  if (payloadBytes + size > SeriesCodec::max_payload) {
+    writePage(); // the sample starts the next page
+    pageStartS = sample.timeS;
+    size = encoder.encode(sample, record);
+  }
+  memcpy(&page[SeriesCodec::header_bytes + payloadBytes], record, size);
+  payloadBytes += static_cast<uint8_t>(size);
+  recordBytes += size;
+}
+
+void SeriesStore::checkFlush() {
+  if ((payloadBytes > 0) && (clockS() - pageStartS >= flushIntervalS)) writePage();
+}
+
+uint32_t SeriesStore::clockS() { return uptimeS() + clockOffsetS; }
+
+uint32_t SeriesStore::slotCount() { return static_cast<uint32_t>(sectorCount) * SeriesStoreUtils::pages_per_sector; }
+
+uint32_t SeriesStore::oldestSlot() { return empty ? nextSlot() : static_cast<uint32_t>(tailSector) * SeriesStoreUtils::pages_per_sector; }
+
+uint32_t SeriesStore::nextSlot() {
+  if (sectorCount == 0) return 0;
+  if (nextPage >= SeriesStoreUtils::pages_per_sector) return static_cast<uint32_t>((headSector + 1) % sectorCount) * SeriesStoreUtils::pages_per_sector;
+  return static_cast<uint32_t>(headSector) * SeriesStoreUtils::pages_per_sector + nextPage;
+}
+
+uint32_t SeriesStore::pageCount() {
+  if (empty) return 0;
+  return static_cast<uint32_t>((headSector + sectorCount - tailSector) % sectorCount) * SeriesStoreUtils::pages_per_sector + nextPage;
+}
+
+bool SeriesStore::readSlot(uint32_t slot, uint8_t *page) {
+  if ((partition == nullptr) || (slot >= slotCount())) return false;
+  return esp_partition_read(partition, slot * SeriesCodec::page_bytes, page, SeriesCodec::page_bytes) == ESP_OK;
+}
+
+size_t SeriesStore::pendingPage(uint8_t *page) {
+  if (payloadBytes == 0) return 0;
+  SeriesPageHeader header = {nextSequence, 0, payloadBytes, channels};
+  memcpy(this->page, &header, sizeof(header));
+  header.crc = seriesPageCrc(this->page);
+  memcpy(this->page, &header, sizeof(header));
+  size_t length = SeriesCodec::header_bytes + payloadBytes;
+  memcpy(page, this->page, length);
+  return length;
+}
+
+uint32_t SeriesStore::sampleCount() { return samples; }
+
+float SeriesStore::bytesPerSample() { return (samples > 0) ? static_cast<float>(recordBytes) / static_cast<float>(samples) : 0.0f; }
+
+float SeriesStore::writeAmplification() {
+  return (writtenBytes > 0) ? static_cast<float>(static_cast<uint64_t>(pages) * SeriesCodec::page_bytes) / static_cast<float>(writtenBytes) : 0.0f;
+}
+
+uint32_t SeriesStore::pagesWritten() { return pages; }
+
+uint32_t SeriesStore::sectorsErased() { return erases; }
+
+void SeriesStore::printStats() {
+  Serial.print(F("Series store: "));
+  if (partition == nullptr) {
+    Serial.println(F("no partition"));
+    return;
+  }
+  Serial.print(pageCount());
+  Serial.print(F(" of "));
+  Serial.print(slotCount());
+  Serial.print(F(" pages used ("));
+  Serial.print(recoveredPages);
+  Serial.print(F(" recovered, "));
+  Serial.print(tornPages);
+  Serial.print(F(" torn), "));
+  Serial.print(samples);
+  Serial.print(F(" samples at "));
+  Serial.print(bytesPerSample(), 2);
+  Serial.print(F(" bytes, "));
+  Serial.print(pages);
+  Serial.print(F(" pages written, "));
+  Serial.print(erases);
+  Serial.print(F(" sectors erased, write amplification "));
+  Serial.println(writeAmplification(), 2);
+}
+
+// Programs the page in RAM into the next slot of the ring; the first page of a sector erases the sector
+void SeriesStore::writePage() {
+  if ((payloadBytes == 0) || (partition == nullptr)) return;
+  if (nextPage >= SeriesStoreUtils::pages_per_sector) {
+    headSector = (headSector + 1) % sectorCount;
+    nextPage = 0;
+    if (!empty && (headSector == tailSector)) tailSector = (tailSector + 1) % sectorCount; // the oldest sector is erased
+  }
+  if (nextPage == 0) {
+    esp_partition_erase_range(partition, pageOffset(headSector, 0), SeriesStoreUtils::sector_bytes);
+    erases++;
+  }
+
+  SeriesPageHeader header = {nextSequence, 0, payloadBytes, channels};
+  memcpy(page, &header, sizeof(header));
+  header.crc = seriesPageCrc(page);
+  memcpy(page, &header, sizeof(header));
+  esp_partition_write(partition, pageOffset(headSector, nextPage), page, SeriesCodec::header_bytes + payloadBytes);
+  if (empty) {
+    tailSector = headSector;
+    empty = false;
+  }
+  nextSequence++;
+  nextPage++;
+  pages++;
+  writtenBytes += payloadBytes;
+
+  memset(page, 0xFF, sizeof(page));
+  payloadBytes = 0;
+  encoder.reset();
+}
+
+bool SeriesStore::isPageErased(const uint8_t *page) {
+  for (size_t i = 0; i < SeriesCodec::page_bytes; i++) {
+    if (page[i] != 0xFF) return false;
+  }
+  return true;
+}
+
+uint32_t SeriesStore::pageOffset(uint16_t sector, uint8_t page) {
+  return static_cast<uint32_t>(sector) * SeriesStoreUtils::sector_bytes + static_cast<uint32_t>(page) * SeriesCodec::page_bytes;
+}
+
+// Time of the newest sample of a valid page
+uint32_t SeriesStore::lastSampleTime(const uint8_t *page) {
+  SeriesPageHeader header;
+  memcpy(&header, page, sizeof(header));
+  SeriesDecoder decoder(header.channels);
+  SeriesSample sample = {};
+  const uint8_t *records = page + SeriesCodec::header_bytes;
+  for (size_t offset = 0; offset < header.payloadBytes;) {
+    size_t size = decoder.decode(records + offset, header.payloadBytes - offset, sample);
+    if (size == 0) break;
+    offset += size;
+  }
+  return sample.timeS;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                      CLASS SeriesExport                                        *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// The slots of the log at the start are counted down, so a full ring (where the next slot is the oldest)
+// is read completely; the slots programmed meanwhile follow until the next slot of the store is reached.
+
+// constructor:
+SeriesExport::SeriesExport(SeriesStore &store, Stream &stream)
+    : store(store),
+      stream(stream),
+      active(false),
+      slot(0),
+      remaining(0),
+      lastSequence(0),
+      atEnd(false),
+      pageLoaded(false),
+      loadedLength(0),
+      startUs(0),
+      exportBytes(0),
+      sent(0),
+      lastThroughput(0.0f) {
+}
+
+uint32_t SeriesExport::activate() {
+  slot = store.oldestSlot();
+  remaining = store.pageCount();
+  lastSequence = 0;
+  atEnd = false;
+  pageLoaded = false;
+  startUs = esp_timer_get_time();
+  exportBytes = 0;
+  active = true;
+  return remaining + (store.pendingPage(buffer) > 0 ? 1 : 0);
+}
+
+bool SeriesExport::isExpired() { return !active; }
+
+bool SeriesExport::checkExport() {
+  if (!active) return false;
+  if (!pageLoaded && !atEnd) {
+    if ((remaining == 0) && (slot == store.nextSlot())) {
+      atEnd = true;
+      loadedLength = store.pendingPage(buffer);
+      pageLoaded = (loadedLength > 0) && ((exportBytes == 0) || (pageSequence(buffer) > lastSequence));
+    } else {
+      bool read = store.readSlot(slot, buffer);
+      slot = (slot + 1) % store.slotCount();
+      if (remaining > 0) remaining--;
+      if (!read || !isValidSeriesPage(buffer, sizeof(buffer))) return false;
+      if ((exportBytes > 0) && (pageSequence(buffer) <= lastSequence)) return false; // overwritten during the export
+      loadedLength = SeriesCodec::header_bytes + buffer[offsetof(SeriesPageHeader, payloadBytes)];
+      pageLoaded = true;
+    }
+  }
+
+  if (pageLoaded) {
+    if (!sendPage(buffer, loadedLength)) return false;
+    pageLoaded = false;
+    lastSequence = pageSequence(buffer);
+    exportBytes += loadedLength;
+    sent++;
+    return true;
+  }
+
+  // end of the export: a message without data
+  uint8_t payload[SeriesStoreUtils::chunk_header_bytes] = {0, 0};
+  size_t size = encodeCommandFrame(CommandId::MessageSeriesPage | CommandUtils::response_flag, 0, payload, sizeof(payload), message);
+  if (stream.availableForWrite() < static_cast<int>(size)) return false;
+  stream.write(message, size);
+  finish();
+  return false;
+}
+
+uint32_t SeriesExport::pagesSent() { return sent; }
+
+float SeriesExport::throughputBytesPerS() { return lastThroughput; }
+
+void SeriesExport::printStats() {
+  Serial.print(F("Series export: "));
+  Serial.print(sent);
+  Serial.print(F(" pages sent, latest export "));
+  Serial.print(lastThroughput, 0);
+  Serial.println(F(" bytes/s"));
+}
+
+bool SeriesExport::sendPage(const uint8_t *page, size_t length) {
+  uint8_t chunkCount = static_cast<uint8_t>((length + SeriesStoreUtils::chunk_data_bytes - 1) / SeriesStoreUtils::chunk_data_bytes);
+  size_t messageBytes = length + chunkCount * (CommandUtils::header_bytes + SeriesStoreUtils::chunk_header_bytes + CommandUtils::crc_bytes);
+  if (stream.availableForWrite() < static_cast<int>(messageBytes)) return false;
+
+  uint8_t payload[CommandUtils::max_payload];
+  uint8_t sequence = static_cast<uint8_t>(pageSequence(page));
+  for (uint8_t chunk = 0; chunk < chunkCount; chunk++) {
+    size_t offset = chunk * SeriesStoreUtils::chunk_data_bytes;
+    size_t chunkBytes = min(length - offset, static_cast<size_t>(SeriesStoreUtils::chunk_data_bytes));
+    payload[0] = chunk;
+    payload[1] = chunkCount;
+    memcpy(&payload[SeriesStoreUtils::chunk_header_bytes], &page[offset], chunkBytes);
+    size_t size = encodeCommandFrame(CommandId::MessageSeriesPage | CommandUtils::response_flag, sequence, payload,
+                                     static_cast<uint8_t>(SeriesStoreUtils::chunk_header_bytes + chunkBytes), message);
+    stream.write(message, size);
+  }
+  return true;
+}
+
+void SeriesExport::finish() {
+  int64_t elapsedUs = esp_timer_get_time() - startUs;
+  lastThroughput = (elapsedUs > 0) ? 1e6f * static_cast<float>(exportBytes) / static_cast<float>(elapsedUs) : 0.0f;
+  active = false;
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include "CommandProtocol.h"
+#include "SeriesCodec.h"
+#include <Arduino.h>
+#include <esp_partition.h>
+
+namespace SeriesStoreUtils {
+  constexpr const char *partition_label = "series"; // data partition of the log (see partitions.csv)
+  constexpr size_t sector_bytes = 4096;             // erase unit of the flash
+  constexpr uint8_t pages_per_sector = sector_bytes / SeriesCodec::page_bytes;
+  constexpr uint8_t chunk_header_bytes = 2; // chunk index, chunk count (0: end of the export)
+  constexpr uint8_t chunk_data_bytes = CommandUtils::max_payload - chunk_header_bytes;
+}
+
+class SeriesStore {
+
+  // CLASS SeriesStore
+  //
+  // Append-only log of samples on a dedicated flash partition, which survives resets and power loss; while
+  // the network is down, the history stays on the device. Samples are encoded into a page in RAM (see
+  // `SeriesCodec.h`), and the page is programmed once it is full, or once its first sample is older than
+  // `flushIntervalS` (a partial page is final: flash is programmed once per erase).
+  //
+  // The partition is a ring of sectors, filled in order: every sector is erased once per turn, which levels
+  // the wear, and the oldest sector is erased when the newest runs out of pages. Each page carries a
+  // sequence number and a CRC, so `begin()` recovers the log after a power loss by scanning the first page
+  // of each sector and the pages of the newest one: a page torn by the power loss fails its CRC, and is
+  // skipped; the samples still in RAM are lost.
+  //
+  // Times are seconds of a log clock, which continues after a reset from the newest sample in the log (the
+  // controller has no wall clock; the time the controller was off is not counted).
+
+  public:
+  SeriesStore(uint8_t channels, uint32_t flushIntervalS); // constructor
+
+  bool begin(); // finds the partition and recovers the log; false without a partition (samples are then dropped)
+  void append(const SeriesSample &sample);
+  void checkFlush(); // Loop function: programs a partial page once it is `flushIntervalS` old
+  uint32_t clockS(); // log clock [s]
+
+  // Reading: the pages of the partition are numbered in ring order (slots); the log runs from the oldest slot
+  // up to the next slot, torn pages included (see `isValidSeriesPage()`)
+  uint32_t slotCount();
+  uint32_t oldestSlot();
+  uint32_t nextSlot();                         // programmed next
+  uint32_t pageCount();                        // from the oldest slot up to the next slot
+  bool readSlot(uint32_t slot, uint8_t *page); // reads `page_bytes`
+  size_t pendingPage(uint8_t *page);           // copies the page in RAM; returns its size, 0 if it is empty
+
+  // Statistics
+  uint32_t sampleCount();     // appended since boot
+  float bytesPerSample();     // bytes of the records per sample
+  float writeAmplification(); // flash consumed (whole pages) per byte of records written
+  uint32_t pagesWritten();    // since boot
+  uint32_t sectorsErased();   // since boot
+  void printStats();          // prints the statistics to the Serial console
+
+  private:
+  void writePage();
+  bool isPageErased(const uint8_t *page);
+  uint32_t pageOffset(uint16_t sector, uint8_t page);
+  uint32_t lastSampleTime(const uint8_t *page);
+
+  // behavioral parameters are lifetime-constants (provided at construction)
+  const uint8_t channels;
+  const uint32_t flushIntervalS;
+
+  // dynamic state parameters
+  const esp_partition_t *partition;
+  uint16_t sectorCount;
+  uint16_t tailSector; // oldest sector
+  uint16_t headSector; // sector being filled
+  uint8_t nextPage;    // page of `headSector` programmed next (`pages_per_sector`: the sector is full)
+  bool empty;
+  uint32_t nextSequence;
+  uint32_t clockOffsetS;
+  SeriesEncoder encoder;
+  uint8_t page[SeriesCodec::page_bytes]; // header and records of the page being filled
+  uint8_t payloadBytes;
+  uint32_t pageStartS; // time of the first sample of the page being filled
+
+  // statistics
+  uint32_t samples;
+  uint64_t recordBytes;  // appended
+  uint64_t writtenBytes; // of records in the pages programmed
+  uint32_t pages;
+  uint32_t erases;
+  uint32_t recoveredPages;
+  uint32_t tornPages;
+};
+
+class SeriesExport {
+
+  // CLASS SeriesExport
+  //
+  // Streams the log of a `SeriesStore` to a host as `MessageSeriesPage` messages of the command protocol (see
+  // `CommandProtocol.h`): one page per call of the Loop function `checkExport()`, read from flash into a
+  // single page buffer, so the history is never held in RAM. A page longer than one message is split into
+  // chunks, which all carry the low byte of the page's sequence number. Torn pages are skipped; pages the
+  // store programs during the export are included, and the page in RAM is sent last; a message without data
+  // ends the export. Pages that the store overwrites during the export (after a full turn of the ring) are
+  // skipped.
+  //
+  // A page is only written if the stream can take all its chunks without blocking; otherwise it is sent on
+  // a later call.
+
+  public:
+  SeriesExport(SeriesStore &store, Stream &stream); // constructor
+
+  // Lifecycle functions
+  uint32_t activate(); // starts with the oldest page; returns the pages to be sent (the page in RAM included)
+  bool isExpired();
+
+  bool checkExport(); // Loop function: returns true if a page was sent
+
+  // Statistics
+  uint32_t pagesSent();
+  float throughputBytesPerS(); // of the latest complete export
+  void printStats();           // prints the statistics to the Serial console
+
+  private:
+  bool sendPage(const uint8_t *page, size_t length);
+  void finish();
+
+  // behavioral parameters are lifetime-constants (provided at construction)
+  SeriesStore &store;
+  Stream &stream;
+
+  // dynamic state parameters
+  bool active;
+  uint32_t slot;         // read next
+  uint32_t remaining;    // slots of the log at the start not yet read
+  uint32_t lastSequence; // of the latest page sent; a page is only sent after its predecessors
+  bool atEnd;            // all slots are read; the page in RAM and the end of the export follow
+  bool pageLoaded;       // `buffer` holds a page not yet sent
+  size_t loadedLength;   // of the page in `buffer`
+  int64_t startUs;
+  uint32_t exportBytes;
+  uint8_t buffer[SeriesCodec::page_bytes];
+  uint8_t message[CommandUtils::max_frame_bytes];
+
+  // statistics
+  uint32_t sent;
+  float lastThroughput;
+};
@@ -1,45 +1,83 @@
 #include "StatDisplay.h"
+#include "OledIcons.h"
 #include <Arduino.h>
 #include <U8g2lib.h>
+#include <esp_timer.h> // For esp_timer_get_time()
 
 namespace {
-  constexpr int OLED_width = 72;
-  constexpr int OLED_height = 40;
-
-  constexpr int epd_bitmap_wifi_width = 12;
-  constexpr int epd_bitmap_wifi_height = 12;
-
-  // Toggler for blinking the "heating symbol" on the OLED screen when the external load is active
-  // Char 'flash-8x.png' from the Open Iconic font https://github.com/iconic/open-iconic, down-scaled to 20x20 pixels
-  constexpr int epd_bitmap_flash_width = 20;
-  constexpr int epd_bitmap_flash_height = 20;
-  const unsigned char epd_bitmap_flash[] PROGMEM = {
-      0x00, 0x0E, 0x00, 0x00, 0x0F, 0x00, 0x00, 0x07, 0x00, 0x80, 0x07, 0x00,
-      0xC0, 0x03, 0x00, 0xC0, 0x7F, 0x00, 0xE0, 0x3F, 0x00, 0x40, 0x3E, 0x00,
-      0x00, 0x1C, 0x00, 0x00, 0x1E, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00,
-      0x40, 0x2F, 0x00, 0xE0, 0x3F, 0x00, 0xC0, 0x1F, 0x00, 0xC0, 0x0F, 0x00,
-      0xC0, 0x07, 0x00, 0x80, 0x03, 0x00, 0x80, 0x01, 0x00, 0x80, 0x00, 0x00};
-
-  // Wifi symbol for display on OLED screen when wifi internet connection is active
-  // Char `rss-8x.png' from the Open Iconic font https://github.com/iconic/open-iconic, down-scaled to 12x12 pixels
-  const unsigned char epd_bitmap_wifi[] PROGMEM = {
-      0x80, 0x07, 0xE0, 0x03, 0x30, 0x00, 0x18, 0x07, 0xCC, 0x03, 0x66, 0x00,
-      0x32, 0x06, 0x93, 0x03, 0x9B, 0x00, 0xDB, 0x0E, 0x49, 0x0E, 0x00, 0x0E};
-}
+  // zone labels (text of the zone widget is not copied)
+  const char *const zone_labels[] = {"Z1", "Z2", "Z3", "Z4", "Z5", "Z6", "Z7", "Z8"};
+  constexpr uint8_t zone_label_count = sizeof(zone_labels) / sizeof(zone_labels[0]);
+  constexpr uint8_t screen_count = 4; // number of `StatDisplay::Screen`s
+} // namespace
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
  *                                      CLASS StatDisplay                                         *
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// The layout of all screens is defined here by the anchor positions of the widgets. Widgets may overlap
+// (e.g. the heating symbol and the "°" sign); the screen then redraws all widgets within the dirty area.
 
 // Constructor
-StatDisplay::StatDisplay(U8G2 &display, unsigned long heatingSymbolOnDurationMs, unsigned long heatingSymbolOffDurationMs)
+StatDisplay::StatDisplay(U8G2 &display, XbmAnimationPlayer &heatingAnimation)
     : display(display),
-      extLoadOnDisplayBlinker(FrequencyUtils::unbounded_lifetime, heatingSymbolOnDurationMs, heatingSymbolOffDurationMs) {
+      // temperature: numbers-only font [ending "tn"] for negative values
+      tempWidget(2, 34, u8g2_font_logisoso30_tf, "-99", u8g2_font_logisoso26_tn),
+      degreeWidget(42, 40, u8g2_font_logisoso30_tf, "°"),
+      celsiusWidget(54, 22, u8g2_font_logisoso18_tf, "C"),
+      zoneWidget(56, 36, u8g2_font_5x8_tf, "", 10),
+      heatingWidget(37, 15, heatingAnimation),
+      wifiWidget(55, 25, epd_bitmap_wifi_width, epd_bitmap_wifi_height, epd_bitmap_wifi),
+      statusScreen(display, true),
+      minLabel(3, 17, u8g2_font_6x12_tf, "min"),
+      minTempWidget(26, 17, u8g2_font_9x15_tf, "-99"),
+      maxLabel(3, 35, u8g2_font_6x12_tf, "max"),
+      maxTempWidget(26, 35, u8g2_font_9x15_tf, "-99"),
+      minMaxScreen(display, true),
+      uptimeLabel(3, 17, u8g2_font_6x12_tf, "up h"),
+      uptimeHoursWidget(30, 17, u8g2_font_9x15_tf, "9999"),
+      wifiStatusWidget(3, 35, u8g2_font_6x12_tf, "WiFi off"),
+      diagnosticsScreen(display, true),
+      energyLabel(3, 17, u8g2_font_6x12_tf, "kWh"),
+      energyWidget(26, 17, u8g2_font_9x15_tf, "9999"),
+      dutyLabel(3, 35, u8g2_font_6x12_tf, "on %"),
+      dutyWidget(30, 35, u8g2_font_9x15_tf, "100"),
+      energyScreen(display, true),
+      activeScreenId(Screen::Status),
+      activeScreen(&statusScreen),
+      screenChanged(true),
+      overlaid(false),
+      mirror(nullptr),
+      tempValid(false),
+      minTemp(0),
+      maxTemp(0) {
+  wifiWidget.setVisible(false);
+
+  statusScreen.add(tempWidget);
+  statusScreen.add(degreeWidget);
+  statusScreen.add(celsiusWidget);
+  statusScreen.add(zoneWidget);
+  statusScreen.add(heatingWidget);
+  statusScreen.add(wifiWidget);
+
+  minMaxScreen.add(minLabel);
+  minMaxScreen.add(minTempWidget);
+  minMaxScreen.add(maxLabel);
+  minMaxScreen.add(maxTempWidget);
+
+  diagnosticsScreen.add(uptimeLabel);
+  diagnosticsScreen.add(uptimeHoursWidget);
+  diagnosticsScreen.add(wifiStatusWidget);
+
+  energyScreen.add(energyLabel);
+  energyScreen.add(energyWidget);
+  energyScreen.add(dutyLabel);
+  energyScreen.add(dutyWidget);
 }
 
 void StatDisplay::setTemp(float temp) {
-  if (!isfinite(temp) || !isnan(temp)) {
-    return; // Ignore invalid temperature values
+  if (!isfinite(temp)) {
+    tempWidget.setInvalid(); // e.g. the sensor has failed; min/max are kept
+    return;
   }
   int newTemp;
   if (temp <= -99.0f) {
@@ -50,74 +88,71 @@ void StatDisplay::setTemp(float temp) {
     newTemp = static_cast<int>(std::round(temp));
   }
 
-  if (newTemp != this->temp) {
-    this->temp = newTemp;
-    dataUpdated = true;
-  }
-}
+  if (!tempValid || (newTemp < minTemp)) minTemp = newTemp;
+  if (!tempValid || (newTemp > maxTemp)) maxTemp = newTemp;
+  tempValid = true;
 
-void StatDisplay::setHeatingStatus(bool isOn) {
-  if (extLoadOnDisplayBlinker.isActive() == isOn) return; // no state change
-  dataUpdated = true;
+  // widgets only mark themselves dirty if the value has changed
+  tempWidget.setValue(newTemp);
+  minTempWidget.setValue(minTemp);
+  maxTempWidget.setValue(maxTemp);
+}
 
-  if (isOn) {
-    extLoadOnDisplayBlinker.activate();
-  } else {
-    extLoadOnDisplayBlinker.expire();
-  }
+void StatDisplay::setZone(uint8_t zone, uint8_t zoneCount) {
+  zoneWidget.setText(((zoneCount > 1) && (zone < zone_label_count)) ? zone_labels[zone] : "");
 }
 
+void StatDisplay::setHeatingStatus(bool isOn) { heatingWidget.setActive(isOn); }
+
 void StatDisplay::setWifiStatus(bool isConnected) {
-  if (isConnected != this->wifiConnected) {
-    this->wifiConnected = isConnected;
-    dataUpdated = true;
-  }
+  wifiWidget.setVisible(isConnected);
+  wifiStatusWidget.setText(isConnected ? "WiFi on" : "WiFi off");
 }
 
-void StatDisplay::checkRedraw() {
-  display.clearBuffer();                            // clear the internal memory
-  display.drawFrame(0, 0, OLED_width, OLED_height); // draw a frame around the border
-  display.setBitmapMode(1);
-
-  /* ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌----╌╌╌╌ Temperature ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ */
-  int t = this->temp;
-  if (t >= 0) {
-    display.setFont(u8g2_font_logisoso30_tf); // same font as for "°C" symbol, hence do not use reduced font
-    // convert this->temp to string and draw
-    // char tempStr[4]; // integer
-    // snprintf(tempStr, sizeof(tempStr), "%d", this->temp);
-    // display.drawUTF8(2, 34, tempStr);
-
-    // display.setCursor(2, 34);
-    // display.print(this->temp);
-  } else {
-    display.setFont(u8g2_font_logisoso26_tn); // numbers-only font [ending "tn"]
+void StatDisplay::setEnergy(float kWh, float duty) {
+  if (isfinite(kWh)) energyWidget.setValue(static_cast<int>(min(kWh, 9999.0f)));
+  if (isfinite(duty)) dutyWidget.setValue(static_cast<int>(std::round(100.0f * min(max(duty, 0.0f), 1.0f))));
+}
+
+void StatDisplay::showScreen(Screen screen) {
+  OledScreen *next = &statusScreen;
+  if (screen == Screen::MinMax) {
+    next = &minMaxScreen;
+  } else if (screen == Screen::Diagnostics) {
+    next = &diagnosticsScreen;
+  } else if (screen == Screen::Energy) {
+    next = &energyScreen;
   }
-  display.setCursor(2, 34);
-  display.print(t);
+  if (next == activeScreen) return;
+  activeScreenId = screen;
+  activeScreen = next;
+  screenChanged = true;
+}
 
-  display.setFont(u8g2_font_logisoso30_tf);
-  display.drawUTF8(42, 40, "°");
-  display.setFont(u8g2_font_logisoso18_tf);
-  display.drawUTF8(54, 22, "C");
+void StatDisplay::showNextScreen() { showScreen(static_cast<Screen>((activeScreenId + 1) % screen_count)); }
 
-  /* ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ Blinking heating symbol ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ */
-  if ((extLoadOnDisplayBlinker.isActive()) && (extLoadOnDisplayBlinker.isCurrentStateOn())) {
-    display.drawXBMP(37, 15, epd_bitmap_flash_width, epd_bitmap_flash_height, epd_bitmap_flash);
-  }
+void StatDisplay::setOverlaid(bool overlaid) {
+  if (overlaid == this->overlaid) return;
+  this->overlaid = overlaid;
+  if (!overlaid) screenChanged = true; // the overlay has drawn over the screen
+}
 
-  /* ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ Wifi symbol ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ */
-  if (this->wifiConnected) {
-    display.drawXBMP(55, 25, epd_bitmap_wifi_width, epd_bitmap_wifi_height, epd_bitmap_wifi);
+void StatDisplay::checkRedraw() {
+  if (overlaid) {
+    if (mirror != nullptr) mirror->checkFrame();
+    return;
+  }
+  if (activeScreen == &diagnosticsScreen) {
+    uptimeHoursWidget.setValue(static_cast<int>(esp_timer_get_time() / 3600000000LL)); // microseconds to hours
   }
 
-  dataUpdated = false;
-  display.sendBuffer();
+  if (screenChanged) {
+    screenChanged = false;
+    activeScreen->show();
+  } else {
+    activeScreen->checkRedraw();
+  }
+  if (mirror != nullptr) mirror->checkFrame();
 }
 
-bool StatDisplay::shouldRedraw() {
-  if (dataUpdated) return true;
-  if (extLoadOnDisplayBlinker.checkToggle()) return true;
-
-  return false;
-};
\ No newline at end of file
+void StatDisplay::setMirror(FrameMirror *mirror) { this->mirror = mirror; }
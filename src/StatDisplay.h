@@ -1,32 +1,87 @@
 #pragma once
+#include "FrameMirror.h"
 #include "FrequentlyUtils.h"
+#include "OledWidgets.h"
+#include "XbmAnimation.h"
 #include <Arduino.h>
 #include <U8g2lib.h>
 
 class StatDisplay {
 
   // CLASS StatDisplay
-  // encapsulates the u8g2 display logic for displaying the system status on the on-board 72x40 OLED screen
+  // encapsulates the u8g2 display logic for displaying the system status on the on-board 72x40 OLED screen.
+  // The values are bound to retained-mode widgets, which are laid out once; a redraw only re-renders the
+  // widgets whose value has changed. Several screens are available, of which one is shown at a time.
+  // While another component draws on the display (e.g. a scrolling status message), the display is set
+  // `overlaid`; it then leaves the screen alone, and redraws the active screen entirely once it is released.
 
   public:
-  StatDisplay(U8G2 &display, unsigned long heatingSymbolOnDurationMs, unsigned long heatingSymbolOffDurationMs); // constructor
+  enum Screen {
+    Status = 0,      // temperature, zone, animated heating symbol and wifi symbol
+    MinMax = 1,      // minimum and maximum temperature since boot
+    Diagnostics = 2, // uptime and wifi status
+    Energy = 3       // heater energy and duty cycle
+  };
 
-  // checkRedraw is intended to be called with high frequency, e.g. by the controller `loop`. It re-draws the
-  // the display only if data has changed since the last draw.
+  StatDisplay(U8G2 &display, XbmAnimationPlayer &heatingAnimation); // constructor; the caller activates the animation
+
+  // checkRedraw is intended to be called with high frequency, e.g. by the controller `loop`. It re-draws
+  // the widgets of the active screen only if their data has changed since the last draw. With a mirror,
+  // the screen is then also mirrored to the host (sent only if it has changed).
   void checkRedraw();
 
+  void showScreen(Screen screen);      // switches to the specified screen (redrawn entirely on the next `checkRedraw()`)
+  void showNextScreen();               // cycles through the screens, e.g. on a button press
+  void setOverlaid(bool overlaid);     // true: another component draws on the display; `checkRedraw()` only mirrors
+  void setMirror(FrameMirror *mirror); // mirrors the screen after each `checkRedraw()`; nullptr: no mirror
+
   // Lifecycle functions
-  void setTemp(float temp);             // sets the temperature to be displayed
-  void setHeatingStatus(bool isOn);     // sets the heating status to be displayed
-  void setWifiStatus(bool isConnected); // sets the wifi status to be displayed
+  void setTemp(float temp);                      // sets the temperature to be displayed; NaN: shown as "--"
+  void setZone(uint8_t zone, uint8_t zoneCount); // sets the zone of the temperature; shown only with several zones
+  void setHeatingStatus(bool isOn);              // sets the heating status to be displayed
+  void setWifiStatus(bool isConnected);          // sets the wifi status to be displayed
+  void setEnergy(float kWh, float duty);         // sets the heater energy [kWh] and duty cycle [0..1] to be displayed
 
   private:
   U8G2 &display;
-  int temp;
-  bool wifiConnected;
-  FrequencyToggler2 extLoadOnDisplayBlinker;
 
-  bool dataUpdated;
+  // Status screen
+  NumberWidget tempWidget;
+  TextWidget degreeWidget;
+  TextWidget celsiusWidget;
+  TextWidget zoneWidget;
+  AnimationWidget heatingWidget;
+  BitmapWidget wifiWidget;
+  OledScreen statusScreen;
+
+  // MinMax screen
+  TextWidget minLabel;
+  NumberWidget minTempWidget;
+  TextWidget maxLabel;
+  NumberWidget maxTempWidget;
+  OledScreen minMaxScreen;
+
+  // Diagnostics screen
+  TextWidget uptimeLabel;
+  NumberWidget uptimeHoursWidget;
+  TextWidget wifiStatusWidget;
+  OledScreen diagnosticsScreen;
+
+  // Energy screen
+  TextWidget energyLabel;
+  NumberWidget energyWidget;
+  TextWidget dutyLabel;
+  NumberWidget dutyWidget;
+  OledScreen energyScreen;
+
+  Screen activeScreenId;
+  OledScreen *activeScreen;
+  bool screenChanged;
+  bool overlaid;
+  FrameMirror *mirror;
 
-  bool shouldRedraw();
-};
\ No newline at end of file
+  // dynamic state parameters
+  bool tempValid; // at least one valid temperature has been set (min/max are meaningful)
+  int minTemp;
+  int maxTemp;
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include <Arduino.h>
+#include <new> // For placement new
+
+template <typename T>
+class StaticInstance {
+
+  // CLASS StaticInstance
+  //
+  // Statically allocated storage for exactly one object of type `T`, constructed at a chosen point in time
+  // (typically in `setup()`) instead of at static initialization. This replaces `new` for long-lived objects:
+  // the memory is reserved in .bss at link time, hence it shows up in the firmware's RAM budget and cannot
+  // fragment the heap.
+  //
+  // `emplace()` constructs the object in place; if an object has already been constructed, it is destroyed
+  // first, i.e. re-emplacing replaces the object without leaking. Access via `->` or `*` is only valid after
+  // the first `emplace()`.
+
+  public:
+  StaticInstance() : constructed(false) {} // constructor
+
+  template <typename... Args>
+  T &emplace(Args &&...args) {
+    if (constructed) object()->~T();
+    new (storage) T(static_cast<Args &&>(args)...);
+    constructed = true;
+    return *object();
+  }
+
+  bool isConstructed() const { return constructed; }
+
+  T *operator->() { return object(); }
+  T &operator*() { return *object(); }
+
+  private:
+  T *object() { return reinterpret_cast<T *>(storage); }
+
+  alignas(T) uint8_t storage[sizeof(T)];
+  bool constructed;
+};
@@ -0,0 +1,364 @@
+#include "StreamStats.h"
+#include <cstdint>     // For int64_t
+#include <esp_timer.h> // For esp_timer_get_time()
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                     STRUCT StatSummary                                         *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Welford's update, and Chan et al.'s combination of two summaries A and B (n = n_A + n_B, δ = mean_B - mean_A):
+//   mean = mean_A + δ * n_B / n
+//   m2   = m2_A + m2_B + δ² * n_A * n_B / n
+// `unmerge()` solves these equations for A.
+
+void StatSummary::reset() {
+  count = 0;
+  mean = 0.0f;
+  m2 = 0.0f;
+  min = INFINITY;
+  max = -INFINITY;
+}
+
+void StatSummary::add(float value) {
+  count++;
+  float delta = value - mean;
+  mean += delta / static_cast<float>(count);
+  m2 += delta * (value - mean);
+  if (value < min) min = value;
+  if (value > max) max = value;
+}
+
+void StatSummary::merge(const StatSummary &other) {
+  if (other.count == 0) return;
+  if (count == 0) {
+    *this = other;
+    return;
+  }
+  float n = static_cast<float>(count + other.count);
+  float delta = other.mean - mean;
+  mean += delta * static_cast<float>(other.count) / n;
+  m2 += other.m2 + delta * delta * static_cast<float>(count) * static_cast<float>(other.count) / n;
+  count += other.count;
+  if (other.min < min) min = other.min;
+  if (other.max > max) max = other.max;
+}
+
+void StatSummary::unmerge(const StatSummary &other) {
+  if (other.count == 0) return;
+  if (other.count >= count) {
+    count = 0;
+    mean = 0.0f;
+    m2 = 0.0f;
+    return;
+  }
+  float n = static_cast<float>(count);
+  float remaining = static_cast<float>(count - other.count);
+  float remainingMean = (n * mean - static_cast<float>(other.count) * other.mean) / remaining;
+  float delta = other.mean - remainingMean;
+  m2 -= other.m2 + delta * delta * remaining * static_cast<float>(other.count) / n;
+  if (m2 < 0.0f) m2 = 0.0f; // rounding
+  mean = remainingMean;
+  count -= other.count;
+}
+
+float StatSummary::variance() { return (count < 2) ? 0.0f : m2 / static_cast<float>(count - 1); }
+
+float StatSummary::stddev() { return sqrtf(variance()); }
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                      CLASS StatWindow                                          *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Sliding window of buckets. The deques hold the indices of the buckets that may still become the window's
+// minimum (maximum): a bucket is dropped from the back once a newer bucket has a smaller (larger) minimum
+// (maximum), and from the front once it is evicted from the ring. Empty buckets never enter the deques.
+
+// constructor:
+StatWindow::StatWindow() { reset(); }
+
+void StatWindow::reset() {
+  for (StatSummary &bucket : buckets) bucket.reset();
+  open.reset();
+  running.reset();
+  head = 0;
+  filled = 0;
+  minFront = 0;
+  minSize = 0;
+  maxFront = 0;
+  maxSize = 0;
+}
+
+void StatWindow::add(float value) { open.add(value); }
+
+void StatWindow::addSummary(const StatSummary &s) { open.merge(s); }
+
+const StatSummary &StatWindow::closeBucket() {
+  constexpr uint8_t capacity = StreamStatsUtils::buckets_per_window;
+  uint8_t index = head;
+
+  // evict the oldest bucket, which occupies the slot of the new one
+  if (filled == capacity) {
+    running.unmerge(buckets[index]);
+    if ((minSize > 0) && (minDeque[minFront] == index)) {
+      minFront = (minFront + 1) % capacity;
+      minSize--;
+    }
+    if ((maxSize > 0) && (maxDeque[maxFront] == index)) {
+      maxFront = (maxFront + 1) % capacity;
+      maxSize--;
+    }
+  }
+
+  buckets[index] = open;
+  running.merge(open);
+  if (open.count > 0) pushDeques(index);
+  open.reset();
+
+  head = (head + 1) % capacity;
+  if (filled < capacity) filled++;
+  if (head == 0) rebuild(); // once per lap: amortized O(1)
+  return buckets[index];
+}
+
+StatSummary StatWindow::summary() {
+  StatSummary result = running;
+  result.min = (minSize > 0) ? buckets[minDeque[minFront]].min : INFINITY;
+  result.max = (maxSize > 0) ? buckets[maxDeque[maxFront]].max : -INFINITY;
+  result.merge(open);
+  return result;
+}
+
+const StatSummary &StatWindow::openBucket() { return open; }
+
+void StatWindow::pushDeques(uint8_t index) {
+  constexpr uint8_t capacity = StreamStatsUtils::buckets_per_window;
+  while ((minSize > 0) && (buckets[minDeque[(minFront + minSize - 1) % capacity]].min >= buckets[index].min)) minSize--;
+  minDeque[(minFront + minSize) % capacity] = index;
+  minSize++;
+  while ((maxSize > 0) && (buckets[maxDeque[(maxFront + maxSize - 1) % capacity]].max <= buckets[index].max)) maxSize--;
+  maxDeque[(maxFront + maxSize) % capacity] = index;
+  maxSize++;
+}
+
+void StatWindow::skipBuckets(uint32_t count) {
+  if (count >= StreamStatsUtils::buckets_per_window) {
+    reset(); // a full lap of empty buckets evicts every closed bucket
+    return;
+  }
+  for (uint32_t i = 0; i < count; i++) closeBucket();
+}
+
+void StatWindow::rebuild() {
+  running.reset();
+  for (uint8_t i = 0; i < filled; i++) running.merge(buckets[i]);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                      CLASS StreamStats                                         *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Minute, hour and day windows, decimating 1-second buckets into 1-minute and 24-minute buckets.
+
+// constructor:
+StreamStats::StreamStats()
+    : openSinceMs(0),
+      secondsInMinuteBucket(0),
+      minutesInDayBucket(0),
+      started(false) {
+}
+
+void StreamStats::add(float value) { add(value, esp_timer_get_time() / 1000LL); }
+
+void StreamStats::add(float value, int64_t nowMs) {
+  advanceTo(nowMs);
+  minute.add(value);
+}
+
+void StreamStats::reset() {
+  minute.reset();
+  hour.reset();
+  day.reset();
+  secondsInMinuteBucket = 0;
+  minutesInDayBucket = 0;
+  started = false;
+}
+
+StatSummary StreamStats::lastMinute() {
+  return minute.summary();
+}
+
+StatSummary StreamStats::lastHour() {
+  StatSummary result = hour.summary();
+  result.merge(minute.openBucket());
+  return result;
+}
+
+StatSummary StreamStats::lastDay() {
+  StatSummary result = day.summary();
+  result.merge(hour.openBucket());
+  result.merge(minute.openBucket());
+  return result;
+}
+
+void StreamStats::printSummary(const __FlashStringHelper *label, uint8_t decimals /* = 2 */) {
+  StatSummary windows[3] = {lastMinute(), lastHour(), lastDay()};
+  static const char *const names[3] = {" 1m ", " 1h ", " 1d "};
+  Serial.print(label);
+  Serial.print(':');
+  for (uint8_t i = 0; i < 3; i++) {
+    Serial.print(names[i]);
+    if (windows[i].count == 0) {
+      Serial.print(F("-"));
+      continue;
+    }
+    Serial.print(windows[i].mean, decimals);
+    Serial.print(F("±"));
+    Serial.print(windows[i].stddev(), decimals);
+    Serial.print(F(" ["));
+    Serial.print(windows[i].min, decimals);
+    Serial.print(F(".."));
+    Serial.print(windows[i].max, decimals);
+    Serial.print(']');
+  }
+  Serial.println();
+}
+
+void StreamStats::advanceTo(int64_t nowMs) {
+  constexpr int64_t day_ms = static_cast<int64_t>(StreamStatsUtils::buckets_per_window) * StreamStatsUtils::minutes_per_day_bucket *
+                             StreamStatsUtils::seconds_per_minute_bucket * StreamStatsUtils::second_bucket_ms;
+  if (!started || (nowMs - openSinceMs > day_ms)) {
+    // first value, or silent for longer than the day window: nothing in the windows remains valid
+    if (started) reset();
+    openSinceMs = nowMs;
+    started = true;
+    return;
+  }
+  uint32_t seconds = static_cast<uint32_t>((nowMs - openSinceMs) / StreamStatsUtils::second_bucket_ms);
+  if (seconds == 0) return;
+  openSinceMs += static_cast<int64_t>(seconds) * StreamStatsUtils::second_bucket_ms;
+  tick();                        // the open bucket holds the values since the last tick
+  skipEmptySeconds(seconds - 1); // the rest of the gap saw no values
+}
+
+void StreamStats::tick() {
+  hour.addSummary(minute.closeBucket());
+  if (++secondsInMinuteBucket < StreamStatsUtils::seconds_per_minute_bucket) return;
+  secondsInMinuteBucket = 0;
+  day.addSummary(hour.closeBucket());
+  if (++minutesInDayBucket < StreamStatsUtils::minutes_per_day_bucket) return;
+  minutesInDayBucket = 0;
+  day.closeBucket();
+}
+
+// Same as `count` calls of `tick()` with no values added in between: the first close of a coarser window
+// carries its open bucket on, the further closes are empty.
+void StreamStats::skipEmptySeconds(uint32_t count) {
+  if (count == 0) return;
+  minute.skipBuckets(count);
+  uint32_t seconds = secondsInMinuteBucket + count;
+  secondsInMinuteBucket = seconds % StreamStatsUtils::seconds_per_minute_bucket;
+  uint32_t minutes = seconds / StreamStatsUtils::seconds_per_minute_bucket;
+  if (minutes == 0) return;
+  day.addSummary(hour.closeBucket());
+  hour.skipBuckets(minutes - 1);
+  minutes += minutesInDayBucket;
+  minutesInDayBucket = minutes % StreamStatsUtils::minutes_per_day_bucket;
+  uint32_t days = minutes / StreamStatsUtils::minutes_per_day_bucket;
+  if (days == 0) return;
+  day.closeBucket();
+  day.skipBuckets(days - 1);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                      CLASS P2Quantile                                          *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// P² quantile estimator (R. Jain, I. Chlamtac: "The P² algorithm for dynamic calculation of quantiles and
+// histograms without storing observations", CACM 28(10), 1985).
+
+// constructor:
+P2Quantile::P2Quantile(float quantile) : quantile(quantile) { reset(); }
+
+void P2Quantile::add(float value) {
+  if (count < 5) {
+    // collect the first five values, sorted by insertion
+    uint8_t i = count;
+    while ((i > 0) && (heights[i - 1] > value)) {
+      heights[i] = heights[i - 1];
+      i--;
+    }
+    heights[i] = value;
+    count++;
+    return;
+  }
+  count++;
+
+  // cell k with heights[k] <= value < heights[k+1]; extend the extreme markers if needed
+  uint8_t k;
+  if (value < heights[0]) {
+    heights[0] = value;
+    k = 0;
+  } else if (value >= heights[4]) {
+    heights[4] = value;
+    k = 3;
+  } else {
+    k = 0;
+    while (value >= heights[k + 1]) k++;
+  }
+  for (uint8_t i = k + 1; i < 5; i++) {
+    positions[i]++;
+    lags[i] -= 1.0f;
+  }
+  for (uint8_t i = 0; i < 5; i++) lags[i] += increments[i];
+
+  // move the middle markers towards their desired positions
+  for (uint8_t i = 1; i < 4; i++) {
+    float d = lags[i];
+    if (((d >= 1.0f) && (positions[i + 1] - positions[i] > 1)) || ((d <= -1.0f) && (positions[i] - positions[i - 1] > 1))) {
+      float step = (d > 0.0f) ? 1.0f : -1.0f;
+      float candidate = parabolic(i, step);
+      heights[i] = ((heights[i - 1] < candidate) && (candidate < heights[i + 1])) ? candidate : linear(i, step);
+      if (d > 0.0f) {
+        positions[i]++;
+      } else {
+        positions[i]--;
+      }
+      lags[i] -= step;
+    }
+  }
+}
+
+float P2Quantile::value() {
+  if (count == 0) return NAN;
+  if (count >= 5) return heights[2];
+  return heights[static_cast<uint8_t>(roundf(quantile * static_cast<float>(count - 1)))];
+}
+
+void P2Quantile::reset() {
+  count = 0;
+  for (uint8_t i = 0; i < 5; i++) {
+    heights[i] = 0.0f;
+    positions[i] = i + 1;
+  }
+  // initial desired positions 1, 1 + 2q, 1 + 4q, 3 + 2q, 5
+  lags[0] = 0.0f;
+  lags[1] = 2.0f * quantile - 1.0f;
+  lags[2] = 4.0f * quantile - 2.0f;
+  lags[3] = 2.0f * quantile - 1.0f;
+  lags[4] = 0.0f;
+  increments[0] = 0.0f;
+  increments[1] = quantile / 2.0f;
+  increments[2] = quantile;
+  increments[3] = (1.0f + quantile) / 2.0f;
+  increments[4] = 1.0f;
+}
+
+// Only distances between markers enter the interpolation; they are small, hence exact as floats.
+float P2Quantile::parabolic(uint8_t i, float d) {
+  float below = static_cast<float>(positions[i] - positions[i - 1]);
+  float above = static_cast<float>(positions[i + 1] - positions[i]);
+  return heights[i] + d / (below + above) *
+                          ((below + d) * (heights[i + 1] - heights[i]) / above + (above - d) * (heights[i] - heights[i - 1]) / below);
+}
+
+float P2Quantile::linear(uint8_t i, float d) {
+  float distance = (d > 0.0f) ? static_cast<float>(positions[i + 1] - positions[i]) : -static_cast<float>(positions[i] - positions[i - 1]);
+  uint8_t j = (d > 0.0f) ? i + 1 : i - 1;
+  return heights[i] + d * (heights[j] - heights[i]) / distance;
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include <Arduino.h>
+
+namespace StreamStatsUtils {
+  constexpr uint8_t buckets_per_window = 60;        // every window is made of this many buckets
+  constexpr uint32_t second_bucket_ms = 1000;       // minute window: 60 buckets of 1 second
+  constexpr uint8_t seconds_per_minute_bucket = 60; // hour window:  60 buckets of 1 minute
+  constexpr uint8_t minutes_per_day_bucket = 24;    // day window:   60 buckets of 24 minutes
+}
+
+// Count, mean, variance (Welford), minimum and maximum of a set of values. Summaries can be merged, and a
+// merged part can be removed again (except for minimum and maximum).
+struct StatSummary {
+  uint32_t count;
+  float mean;
+  float m2; // sum of squared differences from the mean
+  float min;
+  float max;
+
+  void reset();
+  void add(float value);                  // Welford's update
+  void merge(const StatSummary &other);   // Chan's parallel combination
+  void unmerge(const StatSummary &other); // inverse of `merge()`; leaves minimum and maximum untouched
+  float variance();                       // sample variance (0 for less than two values)
+  float stddev();
+};
+
+class StatWindow {
+
+  // CLASS StatWindow
+  //
+  // Sliding window over the latest `buckets_per_window` closed buckets plus the open bucket. Closing a bucket
+  // is O(1): the running summary of the window adds the new bucket and removes the evicted one, and two
+  // monotonic deques of bucket indices keep the window's minimum and maximum at their front. Skipping a
+  // stretch of empty buckets costs at most one lap of the ring.
+  // The running summary is rebuilt from the buckets once per lap of the ring, so floating-point drift from
+  // repeated add/remove does not accumulate.
+
+  public:
+  StatWindow(); // constructor
+
+  void reset();
+  void add(float value);                 // adds a value to the open bucket
+  void addSummary(const StatSummary &s); // merges a closed bucket of a finer window into the open bucket
+  const StatSummary &closeBucket();      // closes the open bucket; returns it (for the next coarser window)
+  void skipBuckets(uint32_t count);      // closes `count` empty buckets (the open bucket must be empty)
+
+  StatSummary summary();           // summary of the window, including the open bucket
+  const StatSummary &openBucket(); // the open bucket
+
+  private:
+  void pushDeques(uint8_t index);
+  void rebuild();
+
+  StatSummary buckets[StreamStatsUtils::buckets_per_window]; // ring of closed buckets
+  StatSummary open;
+  StatSummary running; // count, mean and m2 of the closed buckets in the ring
+  uint8_t head;        // slot for the next closed bucket
+  uint8_t filled;      // number of closed buckets in the ring
+
+  // monotonic deques of ring indices (in chronological order); stored as rings of their own
+  uint8_t minDeque[StreamStatsUtils::buckets_per_window];
+  uint8_t maxDeque[StreamStatsUtils::buckets_per_window];
+  uint8_t minFront, minSize;
+  uint8_t maxFront, maxSize;
+};
+
+class StreamStats {
+
+  // CLASS StreamStats
+  //
+  // Rolling statistics (count, mean, standard deviation, min, max) of a stream of values over the last
+  // minute, hour and day, in fixed memory. Values are collected in 1-second buckets; every closed bucket is
+  // decimated into the open bucket of the next coarser window (1 minute, then 24 minutes). Adding a value is
+  // O(1), and so is closing a bucket. A gap in the stream closes its empty buckets in bulk, so time may
+  // advance in arbitrary steps at a bounded cost.
+  //
+  // The same class serves sensor values (e.g. temperature) and profiling durations (e.g. loop time).
+
+  public:
+  StreamStats(); // constructor
+
+  void add(float value);                // adds a value at the current time
+  void add(float value, int64_t nowMs); // adds a value at the given time [milliseconds]
+  void reset();
+
+  // Windows end at the time of the latest value added (the streams are expected to be fed continuously).
+  StatSummary lastMinute();
+  StatSummary lastHour();
+  StatSummary lastDay();
+
+  void printSummary(const __FlashStringHelper *label, uint8_t decimals = 2); // prints the three windows
+
+  private:
+  void advanceTo(int64_t nowMs);
+  void tick();                           // closes the 1-second bucket, and cascades to the coarser windows
+  void skipEmptySeconds(uint32_t count); // closes `count` empty 1-second buckets, and cascades in bulk
+
+  StatWindow minute;
+  StatWindow hour;
+  StatWindow day;
+  int64_t openSinceMs;
+  uint8_t secondsInMinuteBucket;
+  uint8_t minutesInDayBucket;
+  bool started;
+};
+
+class P2Quantile {
+
+  // CLASS P2Quantile
+  //
+  // Streaming estimate of a quantile (e.g. the 99th percentile of the loop time) with the P² algorithm by Jain
+  // and Chlamtac: five markers track the minimum, the quantile, the maximum and two intermediate quantiles, and
+  // are adjusted by piecewise-parabolic interpolation. Memory and the cost of an update are constant.
+  // The estimate covers all values since the last `reset()`. Marker positions are counted in integers, and
+  // only the small lag of a marker behind its desired position is kept in floating point, so the markers
+  // keep moving after any number of values (a float position stops counting at 2^24).
+
+  public:
+  P2Quantile(float quantile); // constructor
+
+  void add(float value);
+  float value(); // current estimate (exact for less than five values)
+  void reset();
+
+  private:
+  float parabolic(uint8_t i, float d);
+  float linear(uint8_t i, float d);
+
+  const float quantile;
+  float heights[5];
+  uint32_t positions[5];
+  float lags[5];       // desired minus actual position of the markers
+  float increments[5]; // growth of the desired positions per value
+  uint32_t count;
+};
@@ -0,0 +1,273 @@
+#include "ThermalPredictor.h"
+#include <Preferences.h> // For persisting the learned model in NVS
+#include <cstdint>       // For int64_t
+#include <esp_timer.h>   // For esp_timer_get_time()
+
+namespace {
+  constexpr uint32_t persisted_magic = 0x4B544D31; // "KTM1": version 1 of the persisted model
+
+  struct PersistedModel {
+    uint32_t magic;
+    uint8_t deadTime;
+    float theta[3];
+  };
+
+  Preferences modelStore;
+  constexpr const char *store_namespace = "thermal";
+  constexpr const char *store_key = "model";
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                   CLASS ThermalPredictor                                       *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Online identification of a first-order-plus-dead-time plant and predictive on/off control.
+//
+// RLS step for regressor φ = [T[k], u[k-d], 1] and observation y = T[k+1]:
+//   e = y - φᵀθ,  g = Pφ / (λ + φᵀPφ),  θ += g e,  P = (P - g (Pφ)ᵀ) / λ
+// P is kept symmetric by construction. Without excitation (constant temperature and duty), dividing by λ
+// lets P grow without bound; beyond `max_covariance_trace`, forgetting is suspended.
+
+// constructor:
+ThermalPredictor::ThermalPredictor(float setpointC, float hysteresisC)
+    : hysteresisC(hysteresisC),
+      setpointC(setpointC),
+      best(0),
+      rotation(0),
+      duties{},
+      dutyHead(0),
+      latestC(0.0f),
+      previousC(0.0f),
+      hasLatest(false),
+      hasPrevious(false),
+      updates(0),
+      updatesSincePersist(0),
+      heat(false),
+      periodStartMilli(0),
+      lastCheckMilli(0),
+      onTimeMs(0),
+      lastHeaterOn(false),
+      predictionError(0.05f),
+      projected(0.0f),
+      updateUs(0) {
+  for (Estimator &estimator : estimators) resetEstimator(estimator, ThermalUtils::initial_covariance);
+}
+
+void ThermalPredictor::begin() {
+  modelStore.begin(store_namespace, false);
+  PersistedModel model;
+  if ((modelStore.getBytes(store_key, &model, sizeof(model)) != sizeof(model)) || (model.magic != persisted_magic) ||
+      (model.deadTime >= ThermalUtils::dead_time_candidates)) {
+    return;
+  }
+  // seed all candidates with the learned model, favoring the learned dead time; learning continues from there
+  for (uint8_t d = 0; d < ThermalUtils::dead_time_candidates; d++) {
+    resetEstimator(estimators[d], ThermalUtils::restored_covariance);
+    for (uint8_t i = 0; i < 3; i++) estimators[d].theta[i] = model.theta[i];
+    estimators[d].squaredError = (d == model.deadTime) ? 0.0f : 1.0f;
+  }
+  best = model.deadTime;
+  updates = ThermalUtils::min_updates;
+}
+
+void ThermalPredictor::addTemperature(float tempC) {
+  latestC = tempC;
+  hasLatest = true;
+}
+
+bool ThermalPredictor::checkUpdate(bool heaterOn) {
+  int64_t currentMillis = esp_timer_get_time() / 1000LL; // convert microseconds returned by `esp_timer_get_time()` to milliseconds
+  if (periodStartMilli == 0) {
+    periodStartMilli = currentMillis;
+    lastCheckMilli = currentMillis;
+  }
+  if (lastHeaterOn) onTimeMs += currentMillis - lastCheckMilli;
+  lastHeaterOn = heaterOn;
+  lastCheckMilli = currentMillis;
+
+  int64_t elapsedMs = currentMillis - periodStartMilli;
+  if (elapsedMs < static_cast<int64_t>(ThermalUtils::period_ms)) return false;
+
+  int64_t startUs = esp_timer_get_time();
+  float duty = min(1.0f, static_cast<float>(onTimeMs) / static_cast<float>(elapsedMs));
+  periodStartMilli = currentMillis;
+  onTimeMs = 0;
+  addPeriod(duty);
+  updateUs = static_cast<uint32_t>(esp_timer_get_time() - startUs);
+
+  if ((++updatesSincePersist >= ThermalUtils::persist_every_updates) && isTrusted()) {
+    updatesSincePersist = 0;
+    persist();
+  }
+  return true;
+}
+
+void ThermalPredictor::addPeriod(float duty) {
+  updateModel(duty);
+  decide();
+}
+
+bool ThermalPredictor::shouldHeat() { return heat; }
+
+void ThermalPredictor::setSetpoint(float setpointC) { this->setpointC = setpointC; }
+
+bool ThermalPredictor::isTrusted() {
+  const float *theta = estimators[best].theta;
+  return (updates >= ThermalUtils::min_updates) && (theta[0] > 0.0f) && (theta[0] < 1.0f) && (theta[1] > 0.0f);
+}
+
+float ThermalPredictor::gainC() {
+  const float *theta = estimators[best].theta;
+  return theta[1] / (1.0f - theta[0]);
+}
+
+float ThermalPredictor::timeConstantS() {
+  float a = estimators[best].theta[0];
+  if ((a <= 0.0f) || (a >= 1.0f)) return NAN;
+  return -(ThermalUtils::period_ms / 1000.0f) / logf(a);
+}
+
+float ThermalPredictor::deadTimeS() { return best * (ThermalUtils::period_ms / 1000.0f); }
+
+float ThermalPredictor::ambientC() {
+  const float *theta = estimators[best].theta;
+  return theta[2] / (1.0f - theta[0]);
+}
+
+float ThermalPredictor::predictionErrorC() { return predictionError.value(); }
+
+float ThermalPredictor::projectedC() { return projected; }
+
+uint32_t ThermalPredictor::lastUpdateUs() { return updateUs; }
+
+void ThermalPredictor::printStats() {
+  Serial.print(F("Thermal model: "));
+  Serial.print(isTrusted() ? F("trusted") : F("learning"));
+  Serial.print(F(", gain "));
+  Serial.print(gainC());
+  Serial.print(F(" C, tau "));
+  Serial.print(timeConstantS());
+  Serial.print(F(" s, dead time "));
+  Serial.print(deadTimeS());
+  Serial.print(F(" s, ambient "));
+  Serial.print(ambientC());
+  Serial.print(F(" C, prediction error "));
+  Serial.print(predictionError.value(), 3);
+  Serial.print(F(" C, projected "));
+  Serial.print(projected);
+  Serial.print(F(" C, update "));
+  Serial.print(updateUs);
+  Serial.println(F(" us"));
+}
+
+void ThermalPredictor::updateModel(float duty) {
+  dutyHead = (dutyHead + 1) % ThermalUtils::dead_time_candidates;
+  duties[dutyHead] = duty;
+  if (!hasLatest) return;
+
+  if (hasPrevious) {
+    // the best candidate and its neighbours learn every period, the others in turn
+    uint8_t first = (best > 0) ? best - 1 : 0;
+    uint8_t last = min<uint8_t>(best + 1, ThermalUtils::dead_time_candidates - 1);
+    for (uint8_t d = first; d <= last; d++) updateCandidate(d);
+    do {
+      rotation = (rotation + 1) % ThermalUtils::dead_time_candidates;
+    } while ((rotation >= first) && (rotation <= last));
+    updateCandidate(rotation);
+    for (uint8_t d = 0; d < ThermalUtils::dead_time_candidates; d++) {
+      if (estimators[d].squaredError < estimators[best].squaredError) best = d;
+    }
+    if (updates < UINT16_MAX) updates++;
+  }
+  previousC = latestC;
+  hasPrevious = true;
+}
+
+void ThermalPredictor::updateCandidate(uint8_t deadTime) {
+  const float phi[3] = {previousC, pastDuty(deadTime), 1.0f};
+  updateEstimator(estimators[deadTime], phi, latestC);
+}
+
+void ThermalPredictor::updateEstimator(Estimator &estimator, const float phi[3], float y) {
+  float(&p)[3][3] = estimator.p;
+  float *theta = estimator.theta;
+
+  float error = y - (phi[0] * theta[0] + phi[1] * theta[1] + phi[2] * theta[2]);
+  estimator.squaredError += 0.05f * (error * error - estimator.squaredError);
+  if (&estimator == &estimators[best]) predictionError.update(fabsf(error));
+
+  float pPhi[3];
+  for (uint8_t i = 0; i < 3; i++) pPhi[i] = p[i][0] * phi[0] + p[i][1] * phi[1] + p[i][2] * phi[2];
+  float trace = p[0][0] + p[1][1] + p[2][2];
+  float lambda = (trace < ThermalUtils::max_covariance_trace) ? ThermalUtils::forgetting_factor : 1.0f;
+  float denominator = lambda + phi[0] * pPhi[0] + phi[1] * pPhi[1] + phi[2] * pPhi[2];
+  float inverseLambda = 1.0f / lambda;
+
+  float gain[3];
+  for (uint8_t i = 0; i < 3; i++) {
+    gain[i] = pPhi[i] / denominator;
+    theta[i] += gain[i] * error;
+  }
+  for (uint8_t i = 0; i < 3; i++) {
+    for (uint8_t j = i; j < 3; j++) {
+      p[i][j] = (p[i][j] - gain[i] * pPhi[j]) * inverseLambda;
+      p[j][i] = p[i][j];
+    }
+  }
+}
+
+void ThermalPredictor::resetEstimator(Estimator &estimator, float covariance) {
+  estimator.theta[0] = 1.0f; // a: no decay
+  estimator.theta[1] = 0.0f; // b: no heating effect
+  estimator.theta[2] = 0.0f;
+  for (uint8_t i = 0; i < 3; i++) {
+    for (uint8_t j = 0; j < 3; j++) estimator.p[i][j] = (i == j) ? covariance : 0.0f;
+  }
+  estimator.squaredError = 0.0f;
+}
+
+// Projects the temperature over the dead time plus the lookahead, with the heater off from now on. Returns the
+// temperature at the end of the horizon; `peakC` receives the maximum along the way.
+float ThermalPredictor::project(const Estimator &estimator, uint8_t deadTime, float &peakC) {
+  const float *theta = estimator.theta;
+  float tempC = latestC;
+  peakC = tempC;
+  for (uint8_t j = 1; j <= deadTime + ThermalUtils::lookahead_periods; j++) {
+    // input of period k+j-d: known for j <= d (heater state in the pipe), off afterwards
+    float duty = (j <= deadTime) ? pastDuty(deadTime - j) : 0.0f;
+    tempC = theta[0] * tempC + theta[1] * duty + theta[2];
+    peakC = max(peakC, tempC);
+  }
+  return tempC;
+}
+
+// heater duty of the period `periodsAgo` periods before the latest one
+float ThermalPredictor::pastDuty(uint8_t periodsAgo) {
+  uint8_t index = (dutyHead + ThermalUtils::dead_time_candidates - periodsAgo) % ThermalUtils::dead_time_candidates;
+  return duties[index];
+}
+
+void ThermalPredictor::decide() {
+  if (!hasLatest) return;
+  if (!isTrusted()) {
+    // plain hysteresis thermostat
+    projected = latestC;
+    if (heat && (latestC >= setpointC)) heat = false;
+    if (!heat && (latestC <= setpointC - hysteresisC)) heat = true;
+    return;
+  }
+  float peakC;
+  projected = project(estimators[best], best, peakC);
+  if (heat && (peakC >= setpointC)) {
+    heat = false; // heat in the pipe will carry the temperature to the setpoint
+  } else if (!heat && (projected <= setpointC - hysteresisC)) {
+    heat = true; // heating now arrives after the dead time, when the temperature has dropped
+  }
+}
+
+void ThermalPredictor::persist() {
+  PersistedModel model;
+  model.magic = persisted_magic;
+  model.deadTime = best;
+  for (uint8_t i = 0; i < 3; i++) model.theta[i] = estimators[best].theta[i];
+  modelStore.putBytes(store_key, &model, sizeof(model));
+}
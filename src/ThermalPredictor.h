@@ -0,0 +1,111 @@
+#pragma once
+#include "Ewma.h"
+#include <Arduino.h>
+
+namespace ThermalUtils {
+  constexpr unsigned long period_ms = 5000;       // identification and control period
+  constexpr uint8_t dead_time_candidates = 6;     // candidate dead times: 0 .. 5 periods (0 .. 25 s)
+  constexpr uint8_t lookahead_periods = 2;        // prediction horizon beyond the dead time
+  constexpr float forgetting_factor = 0.995f;     // RLS: weight of past samples per period (time constant ~17 min)
+  constexpr float initial_covariance = 1000.0f;   // RLS: initial uncertainty of the parameters
+  constexpr float restored_covariance = 10.0f;    // RLS: uncertainty of parameters restored after a reboot
+  constexpr float max_covariance_trace = 1.0e5f;  // RLS: stop forgetting beyond, to avoid wind-up without excitation
+  constexpr uint16_t min_updates = 60;            // periods before the model is trusted (5 minutes)
+  constexpr uint16_t persist_every_updates = 360; // store the learned model every 30 minutes
+}
+
+class ThermalPredictor {
+
+  // CLASS ThermalPredictor
+  //
+  // Online identification of the heated zone as a first-order-plus-dead-time plant, and on/off control of the
+  // heater that cuts or resumes heating early based on the projected temperature.
+  //
+  // Model, sampled with the fixed period Ts = `period_ms` (temperature T, heater duty u in [0, 1], dead time d):
+  //   T[k+1] = a * T[k] + b * u[k-d] + c
+  // with a = exp(-Ts/τ), b = K * (1-a), c = T_ambient * (1-a), where K is the heater gain [°C at full duty]
+  // and τ the time constant. For each candidate dead time, a recursive least squares (RLS) estimator with
+  // forgetting learns (a, b, c); the candidate with the smallest prediction error determines the dead time.
+  //
+  // Control: the heater state already "in the pipe" reaches the sensor only after the dead time. Hence, the
+  // temperature is projected over the dead time plus `lookahead_periods` with the heater off from now on:
+  //   * heating: cut as soon as the projection reaches the setpoint
+  //   * not heating: resume as soon as the projection drops below setpoint - hysteresis
+  // Until the model is trusted, a plain hysteresis thermostat on the current temperature is used.
+  //
+  // All state is fixed-size. Per period, the best candidate and its neighbours take one RLS step (~60 float
+  // operations) each, and one of the other candidates in turn, i.e. at most 4 of the 6; every candidate learns
+  // at least every fourth period. `lastUpdateUs()` reports the measured time. The learned model of the best
+  // candidate is persisted in NVS (every `persist_every_updates` periods) and restored by `begin()`.
+
+  public:
+  ThermalPredictor(float setpointC, float hysteresisC); // constructor
+
+  void begin(); // restores a persisted model, if any
+
+  void addTemperature(float tempC); // reports a valid temperature reading (the latest reading is used per period)
+
+  // Loop function: integrates the heater state; returns true _once_ per period, after the model has been
+  // updated and the heating decision re-evaluated.
+  bool checkUpdate(bool heaterOn);
+  void addPeriod(float duty); // closes a period with the given heater duty in [0, 1] (as `checkUpdate()` does)
+  bool shouldHeat();          // heating decision of the latest period
+
+  void setSetpoint(float setpointC);
+
+  // Metrics (of the best candidate)
+  bool isTrusted();         // true once the model is trusted for the predictive control
+  float gainC();            // heater gain K: temperature rise at full duty in steady state [°C]
+  float timeConstantS();    // time constant τ [seconds]
+  float deadTimeS();        // dead time [seconds]
+  float ambientC();         // estimated ambient temperature [°C]
+  float predictionErrorC(); // average absolute one-period prediction error [°C]
+  float projectedC();       // latest projected temperature (heater off from now on) [°C]
+  uint32_t lastUpdateUs();  // CPU time of the latest update [microseconds]
+  void printStats();        // prints the metrics to the Serial console
+
+  private:
+  struct Estimator {
+    float theta[3];     // a, b, c
+    float p[3][3];      // covariance
+    float squaredError; // exponentially weighted squared prediction error
+  };
+
+  void updateModel(float duty);
+  void updateCandidate(uint8_t deadTime);
+  void updateEstimator(Estimator &estimator, const float phi[3], float y);
+  void resetEstimator(Estimator &estimator, float covariance);
+  float project(const Estimator &estimator, uint8_t deadTime, float &peakC);
+  float pastDuty(uint8_t periodsAgo);
+  void decide();
+  void persist();
+
+  // behavioral parameters are lifetime-constants (provided at construction)
+  const float hysteresisC;
+
+  // dynamic state parameters
+  float setpointC;
+  Estimator estimators[ThermalUtils::dead_time_candidates];
+  uint8_t best;
+  uint8_t rotation; // latest candidate updated in turn (outside the neighbourhood of `best`)
+  float duties[ThermalUtils::dead_time_candidates]; // ring: heater duty of the recent periods
+  uint8_t dutyHead;                                  // index of the latest period in `duties`
+  float latestC;
+  float previousC;
+  bool hasLatest;
+  bool hasPrevious;
+  uint16_t updates;
+  uint16_t updatesSincePersist;
+  bool heat;
+
+  // integration of the heater state over the current period
+  int64_t periodStartMilli;
+  int64_t lastCheckMilli;
+  int64_t onTimeMs;
+  bool lastHeaterOn;
+
+  // metrics
+  Ewma predictionError;
+  float projected;
+  uint32_t updateUs;
+};
@@ -0,0 +1,169 @@
+#pragma once
+#include <Arduino.h>
+#include <esp_timer.h> // For esp_timer_get_time()
+
+// Policies of the `TimingCore` template. A schedule decides when the next event is due and how the on/off
+// state changes, a lifetime decides when the core expires by itself, and a sink receives every event.
+namespace Timing {
+
+  inline int64_t nowMs() { return esp_timer_get_time() / 1000LL; } // convert microseconds to milliseconds
+
+  // SCHEDULES: `advance()` is called once the deadline `nextMs` has been reached (`nowMs >= nextMs`). It moves
+  // the deadline past `nowMs`, skipping missed intervals, and updates the on/off state. Intervals must be positive.
+
+  // one event per interval; no on/off state
+  struct Trigger {
+    const int64_t intervalMs;
+
+    Trigger(unsigned long intervalMs) : intervalMs(static_cast<int64_t>(intervalMs)) {}
+
+    void advance(int64_t nowMs, int64_t &nextMs, bool & /* on */) const {
+      nextMs += intervalMs;
+      if (nowMs >= nextMs) nextMs += intervalMs * ((nowMs - nextMs) / intervalMs + 1); // missed intervals
+    }
+  };
+
+  // on/off state alternating every interval
+  struct Toggle {
+    const int64_t intervalMs;
+
+    Toggle(unsigned long intervalMs) : intervalMs(static_cast<int64_t>(intervalMs)) {}
+
+    void advance(int64_t nowMs, int64_t &nextMs, bool &on) const {
+      on = !on;
+      nextMs += intervalMs;
+      if (nowMs < nextMs) return;
+      // missed intervals: the state ends up as if it had toggled once per interval
+      int64_t missed = (nowMs - nextMs) / intervalMs + 1;
+      nextMs += intervalMs * missed;
+      if (missed & 1) on = !on;
+    }
+  };
+
+  // on/off state with separate durations of the on- and the off-state
+  struct AsymmetricToggle {
+    const int64_t onMs;
+    const int64_t offMs;
+
+    AsymmetricToggle(unsigned long onMs, unsigned long offMs) : onMs(static_cast<int64_t>(onMs)), offMs(static_cast<int64_t>(offMs)) {}
+
+    void advance(int64_t nowMs, int64_t &nextMs, bool &on) const {
+      on = !on;
+      nextMs += on ? onMs : offMs;
+      if (nowMs < nextMs) return;
+      // missed intervals: skip whole on/off periods (state invariant), then toggle at most twice
+      int64_t periodMs = onMs + offMs;
+      nextMs += periodMs * ((nowMs - nextMs) / periodMs);
+      while (nowMs >= nextMs) {
+        on = !on;
+        nextMs += on ? onMs : offMs;
+      }
+    }
+  };
+
+  // LIFETIMES: measured from the latest activation
+
+  // expires `lifetimeMs` after activation; negative lifetime: never; zero lifetime: cannot be activated
+  struct BoundedLifetime {
+    const int64_t lifetimeMs;
+
+    BoundedLifetime(int64_t lifetimeMs) : lifetimeMs(lifetimeMs) {}
+
+    bool canActivate() const { return lifetimeMs != 0LL; }
+    bool hasElapsed(int64_t sinceActivationMs) const { return (lifetimeMs >= 0LL) && (sinceActivationMs > lifetimeMs); }
+  };
+
+  // SINKS: `onEvent()` receives every event with the (new) on/off state
+
+  struct NoSink {
+    void onEvent(bool /* on */) {}
+  };
+}
+
+template <typename Schedule, typename Lifetime = Timing::BoundedLifetime, typename Sink = Timing::NoSink>
+class TimingCore {
+
+  // CLASS TimingCore
+  //
+  // Common core of the triggers and togglers on the controller loop: the core is polled by `check()`, which
+  // returns true _once_ whenever an event is due, and then passes the event to the sink. The schedule, the
+  // lifetime and the sink are template parameters, so every combination compiles to straight-line code
+  // without indirect calls.
+  //
+  // The constructor instantiates a _disabled_ core, which can be enabled by calling `activate()`. Once
+  // activated, the first event is due immediately (after the optional delay). If an interval is missed
+  // (e.g., because the controller loop is busy), the interval is skipped and the next event is due when it
+  // would have been otherwise.
+  // After the lifetime has elapsed, or `expire()` is called, the core deactivates:
+  //   * If the state is ON, then `check()` switches the state to OFF on the subsequent call, returning true once.
+  //   * If the state is OFF (always for triggers), no event occurs, i.e `check()` returns false.
+  // All subsequent `check()` calls then return false, until `activate()` is called again.
+  //
+  // Time is taken from `esp_timer_get_time()`, so results do not depend on the CPU frequency.
+
+  public:
+  TimingCore(Lifetime lifetime, Schedule schedule, Sink sink = Sink()) // constructor
+      : schedule(schedule),
+        lifetime(lifetime),
+        sink(sink),
+        lastActivationObservedMilli(0),
+        nextTriggerAtOrAfterMilli(0),
+        stateIsOn(false),
+        status(Status::Expired) {
+  }
+
+  // Loop function: returns true _once_ when the next event is due (the new state is `isCurrentStateOn()`)
+  bool check() {
+    if (status == Status::Expired) return false;
+    int64_t currentMillis = Timing::nowMs();
+
+    if ((status == Status::ShouldExpire) || lifetime.hasElapsed(currentMillis - lastActivationObservedMilli)) {
+      // only an ON state is switched off (with an event) when expiring
+      bool sendToggleSignal = stateIsOn;
+      status = Status::Expired;
+      stateIsOn = false;
+      if (sendToggleSignal) sink.onEvent(false);
+      return sendToggleSignal;
+    }
+
+    // within lifetime, but still before the next event: nothing to do
+    if (currentMillis < nextTriggerAtOrAfterMilli) return false;
+
+    schedule.advance(currentMillis, nextTriggerAtOrAfterMilli, stateIsOn);
+    sink.onEvent(stateIsOn);
+    return true;
+  }
+
+  bool isCurrentStateOn() { return stateIsOn; }
+
+  // Lifecycle functions
+  void activate(long delayMs = 0) { // activates the core (after optional delay [milliseconds])
+    if (!lifetime.canActivate()) return;
+    lastActivationObservedMilli = Timing::nowMs() + static_cast<int64_t>(delayMs);
+    status = Status::Active;
+    nextTriggerAtOrAfterMilli = lastActivationObservedMilli; // first event on the next `check()` (after `delayMs`)
+  }
+  void expire() { // disables the core (an ON state is switched off by the next `check()`)
+    if (status != Status::Expired) status = Status::ShouldExpire;
+  }
+  bool isExpired() { return status != Status::Active; } // returns true if the core is expired/disabled
+  bool isActive() { return status == Status::Active; }  // irrespective whether the state is on or off
+
+  protected:
+  enum class Status : uint8_t {
+    Active = 0,
+    ShouldExpire = 1, // `expire()` was called; the next `check()` completes the expiry
+    Expired = 2
+  };
+
+  // behavioral parameters are lifetime-constants (provided at construction)
+  const Schedule schedule;
+  const Lifetime lifetime;
+  Sink sink;
+
+  // dynamic state parameters
+  int64_t lastActivationObservedMilli;
+  int64_t nextTriggerAtOrAfterMilli;
+  bool stateIsOn;
+  Status status;
+};
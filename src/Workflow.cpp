@@ -0,0 +1,190 @@
+#include "Workflow.h"
+#include <cstddef>   // For max_align_t
+#include <esp_cpu.h> // For esp_cpu_get_cycle_count()
+
+namespace {
+  struct FrameSlot {
+    alignas(std::max_align_t) uint8_t bytes[WorkflowUtils::frame_slot_bytes];
+  };
+
+  FrameSlot frameSlots[WorkflowUtils::max_workflows];
+  size_t frameSlotBytes[WorkflowUtils::max_workflows]; // 0: slot free
+  uint32_t failedAllocations = 0;
+
+  int8_t slotOf(const void *frame) {
+    for (uint8_t i = 0; i < WorkflowUtils::max_workflows; i++) {
+      if (frame == frameSlots[i].bytes) return static_cast<int8_t>(i);
+    }
+    return -1;
+  }
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                      WorkflowFramePool                                         *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Frames are allocated and released by the controller loop only (workflows are created and destroyed there),
+// hence the pool takes no lock.
+
+void *WorkflowFramePool::allocate(size_t size) noexcept {
+  if ((size > 0) && (size <= WorkflowUtils::frame_slot_bytes)) {
+    for (uint8_t i = 0; i < WorkflowUtils::max_workflows; i++) {
+      if (frameSlotBytes[i] != 0) continue;
+      frameSlotBytes[i] = size;
+      return frameSlots[i].bytes;
+    }
+  }
+  failedAllocations++;
+  return nullptr;
+}
+
+void WorkflowFramePool::release(void *frame) noexcept {
+  int8_t slot = slotOf(frame);
+  if (slot >= 0) frameSlotBytes[slot] = 0;
+}
+
+size_t WorkflowFramePool::frameBytes(const void *frame) {
+  int8_t slot = slotOf(frame);
+  return (slot >= 0) ? frameSlotBytes[slot] : 0;
+}
+
+uint8_t WorkflowFramePool::slotsInUse() {
+  uint8_t used = 0;
+  for (uint8_t i = 0; i < WorkflowUtils::max_workflows; i++) {
+    if (frameSlotBytes[i] != 0) used++;
+  }
+  return used;
+}
+
+uint32_t WorkflowFramePool::failedCount() { return failedAllocations; }
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                     CLASS WorkflowRunner                                       *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// The clock is read at most once per `checkResume()`, and only if a workflow waits for a deadline or
+// a timeout; with all workflows waiting for events, a check costs a few comparisons per slot.
+
+// constructor:
+WorkflowRunner::WorkflowRunner() : completed(0) {}
+
+WorkflowRunner::~WorkflowRunner() {
+  for (Slot &slot : slots) {
+    if (slot.handle) slot.handle.destroy();
+  }
+}
+
+bool WorkflowRunner::start(Workflow &&workflow, const char *name) {
+  if (!workflow.isValid()) return false;
+  for (Slot &slot : slots) {
+    if (slot.handle) continue;
+    slot.handle = workflow.handle;
+    workflow.handle = nullptr; // the runner owns the coroutine now
+    slot.name = name;
+    slot.frameBytes = WorkflowFramePool::frameBytes(slot.handle.address());
+    slot.resumes = 0;
+    slot.maxResumeCycles = 0;
+    slot.resumeCycles.reset(0.0f);
+    resume(slot); // runs up to the first `co_await`
+    return true;
+  }
+  return false;
+}
+
+void WorkflowRunner::notify(const Event &event) {
+  for (Slot &slot : slots) {
+    if (!slot.handle) continue;
+    WorkflowPromise &promise = slot.handle.promise();
+    if ((promise.waitKind != WorkflowPromise::WaitEvent) || (promise.eventType != event.type) || promise.conditionMet) continue;
+    promise.event = event;
+    promise.conditionMet = true;
+  }
+}
+
+void WorkflowRunner::checkResume() {
+  int64_t nowMs = -1; // read on demand
+  for (Slot &slot : slots) {
+    if (!slot.handle) continue;
+    WorkflowPromise &promise = slot.handle.promise();
+    bool ready = false;
+    switch (promise.waitKind) {
+      case WorkflowPromise::WaitNone:
+        ready = true;
+        break;
+      case WorkflowPromise::WaitDeadline:
+        if (nowMs < 0) nowMs = Timing::nowMs();
+        ready = (nowMs >= promise.deadlineMs);
+        break;
+      case WorkflowPromise::WaitEvent:
+        ready = promise.conditionMet;
+        break;
+      case WorkflowPromise::WaitPredicate:
+        promise.conditionMet = promise.predicate();
+        ready = promise.conditionMet;
+        break;
+    }
+    if (!ready && (promise.waitKind != WorkflowPromise::WaitDeadline) && (promise.deadlineMs >= 0)) {
+      if (nowMs < 0) nowMs = Timing::nowMs();
+      ready = (nowMs >= promise.deadlineMs); // timeout; `conditionMet` stays false
+    }
+    if (ready) resume(slot);
+  }
+}
+
+uint8_t WorkflowRunner::runningCount() {
+  uint8_t running = 0;
+  for (Slot &slot : slots) {
+    if (slot.handle) running++;
+  }
+  return running;
+}
+
+uint32_t WorkflowRunner::completedCount() { return completed; }
+
+size_t WorkflowRunner::maxFrameBytes() {
+  size_t largest = 0;
+  for (Slot &slot : slots) {
+    if (slot.handle && (slot.frameBytes > largest)) largest = slot.frameBytes;
+  }
+  return largest;
+}
+
+void WorkflowRunner::printStats() {
+  Serial.print(F("Workflows: "));
+  Serial.print(runningCount());
+  Serial.print(F(" running, "));
+  Serial.print(completed);
+  Serial.print(F(" completed, "));
+  Serial.print(WorkflowFramePool::failedCount());
+  Serial.println(F(" frames refused"));
+  for (Slot &slot : slots) {
+    if (slot.name == nullptr) continue;
+    Serial.print(F("  "));
+    Serial.print(slot.name);
+    Serial.print(slot.handle ? F(": frame ") : F(" (completed): frame "));
+    Serial.print(slot.frameBytes);
+    Serial.print(F(" bytes, "));
+    Serial.print(slot.resumes);
+    Serial.print(F(" resumes, "));
+    Serial.print(slot.resumeCycles.value(), 0);
+    Serial.print(F(" cycles per resume (max "));
+    Serial.print(slot.maxResumeCycles);
+    Serial.println(F(")"));
+  }
+}
+
+void WorkflowRunner::resume(Slot &slot) {
+  slot.handle.promise().waitKind = WorkflowPromise::WaitNone;
+  uint32_t startCycles = esp_cpu_get_cycle_count();
+  slot.handle.resume();
+  uint32_t cycles = esp_cpu_get_cycle_count() - startCycles;
+
+  if (slot.resumes == 0) slot.resumeCycles.reset(static_cast<float>(cycles));
+  else slot.resumeCycles.update(static_cast<float>(cycles));
+  if (cycles > slot.maxResumeCycles) slot.maxResumeCycles = cycles;
+  slot.resumes++;
+
+  if (slot.handle.done()) {
+    slot.handle.destroy();
+    slot.handle = nullptr;
+    completed++;
+  }
+}
@@ -0,0 +1,214 @@
+#pragma once
+#include "EventQueue.h"
+#include "TimingCore.h" // For Timing::nowMs()
+#include <Arduino.h>
+#include <coroutine>
+
+namespace WorkflowUtils {
+  constexpr uint8_t max_workflows = 4;         // workflows alive at the same time; one frame slot each
+  constexpr size_t frame_slot_bytes = 256;     // largest coroutine frame (locals alive across a `co_await` count)
+  constexpr int64_t no_timeout = -1;
+  constexpr float resume_cycles_alpha = 0.1f;  // smoothing of the CPU cycles per resume
+}
+
+// Storage of the coroutine frames: `max_workflows` slots of `frame_slot_bytes` in .bss. A frame that does not
+// fit, or does not find a free slot, fails the creation of its workflow; there is no fallback to the heap.
+namespace WorkflowFramePool {
+  void *allocate(size_t size) noexcept;
+  void release(void *frame) noexcept;
+  size_t frameBytes(const void *frame); // size requested for `frame` (0 if not allocated from the pool)
+  uint8_t slotsInUse();
+  uint32_t failedCount(); // allocations refused
+}
+
+class Workflow;
+
+// Promise of a `Workflow` coroutine: holds the condition the workflow waits for, as set by the awaitables
+struct WorkflowPromise {
+  enum WaitKind : uint8_t {
+    WaitNone = 0,      // resumed on the next `checkResume()`
+    WaitDeadline = 1,  // resumed once `deadlineMs` is reached
+    WaitEvent = 2,     // resumed by a notified event of `eventType`, or at the timeout
+    WaitPredicate = 3  // resumed once `predicate()` is true, or at the timeout
+  };
+
+  WaitKind waitKind = WaitNone;
+  int64_t deadlineMs = WorkflowUtils::no_timeout; // deadline, or timeout of an event or predicate wait
+  EventType eventType = EventType::Count;
+  bool (*predicate)() = nullptr;
+  bool conditionMet = false; // the event arrived, or the predicate was true (false: timeout)
+  Event event = {};          // the event that arrived
+
+  Workflow get_return_object() noexcept;
+  static Workflow get_return_object_on_allocation_failure() noexcept;
+  std::suspend_always initial_suspend() noexcept { return {}; } // started by `WorkflowRunner::start()`
+  std::suspend_always final_suspend() noexcept { return {}; }   // destroyed by the runner
+  void return_void() noexcept {}
+  void unhandled_exception() noexcept { abort(); }
+
+  static void *operator new(size_t size) noexcept { return WorkflowFramePool::allocate(size); }
+  static void operator delete(void *frame) noexcept { WorkflowFramePool::release(frame); }
+};
+
+typedef std::coroutine_handle<WorkflowPromise> WorkflowHandle;
+
+class Workflow {
+
+  // CLASS Workflow
+  //
+  // A multi-step sequence written as a coroutine: the function returns `Workflow` and waits with
+  // `co_await` on the awaitables below, e.g.
+  //
+  //   Workflow blinkTwice() {
+  //     led.on();
+  //     co_await sleepFor(200);
+  //     led.off();
+  //   }
+  //
+  // A workflow does not run until it is handed to a `WorkflowRunner`, which resumes it from the loop. It
+  // never blocks: while it waits, the loop goes on. Parameters are copied into the frame; references and
+  // pointers must outlive the workflow.
+
+  public:
+  using promise_type = WorkflowPromise;
+
+  Workflow(Workflow &&other) noexcept : handle(other.handle) { other.handle = nullptr; }
+  Workflow(const Workflow &) = delete;
+  Workflow &operator=(const Workflow &) = delete;
+  ~Workflow() {
+    if (handle) handle.destroy();
+  }
+
+  bool isValid() const { return static_cast<bool>(handle); } // false if the frame could not be allocated
+
+  private:
+  friend struct WorkflowPromise;
+  friend class WorkflowRunner;
+  explicit Workflow(WorkflowHandle handle) : handle(handle) {}
+
+  WorkflowHandle handle;
+};
+
+inline Workflow WorkflowPromise::get_return_object() noexcept { return Workflow(WorkflowHandle::from_promise(*this)); }
+inline Workflow WorkflowPromise::get_return_object_on_allocation_failure() noexcept { return Workflow(nullptr); }
+
+// AWAITABLES: `co_await` them in a `Workflow`
+
+// Suspends until the next `checkResume()`, i.e. the next pass of the loop
+struct NextPassAwaiter {
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(WorkflowHandle handle) const noexcept { handle.promise().waitKind = WorkflowPromise::WaitNone; }
+  void await_resume() const noexcept {}
+};
+
+// Suspends until the deadline [milliseconds of `Timing::nowMs()`]; does not suspend if it has passed
+struct SleepAwaiter {
+  int64_t deadlineMs;
+
+  bool await_ready() const noexcept { return Timing::nowMs() >= deadlineMs; }
+  void await_suspend(WorkflowHandle handle) const noexcept {
+    handle.promise().waitKind = WorkflowPromise::WaitDeadline;
+    handle.promise().deadlineMs = deadlineMs;
+  }
+  void await_resume() const noexcept {}
+};
+
+// Suspends until an event of `type` is notified to the runner; `co_await` returns false on timeout. The
+// event is copied to `event`, if given.
+struct EventAwaiter {
+  EventType type;
+  int64_t deadlineMs;
+  Event *event;
+  WorkflowPromise *promise;
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(WorkflowHandle handle) noexcept {
+    promise = &handle.promise();
+    promise->waitKind = WorkflowPromise::WaitEvent;
+    promise->eventType = type;
+    promise->deadlineMs = deadlineMs;
+    promise->conditionMet = false;
+  }
+  bool await_resume() const noexcept {
+    if (promise->conditionMet && (event != nullptr)) *event = promise->event;
+    return promise->conditionMet;
+  }
+};
+
+// Suspends until `predicate()` is true (polled on every `checkResume()`); `co_await` returns false on timeout
+struct PredicateAwaiter {
+  bool (*predicate)();
+  int64_t deadlineMs;
+  WorkflowPromise *promise;
+
+  bool await_ready() const { return predicate(); }
+  void await_suspend(WorkflowHandle handle) noexcept {
+    promise = &handle.promise();
+    promise->waitKind = WorkflowPromise::WaitPredicate;
+    promise->predicate = predicate;
+    promise->deadlineMs = deadlineMs;
+    promise->conditionMet = false;
+  }
+  bool await_resume() const noexcept { return (promise == nullptr) || promise->conditionMet; } // not suspended: the predicate was true
+};
+
+inline NextPassAwaiter nextPass() { return {}; } // (not `yield()`: taken by the Arduino core)
+inline SleepAwaiter sleepUntil(int64_t deadlineMs) { return {deadlineMs}; }
+inline SleepAwaiter sleepFor(uint32_t durationMs) { return {Timing::nowMs() + static_cast<int64_t>(durationMs)}; }
+inline int64_t deadlineAfter(int64_t timeoutMs) { return (timeoutMs >= 0) ? Timing::nowMs() + timeoutMs : WorkflowUtils::no_timeout; }
+inline EventAwaiter waitForEvent(EventType type, int64_t timeoutMs = WorkflowUtils::no_timeout, Event *event = nullptr) {
+  return {type, deadlineAfter(timeoutMs), event, nullptr};
+}
+// Waits for the DS18B20 conversion to complete (`EventType::TemperatureConversionDone`)
+inline EventAwaiter waitForConversion(int64_t timeoutMs = WorkflowUtils::no_timeout) { return waitForEvent(EventType::TemperatureConversionDone, timeoutMs); }
+inline PredicateAwaiter waitUntil(bool (*predicate)(), int64_t timeoutMs = WorkflowUtils::no_timeout) {
+  return {predicate, deadlineAfter(timeoutMs), nullptr};
+}
+
+class WorkflowRunner {
+
+  // CLASS WorkflowRunner
+  //
+  // Runs up to `max_workflows` workflows from the loop. `start()` takes a workflow over, and runs it up to its
+  // first `co_await`. The loop function `checkResume()` checks the condition every suspended workflow waits
+  // for, and resumes those whose condition is met; a workflow that has completed is destroyed, which frees
+  // its slot and its frame. Events reach waiting workflows through `notify()`, which event handlers call;
+  // they are resumed by the next `checkResume()`.
+  //
+  // The runner reports per workflow the size of its coroutine frame and the CPU cycles of a resume.
+
+  public:
+  WorkflowRunner(); // constructor
+  ~WorkflowRunner(); // destroys the running workflows
+
+  bool start(Workflow &&workflow, const char *name); // false if the workflow is invalid, or all slots are taken
+  void notify(const Event &event);                  // passes an event to the workflows waiting for its type
+
+  void checkResume(); // Loop function
+
+  // Statistics
+  uint8_t runningCount();  // workflows started and not yet completed
+  uint32_t completedCount();
+  size_t maxFrameBytes();  // largest frame of the running workflows [bytes]
+  void printStats();       // prints the statistics to the Serial console, one line per workflow
+
+  private:
+  struct Slot {
+    WorkflowHandle handle; // null: slot free
+    const char *name;      // kept after completion, for the statistics
+    size_t frameBytes;
+    uint32_t resumes;
+    uint32_t maxResumeCycles;
+    Ewma resumeCycles;
+
+    Slot() : handle(nullptr), name(nullptr), frameBytes(0), resumes(0), maxResumeCycles(0), resumeCycles(WorkflowUtils::resume_cycles_alpha) {}
+  };
+
+  void resume(Slot &slot);
+
+  // dynamic state parameters
+  Slot slots[WorkflowUtils::max_workflows];
+
+  // statistics
+  uint32_t completed;
+};
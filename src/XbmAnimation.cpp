@@ -0,0 +1,202 @@
+#include "XbmAnimation.h"
+#include "FrameCodec.h" // For FrameCodec::min_run
+#include <esp_cpu.h>    // For esp_cpu_get_cycle_count()
+
+namespace {
+  // bits of a nibble in reverse order
+  const uint8_t reversedNibbles[16] = {0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF};
+
+  inline uint64_t reverseBits(uint64_t value) {
+    uint64_t reversed = 0;
+    for (uint8_t i = 0; i < 8; i++) {
+      uint8_t byte = static_cast<uint8_t>(value >> (8 * i));
+      uint8_t mirrored = static_cast<uint8_t>((reversedNibbles[byte & 0x0F] << 4) | reversedNibbles[byte >> 4]);
+      reversed |= static_cast<uint64_t>(mirrored) << (8 * (7 - i));
+    }
+    return reversed;
+  }
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                    CLASS XbmFrameDecoder                                       *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// The code of `FrameCodec`, decoded one control byte at a time: a run or literal may end in the middle of a
+// slice, and is continued by the next `decode()`. Runs and literals never cross a frame boundary (each frame
+// is encoded on its own). A truncated code ends the frame early, so the decoder cannot run past the data.
+
+// constructor:
+XbmFrameDecoder::XbmFrameDecoder(const XbmAnimation &animation)
+    : animation(animation),
+      position(0),
+      frameOffset(0),
+      nextFrame(0),
+      runLeft(0),
+      literalLeft(0),
+      runValue(0) {
+}
+
+void XbmFrameDecoder::rewind() {
+  position = 0;
+  frameOffset = 0;
+  nextFrame = 0;
+  runLeft = 0;
+  literalLeft = 0;
+}
+
+bool XbmFrameDecoder::decode(uint8_t *frame, size_t maxBytes) {
+  if (isAtEnd()) return true;
+  const size_t frameBytes = animation.frameBytes();
+  const uint8_t *data = animation.data;
+  while ((maxBytes > 0) && (frameOffset < frameBytes)) {
+    if (runLeft > 0) {
+      frame[frameOffset++] ^= runValue;
+      runLeft--;
+    } else if (literalLeft > 0) {
+      if (position >= animation.dataBytes) break;
+      frame[frameOffset++] ^= data[position++];
+      literalLeft--;
+    } else {
+      if (position >= animation.dataBytes) break;
+      uint8_t control = data[position++];
+      if (control & 0x80) {
+        if (position >= animation.dataBytes) break;
+        runLeft = static_cast<uint8_t>((control & 0x7F) + FrameCodec::min_run);
+        runValue = data[position++];
+      } else {
+        literalLeft = static_cast<uint8_t>(control + 1);
+      }
+      continue;
+    }
+    maxBytes--;
+  }
+  if ((frameOffset < frameBytes) && (position < animation.dataBytes || runLeft > 0 || literalLeft > 0)) return false;
+
+  frameOffset = 0;
+  runLeft = 0;
+  literalLeft = 0;
+  nextFrame++;
+  return true;
+}
+
+bool XbmFrameDecoder::isAtEnd() { return nextFrame >= animation.frameCount; }
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                  CLASS XbmAnimationPlayer                                      *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// A switch of the toggler while a frame is still being decoded is skipped: the animation then runs late
+// rather than tearing a frame. `blit()` assembles each column of the frame as one 64-bit word (a display is
+// at most 64 pixels high), shifted (or, on R2, mirrored) into place, and merges it into the buffer under a
+// mask, one byte per tile row.
+
+// constructor:
+XbmAnimationPlayer::XbmAnimationPlayer(const XbmAnimation &animation, uint8_t *frame, unsigned long frameMs, bool loops)
+    : animation(animation),
+      frame(frame),
+      loops(loops),
+      frameToggler(FrequencyUtils::unbounded_lifetime, frameMs, frameMs),
+      decoder(animation),
+      decoding(false),
+      finished(false),
+      frameCycles(0),
+      shown(0),
+      averageDecodeCycles(XbmAnimationUtils::decode_cycles_alpha) {
+}
+
+void XbmAnimationPlayer::activate() {
+  memset(frame, 0, animation.frameBytes());
+  decoder.rewind();
+  decoding = false;
+  finished = false;
+  frameToggler.activate();
+}
+
+void XbmAnimationPlayer::expire() { frameToggler.expire(); }
+
+bool XbmAnimationPlayer::isExpired() { return frameToggler.isExpired(); }
+
+bool XbmAnimationPlayer::checkFrame() {
+  if (frameToggler.checkToggle() && !decoding && !frameToggler.isExpired()) {
+    if (finished) {
+      frameToggler.expire();
+      return false;
+    }
+    if (decoder.isAtEnd()) { // looping: frame 0 is not a delta
+      memset(frame, 0, animation.frameBytes());
+      decoder.rewind();
+    }
+    decoding = true;
+    frameCycles = 0;
+  }
+  if (!decoding) return false;
+
+  esp_cpu_cycle_count_t startCycles = esp_cpu_get_cycle_count();
+  bool complete = decoder.decode(frame, XbmAnimationUtils::decode_bytes_per_pass);
+  frameCycles += esp_cpu_get_cycle_count() - startCycles;
+  if (!complete) return false;
+
+  decoding = false;
+  if (shown == 0) averageDecodeCycles.reset(static_cast<float>(frameCycles));
+  else averageDecodeCycles.update(static_cast<float>(frameCycles));
+  shown++;
+  if (!loops && decoder.isAtEnd()) finished = true;
+  return true;
+}
+
+void XbmAnimationPlayer::blit(U8G2 &display, int16_t x, int16_t y) {
+  uint8_t *buffer = display.getBufferPtr();
+  const int16_t bufferWidth = 8 * display.getBufferTileWidth();
+  const uint8_t bufferTileRows = display.getBufferTileHeight();
+  const int16_t bufferHeight = 8 * bufferTileRows;
+  if ((bufferHeight > 64) || (y <= -static_cast<int16_t>(animation.height)) || (y >= bufferHeight)) return;
+  const bool rotated = (display.getU8g2()->cb == U8G2_R2);
+  const uint8_t tileRows = animation.tileRows();
+  const uint64_t heightMask = (animation.height >= 64) ? ~0ULL : ((1ULL << animation.height) - 1ULL);
+  // pixels of the box within a column of the buffer (bit i: tile row i / 8, bit i % 8)
+  uint64_t mask = (y >= 0) ? (heightMask << y) : (heightMask >> -y);
+  if (rotated) mask = reverseBits(mask) >> (64 - bufferHeight);
+
+  for (uint8_t column = 0; column < animation.width; column++) {
+    int16_t screenX = x + column;
+    if ((screenX < 0) || (screenX >= bufferWidth)) continue;
+
+    // bit i: pixel (screenX, i) on the screen
+    uint64_t bits = 0;
+    for (uint8_t row = 0; row < tileRows; row++) bits |= static_cast<uint64_t>(frame[row * animation.width + column]) << (8 * row);
+    bits &= heightMask;
+    bits = (y >= 0) ? (bits << y) : (bits >> -y);
+    int16_t bufferX = screenX;
+    if (rotated) { // the buffer holds the screen rotated by 180°: pixel (x, y) at (width - 1 - x, height - 1 - y)
+      bufferX = bufferWidth - 1 - screenX;
+      bits = reverseBits(bits) >> (64 - bufferHeight);
+    }
+
+    for (uint8_t row = 0; row < bufferTileRows; row++) {
+      uint8_t rowMask = static_cast<uint8_t>(mask >> (8 * row));
+      if (rowMask == 0) continue;
+      uint8_t &target = buffer[row * bufferWidth + bufferX];
+      target = static_cast<uint8_t>((target & ~rowMask) | (static_cast<uint8_t>(bits >> (8 * row)) & rowMask));
+    }
+  }
+}
+
+uint32_t XbmAnimationPlayer::framesShown() { return shown; }
+
+float XbmAnimationPlayer::decodeCycles() { return averageDecodeCycles.value(); }
+
+int32_t XbmAnimationPlayer::flashSavedBytes() { return static_cast<int32_t>(animation.xbmBytes) - static_cast<int32_t>(animation.dataBytes); }
+
+void XbmAnimationPlayer::printStats(const char *name) {
+  Serial.print(F("Animation "));
+  Serial.print(name);
+  Serial.print(F(": "));
+  Serial.print(animation.dataBytes);
+  Serial.print(F(" bytes of flash for "));
+  Serial.print(animation.xbmBytes);
+  Serial.print(F(" bytes of XBM ("));
+  Serial.print(flashSavedBytes());
+  Serial.print(F(" saved), "));
+  Serial.print(shown);
+  Serial.print(F(" frames shown, "));
+  Serial.print(averageDecodeCycles.value(), 0);
+  Serial.println(F(" CPU cycles per frame"));
+}
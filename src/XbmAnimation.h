@@ -0,0 +1,110 @@
+#pragma once
+#include "Ewma.h"
+#include "FrequentlyUtils.h"
+#include <Arduino.h>
+#include <U8g2lib.h>
+
+namespace XbmAnimationUtils {
+  constexpr uint8_t flag_rotated_180 = 0x01;    // frames are stored rotated by 180° (see `XbmAnimation`)
+  constexpr size_t decode_bytes_per_pass = 128; // frame bytes decoded per `checkFrame()`
+  constexpr float decode_cycles_alpha = 0.1f;   // smoothing of the CPU cycles per frame
+}
+
+// An animation of equally sized monochrome frames, compressed by tools/xbmpack from XBM images. The frames
+// are stored in the layout of the u8g2 frame buffer (tile rows of 8-pixel columns, least significant bit on
+// top), in the run-length code of `FrameCodec`: frame 0 as is, every further frame as the XOR with its
+// predecessor. A full-screen animation stored rotated by 180° decodes straight into the buffer of a display
+// with U8G2_R2.
+struct XbmAnimation {
+  uint8_t width;  // [pixels]
+  uint8_t height; // [pixels]
+  uint8_t frameCount;
+  uint8_t flags;       // `flag_...`
+  const uint8_t *data; // the encoded frames, back to back (in flash)
+  uint16_t dataBytes;
+  uint16_t xbmBytes; // size of the frames as XBM arrays, for the statistics
+
+  uint8_t tileRows() const { return (height + 7) / 8; }
+  size_t frameBytes() const { return static_cast<size_t>(tileRows()) * width; }
+};
+
+class XbmFrameDecoder {
+
+  // CLASS XbmFrameDecoder
+  //
+  // Streaming decoder of the frames of an `XbmAnimation`: reads the code from flash one control byte at a
+  // time and XORs the decoded bytes onto the previous frame in place, so it needs no buffer of its own; its
+  // state is the position in the code and the remainder of the current run or literal. A frame may be decoded
+  // in slices of any size, across several passes of the loop.
+
+  public:
+  XbmFrameDecoder(const XbmAnimation &animation); // constructor
+
+  void rewind();                                // back to frame 0; the frame memory must then be cleared
+  bool decode(uint8_t *frame, size_t maxBytes); // decodes up to `maxBytes` more bytes; true once the frame is complete
+  bool isAtEnd();                               // true once the last frame is complete
+
+  private:
+  // behavioral parameters are lifetime-constants (provided at construction)
+  const XbmAnimation &animation;
+
+  // dynamic state parameters
+  uint16_t position;    // next byte of the code
+  uint16_t frameOffset; // bytes of the current frame decoded so far
+  uint8_t nextFrame;    // frame being decoded (`frameCount`: at the end)
+  uint8_t runLeft;      // bytes of the current run still to be written
+  uint8_t literalLeft;  // bytes of the current literal still to be read
+  uint8_t runValue;
+};
+
+class XbmAnimationPlayer {
+
+  // CLASS XbmAnimationPlayer
+  //
+  // Plays an `XbmAnimation` from flash, one frame every `frameMs`, timed by a `FrequencyToggler2` (every
+  // switch shows the next frame). The current frame is kept in `frame` (`animation.frameBytes()`, provided by
+  // the caller), onto which the next frame is decoded: either a small array, from which `blit()` copies the
+  // frame into the display buffer wherever the icon is drawn, or, for a full-screen animation, the display
+  // buffer itself (`U8G2::getBufferPtr()`), which then must not be drawn on while the animation plays.
+  //
+  // The Loop function `checkFrame()` decodes at most `decode_bytes_per_pass` bytes, so a large frame is spread
+  // over several passes; it returns true once the next frame is complete. A looping animation restarts after
+  // its last frame; otherwise, the player expires one interval after the last frame.
+
+  public:
+  XbmAnimationPlayer(const XbmAnimation &animation, uint8_t *frame, unsigned long frameMs, bool loops); // constructor
+
+  void activate(); // clears the frame, and starts with frame 0
+  void expire();
+  bool isExpired();
+
+  bool checkFrame(); // Loop function
+
+  // Draws the current frame with its top-left corner at (x, y), replacing the pixels of its box; the frames
+  // must not be stored rotated. Writes the bytes of the buffer directly, for R0 and R2 displays.
+  void blit(U8G2 &display, int16_t x, int16_t y);
+  const XbmAnimation &xbm() { return animation; } // the animation played (e.g. for the size of its frames)
+
+  // Statistics
+  uint32_t framesShown();
+  float decodeCycles();              // average CPU cycles to decode one frame
+  int32_t flashSavedBytes();         // XBM size of the frames minus their encoded size
+  void printStats(const char *name); // prints the statistics to the Serial console
+
+  private:
+  // behavioral parameters are lifetime-constants (provided at construction)
+  const XbmAnimation &animation;
+  uint8_t *const frame;
+  const bool loops;
+
+  // dynamic state parameters
+  FrequencyToggler2 frameToggler;
+  XbmFrameDecoder decoder;
+  bool decoding;
+  bool finished;        // the last frame of a non-looping animation is shown
+  uint32_t frameCycles; // cycles spent on the frame being decoded
+
+  // statistics
+  uint32_t shown;
+  Ewma averageDecodeCycles;
+};
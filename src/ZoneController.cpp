@@ -0,0 +1,228 @@
+#include "ZoneController.h"
+#include "HeaterSupervisor.h" // For HeaterSafetyUtils (plausible range of readings)
+#include <esp_timer.h>        // For esp_timer_get_time()
+
+namespace {
+  inline uint32_t nowMs() { return static_cast<uint32_t>(esp_timer_get_time() / 1000LL); }
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ *
+ *                                    CLASS ZoneController                                        *
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Heating zones with a shared power budget. Timestamps are the lower 32 bits of the time in milliseconds;
+// differences are computed with unsigned arithmetic, hence correct across the wrap-around (every ~49 days).
+
+// constructor:
+ZoneController::ZoneController(uint8_t maxActiveLoads, ZoneLoadWriter writer)
+    : maxActiveLoads(maxActiveLoads),
+      writer(writer),
+      count(0),
+      sampledMask(0),
+      demandMask(0),
+      loadMask(0),
+      externalMask(0),
+      externalDemandMask(0),
+      tickTrigger(FrequencyUtils::unbounded_lifetime, ZoneUtils::tick_ms),
+      lastTickMs(0),
+      lastSwitchOnMs(0),
+      rotationWindowStartMs(0),
+      nextInRotation(0),
+      statsSinceMs(0) {
+}
+
+uint8_t ZoneController::addZone(const uint8_t *sensorAddress, uint8_t loadPin, float setpointC) {
+  if (count >= ZoneUtils::max_zones) return ZoneUtils::max_zones;
+  uint8_t zone = count++;
+  memcpy(address[zone], sensorAddress, ZoneUtils::address_bytes);
+  this->loadPin[zone] = loadPin;
+  setpoint[zone] = setpointC;
+  temperature[zone] = NAN;
+  lastSampleMs[zone] = 0;
+  loadOnSinceMs[zone] = 0;
+  onTimeMs[zone] = 0;
+  faultFlags[zone] = ZoneFault::ZoneNoReading;
+  if (writer == nullptr) pinMode(loadPin, OUTPUT);
+  switchLoad(zone, false, nowMs());
+  return zone;
+}
+
+uint8_t ZoneController::zoneCount() { return count; }
+
+void ZoneController::addTemperature(uint8_t zone, float tempC) {
+  if (zone >= count) return;
+  if (!isfinite(tempC) || (tempC < HeaterSafetyUtils::min_plausible_temp_c) || (tempC > HeaterSafetyUtils::max_plausible_temp_c)) {
+    faultFlags[zone] |= ZoneFault::ZoneImplausible; // the load is switched off by the next tick
+    return;
+  }
+  temperature[zone] = tempC;
+  lastSampleMs[zone] = nowMs();
+  sampledMask |= (1 << zone);
+  faultFlags[zone] = ZoneFault::NoZoneFault;
+}
+
+void ZoneController::setExternalDemand(uint8_t zone, bool heat) {
+  if (zone >= count) return;
+  uint8_t bit = 1 << zone;
+  externalMask |= bit;
+  externalDemandMask = heat ? (externalDemandMask | bit) : (externalDemandMask & ~bit);
+}
+
+void ZoneController::setSetpoint(uint8_t zone, float setpointC) {
+  if (zone < count) setpoint[zone] = setpointC;
+}
+
+void ZoneController::setSensorAddress(uint8_t zone, const uint8_t *sensorAddress) {
+  if (zone < count) memcpy(address[zone], sensorAddress, ZoneUtils::address_bytes);
+}
+
+uint8_t ZoneController::checkTick() {
+  if (!tickTrigger.checkTrigger()) return 0;
+  return tick(nowMs());
+}
+
+uint8_t ZoneController::tick(uint32_t nowMs) {
+  uint32_t elapsedMs = nowMs - lastTickMs;
+  lastTickMs = nowMs;
+
+  // 1. demand of every zone; faulted zones have none
+  uint8_t demand = 0;
+  for (uint8_t zone = 0; zone < count; zone++) {
+    uint8_t bit = 1 << zone;
+    if (loadMask & bit) onTimeMs[zone] += elapsedMs;
+    if (((sampledMask & bit) == 0) || (nowMs - lastSampleMs[zone] > ZoneUtils::max_sample_age_ms)) {
+      faultFlags[zone] |= ZoneFault::ZoneNoReading;
+    }
+    if (faultFlags[zone] != ZoneFault::NoZoneFault) continue;
+
+    bool heat;
+    if (externalMask & bit) {
+      heat = (externalDemandMask & bit) != 0;
+    } else if (temperature[zone] < setpoint[zone] - ZoneUtils::hysteresis_c) {
+      heat = true;
+    } else if (temperature[zone] >= setpoint[zone]) {
+      heat = false;
+    } else {
+      heat = (demandMask & bit) != 0; // within the hysteresis band: hold
+    }
+    if (heat) demand |= bit;
+  }
+  demandMask = demand;
+
+  // 2. loads without demand off
+  uint8_t switched = loadMask & ~demandMask;
+  for (uint8_t zone = 0; zone < count; zone++) {
+    if (switched & (1 << zone)) switchLoad(zone, false, nowMs);
+  }
+
+  // 3. shared budget: one switch-on per `stagger_ms`, at most `maxActiveLoads` loads on
+  uint8_t waiting = demandMask & ~loadMask;
+  if (waiting == 0) {
+    rotationWindowStartMs = nowMs;
+    return switched;
+  }
+  if (__builtin_popcount(loadMask) >= maxActiveLoads) {
+    if (nowMs - rotationWindowStartMs < ZoneUtils::rotation_window_ms) return switched;
+    // the longest-running load yields its slot to a waiting zone
+    uint8_t longest = ZoneUtils::max_zones;
+    for (uint8_t zone = 0; zone < count; zone++) {
+      if ((loadMask & (1 << zone)) == 0) continue;
+      if ((longest == ZoneUtils::max_zones) || (nowMs - loadOnSinceMs[zone] > nowMs - loadOnSinceMs[longest])) longest = zone;
+    }
+    switchLoad(longest, false, nowMs);
+    switched |= (1 << longest);
+    rotationWindowStartMs = nowMs;
+  }
+  if (nowMs - lastSwitchOnMs < ZoneUtils::stagger_ms) return switched;
+
+  // next waiting zone in round-robin order
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t zone = (nextInRotation + i) % count;
+    if ((waiting & (1 << zone)) == 0) continue;
+    switchLoad(zone, true, nowMs);
+    switched |= (1 << zone);
+    lastSwitchOnMs = nowMs;
+    nextInRotation = (zone + 1) % count;
+    break;
+  }
+  return switched;
+}
+
+void ZoneController::activate(long delayMs /* = 0 */) {
+  lastTickMs = nowMs();
+  statsSinceMs = lastTickMs;
+  rotationWindowStartMs = lastTickMs;
+  tickTrigger.activate(delayMs);
+}
+
+void ZoneController::expire() {
+  tickTrigger.expire();
+  uint32_t now = nowMs();
+  for (uint8_t zone = 0; zone < count; zone++) switchLoad(zone, false, now);
+}
+
+const uint8_t *ZoneController::sensorAddress(uint8_t zone) { return address[zone]; }
+
+float ZoneController::temperatureC(uint8_t zone) { return temperature[zone]; }
+
+float ZoneController::setpointC(uint8_t zone) { return setpoint[zone]; }
+
+bool ZoneController::isLoadOn(uint8_t zone) { return (loadMask & (1 << zone)) != 0; }
+
+bool ZoneController::hasDemand(uint8_t zone) { return (demandMask & (1 << zone)) != 0; }
+
+uint8_t ZoneController::faults(uint8_t zone) { return faultFlags[zone]; }
+
+uint8_t ZoneController::activeLoads() { return __builtin_popcount(loadMask); }
+
+void ZoneController::printZone(uint8_t zone) { printZoneStatus(zone, -1.0f); }
+
+void ZoneController::printStats() {
+  uint32_t now = nowMs();
+  uint32_t periodMs = now - statsSinceMs;
+  statsSinceMs = now;
+
+  Serial.print(F("Zones: "));
+  Serial.print(activeLoads());
+  Serial.print(F(" of "));
+  Serial.print(count);
+  Serial.print(F(" loads on (budget "));
+  Serial.print(maxActiveLoads);
+  Serial.println(F(")"));
+  for (uint8_t zone = 0; zone < count; zone++) {
+    float dutyPct = (periodMs > 0) ? 100.0f * static_cast<float>(onTimeMs[zone]) / static_cast<float>(periodMs) : 0.0f;
+    onTimeMs[zone] = 0;
+    printZoneStatus(zone, dutyPct);
+  }
+}
+
+void ZoneController::switchLoad(uint8_t zone, bool on, uint32_t nowMs) {
+  uint8_t bit = 1 << zone;
+  if (writer != nullptr) {
+    writer(loadPin[zone], on);
+  } else {
+    digitalWrite(loadPin[zone], on ? HIGH : LOW);
+  }
+  if (on && ((loadMask & bit) == 0)) loadOnSinceMs[zone] = nowMs;
+  loadMask = on ? (loadMask | bit) : (loadMask & ~bit);
+}
+
+void ZoneController::printZoneStatus(uint8_t zone, float dutyPct) {
+  Serial.print(F("Zone "));
+  Serial.print(zone + 1);
+  Serial.print(F(": "));
+  Serial.print(temperature[zone]);
+  Serial.print(F(" C (setpoint "));
+  Serial.print(setpoint[zone]);
+  Serial.print(F(" C), demand "));
+  Serial.print(hasDemand(zone) ? F("yes") : F("no"));
+  Serial.print(F(", load "));
+  Serial.print(isLoadOn(zone) ? F("on") : F("off"));
+  if (dutyPct >= 0.0f) {
+    Serial.print(F(", duty "));
+    Serial.print(dutyPct, 1);
+    Serial.print('%');
+  }
+  if (faultFlags[zone] & ZoneFault::ZoneNoReading) Serial.print(F(", FAULT no reading"));
+  if (faultFlags[zone] & ZoneFault::ZoneImplausible) Serial.print(F(", FAULT implausible reading"));
+  Serial.println();
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include "FrequentlyUtils.h"
+#include <Arduino.h>
+
+namespace ZoneUtils {
+  constexpr uint8_t max_zones = 8;               // zones per controller; masks of all zones fit into one byte
+  constexpr uint8_t address_bytes = 8;           // OneWire ROM address of a zone's sensor
+  constexpr unsigned long tick_ms = 100;         // period of the control tick
+  constexpr float hysteresis_c = 0.5f;           // thermostat: heating resumes below setpoint - hysteresis
+  constexpr uint32_t max_sample_age_ms = 15000;  // zone faults (load off) without a valid reading for this long
+  constexpr uint32_t stagger_ms = 2000;          // loads switch on at least this far apart (one at a time)
+  constexpr uint32_t rotation_window_ms = 60000; // with zones waiting for budget, the longest-running load yields after this
+}
+
+// Fault codes of a zone (bit flags); a faulted zone's load is off. Faults clear with the next valid reading.
+enum ZoneFault : uint8_t {
+  NoZoneFault = 0,
+  ZoneNoReading = 1 << 0,   // no reading yet, or none for longer than `max_sample_age_ms`
+  ZoneImplausible = 1 << 1, // latest reading out of the sensor range (e.g. DEVICE_DISCONNECTED_C)
+};
+
+// Writes the output of a zone: `on` is the logical state of the load (the writer maps it to the GPIO level)
+typedef void (*ZoneLoadWriter)(uint8_t loadPin, bool on);
+
+class ZoneController {
+
+  // CLASS ZoneController
+  //
+  // Runs up to `max_zones` heating zones. A zone binds a temperature sensor (OneWire address), an output pin,
+  // a setpoint and its control state. Every `tick_ms`, the control tick
+  //   1. derives each zone's demand: a hysteresis thermostat on the latest reading, or a demand set from
+  //      outside (`setExternalDemand()`, e.g. by a predictive controller); faulted zones have no demand,
+  //   2. switches off the loads without demand,
+  //   3. enforces the shared power budget: at most `maxActiveLoads` loads are on at a time, and loads are
+  //      switched on one at a time, `stagger_ms` apart, so that the SSRs' on-windows are staggered and the
+  //      loads do not all switch on at once. Waiting zones are served round-robin; while zones are waiting, the
+  //      longest-running load yields its slot once per `rotation_window_ms`.
+  //
+  // The zones are stored structure-of-arrays, and per-zone flags as bit masks (one bit per zone), so a tick
+  // walks a few contiguous arrays; its cost is linear in the number of zones.
+  //
+  // Outputs are written through a `ZoneLoadWriter`, so loads that are gated by a supervisor (e.g. the
+  // `HeaterSupervisor`) can be routed through it. This class only takes loads off on missing or implausible
+  // readings; it does not replace an independent safety supervision.
+
+  public:
+  ZoneController(uint8_t maxActiveLoads, ZoneLoadWriter writer); // constructor
+
+  // Adds a zone; returns its index, or `max_zones` if all zones are taken. The output is written off.
+  uint8_t addZone(const uint8_t *sensorAddress, uint8_t loadPin, float setpointC);
+  uint8_t zoneCount();
+
+  void addTemperature(uint8_t zone, float tempC);  // reports a reading of the zone's sensor (including DEVICE_DISCONNECTED_C)
+  void setExternalDemand(uint8_t zone, bool heat); // the zone's demand is set from outside from now on
+  void setSetpoint(uint8_t zone, float setpointC);
+  void setSensorAddress(uint8_t zone, const uint8_t *sensorAddress); // e.g. after a rescan of the bus
+
+  // Loop function: runs the control tick every `tick_ms`; returns the mask of zones whose load switched
+  uint8_t checkTick();
+  uint8_t tick(uint32_t nowMs); // control tick at the given time [milliseconds]; returns the mask of zones whose load switched
+
+  // Lifecycle functions
+  void activate(long delayMs = 0); // starts the control ticks (after optional delay [milliseconds])
+  void expire();                   // stops the control ticks and switches all loads off
+
+  // Status of a zone
+  const uint8_t *sensorAddress(uint8_t zone);
+  float temperatureC(uint8_t zone); // latest valid reading [°C] (NAN before the first)
+  float setpointC(uint8_t zone);
+  bool isLoadOn(uint8_t zone);
+  bool hasDemand(uint8_t zone);
+  uint8_t faults(uint8_t zone);
+  uint8_t activeLoads(); // number of loads currently on
+
+  void printZone(uint8_t zone); // prints the status of the zone to the Serial console (one line)
+  void printStats();            // prints the status of all zones, with the duty cycle since the last call
+
+  private:
+  void switchLoad(uint8_t zone, bool on, uint32_t nowMs);
+  void printZoneStatus(uint8_t zone, float dutyPct); // negative duty: not printed
+
+  // behavioral parameters are lifetime-constants (provided at construction)
+  const uint8_t maxActiveLoads;
+  const ZoneLoadWriter writer;
+
+  // zones, structure-of-arrays; hot arrays first
+  uint8_t count;
+  float temperature[ZoneUtils::max_zones];
+  float setpoint[ZoneUtils::max_zones];
+  uint32_t lastSampleMs[ZoneUtils::max_zones];
+  uint32_t loadOnSinceMs[ZoneUtils::max_zones];
+  uint8_t loadPin[ZoneUtils::max_zones];
+  uint8_t faultFlags[ZoneUtils::max_zones];
+  uint32_t onTimeMs[ZoneUtils::max_zones]; // accumulated on-time since the last `printStats()`
+  uint8_t address[ZoneUtils::max_zones][ZoneUtils::address_bytes];
+
+  // per-zone flags, one bit per zone
+  uint8_t sampledMask;        // zone has a valid reading
+  uint8_t demandMask;         // zone asks for heat
+  uint8_t loadMask;           // zone's load is on
+  uint8_t externalMask;       // zone's demand is set from outside
+  uint8_t externalDemandMask; // demand set from outside
+
+  // shared budget
+  FrequencyTrigger tickTrigger;
+  uint32_t lastTickMs;
+  uint32_t lastSwitchOnMs;
+  uint32_t rotationWindowStartMs;
+  uint8_t nextInRotation;
+  uint32_t statsSinceMs;
+};
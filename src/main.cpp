@@ -1,5 +1,8 @@
 #include <Arduino.h>
 #include <U8g2lib.h>
+#include <esp_system.h>  // For esp_reset_reason()
+#include <esp_timer.h>   // For one-shot timers and esp_timer_get_time()
+#include <hal/gpio_ll.h> // For gpio_ll_get_level(): ISR-safe GPIO read
 
 // WIFI
 #include <WiFi.h>
@@ -10,14 +13,58 @@
 #include "OneWire.h"
 
 // Custom utils
+#include "AdaptiveSampler.h"
+#include "AnimationAssets.h"
+#include "BurstFireDriver.h"
+#include "CommandServer.h"
 #include "ConsoleUtils.h"
+#include "ControllerSnapshot.h"
+#include "EventQueue.h"
+#include "FlightRecorder.h"
+#include "FrameMirror.h"
 #include "FrequentlyUtils.h"
+#include "HeapMonitor.h"
+#include "HeaterAccounting.h"
+#include "HeaterSupervisor.h"
 #include "LedUtils.h"
+#include "OledFonts.h"
+#include "OledIcons.h"
+#include "OledMarquee.h"
+#include "RmtOneWire.h"
+#include "SeriesStore.h"
+#include "StatDisplay.h"
+#include "StaticInstance.h"
+#include "StreamStats.h"
+#include "ThermalPredictor.h"
+#include "Workflow.h"
+#include "XbmAnimation.h"
+#include "ZoneController.h"
 
 /* ▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅ System CONFIGURATION ▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅ */
+// Memory model: the controller does not use the heap after `setup()`. Long-lived objects are either plain
+// globals, or `StaticInstance`s (statically reserved storage) where the object must be constructed in
+// `setup()`, e.g. because its constructor configures a GPIO. `heapMonitor` flags allocations after boot.
+
 // Wifi credentials:
 #include "WiFiCredentials.h"
 
+/* Event Queue
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// ISRs and system callbacks post events, which the controller loop dispatches to the handlers below
+EventQueue eventQueue;
+FrequencyTrigger printTriggerEventStats(FrequencyUtils::unbounded_lifetime, 60000); // print event queue statistics every minute
+
+/* Workflows
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Multi-step sequences written as coroutines (see `Workflow.h`), resumed by the loop; event handlers pass
+// their events on with `workflows.notify()`
+WorkflowRunner workflows;
+
+#define USER_BUTTON_GPIO 9          // GPIO 9: BOOT button of the ESP32-C3 (LOW = pressed); reserved as user button
+#define USER_BUTTON_DEBOUNCE_MS 30  // edges within this time after an accepted change are contact bounce
+int32_t userButtonLevel = HIGH;     // debounced level (released)
+uint32_t userButtonChangedAtUs = 0; // when the debounced level last changed (`Event::postedAtUs`)
+
 /* On-Board Screen (OLED 72x40)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
@@ -34,26 +81,60 @@ int yOffset = 24; // = (64-h)/2
 
 const char DEG_SYM[] = {0xB0, '\0'};
 
-const unsigned int text1_y0 = 34, text2_y0 = 66;
-const char *text1 = "Bunny Happyness ";             // scroll this text from right to left
-const char *text2 = "The Cat Sleeps well tonight "; // scroll this text from right to left
+// Status messages scrolling from right to left, advancing by one pixel every 10ms, scrolling through once
+OledMarquee statusMarquee(u8g2, 10, 1);
+
+// Mirrors the screen to a host on the serial console (enabled by the mirror command; see tools/cli `view`)
+FrameMirror displayMirror(u8g2, Serial);
 
 /* DS18B20 Temperature Sensor
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
-#define TEMPERATURE_SENSOR_GPIO 2 // DS18B20 is connected to GPIO 2; this is the port for the OneWire bus
-#define TEMPERATURE_PRECISION 10  // select 10 bit precision for DS18B20 (available range is 9 to 12 bits): corresponds to 0.25°C resolution with 187.5 ms measurement duration
+#define TEMPERATURE_SENSOR_GPIO 2    // DS18B20 is connected to GPIO 2; this is the port for the OneWire bus
+#define TEMPERATURE_PRECISION 10     // initial precision for DS18B20 (available range is 9 to 12 bits); adapted at runtime by `temperatureSampler`
+#define TEMPERATURE_SETPOINT_C 40.0f // target temperature; sampling speeds up when approaching it
 OneWire temperatureSensorBus(TEMPERATURE_SENSOR_GPIO);
 DallasTemperature temperatureSensors(&temperatureSensorBus);
 
-DeviceAddress tempSensorDeviceAddress; // type definition for DS18B20 address (8 bytes), provided by DallasTemperature library
-FrequencyTrigger *readTriggerTemperature = nullptr;
+DeviceAddress sensorAddresses[ZoneUtils::max_zones]; // DS18B20 addresses (8 bytes each, type provided by DallasTemperature library), in bus search order
+bool sensorBusShared = false;                        // more than one device on the bus: scratchpads are read by address
+AdaptiveSampler temperatureSampler(TEMPERATURE_SETPOINT_C); // picks sampling interval and resolution
+esp_timer_handle_t temperatureConversionTimer = nullptr;    // fires when the DS18B20 conversion is done
+
+// After setup, the RMT peripheral drives the bus (`temperatureSensorBus` and `temperatureSensors` are only
+// used for discovery and configuration during setup)
+RmtOneWire temperatureSensorRmtBus(TEMPERATURE_SENSOR_GPIO);
+#define ONEWIRE_SKIP_ROM 0xCC         // OneWire command: address all devices (conversion and resolution are common to all sensors)
+#define ONEWIRE_MATCH_ROM 0x55        // OneWire command: address the device with the 8-byte ROM code that follows
+#define DS18B20_CONVERT_T 0x44        // DS18B20 command: start a temperature conversion
+#define DS18B20_READ_SCRATCHPAD 0xBE  // DS18B20 command: read the 9-byte scratchpad
+#define DS18B20_WRITE_SCRATCHPAD 0x4E // DS18B20 command: write alarm registers TH, TL and the configuration (resolution)
+
+// Steps of a temperature measurement on the RMT bus
+enum SensorStep : uint8_t {
+  SensorIdle = 0,
+  SensorConfiguring = 1,          // resolution being written
+  SensorConverting = 2,           // CONVERT T command being sent
+  SensorWaitingForConversion = 3, // conversion in progress in the DS18B20
+  SensorReading = 4               // scratchpad being read
+};
+SensorStep sensorStep = SensorIdle;
+ScratchPad sensorScratchpad;                      // latest valid scratchpad (alarm registers are rewritten with the resolution)
+uint8_t sensorResolution = TEMPERATURE_PRECISION; // resolution the DS18B20 is configured to [bits]
+uint8_t sensorReadZone = 0;                       // zone whose scratchpad is being read
+uint32_t bitBangedScratchpadReadUs = 0;           // CPU time of a scratchpad read on the bit-banged bus, for comparison
 
 /* LEDs
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 #define BLUE_LED_BUILTIN 8 // GPIO 8, Blue LED: LOW = on, HIGH = off
 
-// LED Blinking patterns to indicate current state
-LEDExpiringToggler *blueToggler = nullptr; // blinks 5 times turning o1 second
+// LED Blinking patterns to indicate current state; generated by the LEDC peripheral, independent of the loop
+StaticInstance<LEDExpiringToggler> blueToggler; // constructed in `setup()`: start-up pattern first, then state pattern
+#define STATUS_STARTUP_MS 1350   // duration of the start-up pattern
+#define STATUS_BREATHE_MS 3000   // breathing period of the blue LED while the heater is on
+#define STATUS_FAULT_FLASHES 3   // blink code of the blue LED while a heater fault is latched
+#define STATUS_FLASH_MS 150      // flashes of the blink code
+#define STATUS_PAUSE_MS 1500     // pause between two blink codes
+void showHeaterState();          // selects the pattern of the blue LED
 
 /* Controller for External Load -> GPIO
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
@@ -65,57 +146,185 @@ LEDExpiringToggler *blueToggler = nullptr; // blinks 5 times turning o1 second
 #define EXT_LOAD_ON HIGH
 #define EXT_LOAD_OFF LOW
 
-// For testing purposes, we are "misusing" an LED toggler to control the external load logic
-LEDExpiringToggler *extLoadToggler = nullptr;
-
-// Toggler for blinking the "heating symbol" on the OLED screen when the external load is active
-// Char 'flash-8x.png' from the Open Iconic font https://github.com/iconic/open-iconic, down-scaled to 20x20 pixels
-#define epd_bitmap_flash_width 20
-#define epd_bitmap_flash_height 20
-const unsigned char epd_bitmap_flash[] PROGMEM = {
-    0x00, 0x0E, 0x00, 0x00, 0x0F, 0x00, 0x00, 0x07, 0x00, 0x80, 0x07, 0x00,
-    0xC0, 0x03, 0x00, 0xC0, 0x7F, 0x00, 0xE0, 0x3F, 0x00, 0x40, 0x3E, 0x00,
-    0x00, 0x1C, 0x00, 0x00, 0x1E, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00,
-    0x40, 0x2F, 0x00, 0xE0, 0x3F, 0x00, 0xC0, 0x1F, 0x00, 0xC0, 0x0F, 0x00,
-    0xC0, 0x07, 0x00, 0x80, 0x03, 0x00, 0x80, 0x01, 0x00, 0x80, 0x00, 0x00};
-
-// Wify symbol for display on OLED screen when wifi internet connection is active
-// Char `rss-8x.png' from the Open Iconic font https://github.com/iconic/open-iconic, down-scaled to 12x12 pixels
-#define epd_bitmap_wifi_width 12
-#define epd_bitmap_wifi_height 12
-const unsigned char epd_bitmap_wifi[] PROGMEM = {
-    0x80, 0x07, 0xE0, 0x03, 0x30, 0x00, 0x18, 0x07, 0xCC, 0x03, 0x66, 0x00,
-    0x32, 0x06, 0x93, 0x03, 0x9B, 0x00, 0xDB, 0x0E, 0x49, 0x0E, 0x00, 0x0E};
-
-// Array of all bitmaps for convenience. (Total bytes used to store images in PROGMEM = 96)
-const int epd_bitmap_allArray_LEN = 1;
-const unsigned char *epd_bitmap_allArray[1] = {epd_bitmap_flash};
-
-FrequencyToggler *extLoadOnDisplayBlinker = nullptr;
+// Safety limits for the loads of all zones (heaters); all writes to a load go through the supervisor, whose
+// load index is the zone index (the loads are added in zone order)
+#define HEATER_MAX_TEMP_C 45.0f        // load is forced off above this temperature
+#define HEATER_MAX_RISE_C_PER_MIN 5.0f // load is forced off if the temperature rises faster
+HeaterSupervisor heaterSupervisor(EXT_LOAD_ON == HIGH, HEATER_MAX_TEMP_C, HEATER_MAX_RISE_C_PER_MIN);
+uint32_t reportedHeaterFaults = HeaterFault::NoFault;
+
+// Duty cycle, switch-ons and energy of the load, from its transitions; kept in RTC memory and NVS across resets
+#define HEATER_LOAD_W 1000.0f // rated power of the heater at full conduction [W]
+RTC_NOINIT_ATTR HeaterTotals heaterTotals;
+HeaterAccounting heaterAccounting(heaterTotals, HEATER_LOAD_W);
+
+// While zone 1 heats, the SSR conducts HEATER_POWER_FRACTION of the mains cycles (burst fire, timed by interrupts)
+#define HEATER_POWER_FRACTION 0.75f  // share of full power while heating
+#define MAINS_HZ 50                  // mains frequency
+#define ZERO_CROSS_GPIO -1           // GPIO of a zero-cross detector to phase-lock to (-1: none fitted)
+#define ZERO_CROSS_EDGES_PER_CYCLE 2 // rising edges of the detector per mains cycle
+void IRAM_ATTR writeBurstLoad(bool on);
+BurstFireDriver heaterBurstFire(&writeBurstLoad, MAINS_HZ);
+
+// On/off control towards TEMPERATURE_SETPOINT_C, cutting and resuming early based on a learned thermal model
+#define HEATER_HYSTERESIS_C 0.5f // heating resumes below setpoint - hysteresis
+ThermalPredictor thermalPredictor(TEMPERATURE_SETPOINT_C, HEATER_HYSTERESIS_C);
+
+/* Heating Zones
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// One zone per DS18B20 on the bus, in bus search order. Zone 1 is the load on EXT_LOAD_SWITCH, heated as
+// decided by `thermalPredictor`; further zones run a hysteresis thermostat on their own pin. Every zone's load
+// is supervised by `heaterSupervisor`.
+struct ZoneConfig {
+  uint8_t loadPin;
+  float setpointC;
+};
+const ZoneConfig zoneConfigs[] = {
+    {EXT_LOAD_SWITCH, TEMPERATURE_SETPOINT_C},
+};
+#define ZONE_COUNT (sizeof(zoneConfigs) / sizeof(zoneConfigs[0]))
+#define ZONE_MAX_ACTIVE_LOADS 2 // shared power budget: loads on at the same time
+
+void writeZoneLoad(uint8_t loadPin, bool on); // routes every load through `heaterSupervisor`
+ZoneController zones(ZONE_MAX_ACTIVE_LOADS, &writeZoneLoad);
+FrequencyTrigger displayZoneTrigger(FrequencyUtils::unbounded_lifetime, 3000); // with several zones, the display cycles through them
+uint8_t displayedZone = 0;
+
+// Boot splash, decoded frame by frame straight into the screen buffer (see `bootSplashWorkflow()`); the
+// status screen is drawn once it has run out
+XbmAnimationPlayer bootSplash(splashAnimation, u8g2.getBufferPtr(), 120, false);
+
+// Heating symbol, animated while the external load heats: 60 bytes of RAM for the current frame
+uint8_t heatingIconFrame[20 * 3];
+XbmAnimationPlayer heatingIcon(heatingAnimation, heatingIconFrame, 150, true);
+
+// Status screens as retained-mode widgets, fed by the loop and the event handlers; the user button cycles
+// through them. Only the widgets that have changed are redrawn.
+StatDisplay statDisplay(u8g2, heatingIcon);
 
 /* Life-Signs
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 // prints life-signs to Serial console, unbounded runtime, print every 5000 milliseconds
-PrintLifeSign *consolePrintLifeSign = new PrintLifeSign(-1, 5000, "Controller alive");
+PrintLifeSign consolePrintLifeSign(FrequencyUtils::unbounded_lifetime, 5000, F("Controller alive"));
+
+/* Stream Statistics
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// rolling statistics over the last minute, hour and day; printed together with the event queue statistics
+StreamStats temperatureStats; // valid temperature readings [°C]
+StreamStats loopTimeStats;    // duration of a loop pass [microseconds]
+P2Quantile loopTimeP50(0.50f);
+P2Quantile loopTimeP90(0.90f);
+P2Quantile loopTimeP99(0.99f);
+
+/* Command Protocol
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// Framed binary commands on the serial console (see CommandProtocol.h), e.g. sent by the host CLI in tools/cli
+CommandStatus handlePingCommand(PayloadReader &request, PayloadWriter &response);
+CommandStatus handleGetStateCommand(PayloadReader &request, PayloadWriter &response);
+CommandStatus handleSetSetpointCommand(PayloadReader &request, PayloadWriter &response);
+CommandStatus handleGetMetricsCommand(PayloadReader &request, PayloadWriter &response);
+CommandStatus handleRescanSensorsCommand(PayloadReader &request, PayloadWriter &response);
+CommandStatus handleMirrorDisplayCommand(PayloadReader &request, PayloadWriter &response);
+CommandStatus handleGetSnapshotCommand(PayloadReader &request, PayloadWriter &response);
+CommandStatus handleExportSeriesCommand(PayloadReader &request, PayloadWriter &response);
+CommandStatus handleClearFaultsCommand(PayloadReader &request, PayloadWriter &response);
+
+constexpr CommandEntry commandTable[] = {
+    {CommandId::CommandPing, &handlePingCommand},
+    {CommandId::CommandGetState, &handleGetStateCommand},
+    {CommandId::CommandSetSetpoint, &handleSetSetpointCommand},
+    {CommandId::CommandGetMetrics, &handleGetMetricsCommand},
+    {CommandId::CommandRescanSensors, &handleRescanSensorsCommand},
+    {CommandId::CommandMirrorDisplay, &handleMirrorDisplayCommand},
+    {CommandId::CommandGetSnapshot, &handleGetSnapshotCommand},
+    {CommandId::CommandExportSeries, &handleExportSeriesCommand},
+    {CommandId::CommandClearFaults, &handleClearFaultsCommand}};
+CommandServer commandServer(Serial, commandTable, sizeof(commandTable) / sizeof(commandTable[0]));
+bool sensorRescanRequested = false; // set by the rescan command; the bus is scanned once it is idle
+
+/* Controller Snapshot
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// the state of the controller in one record, rebuilt at the end of every loop pass and shared by its consumers
+ControllerSnapshot snapshot = {};
+
+/* Flight Recorder
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// the latest significant events, kept across resets in RTC memory and dumped at boot
+#define LOOP_OVERRUN_US 50000 // a loop pass taking longer is recorded as an overrun
+RTC_NOINIT_ATTR FlightLog flightLog;
+FlightRecorder flightRecorder(flightLog);
+
+/* Temperature History
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+// every measurement of all zones, with the heater power and the loads, logged to the "series" partition
+// (see partitions.csv); exported to a host by the export command (see tools/cli `export`)
+#define SERIES_FLUSH_S 900 // a partial page is programmed after 15 minutes: at most this much history is lost on a power loss
+SeriesStore seriesStore(ZONE_COUNT, SERIES_FLUSH_S);
+SeriesExport seriesExport(seriesStore, Serial);
+
+/* Heap Telemetry
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+HeapMonitor heapMonitor; // samples the heap every 10s, warns on allocations after boot and fragmentation
 
 /* ▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅ CONTROLLER INITIALIZATION ▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅ */
 
 /* FUNCTION PROTOTYPES
  * ╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴ */
-uint8_t scanDevicesAddressesAndRememberLast(OneWire &bus, DeviceAddress addressOut);
+uint8_t scanDeviceAddresses(OneWire &bus, DeviceAddress *addressesOut, uint8_t maxAddresses);
 void printDeviceAddress(const DeviceAddress address);
 void printTemperature(DallasTemperature &sensors, DeviceAddress deviceAddress);
 
 void oledPrintTwoLines(U8G2 &display, const char *line1, const char *line2, uint8_t textHeight = 16);
-void oledScrollText(U8G2 &display, const char *text, uint8_t textHeight = 16, uint16_t scrollSpeedMs = 50);
+
+void IRAM_ATTR onUserButtonEdge();
+void onTemperatureConversionTimer(void *arg);
+void onWifiEvent(arduino_event_id_t event, arduino_event_info_t info);
+void handleTemperatureConversionDone(const Event &event);
+void handleUserButtonEdge(const Event &event);
+void handleWifiStatus(const Event &event);
+void handleScratchpad(uint8_t zone, OneWireStatus status);
+void appendSeriesSample();
+
+void startTemperatureMeasurement();
+void startTemperatureConversion();
+void startScratchpadRead(uint8_t zone);
+void advanceTemperatureMeasurement(OneWireStatus status);
+bool isValidScratchpad(const uint8_t *scratchpad);
+float ds18b20ScratchpadToCelsius(const uint8_t *scratchpad);
+void printSensorBusStats();
+void addLoopTime(uint32_t loopTimeUs);
+void updateSnapshot();
+void printLoopTimeStats();
+void printSwitchedZones(uint8_t switched);
+void rescanSensors();
+Workflow bootIndicatorWorkflow();
+Workflow bootSplashWorkflow();
 
 /* FRAMEWORK FUNCTION setup(): called by Arduino framework once at startup
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
 void setup() { /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+  for (uint8_t zone = 0; zone < ZONE_COUNT; zone++) { // first of all: the loads of all zones off
+    heaterSupervisor.addLoad(zoneConfigs[zone].loadPin);
+  }
+  heaterSupervisor.begin();
+  heaterAccounting.begin();
+  heaterSupervisor.setAccounting(0, &heaterAccounting); // before the load of zone 1 is switched on
+  Serial.setTxBufferSize(1024); // room for a mirrored frame next to the console output (set before `begin()`)
   Serial.begin(115200);
   delay(1000);
 
+  flightRecorder.begin(esp_reset_reason());
+  if (flightRecorder.previousCount() > 0) flightRecorder.printLog();
+  if (!seriesStore.begin()) Serial.println(F("WARNING: no \"series\" partition, the temperature history is not logged"));
+  seriesStore.printStats();
+
+  if (heaterSupervisor.previousFaults() != HeaterFault::NoFault) {
+    Serial.print(F("WARNING: heater faults before last reset: "));
+    HeaterSupervisor::printFaults(heaterSupervisor.previousFaults());
+    Serial.println();
+  }
+
   /* ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ On-Board Screen (OLED 72x40) ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ */
   u8g2.begin();
   u8g2.clearBuffer();
@@ -125,84 +334,128 @@ void setup() { /* ━━━━━━━━━━━━━━━━━━━━
   u8g2.enableUTF8Print();
   u8g2.setFont(u8g2_font_logisoso30_tf); // set the target font to calculate the pixel width
   u8g2.setFontMode(0);                   // enable transparent mode, which is faster
+  statDisplay.setMirror(&displayMirror); // mirrored only while enabled by the mirror command
 
   /* ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ Temperature Sensor ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ */
   Serial.print(F("Scanning for OneWire devices on GPIO pin "));
   Serial.println(TEMPERATURE_SENSOR_GPIO, DEC);
 
-  uint8_t deviceCount = scanDevicesAddressesAndRememberLast(temperatureSensorBus, tempSensorDeviceAddress); // scan for connected DS18B20 devices
-  if (deviceCount != 1) {
+  uint8_t deviceCount = scanDeviceAddresses(temperatureSensorBus, sensorAddresses, ZoneUtils::max_zones); // scan for connected DS18B20 devices
+  if (deviceCount < ZONE_COUNT) {
     while (true) {
-      Serial.print(F("Error: Expected exactly 1 DS18B20 device, but found "));
+      Serial.print(F("Error: Expected "));
+      Serial.print(ZONE_COUNT, DEC);
+      Serial.print(F(" DS18B20 device(s), one per zone, but found "));
       Serial.print(deviceCount, DEC);
       Serial.println(F(" devices. Halting execution."));
       delay(5000);
     }
   }
-  Serial.print(F("Assuming last detected device with address "));
-  printDeviceAddress(tempSensorDeviceAddress);
-  Serial.println(F(" to be the expected DS18B20 temperature sensor\n"));
+  sensorBusShared = (deviceCount > 1);
+  for (uint8_t zone = 0; zone < ZONE_COUNT; zone++) {
+    Serial.print(F("Assuming device with address "));
+    printDeviceAddress(sensorAddresses[zone]);
+    Serial.print(F(" to be the DS18B20 temperature sensor of zone "));
+    Serial.println(zone + 1, DEC);
+  }
+  Serial.println();
 
   temperatureSensors.begin(); // Initialise the sensor.
 
-  // Check that sensor is not reporting parasite power mode, which would not be expected and likely a symptom of some defect
-  if (temperatureSensors.readPowerSupply(tempSensorDeviceAddress)) { // Read device's power requirements. Return 1 if device needs parasite power.
-    Serial.print(F("WARNING: DS18B20 temperature sensor "));
-    printDeviceAddress(tempSensorDeviceAddress);
-    Serial.println(F(" is reporting PARASITE POWER MODE. This is unexpected and may indicate a defect."));
-  }
-
-  // set the temperature accuracy
-  // Note on `skipGlobalBitResolutionCalculation` parameter:
-  // When skipGlobalBitResolutionCalculation is set to true, the function will only set the resolution for the targeted device and will not recalculate or update the overall (global) bit
-  // resolution for all devices on the bus. This can be useful for performance reasons or when you want to manage device resolutions individually without affecting the global setting.
-  // Conversely, if skipGlobalBitResolutionCalculation is false, the function will update the global bit resolution variable after successfully setting the device's resolution. It will als
-  // scan all devices to ensure the global bit resolution reflects the highest resolution among all connected sensors. This ensures consistency when reading temperatures from multiple devices.
-  temperatureSensors.setResolution(tempSensorDeviceAddress, TEMPERATURE_PRECISION);
-
-  // verify resolution setting:
-  uint8_t actualPrecision = temperatureSensors.getResolution(tempSensorDeviceAddress);
-  if (actualPrecision != TEMPERATURE_PRECISION) {
-    Serial.print(F("Error: Unable to set DS18B20 temperature sensor "));
-    printDeviceAddress(tempSensorDeviceAddress);
-    Serial.print(F(" to desired precision of "));
-    Serial.print(TEMPERATURE_PRECISION, DEC);
-    Serial.println(F(" bits."));
-    Serial.println(F("Sensor reports precision of "));
-    Serial.print(actualPrecision, DEC);
-    Serial.println(F(" bits."));
-  }
-
-  readTriggerTemperature = new FrequencyTrigger(-1, 5000); // read temperature every 2s, unbounded lifetime
-  extLoadOnDisplayBlinker = new FrequencyToggler(-1, 500); // blinks every 500ms when activated
+  // every zone: binds sensor and load
+  for (uint8_t zone = 0; zone < ZONE_COUNT; zone++) {
+    zones.addZone(sensorAddresses[zone], zoneConfigs[zone].loadPin, zoneConfigs[zone].setpointC);
+
+    // Check that sensor is not reporting parasite power mode, which would not be expected and likely a symptom of some defect
+    if (temperatureSensors.readPowerSupply(sensorAddresses[zone])) { // Read device's power requirements. Return 1 if device needs parasite power.
+      Serial.print(F("WARNING: DS18B20 temperature sensor "));
+      printDeviceAddress(sensorAddresses[zone]);
+      Serial.println(F(" is reporting PARASITE POWER MODE. This is unexpected and may indicate a defect."));
+    }
+
+    // set the temperature accuracy
+    // Note on `skipGlobalBitResolutionCalculation` parameter:
+    // When skipGlobalBitResolutionCalculation is set to true, the function will only set the resolution for the targeted device and will not recalculate or update the overall (global) bit
+    // resolution for all devices on the bus. This can be useful for performance reasons or when you want to manage device resolutions individually without affecting the global setting.
+    // Conversely, if skipGlobalBitResolutionCalculation is false, the function will update the global bit resolution variable after successfully setting the device's resolution. It will als
+    // scan all devices to ensure the global bit resolution reflects the highest resolution among all connected sensors. This ensures consistency when reading temperatures from multiple devices.
+    temperatureSensors.setResolution(sensorAddresses[zone], TEMPERATURE_PRECISION);
+
+    // verify resolution setting:
+    uint8_t actualPrecision = temperatureSensors.getResolution(sensorAddresses[zone]);
+    if (actualPrecision != TEMPERATURE_PRECISION) {
+      Serial.print(F("Error: Unable to set DS18B20 temperature sensor "));
+      printDeviceAddress(sensorAddresses[zone]);
+      Serial.print(F(" to desired precision of "));
+      Serial.print(TEMPERATURE_PRECISION, DEC);
+      Serial.println(F(" bits."));
+      Serial.println(F("Sensor reports precision of "));
+      Serial.print(actualPrecision, DEC);
+      Serial.println(F(" bits."));
+    }
+  }
+  sensorResolution = temperatureSensors.getResolution(sensorAddresses[0]);
+  zones.setExternalDemand(0, false); // zone 1 follows `thermalPredictor`
+
+  // CPU time of a scratchpad read on the bit-banged bus (the library busy-waits through all time slots)
+  int64_t bitBangStartUs = esp_timer_get_time();
+  temperatureSensors.readScratchPad(sensorAddresses[0], sensorScratchpad);
+  bitBangedScratchpadReadUs = static_cast<uint32_t>(esp_timer_get_time() - bitBangStartUs);
+
+  // hand the bus over to the RMT peripheral
+  if (!temperatureSensorRmtBus.begin()) {
+    while (true) {
+      Serial.println(F("Error: Unable to set up the RMT peripheral for the OneWire bus. Halting execution."));
+      delay(5000);
+    }
+  }
+
+  // Conversions are started asynchronously; a one-shot timer posts an event once the conversion time has elapsed
+  esp_timer_create_args_t conversionTimerArgs = {};
+  conversionTimerArgs.callback = &onTemperatureConversionTimer;
+  conversionTimerArgs.dispatch_method = ESP_TIMER_TASK;
+  conversionTimerArgs.name = "ds18b20";
+  esp_timer_create(&conversionTimerArgs, &temperatureConversionTimer);
 
   /* ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ LEDs ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ */
-  // blinks quickly every 300ms for a total duration of 1.35s to indicate system is starting up
-  blueToggler = new LEDExpiringToggler(BLUE_LED_BUILTIN, 1350, 150, LedUtils::LOW_IS_ON);
+  // blinks quickly every 300ms for a total duration of 1.35s to indicate system is starting up; the setup
+  // goes on meanwhile, and the state pattern takes over afterwards (see `bootIndicatorWorkflow()`)
+  blueToggler.emplace(BLUE_LED_BUILTIN, STATUS_STARTUP_MS, 150, LedUtils::LOW_IS_ON);
   blueToggler->activate();
-  while (true) {
-    delay(20);
-    blueToggler->checkToggleLED();
-    if (blueToggler->isExpired()) break;
-  }
+  workflows.start(bootIndicatorWorkflow(), "boot indicator");
 
-  /* ── LEDs' blinking patterns to indicate current state ─────────── */
-  blueToggler = new LEDExpiringToggler(BLUE_LED_BUILTIN, -1, 2000, LedUtils::LOW_IS_ON); // blinks 1 times turning o1 second
+  /* ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ Event sources ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ */
+  eventQueue.subscribe(EventType::TemperatureConversionDone, &handleTemperatureConversionDone);
+  eventQueue.subscribe(EventType::ButtonEdge, &handleUserButtonEdge);
+  eventQueue.subscribe(EventType::WifiConnected, &handleWifiStatus);
+  eventQueue.subscribe(EventType::WifiDisconnected, &handleWifiStatus);
 
-  /* ── Toggling GPIO 1, which connects to Mosfet ─────────── */
-  extLoadToggler = new LEDExpiringToggler(EXT_LOAD_SWITCH, -1, 2000, LedUtils::HIGH_IS_ON); // blinks 1 times turning o1 second
+  pinMode(USER_BUTTON_GPIO, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(USER_BUTTON_GPIO), &onUserButtonEdge, CHANGE);
+  WiFi.onEvent(&onWifiEvent);
 
   /* ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ start ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ */
-  blueToggler->activate();
-  extLoadToggler->activate();
+  thermalPredictor.begin();
+  zones.activate();
+  displayZoneTrigger.activate();
 
-  consolePrintLifeSign->activate(293);
-  readTriggerTemperature->activate(421);
-  extLoadOnDisplayBlinker->activate(421);
+  consolePrintLifeSign.activate(293);
+  temperatureSampler.activate(421);
+  printTriggerEventStats.activate(60000);
   Serial.println(F("Done with setup. Kolibrie commencing operations!"));
 
-  // oledScrollText(u8g2, "Done with setup. Kolibrie commencing operations!", 20, 10);
-  // delay(5000);
+  bootSplash.activate(); // the welcome message scrolls in after the splash
+  workflows.start(bootSplashWorkflow(), "boot splash");
+  heatingIcon.activate();
+
+  heaterSupervisor.arm(); // from here on, the loop must check in regularly
+  heaterBurstFire.begin();
+#if ZERO_CROSS_GPIO >= 0
+  heaterBurstFire.attachZeroCross(ZERO_CROSS_GPIO, ZERO_CROSS_EDGES_PER_CYCLE);
+#endif
+
+  heapMonitor.activate(); // last: everything allocated up to here is the baseline
+  heapMonitor.printStats();
 }
 
 /* ▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅ CONTROLLER LOOP ▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅ */
@@ -210,84 +463,539 @@ void setup() { /* ━━━━━━━━━━━━━━━━━━━━
  * ╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴╴ */
 
 void loop() { /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+  int64_t loopStartUs = esp_timer_get_time();
+  heaterSupervisor.checkIn();
 
-  u8g2.setFont(u8g2_font_logisoso30_tf);
-  u8g2.clearBuffer();                  // clear the internal memory
-  u8g2.drawFrame(0, 0, width, height); // draw a frame around the border
-  // u8g2.setCursor(xOffset + 15, yOffset + 25);
-  // u8g2.printf("%dx%d", width, height);
-  u8g2.drawUTF8(2, 34, "82"); // draw the scolling text
-
-  u8g2.drawUTF8(42, 40, "°"); // draw the scolling text
-  u8g2.setFont(u8g2_font_logisoso18_tf);
-  u8g2.drawUTF8(54, 22, "C");
-  u8g2.sendBuffer(); // transfer internal memory to the display
+  /* ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ On-Board Screen (OLED 72x40) ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ */
+  // while the boot splash plays or a status message is scrolling, they own the screen
+  statusMarquee.checkScroll();
+  statDisplay.setOverlaid(!statusMarquee.isExpired() || !bootSplash.isExpired());
+  statDisplay.setTemp(zones.temperatureC(displayedZone));
+  statDisplay.setZone(displayedZone, zones.zoneCount());
+  statDisplay.setHeatingStatus(heaterBurstFire.fraction() > 0.0f);
+  statDisplay.setEnergy(heaterAccounting.energyKWh(), heaterAccounting.currentHourDuty());
+  statDisplay.checkRedraw(); // also mirrors the screen to the host, if enabled
+  if (displayZoneTrigger.checkTrigger() && (zones.zoneCount() > 1)) {
+    displayedZone = (displayedZone + 1) % zones.zoneCount();
+  }
 
   /* ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ Temperature Sensor ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ */
-  temperatureSensors.requestTemperatures();
-
-  if (readTriggerTemperature->checkTrigger()) {
-    Serial.print("Celsius temperature: ");
-    // We need to provide a "sensor index", as there can be more than one IC on the same bus. 0 refers to the first IC on the wire
-    Serial.print(temperatureSensors.getTempCByIndex(0));
-    Serial.print(" - Fahrenheit temperature: ");
-    Serial.println(temperatureSensors.getTempFByIndex(0));
-  }
-
-  Serial.print("Toggler state: ");
-  Serial.println(extLoadOnDisplayBlinker->isCurrentStateOn());
-
-  if (extLoadOnDisplayBlinker->checkToggle()) {
-    // toggle the heating symbol on the OLED display
-    if (extLoadOnDisplayBlinker->isCurrentStateOn()) {
-      Serial.println(" toggle heating symbol ON display");
-      // u8g2.setFont(u8g2_font_open_iconic_embedded_2x_t);
-      // u8g2.drawUTF8(38, 35, "\x43"); // draw heating symbol
-      u8g2.setBitmapMode(1);
-      // u8g2.drawXBMP(37, 15, epd_bitmap_flash_width, epd_bitmap_flash_height, epd_bitmap_flash);
-      u8g2.drawXBMP(55, 25, epd_bitmap_wifi_width, epd_bitmap_wifi_height, epd_bitmap_wifi);
-
-      // alternative for wifi symbol:
-      // u8g2.setFont(u8g2_font_open_iconic_embedded_2x_t);
-      // u8g2.drawUTF8(54, 45, "\x50");
+  if ((sensorStep == SensorIdle) && sensorRescanRequested) rescanSensors();
+  // start a measurement when the sampler asks for it; the scratchpad is read by `handleTemperatureConversionDone()`
+  if ((sensorStep == SensorIdle) && temperatureSampler.checkSample()) {
+    startTemperatureMeasurement();
+  }
+  OneWireStatus sensorBusStatus = temperatureSensorRmtBus.checkTransaction();
+  if ((sensorBusStatus != OneWireStatus::Busy) && (sensorStep != SensorIdle) && (sensorStep != SensorWaitingForConversion)) {
+    temperatureSampler.addBusTime(temperatureSensorRmtBus.lastBusTimeUs());
+    advanceTemperatureMeasurement(sensorBusStatus);
+  }
+
+  /* ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ Events ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ */
+  eventQueue.dispatch();
+  workflows.checkResume();
+  commandServer.checkInput();
+  seriesStore.checkFlush();
+  seriesExport.checkExport();
+  if (printTriggerEventStats.checkTrigger()) {
+    eventQueue.printStats();
+    commandServer.printStats();
+    displayMirror.printStats();
+    heaterBurstFire.printStats();
+    heaterAccounting.printStats();
+    blueToggler->indicator().printStats();
+    workflows.printStats();
+    bootSplash.printStats("boot splash");
+    heatingIcon.printStats("heating");
+    seriesStore.printStats();
+    seriesExport.printStats();
+    printSensorBusStats();
+    temperatureSampler.printStats();
+    thermalPredictor.printStats();
+    zones.printStats();
+    temperatureStats.printSummary(F("Temperature [°C]"));
+    printLoopTimeStats();
+  }
+
+  /* ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ External Load ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ */
+  // zone 1 heats as the predictor decides; the zone controller switches all loads within the power budget
+  // the load is heating while the burst fire has a fraction (the SSR itself toggles with the pattern)
+  bool heating = (heaterBurstFire.fraction() > 0.0f) && (heaterSupervisor.faults(0) == HeaterFault::NoFault);
+  if (thermalPredictor.checkUpdate(heating)) {
+    zones.setExternalDemand(0, thermalPredictor.shouldHeat());
+  }
+  uint8_t switchedZones = zones.checkTick();
+  if (switchedZones != 0) printSwitchedZones(switchedZones);
+  if (heaterSupervisor.faults() != reportedHeaterFaults) {
+    reportedHeaterFaults = heaterSupervisor.faults();
+    flightRecorder.record(FlightEvent::FlightHeaterFault, 0, static_cast<int16_t>(reportedHeaterFaults & 0xFFFF));
+    if (reportedHeaterFaults == HeaterFault::NoFault) {
+      Serial.println(F("Heater faults cleared"));
     } else {
-      // Serial.println(" toggle heating symbol OFF display");
-      // // clear heating symbol area
-      // u8g2.setDrawColor(0); // set draw color to black
-      // u8g2.drawBox(0, 10, 20, 30);
-      // u8g2.setDrawColor(1); // reset draw color to white
+      Serial.print(F("HEATER FAULT, load forced off: "));
+      HeaterSupervisor::printFaults(reportedHeaterFaults);
+      Serial.print(F(" (reaction time "));
+      Serial.print(heaterSupervisor.lastReactionMs());
+      Serial.println(F(" ms)"));
     }
-    u8g2.sendBuffer(); // transfer internal memory to the display
-    delay(5000);
+    showHeaterState();
   }
+  heaterAccounting.checkRollover();
 
   /* ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ lifecycle ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌ */
   blueToggler->checkToggleLED();
-  extLoadToggler->checkToggleLED();
-  consolePrintLifeSign->checkConsolePrint();
+  consolePrintLifeSign.checkConsolePrint();
+  heapMonitor.checkHeap();
+
+  updateSnapshot();
+  addLoopTime(static_cast<uint32_t>(esp_timer_get_time() - loopStartUs));
+}
+
+/* ▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅ EVENT SOURCES & HANDLERS ▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅ */
+
+// ISR: edge on the user button. Only posts an event with the pin level; the handler runs on the controller
+// loop, and debounces.
+void IRAM_ATTR onUserButtonEdge() { eventQueue.post(EventType::ButtonEdge, USER_BUTTON_GPIO, gpio_ll_get_level(&GPIO, USER_BUTTON_GPIO)); }
+
+// esp_timer callback (timer task): DS18B20 conversion time has elapsed
+void onTemperatureConversionTimer(void *arg) { eventQueue.post(EventType::TemperatureConversionDone); }
+
+// Wifi system callback (event task): connection status changes
+void onWifiEvent(arduino_event_id_t event, arduino_event_info_t info) {
+  if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+    eventQueue.post(EventType::WifiConnected);
+  } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+    eventQueue.post(EventType::WifiDisconnected, 0, info.wifi_sta_disconnected.reason);
+  }
+}
+
+// All sensors have converted; their scratchpads are read one after the other, starting with zone 1
+void handleTemperatureConversionDone(const Event &event) {
+  startScratchpadRead(0);
+  workflows.notify(event);
+}
+
+// Evaluates the scratchpad of a zone read on the RMT bus. Zone 1 also drives the sampler, the predictor,
+// the statistics and the heater supervision.
+void handleScratchpad(uint8_t zone, OneWireStatus status) {
+  const uint8_t *scratchpad = temperatureSensorRmtBus.readData();
+  float tempC = DEVICE_DISCONNECTED_C;
+  if ((status == OneWireStatus::Done) && isValidScratchpad(scratchpad)) {
+    tempC = ds18b20ScratchpadToCelsius(scratchpad);
+    if (zone == 0) {
+      memcpy(sensorScratchpad, scratchpad, sizeof(ScratchPad));
+      sensorResolution = 9 + ((scratchpad[4] >> 5) & 0x03);
+      temperatureSampler.addSample(tempC);
+      thermalPredictor.addTemperature(tempC);
+      temperatureStats.add(tempC);
+    }
+  }
+  heaterSupervisor.reportTemperature(zone, tempC);
+  zones.addTemperature(zone, tempC);
+  if (zone + 1 == zones.zoneCount()) appendSeriesSample(); // all zones are measured
+  if (tempC == DEVICE_DISCONNECTED_C) {
+    flightRecorder.record(FlightEvent::FlightSensorError, zone, 0);
+  } else {
+    flightRecorder.recordTemperature(FlightEvent::FlightTemperature, zone, tempC);
+  }
+  Serial.print(F("Zone "));
+  Serial.print(zone + 1, DEC);
+  Serial.print(F(": "));
+  if (tempC == DEVICE_DISCONNECTED_C) {
+    Serial.println(F("Error: Could not read temperature data"));
+    return;
+  }
+  Serial.print(F("Celsius temperature: "));
+  Serial.print(tempC);
+  Serial.print(F(" - Fahrenheit temperature: "));
+  Serial.println(DallasTemperature::toFahrenheit(tempC));
+}
+
+// Command: echoes the payload (round-trip measurements)
+CommandStatus handlePingCommand(PayloadReader &request, PayloadWriter &response) {
+  response.putBytes(request.remainingData(), request.remaining());
+  return CommandStatus::CommandOk;
+}
+
+// Command: state of the zones and the heater supervision
+CommandStatus handleGetStateCommand(PayloadReader &request, PayloadWriter &response) {
+  response.putU8(zones.zoneCount());
+  response.putU32(heaterSupervisor.faults());
+  for (uint8_t zone = 0; zone < zones.zoneCount(); zone++) {
+    response.putFloat(zones.temperatureC(zone));
+    response.putFloat(zones.setpointC(zone));
+    response.putU8((zones.isLoadOn(zone) ? 0x01 : 0x00) | (zones.hasDemand(zone) ? 0x02 : 0x00));
+    response.putU8(zones.faults(zone));
+  }
+  return CommandStatus::CommandOk;
+}
+
+// Command: changes the setpoint of a zone; the setpoint of zone 1 also applies to the predictor and the sampler
+CommandStatus handleSetSetpointCommand(PayloadReader &request, PayloadWriter &response) {
+  uint8_t zone;
+  float setpointC;
+  if (!request.getU8(zone) || !request.getFloat(setpointC)) return CommandStatus::CommandBadPayload;
+  if ((zone >= zones.zoneCount()) || !isfinite(setpointC) || (setpointC < 0.0f) || (setpointC > HEATER_MAX_TEMP_C)) {
+    return CommandStatus::CommandBadPayload;
+  }
+  zones.setSetpoint(zone, setpointC);
+  flightRecorder.recordTemperature(FlightEvent::FlightSetpoint, zone, setpointC);
+  if (zone == 0) {
+    thermalPredictor.setSetpoint(setpointC);
+    temperatureSampler.setSetpoint(setpointC);
+  }
+  Serial.print(F("Zone "));
+  Serial.print(zone + 1, DEC);
+  Serial.print(F(": setpoint changed to "));
+  Serial.println(setpointC);
+  return CommandStatus::CommandOk;
+}
+
+// Command: uptime, heap, loop time percentiles, event and command counters (as of the snapshot of the latest loop pass)
+CommandStatus handleGetMetricsCommand(PayloadReader &request, PayloadWriter &response) {
+  response.putU32(snapshot.uptimeMs);
+  response.putU32(snapshot.freeHeapBytes);
+  response.putU32(snapshot.minimumFreeHeapBytes);
+  response.putFloat(snapshot.loopTimeP50Us);
+  response.putFloat(snapshot.loopTimeP90Us);
+  response.putFloat(snapshot.loopTimeP99Us);
+  response.putU32(snapshot.eventsDispatched);
+  response.putU32(snapshot.eventsDropped);
+  response.putU32(snapshot.commands);
+  response.putU32(snapshot.rejectedFrames);
+  return CommandStatus::CommandOk;
+}
+
+// Command: requests a rescan of the sensor bus (see `rescanSensors()`)
+CommandStatus handleRescanSensorsCommand(PayloadReader &request, PayloadWriter &response) {
+  if (sensorRescanRequested) return CommandStatus::CommandBusy;
+  sensorRescanRequested = true;
+  return CommandStatus::CommandOk;
+}
+
+// Command: the snapshot of the latest loop pass, copied as is
+CommandStatus handleGetSnapshotCommand(PayloadReader &request, PayloadWriter &response) {
+  response.putBytes(reinterpret_cast<const uint8_t *>(&snapshot), sizeof(snapshot));
+  return CommandStatus::CommandOk;
+}
+
+// Command: streams the temperature history (see `SeriesExport`)
+CommandStatus handleExportSeriesCommand(PayloadReader &request, PayloadWriter &response) {
+  if (!seriesExport.isExpired()) return CommandStatus::CommandBusy;
+  response.putU32(seriesExport.activate());
+  return CommandStatus::CommandOk;
+}
+
+// Command: clears the latched heater faults, e.g. after the sensor has been reconnected. A fault whose cause
+// persists latches again with the next reading or supervision tick.
+CommandStatus handleClearFaultsCommand(PayloadReader &request, PayloadWriter &response) {
+  response.putU32(heaterSupervisor.faults());
+  heaterSupervisor.clearFaults();
+  return CommandStatus::CommandOk;
+}
+
+// Command: starts or stops mirroring the screen (see `FrameMirror`)
+CommandStatus handleMirrorDisplayCommand(PayloadReader &request, PayloadWriter &response) {
+  uint8_t enable;
+  uint16_t minIntervalMs;
+  if (!request.getU8(enable) || !request.getU16(minIntervalMs)) return CommandStatus::CommandBadPayload;
+  if (enable) {
+    displayMirror.activate(minIntervalMs);
+  } else {
+    displayMirror.expire();
+  }
+  return CommandStatus::CommandOk;
+}
+
+void handleUserButtonEdge(const Event &event) {
+  // bouncing contacts post a burst of edges: only a change of the level counts, and not within the debounce
+  // time after the last accepted change (a later edge then catches up with the level)
+  if (event.value == userButtonLevel) return;
+  if ((event.postedAtUs - userButtonChangedAtUs) < (USER_BUTTON_DEBOUNCE_MS * 1000UL)) return;
+  userButtonLevel = event.value;
+  userButtonChangedAtUs = event.postedAtUs;
+  Serial.print(F("Button on GPIO "));
+  Serial.print(event.param, DEC);
+  Serial.println((event.value == LOW) ? F(" pressed") : F(" released"));
+  if (event.value == LOW) statDisplay.showNextScreen();
+}
+
+void handleWifiStatus(const Event &event) {
+  workflows.notify(event);
+  bool connected = (event.type == EventType::WifiConnected);
+  // the Wifi status has no other home: it is kept in the snapshot, and `updateSnapshot()` leaves it alone
+  snapshot.flags = connected ? (snapshot.flags | SnapshotUtils::flag_wifi_connected) : (snapshot.flags & ~SnapshotUtils::flag_wifi_connected);
+  snapshot.wifiDisconnectReason = connected ? 0 : static_cast<uint8_t>(event.value);
+  flightRecorder.record(FlightEvent::FlightWifi, connected ? 1 : 0, connected ? 0 : static_cast<int16_t>(event.value));
+  statDisplay.setWifiStatus(connected);
+  if (connected) {
+    Serial.println(F("Wifi connected"));
+  } else {
+    Serial.print(F("Wifi disconnected, reason "));
+    Serial.println(event.value);
+  }
 }
 
 /* ▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅ BUSINESS LOGIC FUNCTIONS ▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅▅ */
 
+// Starts a temperature measurement of all DS18B20 on the RMT bus. If the sampler asks for a different
+// resolution, the configuration of all sensors is written first; the alarm registers TH and TL are written
+// back as last read from zone 1.
+// Neither the resolution nor the alarm registers are copied to the EEPROM, nor read back for verification:
+// the next scratchpad read shows the resolution in effect.
+void startTemperatureMeasurement() {
+  uint8_t resolution = temperatureSampler.resolution();
+  if (resolution == sensorResolution) {
+    startTemperatureConversion();
+    return;
+  }
+  uint8_t configuration = ((resolution - 9) << 5) | 0x1F;
+  uint8_t command[] = {ONEWIRE_SKIP_ROM, DS18B20_WRITE_SCRATCHPAD, sensorScratchpad[2], sensorScratchpad[3], configuration};
+  if (temperatureSensorRmtBus.startTransaction(command, sizeof(command), 0)) {
+    sensorResolution = resolution;
+    sensorStep = SensorConfiguring; // continued by `advanceTemperatureMeasurement()`
+  }
+}
+
+void startTemperatureConversion() {
+  uint8_t command[] = {ONEWIRE_SKIP_ROM, DS18B20_CONVERT_T};
+  bool started = temperatureSensorRmtBus.startTransaction(command, sizeof(command), 0);
+  sensorStep = started ? SensorConverting : SensorIdle;
+}
+
+// Starts reading the scratchpad of a zone's sensor: addressed by its ROM code if the bus is shared
+void startScratchpadRead(uint8_t zone) {
+  uint8_t command[2 + ZoneUtils::address_bytes] = {ONEWIRE_SKIP_ROM, DS18B20_READ_SCRATCHPAD};
+  uint8_t length = 2;
+  if (sensorBusShared) {
+    command[0] = ONEWIRE_MATCH_ROM;
+    memcpy(&command[1], sensorAddresses[zone], ZoneUtils::address_bytes);
+    command[1 + ZoneUtils::address_bytes] = DS18B20_READ_SCRATCHPAD;
+    length = sizeof(command);
+  }
+  sensorReadZone = zone;
+  if (temperatureSensorRmtBus.startTransaction(command, length, sizeof(ScratchPad))) {
+    sensorStep = SensorReading; // continued by `advanceTemperatureMeasurement()`
+  } else {
+    sensorStep = SensorIdle;
+    handleScratchpad(zone, OneWireStatus::Failed);
+  }
+}
+
+// Advances the temperature measurement when a transaction on the RMT bus has completed
+void advanceTemperatureMeasurement(OneWireStatus status) {
+  switch (sensorStep) {
+    case SensorConfiguring:
+      startTemperatureConversion(); // a failed write shows in the next scratchpad read
+      break;
+    case SensorConverting:
+      // conversion time counts from the end of the CONVERT T command
+      sensorStep = SensorWaitingForConversion;
+      esp_timer_start_once(temperatureConversionTimer, 1000ULL * DallasTemperature::millisToWaitForConversion(sensorResolution));
+      break;
+    case SensorReading:
+      sensorStep = SensorIdle;
+      handleScratchpad(sensorReadZone, status);
+      if (sensorReadZone + 1 < zones.zoneCount()) startScratchpadRead(sensorReadZone + 1);
+      break;
+    default:
+      break;
+  }
+}
+
+// A scratchpad is valid if its CRC matches and the fixed bits of the configuration register are set
+// (an all-zero scratchpad, e.g. from a shorted bus, has a matching CRC).
+bool isValidScratchpad(const uint8_t *scratchpad) {
+  return (OneWire::crc8(scratchpad, 8) == scratchpad[8]) && ((scratchpad[4] & 0x9F) == 0x1F);
+}
+
+// Converts the temperature register of a DS18B20 scratchpad to °C. At resolutions below 12 bits, the
+// lowest bits of the register are undefined and are masked.
+float ds18b20ScratchpadToCelsius(const uint8_t *scratchpad) {
+  int16_t raw = static_cast<int16_t>((scratchpad[1] << 8) | scratchpad[0]);
+  uint8_t resolution = 9 + ((scratchpad[4] >> 5) & 0x03);
+  raw &= ~((1 << (12 - resolution)) - 1);
+  return raw / 16.0f;
+}
+
+// Prints the CPU time spent on the RMT bus, compared with a scratchpad read on the bit-banged bus
+void printSensorBusStats() {
+  Serial.print(F("OneWire: RMT bus CPU time avg "));
+  Serial.print(temperatureSensorRmtBus.averageCpuTimeUs());
+  Serial.print(F(" us per transaction (last "));
+  Serial.print(temperatureSensorRmtBus.lastCpuTimeUs());
+  Serial.print(F(" us during "));
+  Serial.print(temperatureSensorRmtBus.lastBusTimeUs());
+  Serial.print(F(" us on the bus); bit-banged scratchpad read "));
+  Serial.print(bitBangedScratchpadReadUs);
+  Serial.println(F(" us"));
+}
+
+// Records the duration of a loop pass in the rolling statistics and the percentile estimators, and an
+// overrun in the flight recorder
+void addLoopTime(uint32_t loopTimeUs) {
+  if (loopTimeUs > LOOP_OVERRUN_US) {
+    flightRecorder.record(FlightEvent::FlightLoopOverrun, 0, static_cast<int16_t>(min(loopTimeUs / 1000UL, 32767UL)));
+  }
+  float value = static_cast<float>(loopTimeUs);
+  loopTimeStats.add(value);
+  loopTimeP50.add(value);
+  loopTimeP90.add(value);
+  loopTimeP99.add(value);
+}
+
+// Logs the latest measurement of all zones to the temperature history
+void appendSeriesSample() {
+  SeriesSample sample = {};
+  sample.timeS = seriesStore.clockS();
+  sample.heaterPercent = static_cast<uint8_t>(lroundf(heaterBurstFire.fraction() * 100.0f));
+  for (uint8_t zone = 0; zone < ZoneUtils::max_zones; zone++) {
+    bool valid = zone < zones.zoneCount();
+    sample.temperature[zone] = valid ? snapshotTemperature(zones.temperatureC(zone)) : SnapshotUtils::no_temperature;
+    if (valid && zones.isLoadOn(zone)) sample.loads |= 1 << zone;
+  }
+  seriesStore.append(sample);
+}
+
+// Rebuilds the snapshot in place from the state of this loop pass (the Wifi status is set by its handler)
+void updateSnapshot() {
+  beginSnapshot(snapshot, static_cast<uint32_t>(esp_timer_get_time() / 1000LL));
+  snapshotZones(snapshot, zones);
+  uint8_t flags = snapshot.flags & SnapshotUtils::flag_wifi_connected;
+  if (heaterBurstFire.fraction() > 0.0f) flags |= SnapshotUtils::flag_heating;
+  if (heaterSupervisor.isLoadOn(0)) flags |= SnapshotUtils::flag_load_on;
+  snapshot.flags = flags;
+  snapshot.heaterFaults = heaterSupervisor.faults();
+  snapshot.heaterPowerFraction = heaterBurstFire.fraction();
+  snapshot.heaterEnergyKWh = heaterAccounting.energyKWh();
+  snapshot.heaterSwitchCount = heaterAccounting.switchCount();
+  snapshot.heaterHourDuty = heaterAccounting.currentHourDuty();
+  snapshot.loopTimeP50Us = loopTimeP50.value();
+  snapshot.loopTimeP90Us = loopTimeP90.value();
+  snapshot.loopTimeP99Us = loopTimeP99.value();
+  snapshot.eventsDispatched = eventQueue.dispatchedCount();
+  snapshot.eventsDropped = eventQueue.overflowCount();
+  snapshot.commands = commandServer.commandCount();
+  snapshot.rejectedFrames = commandServer.rejectedFrameCount();
+  snapshot.freeHeapBytes = heapMonitor.freeBytes();
+  snapshot.minimumFreeHeapBytes = heapMonitor.minimumFreeBytes();
+}
+
+// Prints the rolling statistics and the percentiles (since boot) of the loop time
+void printLoopTimeStats() {
+  loopTimeStats.printSummary(F("Loop time [us]"), 0);
+  Serial.print(F("Loop time percentiles since boot: p50 "));
+  Serial.print(loopTimeP50.value(), 0);
+  Serial.print(F(" us, p90 "));
+  Serial.print(loopTimeP90.value(), 0);
+  Serial.print(F(" us, p99 "));
+  Serial.print(loopTimeP99.value(), 0);
+  Serial.println(F(" us"));
+}
+
+// Prints the zones whose load has just been switched
+void printSwitchedZones(uint8_t switched) {
+  for (uint8_t zone = 0; zone < zones.zoneCount(); zone++) {
+    if (switched & (1 << zone)) zones.printZone(zone);
+  }
+}
+
+// Writes the load of a zone through the heater supervisor, which may hold it off. EXT_LOAD_SWITCH is modulated
+// by the burst fire, the loads of further zones are switched directly.
+void writeZoneLoad(uint8_t loadPin, bool on) {
+  uint8_t load = heaterSupervisor.loadIndex(loadPin);
+  if (loadPin == EXT_LOAD_SWITCH) {
+    bool wasHeating = (heaterBurstFire.fraction() > 0.0f);
+    heaterBurstFire.setFraction(on ? HEATER_POWER_FRACTION : 0.0f);
+    if (on != wasHeating) showHeaterState();
+  } else {
+    heaterSupervisor.requestLoad(load, on);
+  }
+  on = on && (heaterSupervisor.faults(load) == HeaterFault::NoFault);
+  flightRecorder.record(FlightEvent::FlightLoad, loadPin, on ? 1 : 0);
+}
+
+// Blue LED: blink code while a heater fault is latched, breathing while the heater is on, slow blinking otherwise
+void showHeaterState() {
+  if (heaterSupervisor.faults() != HeaterFault::NoFault) {
+    blueToggler->indicator().blinkCode(STATUS_FAULT_FLASHES, STATUS_FLASH_MS, STATUS_PAUSE_MS);
+  } else if (heaterBurstFire.fraction() > 0.0f) {
+    blueToggler->indicator().breathe(STATUS_BREATHE_MS);
+  } else {
+    blueToggler->activate();
+  }
+}
+
+// Boot sequence of the blue LED: once the start-up pattern has run out, the state pattern takes over
+Workflow bootIndicatorWorkflow() {
+  co_await sleepFor(STATUS_STARTUP_MS);
+  blueToggler.emplace(BLUE_LED_BUILTIN, -1, 2000, LedUtils::LOW_IS_ON); // replaces the start-up pattern in place
+  showHeaterState();
+}
+
+// Plays the boot splash (one frame per pass at most: a frame is spread over several passes), then scrolls the
+// welcome message
+Workflow bootSplashWorkflow() {
+  while (!bootSplash.isExpired()) {
+    if (bootSplash.checkFrame()) u8g2.sendBuffer();
+    co_await nextPass();
+  }
+  statusMarquee.render("Done with setup. Kolibrie commencing operations!", u8g2_font_logisoso30_tr, 0);
+  statusMarquee.activate();
+}
+
+// Writes EXT_LOAD_SWITCH for one mains cycle; called by the burst-fire timer ISR
+void IRAM_ATTR writeBurstLoad(bool on) { heaterSupervisor.requestLoad(0, on); }
+
+// Searches the sensor bus again, on the bit-banged bus (the RMT peripheral releases the GPIO meanwhile; the
+// search blocks the loop for ~15 ms per device). The zones take the sensors in search order; if there are
+// fewer devices than zones, the zones keep their sensors, and missing sensors show as faults of their zones.
+void rescanSensors() {
+  sensorRescanRequested = false;
+  temperatureSensorRmtBus.end();
+  temperatureSensorBus.reset_search();
+  DeviceAddress found[ZoneUtils::max_zones];
+  uint8_t deviceCount = scanDeviceAddresses(temperatureSensorBus, found, ZoneUtils::max_zones);
+  flightRecorder.record(FlightEvent::FlightSensorRescan, 0, deviceCount);
+  if (deviceCount >= zones.zoneCount()) {
+    for (uint8_t zone = 0; zone < zones.zoneCount(); zone++) {
+      memcpy(sensorAddresses[zone], found[zone], sizeof(DeviceAddress));
+      zones.setSensorAddress(zone, found[zone]);
+    }
+    sensorBusShared = (deviceCount > 1);
+    sensorResolution = 0; // a replaced sensor may still run its default resolution: configure all with the next measurement
+  } else {
+    Serial.print(F("WARNING: rescan found "));
+    Serial.print(deviceCount, DEC);
+    Serial.print(F(" devices for "));
+    Serial.print(zones.zoneCount(), DEC);
+    Serial.println(F(" zones; zones keep their sensors"));
+  }
+  if (!temperatureSensorRmtBus.begin()) {
+    Serial.println(F("Error: Unable to set up the RMT peripheral for the OneWire bus after the rescan."));
+  }
+}
+
 /* ...
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
 // Scan for devices on the OneWire bus.
 // • prints addresses of detected devices to Serial console
-// • writes the address of the LAST DEVICE found to `tempSensorDeviceAddress`
+// • writes the addresses of the first `maxAddresses` devices found to `addressesOut`, in search order
 // • returns number of devices found
-uint8_t scanDevicesAddressesAndRememberLast(OneWire &bus, DeviceAddress addressOut) {
+uint8_t scanDeviceAddresses(OneWire &bus, DeviceAddress *addressesOut, uint8_t maxAddresses) {
   uint8_t count = 0;
+  DeviceAddress address;
 
-  if (bus.search(addressOut)) {
+  if (bus.search(address)) {
     Serial.println(F("Devices with addresses found on OneWire bus:"));
     do {
+      if (count < maxAddresses) memcpy(addressesOut[count], address, sizeof(DeviceAddress));
       count++;
       Serial.print("   ");
-      printDeviceAddress(addressOut);
+      printDeviceAddress(address);
       Serial.println("");
-      // addressOut always contains the last found address
-    } while (bus.search(addressOut));
+    } while (bus.search(address));
   } else {
     Serial.println(F("No devices found on OneWire bus!"));
   }
@@ -331,120 +1039,14 @@ void printTemperature(DallasTemperature &sensors, DeviceAddress deviceAddress) {
 //   oledPrintTwoLines(u8g2, "22 Size: 1234567", "ABCDEFG", 22); delay(5000);
 //
 void oledPrintTwoLines(U8G2 &display, const char *line1, const char *line2, uint8_t textHeight /* = 16 */) {
-  display.clearBuffer();
-  uint8_t fontHeight = textHeight;
-  uint8_t yOffset = 2;
-  uint8_t yPad = 2;
-
   // Choose a font based on the requested height, suitable for small screens
-  if (textHeight <= 10) {
-    display.setFont(u8g2_font_5x8_tf);
-    fontHeight = 10;
-    yOffset = 6;
-    yPad = 6;
-  } else if (textHeight <= 12) {
-    display.setFont(u8g2_font_6x12_tf);
-    fontHeight = 10;
-    yOffset = 5;
-    yPad = 5;
-  } else if (textHeight <= 13) {
-    display.setFont(u8g2_font_6x13_tf);
-    fontHeight = 10;
-    yOffset = 4;
-    yPad = 6;
-  } else if (textHeight <= 14) {
-    display.setFont(u8g2_font_7x13_tf);
-    fontHeight = 11;
-    yOffset = 3;
-    yPad = 7;
-  } else if (textHeight <= 15) {
-    display.setFont(u8g2_font_8x13_tf);
-    yOffset = 2;
-    yPad = 4;
-    fontHeight = 12;
-  } else if (textHeight <= 16) {
-    display.setFont(u8g2_font_9x15_tf);
-    yOffset = 1;
-    fontHeight = 13;
-  } else if (textHeight <= 18) {
-    display.setFont(u8g2_font_9x18_tf);
-    fontHeight = 14;
-    yOffset = 0;
-  } else {
-    display.setFont(u8g2_font_10x20_tf);
-    fontHeight = 15;
-    yPad = 2;
-    yOffset = 0;
-  }
+  const OledFonts::Metrics &metrics = OledFonts::forTextHeight(textHeight);
+
+  display.clearBuffer();
+  display.setFont(metrics.font);
   // Print first line at top
-  display.drawStr(0, yOffset + fontHeight, line1);
+  display.drawStr(0, metrics.yOffset + metrics.fontHeight, line1);
   // Print second line below
-  display.drawStr(0, yOffset + 2 * fontHeight + yPad, line2);
+  display.drawStr(0, metrics.yOffset + 2 * metrics.fontHeight + metrics.yPad, line2);
   display.sendBuffer();
 }
-
-// Service function: Scroll a single line of text horizontally on the OLED, with configurable text height and speed.
-// The `scrollSpeedMs` is the delay between moving the text by 1 pixel (default: 50ms).
-//
-// Examples:
-//   oledScrollText(u8g2, "Done with setup. Kolibrie commencing operations!", 20, 10);
-void oledScrollText(U8G2 &display, const char *text, uint8_t textHeight /* = 16 */, uint16_t scrollSpeedMs /* = 50 */) {
-  // Font selection logic (unchanged)
-  uint8_t fontHeight = textHeight;
-  uint8_t yOffset = 2;
-  if (textHeight <= 10) {
-    display.setFont(u8g2_font_5x8_tf);
-    fontHeight = 10;
-    yOffset = 6;
-  } else if (textHeight <= 12) {
-    display.setFont(u8g2_font_6x12_tf);
-    fontHeight = 10;
-    yOffset = 5;
-  } else if (textHeight <= 13) {
-    display.setFont(u8g2_font_6x13_tf);
-    fontHeight = 10;
-    yOffset = 4;
-  } else if (textHeight <= 14) {
-    display.setFont(u8g2_font_7x13_tf);
-    fontHeight = 11;
-    yOffset = 3;
-  } else if (textHeight <= 15) {
-    display.setFont(u8g2_font_8x13_tf);
-    yOffset = 2;
-    fontHeight = 12;
-  } else if (textHeight <= 16) {
-    display.setFont(u8g2_font_9x15_tf);
-    yOffset = 1;
-    fontHeight = 13;
-  } else if (textHeight <= 18) {
-    display.setFont(u8g2_font_9x18_tf);
-    fontHeight = 14;
-    yOffset = 0;
-  } else {
-    display.setFont(u8g2_font_logisoso30_tr);
-    fontHeight = 30;
-    yOffset = 0;
-  }
-
-  display.setFontMode(1); // transparent mode for speed
-  uint8_t y = fontHeight + yOffset;
-  int textWidth = display.getUTF8Width(text);
-  int screenWidth = display.getDisplayWidth();
-
-  int offset = 0;
-  while (true) {
-    display.clearBuffer();
-    int x = offset;
-    // Draw text repeatedly for seamless loop
-    do {
-      display.drawUTF8(x, y, text);
-      x += textWidth;
-    } while (x < screenWidth);
-    display.sendBuffer();
-    offset--;
-    if (offset < -textWidth) offset = 0;
-    delay(scrollSpeedMs);
-    // Optionally break after one full scroll (uncomment below)
-    if (offset == 0) break;
-  }
-}
@@ -0,0 +1,543 @@
+// Host CLI for the command protocol of the controller (see src/CommandProtocol.h), on Linux.
+//
+//   kolibrie-cli <port> ping [count]              round trips with a 16-byte payload; prints min/median/max
+//   kolibrie-cli <port> state                     zones and heater faults
+//   kolibrie-cli <port> setpoint <zone> <celsius> zones are numbered from 1, as on the console
+//   kolibrie-cli <port> metrics                   uptime, heap, loop time percentiles, counters
+//   kolibrie-cli <port> snapshot                  all fields of the controller snapshot, as described by its schema
+//   kolibrie-cli <port> rescan                    rescans the sensor bus (results on the console)
+//   kolibrie-cli <port> clear-faults              clears the latched heater faults; prints the faults that were latched
+//   kolibrie-cli <port> view [interval] [dir]     mirrors the screen into the terminal, at most one frame per interval
+//                                                 [ms] (default 100); saves each frame as a PBM image in dir; Ctrl-C stops
+//   kolibrie-cli <port> export                    the temperature history as CSV on stdout, oldest sample first; a summary
+//                                                 (pages, samples, bytes, throughput) on stderr
+//
+// <port> is the serial port of the board (e.g. /dev/ttyACM0), or the slave end of a pty. The controller's
+// text output on the same port is skipped. Exits non-zero if a command fails or times out.
+#include "CommandProtocol.h"
+#include "ControllerSnapshot.h"
+#include "FrameCodec.h"
+#include "SeriesCodec.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <functional>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+  constexpr int response_timeout_ms = 1000;
+  constexpr uint8_t ping_bytes = 16;
+  constexpr uint8_t display_chunk_header_bytes = 6; // see `FrameMirrorUtils`
+  constexpr uint8_t display_flag_rotated_180 = 0x01;
+  constexpr uint8_t display_frame_key = 0;
+  constexpr size_t max_display_bytes = 128 * 64 / 8; // largest u8g2 frame buffer the viewer accepts
+  constexpr uint8_t series_chunk_header_bytes = 2;   // see `SeriesStoreUtils`
+  constexpr int export_idle_timeout_ms = 5000;       // the export fails if no page arrives for this long
+
+  volatile sig_atomic_t viewStopped = 0;
+
+  // Receives the frames on the port other than the awaited response, e.g. mirrored screen frames
+  typedef std::function<void(const CommandFrame &message)> MessageHandler;
+
+  // One parser for the port, so a frame split across two reads (or following a response in the same read) is kept
+  CommandParser portParser;
+
+  struct Response {
+    CommandStatus status;
+    uint8_t length; // payload bytes after the status
+    uint8_t payload[CommandUtils::max_payload];
+  };
+
+  const char *statusName(CommandStatus status) {
+    switch (status) {
+      case CommandStatus::CommandOk: return "ok";
+      case CommandStatus::CommandUnknown: return "unknown command";
+      case CommandStatus::CommandBadPayload: return "bad payload";
+      case CommandStatus::CommandBusy: return "busy";
+      default: return "unknown status";
+    }
+  }
+
+  int64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  int openPort(const char *path) {
+    int fd = open(path, O_RDWR | O_NOCTTY);
+    if (fd < 0) return -1;
+    termios attributes;
+    if (tcgetattr(fd, &attributes) == 0) { // a tty: raw mode; anything else (e.g. a pipe) is used as is
+      cfmakeraw(&attributes);
+      cfsetspeed(&attributes, B115200);
+      tcsetattr(fd, TCSANOW, &attributes);
+      tcflush(fd, TCIFLUSH);
+    }
+    return fd;
+  }
+
+  // Sends a request and waits for the response with the same sequence number; returns false on a timeout
+  bool transact(int fd, uint8_t command, const uint8_t *payload, uint8_t length, Response &response, const MessageHandler &onMessage) {
+    static uint8_t sequence = 0;
+    sequence++;
+    uint8_t frame[CommandUtils::max_frame_bytes];
+    size_t size = encodeCommandFrame(command, sequence, payload, length, frame);
+    if ((size == 0) || (write(fd, frame, size) != static_cast<ssize_t>(size))) return false;
+
+    bool responded = false;
+    int64_t deadlineUs = nowUs() + 1000LL * response_timeout_ms;
+    while (!responded) {
+      int remainingMs = static_cast<int>((deadlineUs - nowUs()) / 1000LL);
+      if (remainingMs < 0) return false;
+      pollfd descriptor = {fd, POLLIN, 0};
+      if (poll(&descriptor, 1, remainingMs) <= 0) continue;
+      uint8_t received[256];
+      ssize_t count = read(fd, received, sizeof(received));
+      if (count <= 0) return false;
+      for (ssize_t i = 0; i < count; i++) { // the whole read: frames after the response go to the handler
+        if (!portParser.feed(received[i], static_cast<uint32_t>(nowUs() / 1000LL))) continue;
+        const CommandFrame &reply = portParser.frame();
+        if (responded || (reply.command != (command | CommandUtils::response_flag)) || (reply.sequence != sequence) || (reply.length < 1)) {
+          if (onMessage) onMessage(reply);
+          continue;
+        }
+        response.status = static_cast<CommandStatus>(reply.payload[0]);
+        response.length = reply.length - 1;
+        memcpy(response.payload, &reply.payload[1], response.length);
+        responded = true;
+      }
+    }
+    return true;
+  }
+
+  // Sends a request; prints the failure and returns false unless the response is ok
+  bool request(int fd, uint8_t command, const uint8_t *payload, uint8_t length, Response &response, const MessageHandler &onMessage = nullptr) {
+    if (!transact(fd, command, payload, length, response, onMessage)) {
+      fprintf(stderr, "no response within %d ms\n", response_timeout_ms);
+      return false;
+    }
+    if (response.status != CommandStatus::CommandOk) {
+      fprintf(stderr, "command failed: %s\n", statusName(response.status));
+      return false;
+    }
+    return true;
+  }
+
+  int runPing(int fd, int count) {
+    uint8_t payload[ping_bytes];
+    for (uint8_t i = 0; i < ping_bytes; i++) payload[i] = i;
+    std::vector<int64_t> roundTripsUs;
+    for (int i = 0; i < count; i++) {
+      Response response;
+      int64_t startUs = nowUs();
+      if (!request(fd, CommandId::CommandPing, payload, sizeof(payload), response)) return 1;
+      roundTripsUs.push_back(nowUs() - startUs);
+      if ((response.length != sizeof(payload)) || (memcmp(response.payload, payload, sizeof(payload)) != 0)) {
+        fprintf(stderr, "ping: payload not echoed\n");
+        return 1;
+      }
+    }
+    std::sort(roundTripsUs.begin(), roundTripsUs.end());
+    printf("ping: %d round trips, min %lld us, median %lld us, max %lld us\n", count, static_cast<long long>(roundTripsUs.front()),
+           static_cast<long long>(roundTripsUs[roundTripsUs.size() / 2]), static_cast<long long>(roundTripsUs.back()));
+    return 0;
+  }
+
+  int runState(int fd) {
+    Response response;
+    if (!request(fd, CommandId::CommandGetState, nullptr, 0, response)) return 1;
+    PayloadReader reader(response.payload, response.length);
+    uint8_t zones = 0;
+    uint32_t heaterFaults = 0;
+    if (!reader.getU8(zones) || !reader.getU32(heaterFaults)) return 1;
+    printf("heater faults: 0x%02X\n", static_cast<unsigned>(heaterFaults));
+    for (uint8_t zone = 0; zone < zones; zone++) {
+      float temperatureC, setpointC;
+      uint8_t flags, faults;
+      if (!reader.getFloat(temperatureC) || !reader.getFloat(setpointC) || !reader.getU8(flags) || !reader.getU8(faults)) return 1;
+      printf("zone %u: %.2f C (setpoint %.2f C), demand %s, load %s, faults 0x%02X\n", zone + 1, temperatureC, setpointC,
+             (flags & 0x02) ? "yes" : "no", (flags & 0x01) ? "on" : "off", faults);
+    }
+    return 0;
+  }
+
+  int runClearFaults(int fd) {
+    Response response;
+    if (!request(fd, CommandId::CommandClearFaults, nullptr, 0, response)) return 1;
+    PayloadReader reader(response.payload, response.length);
+    uint32_t heaterFaults = 0;
+    if (!reader.getU32(heaterFaults)) return 1;
+    printf("cleared heater faults: 0x%02X\n", static_cast<unsigned>(heaterFaults));
+    return 0;
+  }
+
+  int runSetpoint(int fd, int zone, float setpointC) {
+    if ((zone < 1) || (zone > 255)) {
+      fprintf(stderr, "setpoint: zones are numbered from 1\n");
+      return 1;
+    }
+    uint8_t payload[5];
+    PayloadWriter writer(payload, sizeof(payload));
+    writer.putU8(static_cast<uint8_t>(zone - 1));
+    writer.putFloat(setpointC);
+    Response response;
+    return request(fd, CommandId::CommandSetSetpoint, payload, writer.length(), response) ? 0 : 1;
+  }
+
+  int runMetrics(int fd) {
+    Response response;
+    if (!request(fd, CommandId::CommandGetMetrics, nullptr, 0, response)) return 1;
+    PayloadReader reader(response.payload, response.length);
+    uint32_t uptimeMs, freeHeap, minimumFreeHeap, events, droppedEvents, commands, rejectedFrames;
+    float p50, p90, p99;
+    if (!reader.getU32(uptimeMs) || !reader.getU32(freeHeap) || !reader.getU32(minimumFreeHeap) || !reader.getFloat(p50) ||
+        !reader.getFloat(p90) || !reader.getFloat(p99) || !reader.getU32(events) || !reader.getU32(droppedEvents) ||
+        !reader.getU32(commands) || !reader.getU32(rejectedFrames)) {
+      return 1;
+    }
+    printf("uptime: %u ms\n", uptimeMs);
+    printf("heap: %u bytes free, minimum %u bytes\n", freeHeap, minimumFreeHeap);
+    printf("loop time: p50 %.0f us, p90 %.0f us, p99 %.0f us\n", p50, p90, p99);
+    printf("events: %u dispatched, %u dropped\n", events, droppedEvents);
+    printf("commands: %u dispatched, %u frames rejected\n", commands, rejectedFrames);
+    return 0;
+  }
+
+  // Prints the fields of the snapshot by its schema: fields the controller's version lacks are marked as such,
+  // and of the per-zone fields only the zones present
+  int runSnapshot(int fd) {
+    Response response;
+    if (!request(fd, CommandId::CommandGetSnapshot, nullptr, 0, response)) return 1;
+    ControllerSnapshot snapshot;
+    if (!decodeSnapshot(response.payload, response.length, snapshot)) {
+      fprintf(stderr, "snapshot: malformed (%u bytes)\n", response.length);
+      return 1;
+    }
+    printf("snapshot %u: version %u (decoder %u), %u bytes\n", snapshot.sequence, snapshot.version, SnapshotUtils::schema_version, snapshot.size);
+    for (uint8_t i = 0; i < snapshotFieldCount; i++) {
+      const SnapshotField &field = snapshotSchema[i];
+      printf("%-22s", field.name);
+      if (!isFieldPresent(snapshot, field)) {
+        printf(" (not sent)\n");
+        continue;
+      }
+      uint8_t count = (field.count == SnapshotUtils::max_zones) ? min(snapshot.zoneCount, SnapshotUtils::max_zones) : field.count;
+      for (uint8_t index = 0; index < count; index++) printf(" %g", snapshotFieldValue(snapshot, field, index));
+      printf("\n");
+    }
+    return 0;
+  }
+
+  // A mirrored frame: u8g2 frame buffer of tile rows, each byte a column of 8 pixels (least significant bit on top)
+  struct DisplayFrame {
+    uint8_t sequence;
+    uint8_t tileWidth;
+    uint8_t tileHeight;
+    uint8_t flags;
+    std::vector<uint8_t> buffer;
+
+    int width() const { return 8 * tileWidth; }
+    int height() const { return 8 * tileHeight; }
+
+    // pixel in screen orientation
+    bool pixel(int x, int y) const {
+      if (flags & display_flag_rotated_180) {
+        x = width() - 1 - x;
+        y = height() - 1 - y;
+      }
+      return buffer[(y / 8) * width() + x] & (1 << (y % 8));
+    }
+  };
+
+  // Reassembles the chunks of mirrored frames and decodes them; a delta frame is applied only onto the frame
+  // it follows, otherwise frames are dropped until the next key frame
+  class DisplayFrameAssembler {
+    public:
+    // Takes a `MessageDisplayFrame`; returns true once a frame is complete, which is then in `frame()`
+    bool add(const CommandFrame &message) {
+      if (message.length < display_chunk_header_bytes) return false;
+      uint8_t encoding = message.payload[0], chunk = message.payload[1], chunkCount = message.payload[2];
+      if (chunk == 0) {
+        assembling = true;
+        sequence = message.sequence;
+        header.assign(message.payload, message.payload + display_chunk_header_bytes);
+        encoded.clear();
+      } else if (!assembling || (message.sequence != sequence) || (chunk != nextChunk)) {
+        assembling = false; // a chunk was lost
+        return false;
+      }
+      encoded.insert(encoded.end(), message.payload + display_chunk_header_bytes, message.payload + message.length);
+      nextChunk = chunk + 1;
+      if (nextChunk < chunkCount) return false;
+      assembling = false;
+
+      DisplayFrame next = {sequence, header[3], header[4], header[5], {}};
+      size_t length = 8 * next.tileWidth * next.tileHeight;
+      if ((length == 0) || (length > max_display_bytes)) return false;
+      next.buffer.resize(length);
+      const uint8_t *reference = nullptr;
+      if (encoding != display_frame_key) {
+        if (!valid || (current.buffer.size() != length) || (sequence != static_cast<uint8_t>(current.sequence + 1))) {
+          valid = false;
+          return false;
+        }
+        reference = current.buffer.data();
+      }
+      if (!FrameCodec::decode(encoded.data(), encoded.size(), reference, next.buffer.data(), length)) {
+        valid = false;
+        return false;
+      }
+      current = next;
+      valid = true;
+      return true;
+    }
+
+    const DisplayFrame &frame() const { return current; }
+    size_t encodedSize() const { return encoded.size(); }
+
+    private:
+    bool assembling = false;
+    bool valid = false;
+    uint8_t sequence = 0;
+    uint8_t nextChunk = 0;
+    std::vector<uint8_t> header;
+    std::vector<uint8_t> encoded;
+    DisplayFrame current;
+  };
+
+  // Draws a frame with half blocks (two pixel rows per line of text), from the top left of the terminal
+  void renderFrame(const DisplayFrame &frame, size_t encodedSize) {
+    std::string text = "\x1b[H";
+    for (int y = 0; y < frame.height(); y += 2) {
+      for (int x = 0; x < frame.width(); x++) {
+        bool upper = frame.pixel(x, y);
+        bool lower = (y + 1 < frame.height()) && frame.pixel(x, y + 1);
+        text += upper ? (lower ? "\u2588" : "\u2580") : (lower ? "\u2584" : " ");
+      }
+      text += "\n";
+    }
+    fputs(text.c_str(), stdout);
+    printf("frame %3u: %zu of %zu bytes\x1b[K\n", frame.sequence, encodedSize, frame.buffer.size());
+    fflush(stdout);
+  }
+
+  bool writePbm(const DisplayFrame &frame, const char *directory, unsigned index) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/frame-%06u.pbm", directory, index);
+    FILE *file = fopen(path, "wb");
+    if (file == nullptr) return false;
+    fprintf(file, "P4\n%d %d\n", frame.width(), frame.height());
+    for (int y = 0; y < frame.height(); y++) {
+      for (int x = 0; x < frame.width(); x += 8) {
+        uint8_t bits = 0;
+        for (int bit = 0; bit < 8; bit++) {
+          if ((x + bit < frame.width()) && frame.pixel(x + bit, y)) bits |= 0x80 >> bit;
+        }
+        fputc(bits, file);
+      }
+    }
+    return fclose(file) == 0;
+  }
+
+  bool requestMirror(int fd, bool enable, uint16_t intervalMs, const MessageHandler &onMessage) {
+    uint8_t payload[3];
+    PayloadWriter writer(payload, sizeof(payload));
+    writer.putU8(enable ? 1 : 0);
+    writer.putU16(intervalMs);
+    Response response;
+    return request(fd, CommandId::CommandMirrorDisplay, payload, writer.length(), response, onMessage);
+  }
+
+  int runView(int fd, int intervalMs, const char *directory) {
+    if ((intervalMs < 0) || (intervalMs > 65535)) return 1;
+    struct sigaction action = {};
+    action.sa_handler = [](int) { viewStopped = 1; };
+    sigaction(SIGINT, &action, nullptr); // without SA_RESTART: interrupts poll()
+
+    DisplayFrameAssembler assembler;
+    unsigned frames = 0;
+    MessageHandler onMessage = [&](const CommandFrame &message) {
+      if (message.command != (CommandId::MessageDisplayFrame | CommandUtils::response_flag)) return;
+      if (!assembler.add(message)) return;
+      renderFrame(assembler.frame(), assembler.encodedSize());
+      if ((directory != nullptr) && !writePbm(assembler.frame(), directory, frames)) {
+        perror(directory);
+        viewStopped = 1;
+      }
+      frames++;
+    };
+    printf("\x1b[2J");
+    if (!requestMirror(fd, true, static_cast<uint16_t>(intervalMs), onMessage)) return 1;
+    while (!viewStopped) {
+      pollfd descriptor = {fd, POLLIN, 0};
+      if (poll(&descriptor, 1, 200) <= 0) continue;
+      uint8_t received[256];
+      ssize_t count = read(fd, received, sizeof(received));
+      if (count <= 0) break;
+      for (ssize_t i = 0; i < count; i++) {
+        if (portParser.feed(received[i], static_cast<uint32_t>(nowUs() / 1000LL))) onMessage(portParser.frame());
+      }
+    }
+    printf("%u frames\n", frames);
+    return requestMirror(fd, false, 0, nullptr) ? 0 : 1;
+  }
+
+  // Reassembles the chunks of exported pages; a page with a lost chunk is dropped
+  class SeriesPageAssembler {
+    public:
+    // Takes a `MessageSeriesPage`; returns true once a page is complete, which is then in `page()`
+    bool add(const CommandFrame &message) {
+      if (message.length < series_chunk_header_bytes) return false;
+      uint8_t chunk = message.payload[0], chunkCount = message.payload[1];
+      if (chunkCount == 0) {
+        ended = true;
+        return false;
+      }
+      if (chunk == 0) {
+        assembling = true;
+        sequence = message.sequence;
+        data.clear();
+      } else if (!assembling || (message.sequence != sequence) || (chunk != nextChunk)) {
+        assembling = false;
+        dropped++;
+        return false;
+      }
+      data.insert(data.end(), message.payload + series_chunk_header_bytes, message.payload + message.length);
+      nextChunk = chunk + 1;
+      if (nextChunk < chunkCount) return false;
+      assembling = false;
+      if (isValidSeriesPage(data.data(), data.size())) return true;
+      dropped++;
+      return false;
+    }
+
+    const std::vector<uint8_t> &page() const { return data; }
+    bool isEnded() const { return ended; }
+    unsigned droppedCount() const { return dropped; }
+
+    private:
+    bool assembling = false;
+    bool ended = false;
+    uint8_t sequence = 0;
+    uint8_t nextChunk = 0;
+    unsigned dropped = 0;
+    std::vector<uint8_t> data;
+  };
+
+  // Prints the samples of a page as CSV lines; returns the number of samples
+  unsigned printSeriesPage(const std::vector<uint8_t> &page) {
+    SeriesPageHeader header;
+    memcpy(&header, page.data(), sizeof(header));
+    SeriesDecoder decoder(header.channels);
+    SeriesSample sample = {};
+    const uint8_t *records = page.data() + SeriesCodec::header_bytes;
+    unsigned samples = 0;
+    for (size_t offset = 0; offset < header.payloadBytes; samples++) {
+      size_t size = decoder.decode(records + offset, header.payloadBytes - offset, sample);
+      if (size == 0) {
+        fprintf(stderr, "export: page %u malformed after %u samples\n", header.sequence, samples);
+        break;
+      }
+      offset += size;
+      printf("%u,%u,%u", sample.timeS, sample.heaterPercent, sample.loads);
+      for (uint8_t channel = 0; channel < header.channels; channel++) {
+        if (sample.temperature[channel] == SnapshotUtils::no_temperature) {
+          printf(",");
+        } else {
+          printf(",%.4f", snapshotCelsius(sample.temperature[channel]));
+        }
+      }
+      printf("\n");
+    }
+    return samples;
+  }
+
+  // Streams the history; the CSV header is printed with the first page (the channels are those of the controller)
+  int runExport(int fd) {
+    SeriesPageAssembler assembler;
+    unsigned pages = 0, samples = 0;
+    size_t bytes = 0;
+    uint8_t channels = 0;
+    MessageHandler onMessage = [&](const CommandFrame &message) {
+      if (message.command != (CommandId::MessageSeriesPage | CommandUtils::response_flag)) return;
+      if (!assembler.add(message)) return;
+      const std::vector<uint8_t> &page = assembler.page();
+      if (pages == 0) {
+        channels = page[offsetof(SeriesPageHeader, channels)];
+        printf("time_s,heater_percent,loads");
+        for (uint8_t channel = 0; channel < channels; channel++) printf(",t%u_c", channel + 1);
+        printf("\n");
+      }
+      samples += printSeriesPage(page);
+      bytes += page.size();
+      pages++;
+    };
+
+    Response response;
+    int64_t startUs = nowUs();
+    if (!request(fd, CommandId::CommandExportSeries, nullptr, 0, response, onMessage)) return 1;
+    PayloadReader reader(response.payload, response.length);
+    uint32_t expected = 0;
+    if (!reader.getU32(expected)) return 1;
+    int64_t lastActivityUs = nowUs();
+    while (!assembler.isEnded()) {
+      if (nowUs() - lastActivityUs > 1000LL * export_idle_timeout_ms) {
+        fprintf(stderr, "export: no page within %d ms\n", export_idle_timeout_ms);
+        return 1;
+      }
+      pollfd descriptor = {fd, POLLIN, 0};
+      if (poll(&descriptor, 1, 200) <= 0) continue;
+      uint8_t received[256];
+      ssize_t count = read(fd, received, sizeof(received));
+      if (count <= 0) return 1;
+      for (ssize_t i = 0; i < count; i++) {
+        if (!portParser.feed(received[i], static_cast<uint32_t>(nowUs() / 1000LL))) continue;
+        onMessage(portParser.frame());
+        lastActivityUs = nowUs();
+      }
+    }
+    double elapsedS = static_cast<double>(nowUs() - startUs) / 1e6;
+    fprintf(stderr, "export: %u of %u pages (%u dropped), %u samples, %zu bytes (%.2f bytes/sample), %.0f bytes/s\n", pages, expected,
+            assembler.droppedCount(), samples, bytes, (samples > 0) ? static_cast<double>(bytes) / samples : 0.0,
+            (elapsedS > 0.0) ? static_cast<double>(bytes) / elapsedS : 0.0);
+    return (assembler.droppedCount() == 0) ? 0 : 1;
+  }
+
+  int usage() {
+    fprintf(stderr, "usage: kolibrie-cli <port> ping [count] | state | setpoint <zone> <celsius> | metrics | snapshot | rescan | clear-faults | view [interval] [dir] | export\n");
+    return 2;
+  }
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) return usage();
+  int fd = openPort(argv[1]);
+  if (fd < 0) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  const char *command = argv[2];
+  Response response;
+  if (strcmp(command, "ping") == 0) {
+    int count = (argc > 3) ? atoi(argv[3]) : 100;
+    return (count > 0) ? runPing(fd, count) : usage();
+  }
+  if (strcmp(command, "state") == 0) return runState(fd);
+  if ((strcmp(command, "setpoint") == 0) && (argc > 4)) return runSetpoint(fd, atoi(argv[3]), strtof(argv[4], nullptr));
+  if (strcmp(command, "metrics") == 0) return runMetrics(fd);
+  if (strcmp(command, "snapshot") == 0) return runSnapshot(fd);
+  if (strcmp(command, "rescan") == 0) return request(fd, CommandId::CommandRescanSensors, nullptr, 0, response) ? 0 : 1;
+  if (strcmp(command, "clear-faults") == 0) return runClearFaults(fd);
+  if (strcmp(command, "view") == 0) return runView(fd, (argc > 3) ? atoi(argv[3]) : 100, (argc > 4) ? argv[4] : nullptr);
+  if (strcmp(command, "export") == 0) return runExport(fd);
+  return usage();
+}
@@ -0,0 +1,190 @@
+// Build step for the animations of the OLED screen (see src/XbmAnimation.h), on the host.
+//
+//   xbmpack <out.h> @<name>[/r] <frame.xbm>... [@<name>[/r] <frame.xbm>...]...
+//
+// Packs each sequence of XBM frames into one `XbmAnimation` named <name>: the frames are converted to the
+// layout of the u8g2 frame buffer and encoded with `FrameCodec`, the first one as is, the others as the XOR
+// with their predecessor. `/r` stores the frames rotated by 180°, for an animation that is decoded straight
+// into the buffer of a display with U8G2_R2. All frames of an animation must have the same size.
+//
+// Regenerates src/AnimationAssets.h (from the repository root):
+//   pio run -e native_xbmpack
+//   .pio/build/native_xbmpack/program src/AnimationAssets.h @heatingAnimation docs/animations/heating_*.xbm
+//     @splashAnimation/r docs/animations/splash_*.xbm
+#include "FrameCodec.h"
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+  constexpr size_t max_dimension = 255;
+  constexpr size_t bytes_per_line = 16; // of the generated arrays
+
+  struct XbmImage {
+    size_t width;
+    size_t height;
+    std::vector<uint8_t> bits; // rows of (width + 7) / 8 bytes, least significant bit on the left
+  };
+
+  struct Animation {
+    std::string name;
+    bool rotated;
+    std::vector<std::string> files;
+  };
+
+  // Reads "#define <name>_width <n>", "#define <name>_height <n>" and the hex bytes of the array
+  bool readXbm(const std::string &path, XbmImage &image) {
+    std::ifstream file(path);
+    if (!file) {
+      fprintf(stderr, "cannot read %s\n", path.c_str());
+      return false;
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+    std::string text = contents.str();
+
+    image.width = image.height = 0;
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+      char name[128];
+      unsigned value;
+      if (sscanf(line.c_str(), " #define %127s %u", name, &value) != 2) continue;
+      size_t length = strlen(name);
+      if ((length > 6) && (strcmp(name + length - 6, "_width") == 0)) image.width = value;
+      if ((length > 7) && (strcmp(name + length - 7, "_height") == 0)) image.height = value;
+    }
+    if ((image.width == 0) || (image.height == 0) || (image.width > max_dimension) || (image.height > max_dimension)) {
+      fprintf(stderr, "%s: missing or unsupported width/height\n", path.c_str());
+      return false;
+    }
+
+    size_t brace = text.find('{');
+    if (brace == std::string::npos) {
+      fprintf(stderr, "%s: no array\n", path.c_str());
+      return false;
+    }
+    image.bits.clear();
+    for (size_t position = text.find("0x", brace); position != std::string::npos; position = text.find("0x", position + 2)) {
+      if (isalnum(static_cast<unsigned char>(text[position - 1]))) continue; // e.g. "20x20" in a comment
+      image.bits.push_back(static_cast<uint8_t>(strtoul(text.c_str() + position, nullptr, 16)));
+    }
+    size_t expected = (image.width + 7) / 8 * image.height;
+    if (image.bits.size() != expected) {
+      fprintf(stderr, "%s: %zu bytes, expected %zu\n", path.c_str(), image.bits.size(), expected);
+      return false;
+    }
+    return true;
+  }
+
+  bool isSet(const XbmImage &image, size_t x, size_t y) { return (image.bits[y * ((image.width + 7) / 8) + x / 8] >> (x % 8)) & 1; }
+
+  // Tile rows of 8-pixel columns, least significant bit on top (the layout of the u8g2 frame buffer)
+  std::vector<uint8_t> toTiles(const XbmImage &image, bool rotated) {
+    size_t tileRows = (image.height + 7) / 8;
+    std::vector<uint8_t> tiles(tileRows * image.width, 0);
+    for (size_t y = 0; y < image.height; y++) {
+      for (size_t x = 0; x < image.width; x++) {
+        if (!isSet(image, x, y)) continue;
+        size_t tileX = rotated ? image.width - 1 - x : x;
+        size_t tileY = rotated ? tileRows * 8 - 1 - y : y;
+        tiles[(tileY / 8) * image.width + tileX] |= static_cast<uint8_t>(1 << (tileY % 8));
+      }
+    }
+    return tiles;
+  }
+
+  bool pack(const Animation &animation, std::string &out) {
+    if (animation.files.empty() || (animation.files.size() > 255)) {
+      fprintf(stderr, "@%s: 1 to 255 frames expected\n", animation.name.c_str());
+      return false;
+    }
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> previous;
+    size_t width = 0, height = 0, xbmBytes = 0;
+    for (const std::string &path : animation.files) {
+      XbmImage image;
+      if (!readXbm(path, image)) return false;
+      if (previous.empty()) {
+        width = image.width;
+        height = image.height;
+      } else if ((image.width != width) || (image.height != height)) {
+        fprintf(stderr, "%s: %zux%zu, expected %zux%zu as the first frame\n", path.c_str(), image.width, image.height, width, height);
+        return false;
+      }
+      xbmBytes += image.bits.size();
+
+      std::vector<uint8_t> tiles = toTiles(image, animation.rotated);
+      std::vector<uint8_t> encoded(FrameCodec::maxEncodedSize(tiles.size()));
+      size_t size = previous.empty() ? FrameCodec::encode(tiles.data(), tiles.size(), encoded.data(), encoded.size())
+                                     : FrameCodec::encodeDelta(tiles.data(), previous.data(), tiles.size(), encoded.data(), encoded.size());
+      data.insert(data.end(), encoded.begin(), encoded.begin() + size);
+      previous = tiles;
+    }
+    if (data.size() > UINT16_MAX) {
+      fprintf(stderr, "@%s: %zu encoded bytes exceed the 64 kB of an animation\n", animation.name.c_str(), data.size());
+      return false;
+    }
+
+    char line[256];
+    snprintf(line, sizeof(line), "\n// %zu frames of %zux%zu pixels%s: %zu bytes as XBM, %zu bytes encoded\n", animation.files.size(), width,
+             height, animation.rotated ? ", rotated by 180°" : "", xbmBytes, data.size());
+    out += line;
+    out += "inline const uint8_t " + animation.name + "_data[] PROGMEM = {";
+    for (size_t i = 0; i < data.size(); i++) {
+      snprintf(line, sizeof(line), "%s0x%02X%s", (i % bytes_per_line == 0) ? "\n    " : " ", data[i], (i + 1 < data.size()) ? "," : "");
+      out += line;
+    }
+    out += "};\n";
+    snprintf(line, sizeof(line), "inline const XbmAnimation %s = {%zu, %zu, %zu, %s, %s_data, %zu, %zu};\n", animation.name.c_str(), width, height,
+             animation.files.size(), animation.rotated ? "XbmAnimationUtils::flag_rotated_180" : "0", animation.name.c_str(), data.size(), xbmBytes);
+    out += line;
+
+    printf("%s: %zu frames, %zu bytes as XBM, %zu bytes encoded (%.0f%% saved)\n", animation.name.c_str(), animation.files.size(), xbmBytes, data.size(),
+           100.0 * (1.0 - static_cast<double>(data.size()) / static_cast<double>(xbmBytes)));
+    return true;
+  }
+
+  int usage() {
+    fprintf(stderr, "usage: xbmpack <out.h> @<name>[/r] <frame.xbm>... [@<name>[/r] <frame.xbm>...]...\n");
+    return 2;
+  }
+}
+
+int main(int argc, char **argv) {
+  if (argc < 4) return usage();
+  std::vector<Animation> animations;
+  for (int i = 2; i < argc; i++) {
+    std::string argument = argv[i];
+    if (argument[0] == '@') {
+      Animation animation;
+      animation.rotated = (argument.size() > 3) && (argument.compare(argument.size() - 2, 2, "/r") == 0);
+      animation.name = argument.substr(1, argument.size() - 1 - (animation.rotated ? 2 : 0));
+      if (animation.name.empty()) return usage();
+      animations.push_back(animation);
+    } else if (animations.empty()) {
+      return usage();
+    } else {
+      animations.back().files.push_back(argument);
+    }
+  }
+
+  std::string out = "// Generated by tools/xbmpack from the XBM frames in docs/animations; do not edit.\n"
+                    "#pragma once\n"
+                    "#include \"XbmAnimation.h\"\n";
+  for (const Animation &animation : animations) {
+    if (!pack(animation, out)) return 1;
+  }
+  std::ofstream file(argv[1]);
+  file << out;
+  if (!file) {
+    fprintf(stderr, "cannot write %s\n", argv[1]);
+    return 1;
+  }
+  return 0;
+}